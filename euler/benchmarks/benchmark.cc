@@ -0,0 +1,107 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/benchmarks/benchmark.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+
+namespace euler {
+
+namespace {
+
+const int64_t kMaxIterations = 1000000000;
+
+}  // namespace
+
+void BenchmarkRunner::Run(const std::string& name, int64_t items,
+                          Function fn) {
+  if (!Enabled(name)) {
+    return;
+  }
+
+  int64_t iterations = 1;
+  double seconds = 0;
+  while (true) {
+    auto start = std::chrono::steady_clock::now();
+    fn(iterations);
+    seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (seconds >= min_seconds_ || iterations >= kMaxIterations) {
+      break;
+    }
+    // Aim a bit over min_seconds, grow at most 10x if the run is too short
+    // to predict
+    double multiplier = seconds > min_seconds_ / 10 ?
+        min_seconds_ * 1.4 / seconds : 10;
+    iterations = std::min(kMaxIterations, std::max(
+        iterations + 1, static_cast<int64_t>(iterations * multiplier)));
+  }
+
+  Result result;
+  result.name = name;
+  result.iterations = iterations;
+  result.ns_per_iteration = seconds * 1e9 / iterations;
+  result.items_per_second = items * iterations / seconds;
+  results_.push_back(result);
+  fprintf(stderr, "%-40s %12lld %14.1f ns %14.0f items/s\n", name.c_str(),
+          static_cast<long long>(iterations),  // NOLINT
+          result.ns_per_iteration, result.items_per_second);
+}
+
+void BenchmarkRunner::SetCounter(const std::string& name,
+                                 const std::string& counter, double value) {
+  for (auto& result : results_) {
+    if (result.name == name) {
+      result.counters.emplace_back(counter, value);
+      fprintf(stderr, "%-40s %s: %g\n", name.c_str(), counter.c_str(),
+              value);
+    }
+  }
+}
+
+std::string BenchmarkRunner::ToJson() const {
+  char host[256] = "";
+  gethostname(host, sizeof(host) - 1);
+  std::string out = "{\n  \"context\": {\"host_name\": \"";
+  out += host;
+  out += "\", \"num_cpus\": " +
+      std::to_string(std::thread::hardware_concurrency()) +
+      ", \"min_seconds\": " + std::to_string(min_seconds_) + "},\n";
+  out += "  \"benchmarks\": [";
+  for (size_t i = 0; i < results_.size(); ++i) {
+    const Result& result = results_[i];
+    out += i == 0 ? "\n" : ",\n";
+    out += "    {\"name\": \"" + result.name + "\", \"iterations\": " +
+        std::to_string(result.iterations) + ", \"ns_per_iteration\": " +
+        std::to_string(result.ns_per_iteration) +
+        ", \"items_per_second\": " +
+        std::to_string(result.items_per_second);
+    for (auto& counter : result.counters) {
+      char value[32];
+      snprintf(value, sizeof(value), "%g", counter.second);
+      out += ", \"" + counter.first + "\": " + value;
+    }
+    out += "}";
+  }
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+}  // namespace euler
@@ -0,0 +1,75 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_BENCHMARKS_BENCHMARK_H_
+#define EULER_BENCHMARKS_BENCHMARK_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace euler {
+
+// A minimal microbenchmark runner. Each benchmark runs with a growing number
+// of iterations until one run takes at least min_seconds, the last run is
+// reported.
+class BenchmarkRunner {
+ public:
+  // Run the benchmark for the given number of iterations
+  typedef std::function<void(int64_t iterations)> Function;
+
+  struct Result {
+    std::string name;
+    int64_t iterations;
+    double ns_per_iteration;
+    double items_per_second;
+    // Other measurements of the benchmark, e.g. an error
+    std::vector<std::pair<std::string, double>> counters;
+  };
+
+  // Only the benchmarks whose names contain filter are run
+  BenchmarkRunner(double min_seconds, const std::string& filter)
+      : min_seconds_(min_seconds), filter_(filter) { }
+
+  // items is the number of items processed by one iteration, e.g. the batch
+  // size of a query
+  void Run(const std::string& name, int64_t items, Function fn);
+
+  // Attach a counter to the result of the benchmark name, nothing is done
+  // if the benchmark is not run
+  void SetCounter(const std::string& name, const std::string& counter,
+                  double value);
+
+  bool Enabled(const std::string& name) const {
+    return name.find(filter_) != std::string::npos;
+  }
+
+  const std::vector<Result>& results() const { return results_; }
+
+  // {"context": {...}, "benchmarks": [{"name": ..., ...}, ...]}
+  std::string ToJson() const;
+
+ private:
+  double min_seconds_;
+  std::string filter_;
+  std::vector<Result> results_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_BENCHMARKS_BENCHMARK_H_
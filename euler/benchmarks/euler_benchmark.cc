@@ -0,0 +1,574 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the hot paths on a synthetic power-law graph, run in
+// local mode on one box: neighbor sampling, feature fetching, the alias
+// method, the random generator, the id bitmaps, the thread pool, tensor
+// encoding, compiling and whole queries. The graph is generated to data_path
+// first unless generate=0 and loaded into the store picked by storage, node,
+// compact or snapshot. The results are written as JSON to output or stdout.
+//
+// Usage: euler_benchmark [key=value ...]
+//   data_path=/tmp/euler_benchmark generate=1 nodes=100000 partitions=1
+//   degree=16 skew=1.0 dense_dim=32 seed=0 min_time=0.5 filter=
+//   dense_columns=1 quantization=none storage=node gremlin=1 output=
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <math.h>
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "euler/benchmarks/benchmark.h"
+#include "euler/benchmarks/graph_generator.h"
+#include "euler/client/graph_config.h"
+#include "euler/client/query.h"
+#include "euler/client/query_proxy.h"
+#include "euler/common/alias_method.h"
+#include "euler/common/env.h"
+#include "euler/common/id_bitmap.h"
+#include "euler/common/logging.h"
+#include "euler/common/quantization.h"
+#include "euler/common/random.h"
+#include "euler/core/framework/allocator.h"
+#include "euler/core/framework/tensor.h"
+#include "euler/core/framework/tensor_util.h"
+#include "euler/core/framework/types.pb.h"
+#include "euler/core/graph/graph.h"
+#include "euler/parser/compiler.h"
+
+namespace euler {
+namespace {
+
+const int kBatchSize = 512;
+const int kNeighborCount = 10;
+
+class Flags {
+ public:
+  Flags(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto pos = arg.find('=');
+      if (pos == std::string::npos) {
+        EULER_LOG(FATAL) << "Invalid argument: " << arg;
+      }
+      values_[arg.substr(0, pos)] = arg.substr(pos + 1);
+    }
+  }
+
+  std::string Get(const std::string& key, const std::string& value) const {
+    auto it = values_.find(key);
+    return it == values_.end() ? value : it->second;
+  }
+
+  double Get(const std::string& key, double value) const {
+    auto it = values_.find(key);
+    return it == values_.end() ? value : atof(it->second.c_str());
+  }
+
+ private:
+  std::unordered_map<std::string, std::string> values_;
+};
+
+// Keep the compiler from dropping the benchmarked results
+template <class T>
+void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Through the node accessors of Graph, which serve every storage type
+void BenchmarkGraph(const std::vector<uint64_t>& ids,
+                    BenchmarkRunner* runner) {
+  Graph& graph = Graph::Instance();
+  std::vector<int32_t> edge_types = {0, 1};
+  int32_t dense_fid = graph.graph_meta().GetFeatureId(kDenseFeature);
+
+  runner->Run("graph/Graph::SampleNeighbor", kNeighborCount,
+              [&graph, &ids, &edge_types] (int64_t iterations) {
+    std::vector<common::NodeID> nb_ids(kNeighborCount);
+    std::vector<float> weights(kNeighborCount);
+    std::vector<int32_t> types(kNeighborCount);
+    for (int64_t i = 0; i < iterations; ++i) {
+      graph.SampleNeighbor(ids[i % ids.size()], edge_types, kNeighborCount,
+                           nb_ids.data(), weights.data(), types.data());
+      DoNotOptimize(nb_ids.data());
+    }
+  });
+
+  runner->Run("graph/Graph::GetFullNeighbor", 1,
+              [&graph, &ids, &edge_types] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      auto result = graph.GetFullNeighbor(ids[i % ids.size()], edge_types);
+      DoNotOptimize(result.data());
+    }
+  });
+
+  runner->Run("graph/Graph::GetFloat32Feature", 1,
+              [&graph, &ids, dense_fid] (int64_t iterations) {
+    std::vector<int32_t> fids = {dense_fid};
+    std::vector<std::vector<float>> values;
+    for (int64_t i = 0; i < iterations; ++i) {
+      values.clear();
+      graph.GetFloat32Feature(ids[i % ids.size()], fids, &values);
+      DoNotOptimize(values.data());
+    }
+  });
+}
+
+void BenchmarkDenseFeature(const std::vector<uint64_t>& ids,
+                           BenchmarkRunner* runner) {
+  const DenseFeatureStore& store = Graph::Instance().dense_features();
+  int32_t fid = Graph::Instance().graph_meta().GetFeatureId(kDenseFeature);
+  int64_t dim = store.dim(fid);
+  if (dim == 0) {
+    return;
+  }
+  std::vector<float> values(kBatchSize * dim);
+  runner->Run("graph/DenseFeatureStore::Gather/512", kBatchSize,
+              [&store, &ids, fid, &values] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      size_t offset = (i * kBatchSize) % (ids.size() - kBatchSize);
+      store.Gather(fid, ids.data() + offset, kBatchSize, values.data());
+      DoNotOptimize(values.data());
+    }
+  });
+}
+
+// Gather with the encodings of the dense feature columns, the accuracy is
+// measured against the features of the graph
+void BenchmarkQuantization(const std::vector<uint64_t>& ids,
+                           BenchmarkRunner* runner) {
+  Graph& graph = Graph::Instance();
+  int32_t fid = graph.graph_meta().GetFeatureId(kDenseFeature);
+  int64_t dim = graph.graph_meta().GetFeatureDim(kDenseFeature);
+  if (fid < 0 || dim <= 0 ||
+      !runner->Enabled("graph/DenseFeatureStore::Gather/")) {
+    return;
+  }
+  std::vector<common::NodeID> all_ids(graph.getNodeSize());
+  std::iota(all_ids.begin(), all_ids.end(), 1);
+  auto reader = [&graph] (common::NodeID id, const std::vector<int32_t>& fids,
+                          std::vector<std::vector<float>>* values) {
+    return graph.GetFloat32Feature(id, fids, values);
+  };
+
+  std::vector<float> expected;
+  std::vector<float> values(ids.size() * dim);
+  std::vector<float> batch(kBatchSize * dim);
+  const char* names[] = {"float32", "fp16", "int8"};
+  for (auto quantization :
+       {kNoQuantization, kFp16Quantization, kInt8Quantization}) {
+    DenseFeatureStore store;
+    store.Build(all_ids, {fid}, {dim}, reader, quantization);
+    if (store.dim(fid) == 0) {
+      return;
+    }
+    std::string name = std::string("graph/DenseFeatureStore::Gather/") +
+        names[quantization] + "/512";
+    runner->Run(name, kBatchSize,
+                [&store, &ids, fid, &batch] (int64_t iterations) {
+      for (int64_t i = 0; i < iterations; ++i) {
+        size_t offset = (i * kBatchSize) % (ids.size() - kBatchSize);
+        store.Gather(fid, ids.data() + offset, kBatchSize, batch.data());
+        DoNotOptimize(batch.data());
+      }
+    });
+
+    store.Gather(fid, ids.data(), ids.size(), values.data());
+    if (quantization == kNoQuantization) {
+      expected = values;
+    }
+    double max_error = 0;
+    double sum_error = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+      double error = fabs(values[i] - expected[i]);
+      max_error = std::max(max_error, error);
+      sum_error += error;
+    }
+    runner->SetCounter(name, "bytes_per_node",
+                       store.ValueBytes() / all_ids.size());
+    runner->SetCounter(name, "max_abs_error", max_error);
+    runner->SetCounter(name, "mean_abs_error", sum_error / values.size());
+  }
+}
+
+void BenchmarkCommon(BenchmarkRunner* runner) {
+  std::vector<float> weights(1000);
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(0, 1);
+  for (auto& weight : weights) {
+    weight = dist(rng);
+  }
+
+  runner->Run("common/AliasMethod::Init/1000", 1,
+              [&weights] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      common::AliasMethod alias;
+      alias.Init(weights);
+      DoNotOptimize(alias.GetSize());
+    }
+  });
+
+  common::AliasMethod alias;
+  alias.Init(weights);
+  runner->Run("common/AliasMethod::Next", 1, [&alias] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      DoNotOptimize(alias.Next());
+    }
+  });
+
+  runner->Run("common/ThreadLocalRandom", 1, [] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      DoNotOptimize(common::ThreadLocalRandom());
+    }
+  });
+
+  std::vector<double> uniforms(4096);
+  runner->Run("common/FillRandom/4096", uniforms.size(),
+              [&uniforms] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      common::FillRandom(uniforms.data(), uniforms.size());
+      DoNotOptimize(uniforms.data());
+    }
+  });
+
+  // Two posting lists of a tenth of 1M node ids, as filtered by the DNFs
+  std::vector<uint64_t> posting_a, posting_b;
+  for (uint64_t id = 0; id < 1000000; ++id) {
+    if (dist(rng) < 0.1) {
+      posting_a.push_back(id);
+    }
+    if (dist(rng) < 0.1) {
+      posting_b.push_back(id);
+    }
+  }
+  IdBitmap bitmap_a = IdBitmap::FromSorted(posting_a.data(), posting_a.size());
+  IdBitmap bitmap_b = IdBitmap::FromSorted(posting_b.data(), posting_b.size());
+  runner->Run("common/IdBitmap::And/100000", posting_a.size(),
+              [&bitmap_a, &bitmap_b] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      DoNotOptimize(bitmap_a.And(bitmap_b).size());
+    }
+  });
+  runner->Run("common/IdBitmap::Contains", 1,
+              [&bitmap_a] (int64_t iterations) {
+    uint64_t hits = 0;
+    for (int64_t i = 0; i < iterations; ++i) {
+      hits += bitmap_a.Contains(i * 7919 % 1000000);
+    }
+    DoNotOptimize(hits);
+  });
+
+  // The dequantization kernels of each instruction set on a row of 4096
+  std::vector<float> floats(4096);
+  for (auto& value : floats) {
+    value = dist(rng);
+  }
+  std::vector<uint16_t> halfs(floats.size());
+  common::FloatToHalf(floats.data(), floats.size(), halfs.data());
+  std::vector<int8_t> int8s(floats.size());
+  common::FloatToInt8(floats.data(), floats.size(), 1.0f / 254, 0.5f,
+                      int8s.data());
+  for (int level = common::kScalar; level <= common::SupportedSimdLevel();
+       ++level) {
+    auto simd = static_cast<common::SimdLevel>(level);
+    std::string suffix = std::string("/") + common::SimdLevelName(simd) +
+        "/4096";
+    runner->Run("common/HalfToFloat" + suffix, floats.size(),
+                [&halfs, &floats, simd] (int64_t iterations) {
+      for (int64_t i = 0; i < iterations; ++i) {
+        common::HalfToFloat(halfs.data(), halfs.size(), floats.data(), simd);
+        DoNotOptimize(floats.data());
+      }
+    });
+    runner->Run("common/Int8ToFloat" + suffix, floats.size(),
+                [&int8s, &floats, simd] (int64_t iterations) {
+      for (int64_t i = 0; i < iterations; ++i) {
+        common::Int8ToFloat(int8s.data(), int8s.size(), 1.0f / 254, 0.5f,
+                            floats.data(), simd);
+        DoNotOptimize(floats.data());
+      }
+    });
+  }
+
+  if (!runner->Enabled("common/StdThreadPool::Schedule")) {
+    return;
+  }
+  int threads = std::max(2u, std::thread::hardware_concurrency());
+  std::unique_ptr<ThreadPool> pool(Env::Default()->StartThreadPool(
+      "benchmark", threads, kStdThreadPool));
+  runner->Run("common/StdThreadPool::Schedule", 1,
+              [&pool] (int64_t iterations) {
+    std::atomic<int64_t> done(0);
+    for (int64_t i = 0; i < iterations; ++i) {
+      pool->Schedule([&done] () { ++done; });
+    }
+    while (done < iterations) {
+      std::this_thread::yield();
+    }
+  });
+}
+
+void BenchmarkTensor(BenchmarkRunner* runner) {
+  Tensor tensor(DefaultAllocator(), TensorShape({kBatchSize, 32}),
+                DataType::kFloat);
+  for (int64_t i = 0; i < tensor.NumElements(); ++i) {
+    tensor.Raw<float>()[i] = i;
+  }
+
+  runner->Run("framework/Encode/512x32", 1, [&tensor] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      TensorProto proto;
+      Encode(tensor, &proto);
+      DoNotOptimize(proto.tensor_content().data());
+    }
+  });
+
+  TensorProto proto;
+  Encode(tensor, &proto);
+  runner->Run("framework/Decode/512x32", 1, [&proto] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      Tensor decoded(DefaultAllocator(), TensorShape({kBatchSize, 32}),
+                     DataType::kFloat);
+      Decode(proto, &decoded);
+      DoNotOptimize(decoded.Raw<float>());
+    }
+  });
+}
+
+void BenchmarkCompiler(bool gremlin, BenchmarkRunner* runner) {
+  Compiler* compiler = Compiler::GetInstance();
+  const std::string op = "API_SAMPLE_NB";
+  const std::vector<std::string> inputs = {
+    "nodes", "edge_types", "count", "default_node"};
+
+  runner->Run("compiler/Op2DAGDef", 1,
+              [compiler, &op, &inputs] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      std::unique_ptr<DAGDef> dag_def(
+          compiler->Op2DAGDef(op, "nb", 4, inputs, {}));
+      DoNotOptimize(dag_def.get());
+    }
+  });
+
+  runner->Run("compiler/Op2DAG/cached", 1,
+              [compiler, &op, &inputs] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      DoNotOptimize(compiler->Op2DAG(op, "nb", 4, inputs, {}));
+    }
+  });
+
+  if (!gremlin) {
+    return;
+  }
+  const std::string query =
+      "v(nodes).sampleNB(edge_types, count, 0).as(nb)"
+      ".values(fid).as(feature)";
+
+  runner->Run("compiler/Compile/uncached", 1,
+              [compiler, &query] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      std::unique_ptr<DAGDef> dag_def(
+          compiler->CompileToDAGDef(query, true));
+      DoNotOptimize(dag_def.get());
+    }
+  });
+
+  runner->Run("compiler/Compile/cached", 1,
+              [compiler, &query] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      DoNotOptimize(compiler->Compile(query));
+    }
+  });
+}
+
+void AllocInputs(const std::vector<uint64_t>& ids, int offset,
+                 Query* query) {
+  Tensor* nodes = query->AllocInput("nodes", {kBatchSize}, kUInt64);
+  for (int i = 0; i < kBatchSize; ++i) {
+    nodes->Raw<uint64_t>()[i] = ids[(offset + i) % ids.size()];
+  }
+  Tensor* edge_types = query->AllocInput("edge_types", {2}, kInt32);
+  edge_types->Raw<int32_t>()[0] = 0;
+  edge_types->Raw<int32_t>()[1] = 1;
+  Tensor* count = query->AllocInput("count", {1}, kInt32);
+  count->Raw<int32_t>()[0] = kNeighborCount;
+}
+
+void BenchmarkQuery(const std::vector<uint64_t>& ids, bool gremlin,
+                    BenchmarkRunner* runner) {
+  QueryProxy* proxy = QueryProxy::GetInstance();
+
+  PreparedQuery sample = proxy->Prepare(
+      "API_SAMPLE_NB", "nb", 4,
+      {"nodes", "edge_types", "count", "default_node"}, {});
+  runner->Run("query/API_SAMPLE_NB/512x10", kBatchSize,
+              [proxy, &ids, &sample] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      Query query(sample);
+      AllocInputs(ids, i * kBatchSize, &query);
+      auto results = proxy->RunGremlin(&query, {"nb:1"});
+      DoNotOptimize(results["nb:1"]);
+    }
+  });
+
+  PreparedQuery get_feature = proxy->Prepare(
+      "API_GET_P", "feature", 2, {"nodes", "fid"}, {});
+  runner->Run("query/API_GET_P/512x32", kBatchSize,
+              [proxy, &ids, &get_feature] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      Query query(get_feature);
+      AllocInputs(ids, i * kBatchSize, &query);
+      Tensor* fid = query.AllocInput("fid", {1}, kString);
+      *(fid->Raw<std::string*>()[0]) = kDenseFeature;
+      auto results = proxy->RunGremlin(&query, {"feature:1"});
+      DoNotOptimize(results["feature:1"]);
+    }
+  });
+
+  // node2vec walks of kNeighborCount steps, p = 0.5 and q = 2
+  PreparedQuery walk = proxy->Prepare(
+      "API_RANDOM_WALK", "rw", 2,
+      {"walks", "edge_types", "edge_type_nums", "pq"}, {});
+  runner->Run("query/API_RANDOM_WALK/512x10", kBatchSize * kNeighborCount,
+              [proxy, &ids, &walk] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      Query query(walk);
+      Tensor* walks = query.AllocInput("walks", {kBatchSize, 3}, kUInt64);
+      auto data = walks->Raw<uint64_t>();
+      for (int j = 0; j < kBatchSize; ++j) {
+        data[j * 3] = ids[(i * kBatchSize + j) % ids.size()];
+        data[j * 3 + 1] = 0;
+        data[j * 3 + 2] = 0;
+      }
+      Tensor* edge_types = query.AllocInput(
+          "edge_types", {kNeighborCount * 2}, kInt32);
+      Tensor* edge_type_nums = query.AllocInput(
+          "edge_type_nums", {kNeighborCount}, kInt32);
+      for (int j = 0; j < kNeighborCount; ++j) {
+        edge_types->Raw<int32_t>()[j * 2] = 0;
+        edge_types->Raw<int32_t>()[j * 2 + 1] = 1;
+        edge_type_nums->Raw<int32_t>()[j] = 2;
+      }
+      Tensor* pq = query.AllocInput("pq", {2}, kFloat);
+      pq->Raw<float>()[0] = 0.5;
+      pq->Raw<float>()[1] = 2;
+      auto results = proxy->RunGremlin(&query, {"rw:0"});
+      DoNotOptimize(results["rw:0"]);
+    }
+  });
+
+  if (!gremlin) {
+    return;
+  }
+  PreparedQuery sample_feature = proxy->Prepare(
+      "v(nodes).sampleNB(edge_types, count, 0).as(nb)"
+      ".values(fid).as(feature)");
+  runner->Run("query/sampleNB.values/512x10", kBatchSize,
+              [proxy, &ids, &sample_feature] (int64_t iterations) {
+    for (int64_t i = 0; i < iterations; ++i) {
+      Query query(sample_feature);
+      AllocInputs(ids, i * kBatchSize, &query);
+      Tensor* fid = query.AllocInput("fid", {1}, kString);
+      *(fid->Raw<std::string*>()[0]) = kDenseFeature;
+      auto results = proxy->RunGremlin(&query, {"feature:1"});
+      DoNotOptimize(results["feature:1"]);
+    }
+  });
+}
+
+int Main(int argc, char** argv) {
+  Flags flags(argc, argv);
+  std::string data_path = flags.Get("data_path", "/tmp/euler_benchmark");
+  bool gremlin = flags.Get("gremlin", 1.0) != 0;
+
+  GraphGeneratorOptions options;
+  options.node_num = flags.Get("nodes", 100000.0);
+  options.partition_num = flags.Get("partitions", 1.0);
+  options.avg_degree = flags.Get("degree", 16.0);
+  options.degree_skew = flags.Get("skew", 1.0);
+  options.dense_feature_dim = flags.Get("dense_dim", 32.0);
+  options.seed = flags.Get("seed", 0.0);
+  if (flags.Get("generate", 1.0) != 0) {
+    Status s = GenerateGraph(options, data_path);
+    if (!s.ok()) {
+      EULER_LOG(ERROR) << "Generate graph failed: " << s;
+      return 1;
+    }
+  }
+
+  GraphConfig config;
+  config.Add("mode", "local");
+  config.Add("data_path", data_path);
+  config.Add("sampler_type", "all");
+  config.Add("data_type", "all");
+  config.Add("storage_type", flags.Get("storage", "node"));
+  config.Add("dense_feature_columns",
+             static_cast<int>(flags.Get("dense_columns", 1.0)));
+  config.Add("dense_feature_quantization",
+             flags.Get("quantization", "none"));
+  if (!QueryProxy::Init(config)) {
+    return 1;
+  }
+
+  // Nodes drawn uniformly, the hubs are still met as the neighbors
+  std::vector<uint64_t> ids(4096);
+  std::mt19937_64 rng(options.seed);
+  std::uniform_int_distribution<uint64_t> id_dist(
+      1, Graph::Instance().getNodeSize());
+  for (auto& id : ids) {
+    id = id_dist(rng);
+  }
+
+  BenchmarkRunner runner(flags.Get("min_time", 0.5),
+                         flags.Get("filter", ""));
+  BenchmarkGraph(ids, &runner);
+  BenchmarkDenseFeature(ids, &runner);
+  BenchmarkQuantization(ids, &runner);
+  BenchmarkCommon(&runner);
+  BenchmarkTensor(&runner);
+  BenchmarkCompiler(gremlin, &runner);
+  BenchmarkQuery(ids, gremlin, &runner);
+
+  std::string output = flags.Get("output", "");
+  std::string json = runner.ToJson();
+  if (output.empty()) {
+    fputs(json.c_str(), stdout);
+  } else {
+    FILE* file = fopen(output.c_str(), "w");
+    if (file == nullptr) {
+      EULER_LOG(ERROR) << "Open " << output << " failed";
+      return 1;
+    }
+    fputs(json.c_str(), file);
+    fclose(file);
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace euler
+
+int main(int argc, char** argv) {
+  return euler::Main(argc, argv);
+}
@@ -0,0 +1,315 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/benchmarks/graph_generator.h"
+
+#include <errno.h>
+#include <math.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "euler/common/bytes_io.h"
+#include "euler/common/env.h"
+#include "euler/common/file_io.h"
+#include "euler/common/logging.h"
+#include "euler/common/str_util.h"
+#include "euler/core/graph/graph_meta.h"
+
+namespace euler {
+
+const char* kSparseFeature = "sparse";
+const char* kDenseFeature = "dense";
+const char* kBinaryFeature = "binary";
+
+namespace {
+
+struct GenEdge {
+  uint64_t src;
+  uint64_t dst;
+  int32_t type;
+  float weight;
+};
+
+// Edges grouped by a vertex, edges of vertex i are in
+// [offsets[i], offsets[i + 1])
+struct AdjacencyList {
+  std::vector<size_t> offsets;
+  std::vector<GenEdge> edges;
+};
+
+Status MakeDirectory(const std::string& path) {
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    return Status::Internal("Create directory ", path, " failed");
+  }
+  return Status::OK();
+}
+
+// Zipf weights of the ranks, assigned to the nodes in a random order so the
+// hubs are spread over the id space and the partitions
+std::vector<double> PowerLawWeights(int64_t n, double skew,
+                                    std::mt19937_64* rng) {
+  std::vector<double> weights(n);
+  for (int64_t i = 0; i < n; ++i) {
+    weights[i] = pow(static_cast<double>(i + 1), -skew);
+  }
+  std::shuffle(weights.begin(), weights.end(), *rng);
+  return weights;
+}
+
+// Build the adjacency list by key, sorted by (key, type, other end)
+AdjacencyList BuildAdjacency(const std::vector<GenEdge>& edges, int64_t n,
+                             bool by_src) {
+  AdjacencyList adj;
+  adj.offsets.assign(n + 2, 0);
+  auto key = [by_src] (const GenEdge& e) { return by_src ? e.src : e.dst; };
+  auto other = [by_src] (const GenEdge& e) { return by_src ? e.dst : e.src; };
+  for (auto& e : edges) {
+    ++adj.offsets[key(e) + 1];
+  }
+  std::partial_sum(adj.offsets.begin(), adj.offsets.end(),
+                   adj.offsets.begin());
+  adj.edges.resize(edges.size());
+  std::vector<size_t> cursor(adj.offsets.begin(), adj.offsets.end() - 1);
+  for (auto& e : edges) {
+    adj.edges[cursor[key(e)]++] = e;
+  }
+  for (int64_t i = 0; i <= n; ++i) {
+    std::sort(adj.edges.begin() + adj.offsets[i],
+              adj.edges.begin() + adj.offsets[i + 1],
+              [&other] (const GenEdge& a, const GenEdge& b) {
+                return a.type != b.type ? a.type < b.type :
+                    other(a) < other(b);
+              });
+  }
+  return adj;
+}
+
+void WriteNeighbors(const AdjacencyList& adj, uint64_t id, bool by_src,
+                    int32_t edge_type_num, BytesWriter* writer) {
+  std::vector<int32_t> group_ids(edge_type_num);
+  std::vector<float> group_weights(edge_type_num, 0);
+  std::vector<int32_t> groups_idx(edge_type_num, 0);
+  std::vector<uint64_t> neighbors;
+  std::vector<float> weights;
+  float sum_weight = 0;
+  for (size_t i = adj.offsets[id]; i < adj.offsets[id + 1]; ++i) {
+    const GenEdge& e = adj.edges[i];
+    neighbors.push_back(by_src ? e.dst : e.src);
+    sum_weight += e.weight;
+    weights.push_back(sum_weight);
+    group_weights[e.type] += e.weight;
+    ++groups_idx[e.type];
+  }
+  for (int32_t i = 0; i < edge_type_num; ++i) {
+    group_ids[i] = i;
+    if (i > 0) {
+      groups_idx[i] += groups_idx[i - 1];
+    }
+  }
+  writer->Write(group_ids);
+  writer->Write(group_weights);
+  writer->Write(groups_idx);
+  writer->Write(neighbors);
+  writer->Write(weights);
+}
+
+template <class T>
+void WriteFeature(const std::vector<T>& values, BytesWriter* writer) {
+  std::vector<int32_t> idx;
+  if (!values.empty()) {
+    idx.push_back(values.size());
+  }
+  writer->Write(idx);
+  writer->Write(values);
+}
+
+class PartitionWriter {
+ public:
+  PartitionWriter(const std::string& dir, int32_t partition_num)
+      : dir_(dir), files_(partition_num) { }
+
+  Status Append(uint64_t id, const std::string& record) {
+    auto& file = files_[id % files_.size()];
+    if (file == nullptr) {
+      auto path = JoinPath(dir_, ToString("part_", id % files_.size(),
+                                          ".dat"));
+      RETURN_IF_ERROR(Env::Default()->NewFileIO(path, false, &file));
+    }
+    if (!file->Append(record)) {
+      return Status::Internal("Write ", dir_, " failed");
+    }
+    return Status::OK();
+  }
+
+ private:
+  std::string dir_;
+  std::vector<std::unique_ptr<FileIO>> files_;
+};
+
+}  // namespace
+
+Status GenerateGraph(const GraphGeneratorOptions& options,
+                     const std::string& path) {
+  const int64_t n = options.node_num;
+  if (n <= 0 || options.partition_num <= 0 || options.node_type_num <= 0 ||
+      options.edge_type_num <= 0 || options.avg_degree < 0) {
+    return Status::InvalidArgument("Invalid graph generator options");
+  }
+
+  std::mt19937_64 rng(options.seed);
+  std::vector<double> out_weights =
+      PowerLawWeights(n, options.degree_skew, &rng);
+  std::vector<double> in_weights =
+      PowerLawWeights(n, options.degree_skew, &rng);
+  double sum_out_weight = std::accumulate(out_weights.begin(),
+                                          out_weights.end(), 0.0);
+  std::discrete_distribution<int64_t> dst_dist(in_weights.begin(),
+                                               in_weights.end());
+  std::uniform_int_distribution<int32_t> edge_type_dist(
+      0, options.edge_type_num - 1);
+  std::uniform_real_distribution<float> weight_dist(0.1, 1.0);
+
+  // Node i + 1 gets its share of the edges by its out weight
+  std::vector<GenEdge> edges;
+  edges.reserve(static_cast<size_t>(n * options.avg_degree));
+  double total_edges = n * options.avg_degree;
+  for (int64_t i = 0; i < n; ++i) {
+    int64_t degree = std::min<int64_t>(
+        n, llround(total_edges * out_weights[i] / sum_out_weight));
+    for (int64_t j = 0; j < degree; ++j) {
+      int64_t dst = dst_dist(rng);
+      edges.push_back({static_cast<uint64_t>(i + 1),
+                       static_cast<uint64_t>(dst + 1),
+                       edge_type_dist(rng), weight_dist(rng)});
+    }
+  }
+
+  // Drop the duplicated edges
+  std::sort(edges.begin(), edges.end(),
+            [] (const GenEdge& a, const GenEdge& b) {
+              return std::tie(a.src, a.type, a.dst) <
+                  std::tie(b.src, b.type, b.dst);
+            });
+  auto end = std::unique(edges.begin(), edges.end(),
+                         [] (const GenEdge& a, const GenEdge& b) {
+                           return a.src == b.src && a.dst == b.dst &&
+                               a.type == b.type;
+                         });
+  edges.erase(end, edges.end());
+  AdjacencyList out_adj = BuildAdjacency(edges, n, true);
+  AdjacencyList in_adj = BuildAdjacency(edges, n, false);
+
+  std::string node_dir = JoinPath(path, "Node");
+  std::string edge_dir = JoinPath(path, "Edge");
+  RETURN_IF_ERROR(MakeDirectory(path));
+  RETURN_IF_ERROR(MakeDirectory(node_dir));
+  RETURN_IF_ERROR(MakeDirectory(edge_dir));
+
+  std::uniform_int_distribution<int32_t> node_type_dist(
+      0, options.node_type_num - 1);
+  std::uniform_int_distribution<uint64_t> sparse_dist(0, 1000000);
+  std::uniform_real_distribution<float> dense_dist(-1.0, 1.0);
+  std::uniform_int_distribution<int> binary_dist('a', 'z');
+  PartitionWriter node_writer(node_dir, options.partition_num);
+  for (int64_t i = 1; i <= n; ++i) {
+    BytesWriter writer;
+    writer.Write(static_cast<uint64_t>(i));
+    writer.Write(node_type_dist(rng));
+    writer.Write(1.0f);
+    WriteNeighbors(out_adj, i, true, options.edge_type_num, &writer);
+    WriteNeighbors(in_adj, i, false, options.edge_type_num, &writer);
+
+    std::vector<uint64_t> sparse(options.sparse_feature_len);
+    for (auto& value : sparse) {
+      value = sparse_dist(rng);
+    }
+    std::vector<float> dense(options.dense_feature_dim);
+    for (auto& value : dense) {
+      value = dense_dist(rng);
+    }
+    std::string binary(options.binary_feature_len, ' ');
+    for (auto& c : binary) {
+      c = static_cast<char>(binary_dist(rng));
+    }
+    WriteFeature(sparse, &writer);
+    WriteFeature(dense, &writer);
+    std::vector<int32_t> binary_idx;
+    if (!binary.empty()) {
+      binary_idx.push_back(binary.size());
+    }
+    writer.Write(binary_idx);
+    writer.Write(binary);
+    RETURN_IF_ERROR(node_writer.Append(i, writer.data()));
+  }
+
+  PartitionWriter edge_writer(edge_dir, options.partition_num);
+  for (auto& e : edges) {
+    BytesWriter writer;
+    writer.Write(e.src);
+    writer.Write(e.dst);
+    writer.Write(e.type);
+    writer.Write(e.weight);
+    for (int i = 0; i < 3; ++i) {  // No uint64, float or binary feature
+      writer.Write(std::vector<int32_t>());
+      writer.Write(std::vector<int32_t>());
+    }
+    RETURN_IF_ERROR(edge_writer.Append(e.src, writer.data()));
+  }
+
+  FeatureInfoMap node_features, edge_features;
+  if (options.sparse_feature_len > 0) {
+    node_features[kSparseFeature] =
+        FeatureInfo(kSparse, 0, options.sparse_feature_len);
+  }
+  if (options.dense_feature_dim > 0) {
+    node_features[kDenseFeature] =
+        FeatureInfo(kDense, 0, options.dense_feature_dim);
+  }
+  if (options.binary_feature_len > 0) {
+    node_features[kBinaryFeature] =
+        FeatureInfo(kBinary, 0, options.binary_feature_len);
+  }
+  std::unordered_map<std::string, uint32_t> node_types, edge_types;
+  for (int32_t i = 0; i < options.node_type_num; ++i) {
+    node_types[std::to_string(i)] = i;
+  }
+  for (int32_t i = 0; i < options.edge_type_num; ++i) {
+    edge_types[std::to_string(i)] = i;
+  }
+  GraphMeta meta("euler_benchmark", "1", n, edges.size(),
+                 options.partition_num, node_features, edge_features,
+                 node_types, edge_types);
+  std::string meta_data;
+  meta.Serialize(&meta_data);
+  std::unique_ptr<FileIO> meta_file;
+  RETURN_IF_ERROR(Env::Default()->NewFileIO(JoinPath(path, "euler.meta"),
+                                            false, &meta_file));
+  if (!meta_file->WriteData(meta_data.data(), meta_data.size())) {
+    return Status::Internal("Write meta failed");
+  }
+
+  EULER_LOG(INFO) << "Generated graph " << path << ", nodes: " << n
+                  << ", edges: " << edges.size();
+  return Status::OK();
+}
+
+}  // namespace euler
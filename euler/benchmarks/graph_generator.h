@@ -0,0 +1,71 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_BENCHMARKS_GRAPH_GENERATOR_H_
+#define EULER_BENCHMARKS_GRAPH_GENERATOR_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "euler/common/status.h"
+
+namespace euler {
+
+// Names of the features written by the generator
+extern const char* kSparseFeature;
+extern const char* kDenseFeature;
+extern const char* kBinaryFeature;
+
+struct GraphGeneratorOptions {
+  GraphGeneratorOptions()
+      : node_num(100000),
+        partition_num(1),
+        node_type_num(2),
+        edge_type_num(2),
+        avg_degree(16),
+        degree_skew(1.0),
+        sparse_feature_len(8),
+        dense_feature_dim(32),
+        binary_feature_len(16),
+        seed(0) { }
+
+  // Node ids are 1 to node_num
+  int64_t node_num;
+  // Node i is written to partition i % partition_num
+  int32_t partition_num;
+  int32_t node_type_num;
+  int32_t edge_type_num;
+  double avg_degree;
+  // The out and in degrees follow Zipf's law with this exponent over the
+  // node ranks, 0 for uniform degrees. Real graphs are around 0.5 to 1.2.
+  double degree_skew;
+  // Widths of the kSparseFeature, kDenseFeature and kBinaryFeature node
+  // features, 0 to skip the feature
+  int32_t sparse_feature_len;
+  int32_t dense_feature_dim;
+  int32_t binary_feature_len;
+  uint64_t seed;
+};
+
+// Write a synthetic power-law graph to the local directory path, in the
+// layout loaded by Graph::Init: Node/part_<i>.dat, Edge/part_<i>.dat and
+// euler.meta. The directories are created if missing.
+Status GenerateGraph(const GraphGeneratorOptions& options,
+                     const std::string& path);
+
+}  // namespace euler
+
+#endif  // EULER_BENCHMARKS_GRAPH_GENERATOR_H_
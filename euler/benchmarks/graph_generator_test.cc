@@ -0,0 +1,110 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/benchmarks/graph_generator.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "euler/core/graph/graph.h"
+
+namespace euler {
+
+TEST(GraphGeneratorTest, Generate) {
+  std::string path = "/tmp/euler_graph_generator_test";
+  GraphGeneratorOptions options;
+  options.node_num = 2000;
+  options.partition_num = 2;
+  options.avg_degree = 8;
+  options.degree_skew = 1.0;
+  options.dense_feature_dim = 4;
+  ASSERT_TRUE(GenerateGraph(options, path).ok());
+
+  Graph graph;
+  ASSERT_TRUE(graph.Init(0, 1, "all", path, "all").ok());
+  ASSERT_EQ(2000, graph.getNodeSize());
+  ASSERT_EQ(static_cast<uint64_t>(graph.getEdgeSize()),
+            graph.graph_meta().GetEdgeCount());
+  ASSERT_EQ(4, graph.graph_meta().GetFeatureDim(kDenseFeature));
+
+  // The degrees are skewed, and the edges are in both the out and in lists
+  std::vector<int32_t> edge_types = {0, 1};
+  size_t max_degree = 0;
+  size_t out_edges = 0;
+  size_t in_edges = 0;
+  for (uint64_t id = 1; id <= 2000; ++id) {
+    Node* node = graph.GetNodeByID(id);
+    ASSERT_NE(nullptr, node);
+    size_t degree = node->GetFullNeighbor(edge_types).size();
+    max_degree = std::max(max_degree, degree);
+    out_edges += degree;
+    in_edges += node->GetFullInNeighbor(edge_types).size();
+
+    std::vector<uint32_t> nums;
+    std::vector<float> values;
+    node->GetFloat32Feature({0}, &nums, &values);
+    ASSERT_EQ(4, values.size());
+  }
+  ASSERT_EQ(out_edges, in_edges);
+  ASSERT_EQ(out_edges, static_cast<size_t>(graph.getEdgeSize()));
+  ASSERT_GT(max_degree, 10 * out_edges / 2000);
+
+  // Only the partitions of the shard are loaded
+  Graph shard;
+  ASSERT_TRUE(shard.Init(1, 2, "all", path, "node").ok());
+  ASSERT_EQ(1000, shard.getNodeSize());
+  ASSERT_EQ(nullptr, shard.GetNodeByID(2));
+  ASSERT_NE(nullptr, shard.GetNodeByID(3));
+
+  // The quantized features are read back through the graph, fp16 with the
+  // node store and int8 with the compact store
+  for (auto quantization : {kFp16Quantization, kInt8Quantization}) {
+    Graph quantized;
+    GraphLoadOptions load_options;
+    load_options.dense_feature_quantization = quantization;
+    quantized.set_load_options(load_options);
+    std::string storage =
+        quantization == kFp16Quantization ? "node" : "compact";
+    ASSERT_TRUE(quantized.Init(0, 1, "all", path, "node", storage).ok());
+    FeatureQuantizationInfo info =
+        quantized.graph_meta().GetFeatureQuantization(kDenseFeature);
+    ASSERT_EQ(quantization, info.type);
+    for (uint64_t id = 1; id <= 2000; id += 7) {
+      std::vector<std::vector<float>> expected, values;
+      ASSERT_TRUE(graph.GetFloat32Feature(id, {0}, &expected));
+      // The unknown fids get empty values around the quantized one
+      ASSERT_TRUE(quantized.GetFloat32Feature(id, {-1, 0, 7}, &values));
+      ASSERT_EQ(3, values.size());
+      ASSERT_TRUE(values[0].empty());
+      ASSERT_TRUE(values[2].empty());
+      ASSERT_EQ(4, values[1].size());
+      for (size_t j = 0; j < 4; ++j) {
+        float error = quantization == kFp16Quantization ?
+            1e-3 * std::abs(expected[0][j]) : info.scale / 2 + 1e-6;
+        ASSERT_NEAR(expected[0][j], values[1][j], error);
+      }
+    }
+  }
+
+  ASSERT_EQ(0, system(("rm -rf " + path).c_str()));
+}
+
+}  // namespace euler
@@ -73,6 +73,23 @@ bool ClientManager::RetrieveShardMeta(
   return true;
 }
 
+bool ClientManager::RetrieveShardMeta(
+    int32_t shard_index, const std::string& key, IdRangeSet* ranges) {
+  std::string value;
+  if (!server_monitor_->GetShardMeta(shard_index, key, &value)) {
+    EULER_LOG(ERROR) << "Retrieve shard meta failed, key: " << key
+                     << " shard index: " << shard_index;
+    return false;
+  }
+
+  if (!ranges->FromString(value)) {
+    EULER_LOG(ERROR) << "Invalid id ranges meta, shard: " << shard_index
+                     << " key: " << key;
+    return false;
+  }
+  return true;
+}
+
 bool ClientManager::RetrieveMeta(
     const std::string& key, std::string* value) {
   if (!server_monitor_->GetMeta(key, value)) {
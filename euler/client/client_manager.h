@@ -22,8 +22,10 @@ limitations under the License.
 #include <utility>
 #include <unordered_set>
 
+#include "euler/common/id_range_set.h"
 #include "euler/common/logging.h"
 #include "euler/common/server_monitor.h"
+#include "euler/client/hot_vertex_cache.h"
 #include "euler/client/rpc_client.h"
 #include "euler/core/graph/graph_meta.h"
 
@@ -62,10 +64,18 @@ class ClientManager {
   bool RetrieveShardMeta(int32_t shard_index, const std::string& key,
                          std::vector<std::vector<float>>* weights);
 
+  bool RetrieveShardMeta(int32_t shard_index, const std::string& key,
+                         IdRangeSet* ranges);
+
   bool RetrieveMeta(const std::string& key, std::string* value);
 
   const GraphMeta& graph_meta() const { return meta_; }
 
+  // The cache of the per node results, nullptr if disabled
+  HotVertexCache* hot_vertex_cache() const {
+    return hot_vertex_cache_.get();
+  }
+
  private:
   explicit ClientManager(const GraphConfig& config) {
     std::string zk_server, zk_path;
@@ -85,6 +95,13 @@ class ClientManager {
             std::move(NewRpcClient(server_monitor_, i, config)));
       }
       EULER_LOG(INFO) << "shard number: " << shard_number;
+
+      int cache_mb = 0;
+      if (config.Get("hot_vertex_cache_mb", &cache_mb) && cache_mb > 0) {
+        hot_vertex_cache_.reset(
+            new HotVertexCache(static_cast<size_t>(cache_mb) << 20));
+        EULER_LOG(INFO) << "hot vertex cache: " << cache_mb << "MB";
+      }
       init_succ_ = true;
     }
   }
@@ -100,6 +117,8 @@ class ClientManager {
   std::vector<std::shared_ptr<RpcClient>> clients_;
 
   GraphMeta meta_;
+
+  std::unique_ptr<HotVertexCache> hot_vertex_cache_;
 };
 
 }  // namespace euler
@@ -478,6 +478,31 @@ TEST(End2EndLocalTest, Execute) {
       ASSERT_EQ(expect_data[i], results_map["graphs:1"]->Raw<uint64_t>()[i]);
     }
   }
+
+  {
+    // A seeded query draws the same samples when run again
+    auto run = [proxy] (uint64_t seed) {
+      Query query("API_SAMPLE_NB", "nb", 4,
+                  {"nodes", "edge_types", "count", "default_node"}, {});
+      query.SetSeed(seed);
+      Tensor* nodes_t = query.AllocInput("nodes", {600}, kUInt64);
+      Tensor* edge_types_t = query.AllocInput("edge_types", {2}, kInt32);
+      Tensor* count_t = query.AllocInput("count", {1}, kInt32);
+      for (int32_t i = 0; i < 600; ++i) {
+        nodes_t->Raw<uint64_t>()[i] = i % 6 + 1;
+      }
+      GetEdgeType("0", &edge_types_t->Raw<int32_t>()[0]);
+      GetEdgeType("1", &edge_types_t->Raw<int32_t>()[1]);
+      count_t->Raw<int32_t>()[0] = 10;
+      Tensor* t = proxy->RunGremlin(&query, {"nb:1"})["nb:1"];
+      return std::vector<uint64_t>(t->Raw<uint64_t>(),
+                                   t->Raw<uint64_t>() + t->NumElements());
+    };
+    std::vector<uint64_t> samples = run(7);
+    ASSERT_EQ(6000, samples.size());
+    ASSERT_EQ(samples, run(7));
+    ASSERT_NE(samples, run(8));
+  }
 }
 
 }  // namespace euler
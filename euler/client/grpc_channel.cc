@@ -19,6 +19,8 @@ limitations under the License.
 
 #include "grpcpp/impl/codegen/proto_utils.h"
 #include "euler/client/completion_queue_pool.h"
+#include "euler/common/logging.h"
+#include "euler/proto/tensor_message.h"
 
 namespace euler {
 
@@ -35,6 +37,12 @@ class GrpcClosure final : public GrpcCQTag {
     } else if (!ctx_->status.ok()) {
       status = Status(ErrorCode::RPC_ERROR,
                       "gRpc error: " + ctx_->status.error_message());
+    } else if (ctx_->tensor_response != nullptr) {
+      Status s = ctx_->tensor_response->Decode(ctx_->response_buf);
+      if (!s.ok()) {
+        status = Status(ErrorCode::PROTO_ERROR,
+                        "Bad response: " + s.error_message());
+      }
     } else {
       grpc::ProtoBufferReader reader(&ctx_->response_buf);
       if (!ctx_->response->ParseFromZeroCopyStream(&reader)) {
@@ -59,6 +67,14 @@ bool GrpcContext::Initialize(const google::protobuf::Message &request) {
   return s.ok();
 }
 
+bool GrpcContext::Initialize(const TensorMessage &request) {
+  Status s = request.Encode(&request_buf);
+  if (!s.ok()) {
+    EULER_LOG(ERROR) << "Encode request failed: " << s;
+  }
+  return s.ok();
+}
+
 GrpcChannel::GrpcChannel(const std::string &host_port,
                          std::shared_ptr<grpc::Channel> raw_channel)
     : RpcChannel(host_port),
@@ -31,7 +31,8 @@ struct GrpcContext: public RpcContext {
               std::function<void(const Status &)> done)
       : RpcContext(method, respone, done) { }
 
-  bool Initialize(const google::protobuf::Message &request);
+  bool Initialize(const google::protobuf::Message &request) override;
+  bool Initialize(const TensorMessage &request) override;
 
   grpc::ByteBuffer request_buf;
   grpc::ByteBuffer response_buf;
@@ -0,0 +1,187 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/client/hot_vertex_cache.h"
+
+#include <algorithm>
+
+namespace euler {
+
+namespace {
+
+const int kSketchDepth = 4;
+const uint8_t kMaxFrequency = 15;
+
+// The size of an entry assumed when sizing the sketch of a shard
+const size_t kAverageEntryBytes = 256;
+
+// The list node, the hash node and the string header of an entry
+const size_t kEntryOverhead = 96;
+
+const uint64_t kSketchSeeds[kSketchDepth] = {
+    0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+    0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+
+inline uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+}  // namespace
+
+FrequencySketch::FrequencySketch(size_t num_entries)
+    : additions_(0) {
+  size_t width = 64;
+  while (width < num_entries) {
+    width <<= 1;
+  }
+  table_.resize(width * kSketchDepth, 0);
+  mask_ = width - 1;
+  sample_size_ = width * 10;
+}
+
+size_t FrequencySketch::Index(uint64_t hash, int row) const {
+  return row * (mask_ + 1) + (Mix(hash + kSketchSeeds[row]) & mask_);
+}
+
+void FrequencySketch::Increment(uint64_t hash) {
+  bool added = false;
+  for (int i = 0; i < kSketchDepth; ++i) {
+    uint8_t& counter = table_[Index(hash, i)];
+    if (counter < kMaxFrequency) {
+      ++counter;
+      added = true;
+    }
+  }
+  if (added && ++additions_ >= sample_size_) {
+    Age();
+  }
+}
+
+int FrequencySketch::Estimate(uint64_t hash) const {
+  int frequency = kMaxFrequency;
+  for (int i = 0; i < kSketchDepth; ++i) {
+    frequency = std::min(frequency, static_cast<int>(table_[Index(hash, i)]));
+  }
+  return frequency;
+}
+
+void FrequencySketch::Age() {
+  for (auto& counter : table_) {
+    counter >>= 1;
+  }
+  additions_ /= 2;
+}
+
+const int HotVertexCache::kDefaultNumShards;
+
+size_t HotVertexCache::KeyHash::operator()(const Key& key) const {
+  return Mix(key.id ^ Mix(key.signature));
+}
+
+HotVertexCache::Shard::Shard(size_t capacity_bytes)
+    : capacity(capacity_bytes), charge(0),
+      sketch(capacity_bytes / kAverageEntryBytes) {
+}
+
+HotVertexCache::HotVertexCache(size_t capacity_bytes, int num_shards)
+    : hits_(0), misses_(0), rejections_(0) {
+  num_shards = std::max(num_shards, 1);
+  for (int i = 0; i < num_shards; ++i) {
+    shards_.emplace_back(new Shard(capacity_bytes / num_shards));
+  }
+}
+
+bool HotVertexCache::Lookup(uint64_t signature, uint64_t id, Value* value) {
+  Key key = {signature, id};
+  size_t hash = KeyHash()(key);
+  Shard* shard = GetShard(hash);
+  {
+    MutexLock l(&shard->mu);
+    shard->sketch.Increment(hash);
+    auto it = shard->entries.find(key);
+    if (it != shard->entries.end()) {
+      shard->lru.splice(shard->lru.begin(), shard->lru, it->second);
+      *value = it->second->value;
+      ++hits_;
+      return true;
+    }
+  }
+  ++misses_;
+  return false;
+}
+
+bool HotVertexCache::Insert(uint64_t signature, uint64_t id, Value value) {
+  Key key = {signature, id};
+  size_t hash = KeyHash()(key);
+  size_t charge = value->size() + kEntryOverhead;
+  Shard* shard = GetShard(hash);
+  MutexLock l(&shard->mu);
+  if (shard->entries.find(key) != shard->entries.end()) {
+    return true;
+  }
+  if (charge > shard->capacity) {
+    ++rejections_;
+    return false;
+  }
+
+  // Admit the new entry only if it is hotter than all the victims
+  int frequency = shard->sketch.Estimate(hash);
+  size_t freed = 0;
+  size_t num_victims = 0;
+  for (auto it = shard->lru.rbegin();
+       shard->charge - freed + charge > shard->capacity; ++it) {
+    if (shard->sketch.Estimate(KeyHash()(it->key)) >= frequency) {
+      ++rejections_;
+      return false;
+    }
+    freed += it->charge;
+    ++num_victims;
+  }
+  for (size_t i = 0; i < num_victims; ++i) {
+    shard->entries.erase(shard->lru.back().key);
+    shard->lru.pop_back();
+  }
+  shard->charge -= freed;
+
+  shard->lru.push_front({key, std::move(value), charge});
+  shard->entries[key] = shard->lru.begin();
+  shard->charge += charge;
+  return true;
+}
+
+size_t HotVertexCache::size() {
+  size_t size = 0;
+  for (auto& shard : shards_) {
+    MutexLock l(&shard->mu);
+    size += shard->entries.size();
+  }
+  return size;
+}
+
+size_t HotVertexCache::charge() {
+  size_t charge = 0;
+  for (auto& shard : shards_) {
+    MutexLock l(&shard->mu);
+    charge += shard->charge;
+  }
+  return charge;
+}
+
+}  // namespace euler
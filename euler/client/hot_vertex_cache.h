@@ -0,0 +1,130 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CLIENT_HOT_VERTEX_CACHE_H_
+#define EULER_CLIENT_HOT_VERTEX_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "euler/common/mutex.h"
+
+namespace euler {
+
+// Count-min sketch of the recent access frequencies, the counters saturate
+// at 15 and are halved periodically so that the old accesses fade out.
+class FrequencySketch {
+ public:
+  // Sized for about num_entries distinct keys
+  explicit FrequencySketch(size_t num_entries);
+
+  void Increment(uint64_t hash);
+
+  int Estimate(uint64_t hash) const;
+
+ private:
+  size_t Index(uint64_t hash, int row) const;
+
+  void Age();
+
+  std::vector<uint8_t> table_;
+  size_t mask_;
+  size_t additions_;
+  size_t sample_size_;
+};
+
+// A bounded cache of the per node results of the immutable graph, e.g. the
+// full neighbors and the features of a node, indexed by the signature of
+// the query and the node id. The cache is split into shards, each is a LRU
+// list guarded by its own mutex. A new entry is admitted only if it is
+// accessed more often than the entries it evicts (TinyLFU), so the cold
+// ids of a scan never flush the hot ones out.
+class HotVertexCache {
+ public:
+  typedef std::shared_ptr<const std::string> Value;
+
+  static const int kDefaultNumShards = 16;
+
+  explicit HotVertexCache(size_t capacity_bytes,
+                          int num_shards = kDefaultNumShards);
+
+  // Record an access of the id, return false if it is not cached
+  bool Lookup(uint64_t signature, uint64_t id, Value* value);
+
+  // Return false if the value is not admitted
+  bool Insert(uint64_t signature, uint64_t id, Value value);
+
+  uint64_t hits() const { return hits_; }
+
+  uint64_t misses() const { return misses_; }
+
+  uint64_t rejections() const { return rejections_; }
+
+  size_t size();
+
+  // Bytes used, including the bookkeeping of the entries
+  size_t charge();
+
+ private:
+  struct Key {
+    uint64_t signature;
+    uint64_t id;
+
+    bool operator==(const Key& other) const {
+      return signature == other.signature && id == other.id;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    Value value;
+    size_t charge;
+  };
+
+  struct Shard {
+    explicit Shard(size_t capacity_bytes);
+
+    Mutex mu;
+    const size_t capacity;
+    size_t charge;                        // Guard by mu
+    FrequencySketch sketch;               // Guard by mu
+    std::list<Entry> lru;                 // Most recent first, guard by mu
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+  };
+
+  Shard* GetShard(size_t hash) {
+    return shards_[(hash >> 32) % shards_.size()].get();
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+  std::atomic<uint64_t> rejections_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_CLIENT_HOT_VERTEX_CACHE_H_
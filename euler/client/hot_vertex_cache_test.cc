@@ -0,0 +1,83 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/client/hot_vertex_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace euler {
+
+TEST(FrequencySketchTest, Estimate) {
+  FrequencySketch sketch(1024);
+  for (int i = 0; i < 5; ++i) {
+    sketch.Increment(1);
+  }
+  sketch.Increment(2);
+  ASSERT_EQ(5, sketch.Estimate(1));
+  ASSERT_EQ(1, sketch.Estimate(2));
+  ASSERT_EQ(0, sketch.Estimate(3));
+
+  // Saturated
+  for (int i = 0; i < 20; ++i) {
+    sketch.Increment(1);
+  }
+  ASSERT_EQ(15, sketch.Estimate(1));
+}
+
+TEST(HotVertexCacheTest, LookupAndInsert) {
+  HotVertexCache cache(1 << 20);
+  HotVertexCache::Value value;
+  ASSERT_FALSE(cache.Lookup(1, 100, &value));
+  ASSERT_TRUE(cache.Insert(1, 100, std::make_shared<std::string>("abc")));
+  ASSERT_TRUE(cache.Lookup(1, 100, &value));
+  ASSERT_EQ("abc", *value);
+
+  // Another signature
+  ASSERT_FALSE(cache.Lookup(2, 100, &value));
+  ASSERT_EQ(1, cache.hits());
+  ASSERT_EQ(2, cache.misses());
+  ASSERT_EQ(1, cache.size());
+}
+
+TEST(HotVertexCacheTest, Admission) {
+  // Room for one entry only
+  HotVertexCache cache(300, 1);
+  auto value = std::make_shared<std::string>(100, 'a');
+  HotVertexCache::Value result;
+  for (int i = 0; i < 3; ++i) {
+    cache.Lookup(0, 1, &result);
+  }
+  ASSERT_TRUE(cache.Insert(0, 1, value));
+
+  // Colder than the cached one
+  cache.Lookup(0, 2, &result);
+  ASSERT_FALSE(cache.Insert(0, 2, value));
+  ASSERT_EQ(1, cache.rejections());
+  ASSERT_TRUE(cache.Lookup(0, 1, &result));
+
+  // Hotter than the cached one
+  for (int i = 0; i < 5; ++i) {
+    cache.Lookup(0, 3, &result);
+  }
+  ASSERT_TRUE(cache.Insert(0, 3, value));
+  ASSERT_FALSE(cache.Lookup(0, 1, &result));
+  ASSERT_TRUE(cache.Lookup(0, 3, &result));
+  ASSERT_EQ(1, cache.size());
+  ASSERT_LE(cache.charge(), 300);
+}
+
+}  // namespace euler
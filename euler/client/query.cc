@@ -18,14 +18,19 @@ limitations under the License.
 #include <string>
 
 #include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/tracer.h"
 
 namespace euler {
 
-Query::Query(const std::string& gremlin) {
+Query::Query(const std::string& gremlin): output_num_(0), dag_(nullptr) {
   gremlin_ = gremlin;
   ctx_ = std::make_shared<OpKernelContext>();
 }
 
+Query::Query(const PreparedQuery& prepared): Query("") {
+  dag_ = prepared.dag_;
+}
+
 Query::Query(
     const std::string& op_name,
     const std::string& alias,
@@ -68,4 +73,17 @@ Tensor* Query::GetResult(const std::string& result_name) {
   return t;
 }
 
+void Query::EnableTrace() {
+  ctx_->EnableTrace();
+}
+
+void Query::SetSeed(uint64_t seed) {
+  ctx_->set_seed(seed);
+}
+
+std::string Query::GetTrace() {
+  Tracer* tracer = ctx_->tracer();
+  return tracer == nullptr ? "" : tracer->ToChromeTrace();
+}
+
 }  // namespace euler
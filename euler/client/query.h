@@ -25,15 +25,35 @@ limitations under the License.
 
 namespace euler {
 
+class DAG;
 class OpKernelContext;
 class Tensor;
 class TensorShape;
 enum DataType: int32_t;
 
+// A query compiled by QueryProxy::Prepare, the queries built from it run the
+// plan directly without compiling or looking up the plan cache
+class PreparedQuery {
+ public:
+  PreparedQuery(): dag_(nullptr) { }
+
+  bool valid() const { return dag_ != nullptr; }
+
+ private:
+  explicit PreparedQuery(DAG* dag): dag_(dag) { }
+
+  DAG* dag_;  // Owned by the compiler
+
+  friend class Query;
+  friend class QueryProxy;
+};
+
 class Query {
  public:
   explicit Query(const std::string& gremlin);
 
+  explicit Query(const PreparedQuery& prepared);
+
   Query(
       const std::string& op_name,
       const std::string& alias,
@@ -50,6 +70,20 @@ class Query {
 
   Tensor* GetResult(const std::string& result_name);
 
+  // Record where the query spends time, must be called before running
+  void EnableTrace();
+
+  // Draw the samples of the query from the seed, must be called before
+  // running. The query returns the same samples when run again with the
+  // same seed, inputs and graph, e.g. to reproduce a mini-batch. The
+  // samples of a seeded query are drawn without OpenMP.
+  void SetSeed(uint64_t seed);
+
+  // The spans of the query in the Chrome trace_event JSON format, including
+  // the compiling, the DAG nodes and the nodes run by the servers. Empty if
+  // the trace is not enabled.
+  std::string GetTrace();
+
   bool SingleOpQuery() {
     return !op_name_.empty();
   }
@@ -63,6 +97,7 @@ class Query {
   std::string alias_;
   std::vector<std::string> input_tensor_names_;
   std::vector<std::string> norm_attr_names_;
+  DAG* dag_;
 
   friend class QueryProxy;
 };
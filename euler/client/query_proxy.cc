@@ -20,10 +20,12 @@ limitations under the License.
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <utility>
 
 #include "euler/common/env.h"
 #include "euler/core/framework/executor.h"
 #include "euler/core/framework/tensor.h"
+#include "euler/core/framework/tracer.h"
 #include "euler/core/index/index_manager.h"
 #include "euler/client/query.h"
 #include "euler/client/client_manager.h"
@@ -47,6 +49,7 @@ bool QueryProxy::Init(const GraphConfig& config) {
   const GraphMeta* meta = nullptr;
   std::vector<std::vector<float>> shard_node_weight, shard_edge_weight;
   std::vector<std::string> graph_label;
+  std::unique_ptr<IdRouter> id_router;
   if (opt_type_str == kRemoteGraphMode) {
     type = distribute;
   } else if (opt_type_str == kGraphPartitionMode) {
@@ -142,6 +145,21 @@ bool QueryProxy::Init(const GraphConfig& config) {
         shard_edge_weight[i][shard_num] = sum_weight;
       }
     }
+    // node id ranges, ids are broadcast to all the shards without them
+    if (type == graph_partition) {
+      std::vector<IdRangeSet> shard_id_ranges(shard_num);
+      shard_meta_ok = true;
+      for (int32_t i = 0; i < shard_num; ++i) {
+        if (!cm->RetrieveShardMeta(
+            i, "node_id_ranges", &shard_id_ranges[i])) {
+          shard_meta_ok = false;
+          EULER_LOG(WARNING) << "node id ranges error, shard no: " << i;
+        }
+      }
+      if (shard_meta_ok) {
+        id_router.reset(new IdRouter(shard_id_ranges));
+      }
+    }
   } else {
     // init graph
     std::string data_path = "";
@@ -160,6 +178,9 @@ bool QueryProxy::Init(const GraphConfig& config) {
       return false;
     }
 
+    std::string storage_type_info = "node";
+    config.Get("storage_type", &storage_type_info);
+
     std::unique_ptr<FileIO> data_dir;
     if (!Env::Default()->NewFileIO(data_path, true, &data_dir).ok() ||
         !data_dir->initialized() || !data_dir->IsDirectory()) {
@@ -168,7 +189,39 @@ bool QueryProxy::Init(const GraphConfig& config) {
     }
 
     auto& graph = Graph::Instance();
-    if (!graph.Init(0, 1, sampler_type_info, data_path, data_type_info).ok()) {
+    GraphLoadOptions load_options;
+    config.Get("load_reader_num", &load_options.reader_num);
+    config.Get("load_parser_num", &load_options.parser_num);
+    int pending_mb = 0;
+    if (config.Get("load_pending_mb", &pending_mb)) {
+      load_options.max_pending_bytes = static_cast<int64_t>(pending_mb) << 20;
+    }
+    std::string neighbor_sampler_type;
+    if (config.Get("neighbor_sampler_type", &neighbor_sampler_type) &&
+        !StringToNeighborSamplerType(
+            neighbor_sampler_type,
+            &load_options.neighbor_sampler_type).ok()) {
+      EULER_LOG(ERROR) << "Invalid neighbor_sampler_type: "
+                       << neighbor_sampler_type;
+      return false;
+    }
+    config.Get("alias_min_degree", &load_options.alias_min_degree);
+    int dense_feature_columns = 0;
+    if (config.Get("dense_feature_columns", &dense_feature_columns)) {
+      load_options.dense_feature_columns = dense_feature_columns != 0;
+    }
+    std::string quantization;
+    if (config.Get("dense_feature_quantization", &quantization) &&
+        !StringToFeatureQuantization(
+            quantization, &load_options.dense_feature_quantization).ok()) {
+      EULER_LOG(ERROR) << "Invalid dense_feature_quantization: "
+                       << quantization;
+      return false;
+    }
+    graph.set_load_options(load_options);
+
+    if (!graph.Init(0, 1, sampler_type_info, data_path, data_type_info,
+                    storage_type_info).ok()) {
       EULER_LOG(FATAL) << "graph data error!";
       return false;
     }
@@ -195,6 +248,7 @@ bool QueryProxy::Init(const GraphConfig& config) {
   instance_->shard_edge_weight_ = shard_edge_weight;
   instance_->shard_node_weight_ = shard_node_weight;
   instance_->graph_label_ = graph_label;
+  instance_->id_router_ = std::move(id_router);
 
   EULER_LOG(INFO) << "QueryProxy load successfully!\n"
                   << "GraphMeta {\n" << meta->ToString() << "}\n";
@@ -209,9 +263,12 @@ QueryProxy::QueryProxy(int32_t shard_num) {
   tp_ = env_->StartThreadPool("client_thread_pool", 8);
 }
 
-std::unordered_map<std::string, Tensor*>
-QueryProxy::RunGremlin(Query* query,
-                       const std::vector<std::string>& result_name) {
+DAG* QueryProxy::GetDAG(Query* query) {
+  if (query->dag_ != nullptr) {
+    return query->dag_;
+  }
+  Tracer* tracer = query->ctx_->tracer();
+  uint64_t start = tracer != nullptr ? Tracer::NowMicros() : 0;
   DAG* dag = nullptr;
   if (query->SingleOpQuery()) {
     dag = compiler_->Op2DAG(query->op_name_,
@@ -222,6 +279,31 @@ QueryProxy::RunGremlin(Query* query,
   } else {
     dag = compiler_->Compile(query->gremlin_);
   }
+  if (tracer != nullptr) {
+    tracer->AddSpan("compile", "compile", start, Tracer::NowMicros());
+  }
+  return dag;
+}
+
+PreparedQuery QueryProxy::Prepare(const std::string& gremlin) {
+  return PreparedQuery(compiler_->Compile(gremlin));
+}
+
+PreparedQuery QueryProxy::Prepare(
+    const std::string& op_name,
+    const std::string& alias,
+    int32_t output_num,
+    const std::vector<std::string>& input_tensor_names,
+    const std::vector<std::string>& norm_attr_names) {
+  return PreparedQuery(compiler_->Op2DAG(op_name, alias, output_num,
+                                         input_tensor_names,
+                                         norm_attr_names));
+}
+
+std::unordered_map<std::string, Tensor*>
+QueryProxy::RunGremlin(Query* query,
+                       const std::vector<std::string>& result_name) {
+  DAG* dag = GetDAG(query);
   if (dag == nullptr) {
     EULER_LOG(FATAL) << "parse error: " << query->gremlin_;
     std::unordered_map<std::string, Tensor*> error_map;
@@ -233,16 +315,7 @@ QueryProxy::RunGremlin(Query* query,
 }
 
 void QueryProxy::RunAsyncGremlin(Query* query, DoneCallback callback) {
-  DAG* dag = nullptr;
-  if (query->SingleOpQuery()) {
-    dag = compiler_->Op2DAG(query->op_name_,
-                            query->alias_,
-                            query->output_num_,
-                            query->input_tensor_names_,
-                            query->norm_attr_names_);
-  } else {
-    dag = compiler_->Compile(query->gremlin_);
-  }
+  DAG* dag = GetDAG(query);
   if (dag == nullptr) {
     EULER_LOG(FATAL) << "parse error: " << query->gremlin_;
     return;
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef EULER_CLIENT_QUERY_PROXY_H_
 #define EULER_CLIENT_QUERY_PROXY_H_
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -23,6 +24,7 @@ limitations under the License.
 #include "euler/client/graph_config.h"
 #include "euler/common/logging.h"
 #include "euler/common/env.h"
+#include "euler/common/id_range_set.h"
 #include "euler/common/str_util.h"
 #include "euler/core/graph/graph.h"
 #include "euler/core/graph/graph_builder.h"
@@ -33,6 +35,8 @@ limitations under the License.
 namespace euler {
 
 class Compiler;
+class DAG;
+class PreparedQuery;
 class Query;
 class Tensor;
 
@@ -51,6 +55,15 @@ class QueryProxy {
 
   void RunAsyncGremlin(Query* query, DoneCallback callback);
 
+  // Compile the query once for the hot paths, see PreparedQuery
+  PreparedQuery Prepare(const std::string& gremlin);
+
+  PreparedQuery Prepare(const std::string& op_name,
+                        const std::string& alias,
+                        int32_t output_num,
+                        const std::vector<std::string>& input_tensor_names,
+                        const std::vector<std::string>& norm_attr_names);
+
   static QueryProxy* GetInstance() {
     if (instance_ == nullptr) {
       EULER_LOG(ERROR) << "Init failed";
@@ -76,7 +89,15 @@ class QueryProxy {
     return graph_label_;
   }
 
+  // Route the node ids to the shards owning them in graph_partition mode,
+  // nullptr if some shard does not publish its node id ranges
+  const IdRouter* GetIdRouter() {
+    return id_router_.get();
+  }
+
  private:
+  DAG* GetDAG(Query* query);
+
   int32_t shard_num_;
   Compiler* compiler_;
   Env* env_;
@@ -87,6 +108,7 @@ class QueryProxy {
   // [edge_types_num + 1, shards_num + 1]
   std::vector<std::vector<float>> shard_edge_weight_;
   std::vector<std::string> graph_label_;
+  std::unique_ptr<IdRouter> id_router_;
   static QueryProxy* instance_;
 
   explicit QueryProxy(int32_t shard_num);
@@ -15,12 +15,111 @@ limitations under the License.
 
 #include "euler/client/rpc_client.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
 
 #include "euler/client/impl_register.h"
+#include "euler/common/time_utils.h"
+#include "euler/proto/tensor_message.h"
 
 namespace euler {
 
+namespace {
+
+// Run the functions after their delays in a background thread, e.g. to
+// issue the hedged requests
+class DelayQueue {
+ public:
+  static DelayQueue *Instance() {
+    static DelayQueue *queue = new DelayQueue();
+    return queue;
+  }
+
+  void Schedule(int64_t delay_us, std::function<void()> fn) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      queue_.push({std::chrono::steady_clock::now() +
+                   std::chrono::microseconds(delay_us), seq_++,
+                   std::move(fn)});
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  struct Item {
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t seq;
+    std::function<void()> fn;
+
+    bool operator>(const Item &other) const {
+      return deadline > other.deadline ||
+             (deadline == other.deadline && seq > other.seq);
+    }
+  };
+
+  DelayQueue() : seq_(0) {
+    std::thread(&DelayQueue::Run, this).detach();
+  }
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (true) {
+      if (queue_.empty()) {
+        cv_.wait(lock);
+      } else if (std::chrono::steady_clock::now() < queue_.top().deadline) {
+        cv_.wait_until(lock, queue_.top().deadline);
+      } else {
+        std::function<void()> fn = std::move(queue_.top().fn);
+        queue_.pop();
+        lock.unlock();
+        fn();
+        lock.lock();
+      }
+    }
+  }
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue_;
+  uint64_t seq_;
+};
+
+}  // namespace
+
+struct RpcClientBase::HedgedCall {
+  HedgedCall() : finished(false), pending(2),
+                 response(nullptr), tensor_response(nullptr) { }
+
+  // Move the response of the context index to the caller
+  void Deliver(int index) {
+    if (tensor_response != nullptr) {
+      tensor_response->Swap(tensor_responses[index].get());
+    } else {
+      response->GetReflection()->Swap(response, responses[index].get());
+    }
+  }
+
+  std::atomic<bool> finished;
+  std::atomic<int> pending;  // The contexts not deleted yet
+  RpcClient::ReplicaDoneCallback done;
+  std::string primary_host;
+  // Set before the primary context is released, in case the hedge is never
+  // issued and is released the last
+  Status primary_status;
+
+  // The caller's response, each context replies into its own one
+  google::protobuf::Message *response;
+  TensorMessage *tensor_response;
+  std::unique_ptr<google::protobuf::Message> responses[2];
+  std::unique_ptr<TensorMessage> tensor_responses[2];
+};
+
 bool RpcClientBase::Initialize(std::shared_ptr<ServerMonitor> monitor,
                                size_t shard_index, const GraphConfig &config) {
   config.Get("num_retries", &num_retries_);
@@ -31,28 +130,163 @@ void RpcClientBase::IssueRpcCall(const std::string &method,
                                  const google::protobuf::Message &request,
                                  google::protobuf::Message *respone,
                                  std::function<void(const Status &)> done) {
+  auto replica_done = [done] (const Status &status,
+                              const std::string &/*replica*/) {
+    done(status);
+  };
+  int64_t hedge_delay = rpc_manager_->HedgeDelay();
+  if (hedge_delay >= 0) {
+    auto call = std::make_shared<HedgedCall>();
+    call->done = replica_done;
+    call->response = respone;
+    RpcContext *ctx[2];
+    for (int i = 0; i < 2; ++i) {
+      call->responses[i].reset(respone->New());
+      ctx[i] = rpc_manager_->CreateContext(method, call->responses[i].get(),
+                                           nullptr);
+    }
+    if (!(ctx[0]->Initialize(request) && ctx[1]->Initialize(request))) {
+      delete ctx[0];
+      delete ctx[1];
+      done(Status(ErrorCode::PROTO_ERROR, "Bad request."));
+      return;
+    }
+    IssueHedgedCall(ctx[0], ctx[1], hedge_delay, call);
+    return;
+  }
+
   RpcContext *ctx = rpc_manager_->CreateContext(method, respone, nullptr);
-  ctx->done = [ctx, done, this](const Status &status) {
-    if (!status.ok()) {
-      rpc_manager_->MoveToBadHost(ctx->destination->host_port());
+  SetDone(ctx, replica_done);
+  if (!(ctx && ctx->Initialize(request))) {
+    done(Status(ErrorCode::PROTO_ERROR, "Bad request."));
+  }
+  DoIssueRpcCall(ctx);
+}
+
+void RpcClientBase::IssueRpcCall(const std::string &method,
+                                 const TensorMessage &request,
+                                 TensorMessage *respone,
+                                 ReplicaDoneCallback done) {
+  int64_t hedge_delay = rpc_manager_->HedgeDelay();
+  std::unique_ptr<TensorMessage> hedge_response;
+  if (hedge_delay >= 0) {
+    hedge_response.reset(respone->New());
+  }
+  if (hedge_response != nullptr) {
+    auto call = std::make_shared<HedgedCall>();
+    call->done = done;
+    call->tensor_response = respone;
+    call->tensor_responses[0].reset(respone->New());
+    call->tensor_responses[1] = std::move(hedge_response);
+    RpcContext *ctx[2];
+    for (int i = 0; i < 2; ++i) {
+      TensorMessage *response = call->tensor_responses[i].get();
+      ctx[i] = rpc_manager_->CreateContext(method, response->message(),
+                                           nullptr);
+      ctx[i]->tensor_response = response;
+    }
+    if (!(ctx[0]->Initialize(request) && ctx[1]->Initialize(request))) {
+      delete ctx[0];
+      delete ctx[1];
+      done(Status(ErrorCode::PROTO_ERROR, "Bad request."), "");
+      return;
     }
+    IssueHedgedCall(ctx[0], ctx[1], hedge_delay, call);
+    return;
+  }
+
+  RpcContext *ctx = rpc_manager_->CreateContext(method, respone->message(),
+                                                nullptr);
+  if (!(ctx && ctx->Initialize(request))) {
+    delete ctx;
+    done(Status(ErrorCode::PROTO_ERROR, "Bad request."), "");
+    return;
+  }
+  ctx->tensor_response = respone;
+  SetDone(ctx, done);
+  DoIssueRpcCall(ctx);
+}
+
+void RpcClientBase::SetDone(RpcContext *ctx, ReplicaDoneCallback done) {
+  ctx->done = [ctx, done, this](const Status &status) {
+    OnCallDone(ctx, status);
 
     if (status.ok() ||
         (num_retries_ > 0 && ++ctx->num_failures == num_retries_)) {
-      done(status);
+      done(status, ctx->destination->host_port());
       delete ctx;
     } else {
       DoIssueRpcCall(ctx);
     }
   };
-  if (!(ctx && ctx->Initialize(request))) {
-    done(Status(ErrorCode::PROTO_ERROR, "Bad request."));
+}
+
+void RpcClientBase::SetHedgedDone(RpcContext *ctx, int index,
+                                  std::shared_ptr<HedgedCall> call) {
+  ctx->done = [ctx, index, call, this](const Status &status) {
+    OnCallDone(ctx, status);
+
+    if (!status.ok() && !call->finished &&
+        !(num_retries_ > 0 && ++ctx->num_failures == num_retries_)) {
+      DoIssueRpcCall(ctx);
+      return;
+    }
+    // Fail only if both the contexts fail
+    if (index == 0) {
+      call->primary_status = status;
+    }
+    bool last = --call->pending == 0;
+    if ((status.ok() || last) && !call->finished.exchange(true)) {
+      if (status.ok()) {
+        call->Deliver(index);
+      }
+      call->done(status, ctx->destination->host_port());
+    }
+    delete ctx;
+  };
+}
+
+void RpcClientBase::IssueHedgedCall(RpcContext *primary, RpcContext *hedge,
+                                    int64_t delay,
+                                    std::shared_ptr<HedgedCall> call) {
+  SetHedgedDone(primary, 0, call);
+  SetHedgedDone(hedge, 1, call);
+  // The primary may be done and deleted once issued
+  primary->destination = rpc_manager_->GetChannel();
+  call->primary_host = primary->destination->host_port();
+  primary->issue_time = TimeUtils::NowMicros();
+  primary->destination->IssueRpcCall(primary);
+  DelayQueue::Instance()->Schedule(delay, [hedge, call, this]() {
+    std::shared_ptr<RpcChannel> destination;
+    if (!call->finished) {
+      destination = rpc_manager_->GetChannel(call->primary_host);
+    }
+    if (destination != nullptr) {
+      hedge->destination = destination;
+      hedge->issue_time = TimeUtils::NowMicros();
+      destination->IssueRpcCall(hedge);
+      return;
+    }
+    // Done already or no replica on another host, the hedge is not issued
+    if (--call->pending == 0 && !call->finished.exchange(true)) {
+      call->done(call->primary_status, call->primary_host);
+    }
+    delete hedge;
+  });
+}
+
+void RpcClientBase::OnCallDone(RpcContext *ctx, const Status &status) {
+  rpc_manager_->OnCallDone(ctx->destination.get(),
+                           TimeUtils::NowMicros() - ctx->issue_time,
+                           status.ok());
+  if (!status.ok()) {
+    rpc_manager_->MoveToBadHost(ctx->destination->host_port());
   }
-  DoIssueRpcCall(ctx);
 }
 
 void RpcClientBase::DoIssueRpcCall(RpcContext *ctx) {
   ctx->destination = rpc_manager_->GetChannel();
+  ctx->issue_time = TimeUtils::NowMicros();
   ctx->destination->IssueRpcCall(ctx);
 }
 
@@ -31,12 +31,24 @@ namespace euler {
 
 class RpcClient {
  public:
+  // Called with the host_port of the replica which served the call, or of
+  // the last one tried if the call fails
+  typedef std::function<void(const Status &, const std::string &)>
+      ReplicaDoneCallback;
+
   virtual bool Initialize(std::shared_ptr<ServerMonitor> monitor,
                           size_t shard_index, const GraphConfig &config) = 0;
   virtual void IssueRpcCall(const std::string &method,
                             const google::protobuf::Message &request,
                             google::protobuf::Message *respone,
                             std::function<void(const Status &)> done) = 0;
+  // The tensors of request and response are sent and received without
+  // copying, see TensorMessage. The replica is reported for the state kept
+  // by each server, e.g. the cached plans.
+  virtual void IssueRpcCall(const std::string &method,
+                            const TensorMessage &request,
+                            TensorMessage *respone,
+                            ReplicaDoneCallback done) = 0;
   virtual ~RpcClient() = default;
 };
 
@@ -51,10 +63,23 @@ class RpcClientBase : public RpcClient {
                     const google::protobuf::Message &request,
                     google::protobuf::Message *respone,
                     std::function<void(const Status &)> done) override;
+  void IssueRpcCall(const std::string &method,
+                    const TensorMessage &request,
+                    TensorMessage *respone,
+                    ReplicaDoneCallback done) override;
 
  private:
   static constexpr const int kRpcRetryCount = 10;
 
+  // A call issued to two replicas, the first reply is taken
+  struct HedgedCall;
+
+  void SetDone(RpcContext *ctx, ReplicaDoneCallback done);
+  void SetHedgedDone(RpcContext *ctx, int index,
+                     std::shared_ptr<HedgedCall> call);
+  void IssueHedgedCall(RpcContext *primary, RpcContext *hedge,
+                       int64_t delay, std::shared_ptr<HedgedCall> call);
+  void OnCallDone(RpcContext *ctx, const Status &status);
   void DoIssueRpcCall(RpcContext *ctx);
 
   std::unique_ptr<RpcManager> rpc_manager_;
@@ -13,13 +13,21 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
 
 #include "gtest/gtest.h"
 #include "euler/client/testing/echo.h"
 #include "euler/client/testing/mock_rpc_manager.h"
 #include "euler/client/testing/simple_server_monitor.h"
 #include "euler/client/rpc_client.h"
+#include "euler/proto/tensor_message.h"
 
 using ::testing::_;
 using ::testing::DoAll;
@@ -122,5 +130,167 @@ TEST_F(RpcClientTest, TestRetryFailure) {
   EXPECT_TRUE(finished);
 }
 
+TEST_F(RpcClientTest, TestHedgedRequest) {
+  GraphConfig config;
+  config.Add("num_retries", 1);
+  config.Add("hedge_percentile", 50);
+  config.Add("hedge_min_delay_us", 1000);
+
+  auto rpc_client = NewRpcClient(monitor_, 0, config);
+  EXPECT_TRUE(rpc_client);
+
+  for (int i = 0; i < 2; ++i) {
+    regs_->RegisterShard(0, std::to_string(i), Meta(), Meta());
+  }
+
+  // The call is held once by a replica, and answered by the other one
+  std::atomic<bool> hold(false);
+  std::atomic<RpcContext *> held(nullptr);
+  for (MockRpcChannel *channel : MockRpcChannel::channels) {
+    EXPECT_CALL(*channel, IssueRpcCall(_))
+        .WillRepeatedly(Invoke([&, channel](RpcContext *ctx) {
+                          if (hold.exchange(false)) {
+                            held = ctx;
+                            return;
+                          }
+                          static_cast<EchoResponse *>(ctx->response)->
+                              set_message(channel->host_port());
+                          ctx->done(Status::OK());
+                        }));
+  }
+
+  std::string method;
+  EchoRequest request;
+  EchoResponse response;
+  int num_done = 0;
+  for (int i = 0; i < 128; ++i) {
+    rpc_client->IssueRpcCall(method, request, &response,
+                             [&](const Status &status) {
+                               EXPECT_TRUE(status.ok());
+                               ++num_done;
+                             });
+  }
+  EXPECT_EQ(128, num_done);
+
+  hold = true;
+  response.Clear();
+  std::mutex mu;
+  std::condition_variable cv;
+  bool finished = false;
+  rpc_client->IssueRpcCall(method, request, &response,
+                           [&](const Status &status) {
+                             EXPECT_TRUE(status.ok());
+                             std::lock_guard<std::mutex> lock(mu);
+                             finished = true;
+                             cv.notify_all();
+                           });
+  {
+    std::unique_lock<std::mutex> lock(mu);
+    EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5),
+                            [&finished] { return finished; }));
+  }
+  ASSERT_NE(nullptr, held.load());
+  EXPECT_FALSE(response.message().empty());
+
+  // The late reply is dropped
+  std::string held_host = held.load()->destination->host_port();
+  held.load()->done(Status::OK());
+  EXPECT_NE(held_host, response.message());
+}
+
+TEST_F(RpcClientTest, TestHedgedRequestSingleHost) {
+  GraphConfig config;
+  config.Add("num_retries", 1);
+  config.Add("hedge_percentile", 50);
+  config.Add("hedge_min_delay_us", 1000);
+
+  auto rpc_client = NewRpcClient(monitor_, 0, config);
+  EXPECT_TRUE(rpc_client);
+  regs_->RegisterShard(0, "0", Meta(), Meta());
+
+  std::atomic<bool> hold(false);
+  std::atomic<RpcContext *> held(nullptr);
+  std::atomic<int> num_issued(0);
+  for (MockRpcChannel *channel : MockRpcChannel::channels) {
+    EXPECT_CALL(*channel, IssueRpcCall(_))
+        .WillRepeatedly(Invoke([&](RpcContext *ctx) {
+                          ++num_issued;
+                          if (hold.exchange(false)) {
+                            held = ctx;
+                            return;
+                          }
+                          ctx->done(Status::OK());
+                        }));
+  }
+
+  std::string method;
+  EchoRequest request;
+  EchoResponse response;
+  int num_done = 0;
+  for (int i = 0; i < 128; ++i) {
+    rpc_client->IssueRpcCall(method, request, &response,
+                             [&](const Status &status) {
+                               EXPECT_TRUE(status.ok());
+                               ++num_done;
+                             });
+  }
+  EXPECT_EQ(128, num_done);
+
+  // No other host to hedge to, the call waits for the only replica
+  hold = true;
+  num_issued = 0;
+  std::atomic<bool> finished(false);
+  rpc_client->IssueRpcCall(method, request, &response,
+                           [&](const Status &status) {
+                             EXPECT_TRUE(status.ok());
+                             finished = true;
+                           });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_NE(nullptr, held.load());
+  EXPECT_EQ(1, num_issued);
+  EXPECT_FALSE(finished);
+
+  held.load()->done(Status::OK());
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(1, num_issued);
+}
+
+TEST_F(RpcClientTest, TestReportReplica) {
+  GraphConfig config;
+  config.Add("num_retries", 1);
+
+  auto rpc_client = NewRpcClient(monitor_, 0, config);
+  EXPECT_TRUE(rpc_client);
+
+  // Two replicas of shard 0
+  for (int i = 0; i < 2; ++i) {
+    regs_->RegisterShard(0, std::to_string(i), Meta(), Meta());
+  }
+
+  std::string served;
+  for (MockRpcChannel *channel : MockRpcChannel::channels) {
+    EXPECT_CALL(*channel, IssueRpcCall(_))
+        .WillRepeatedly(Invoke([&, channel](RpcContext *ctx) {
+                          served = channel->host_port();
+                          ctx->done(Status::OK());
+                        }));
+  }
+
+  std::string method;
+  ExecuteTensorRequest request;
+  std::set<std::string> replicas;
+  for (int i = 0; i < 64; ++i) {
+    ExecuteTensorReply response;
+    rpc_client->IssueRpcCall(method, request, &response,
+                             [&](const Status &status,
+                                 const std::string &replica) {
+                               EXPECT_TRUE(status.ok());
+                               EXPECT_EQ(served, replica);
+                               replicas.insert(replica);
+                             });
+  }
+  EXPECT_EQ(2, replicas.size());
+}
+
 }  // namespace
 }  // namespace euler
@@ -15,12 +15,26 @@ limitations under the License.
 
 #include "euler/client/rpc_manager.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "euler/common/logging.h"
 #include "euler/client/impl_register.h"
 #include "euler/client/grpc_manager.h"
 
 namespace euler {
 
+namespace {
+
+// The weight of a new latency in the EWMA
+const double kLatencyDecay = 0.2;
+
+}  // namespace
+
+const size_t RpcManager::kLatencyWindow;
+const size_t RpcManager::kMinHedgeSamples;
+const size_t RpcManager::kHedgeDelayUpdateInterval;
+
 bool RpcManager::Initialize(std::shared_ptr<ServerMonitor> monitor,
                             size_t shard_index, const GraphConfig &config) {
   if (monitor_) {
@@ -35,6 +49,20 @@ bool RpcManager::Initialize(std::shared_ptr<ServerMonitor> monitor,
   if (config.Get("bad_host_timeout", &value_int)) {
     bad_host_timeout_ = Duration(value_int);
   }
+  std::string selection;
+  if (config.Get("replica_selection", &selection)) {
+    if (selection == "least_loaded") {
+      replica_selection_ = kLeastLoaded;
+    } else if (selection != "round_robin") {
+      EULER_LOG(ERROR) << "Unknown replica selection: " << selection;
+    }
+  }
+  if (config.Get("hedge_percentile", &value_int)) {
+    hedge_percentile_ = std::min(std::max(value_int, 0), 100);
+  }
+  if (config.Get("hedge_min_delay_us", &value_int)) {
+    hedge_min_delay_ = value_int;
+  }
 
   bool success = monitor->SetShardCallback(shard_index, &shard_callback_);
   if (success) {
@@ -55,9 +83,79 @@ RpcManager::~RpcManager() {
 }
 
 std::shared_ptr<RpcChannel> RpcManager::GetChannel() {
+  return SelectChannel(nullptr);
+}
+
+std::shared_ptr<RpcChannel> RpcManager::GetChannel(
+    const std::string &exclude_host) {
+  return SelectChannel(&exclude_host);
+}
+
+std::shared_ptr<RpcChannel> RpcManager::SelectChannel(
+    const std::string *exclude_host) {
   std::unique_lock<std::mutex> lock(mu_);
   cv_.wait(lock, [this]{ return !channels_.empty(); });
-  return channels_[next_replica_index_++ % channels_.size()];
+  size_t start = next_replica_index_++;
+  std::shared_ptr<RpcChannel> selected;
+  double min_cost = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < channels_.size(); ++i) {
+    auto &channel = channels_[(start + i) % channels_.size()];
+    if (exclude_host != nullptr && channel->host_port() == *exclude_host) {
+      continue;
+    }
+    if (replica_selection_ == kRoundRobin) {
+      selected = channel;
+      break;
+    }
+    // The replicas without latencies are tried first
+    double cost = static_cast<double>(channel->latency()) *
+                  (channel->outstanding() + 1);
+    if (cost < min_cost) {
+      min_cost = cost;
+      selected = channel;
+    }
+  }
+  if (!selected) {  // All on the excluded host
+    return nullptr;
+  }
+  ++selected->outstanding_;
+  return selected;
+}
+
+void RpcManager::OnCallDone(RpcChannel *channel, uint64_t latency, bool ok) {
+  --channel->outstanding_;
+  if (!ok) {
+    return;
+  }
+
+  int64_t old_latency = channel->latency_;
+  int64_t new_latency;
+  do {
+    new_latency = old_latency == 0 ? latency :
+        old_latency + (static_cast<int64_t>(latency) - old_latency) *
+                      kLatencyDecay;
+  } while (!channel->latency_.compare_exchange_weak(old_latency,
+                                                    new_latency));
+
+  if (hedge_percentile_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(latency_mu_);
+  if (latencies_.size() < kLatencyWindow) {
+    latencies_.push_back(latency);
+  } else {
+    latencies_[num_latencies_ % kLatencyWindow] = latency;
+  }
+  ++num_latencies_;
+  if (num_latencies_ >= kMinHedgeSamples &&
+      num_latencies_ % kHedgeDelayUpdateInterval == 0) {
+    std::vector<uint64_t> latencies(latencies_);
+    size_t n = (latencies.size() - 1) * hedge_percentile_ / 100;
+    std::nth_element(latencies.begin(), latencies.begin() + n,
+                     latencies.end());
+    hedge_delay_ = std::max(static_cast<int64_t>(latencies[n]),
+                            hedge_min_delay_);
+  }
 }
 
 void RpcManager::MoveToBadHost(const std::string &host_port) {
@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef EULER_CLIENT_RPC_MANAGER_H_
 #define EULER_CLIENT_RPC_MANAGER_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -31,27 +34,33 @@ limitations under the License.
 namespace euler {
 
 class RpcChannel;
+class TensorMessage;
 
 struct RpcContext {
   RpcContext(const std::string &method,
              google::protobuf::Message *response,
              std::function<void(const Status &)> done)
-      : method(method), response(response), done(done), num_failures(0) { }
+      : method(method), response(response), tensor_response(nullptr),
+        done(done), num_failures(0), issue_time(0) { }
 
   virtual bool Initialize(const google::protobuf::Message &request) = 0;
+  virtual bool Initialize(const TensorMessage &request) = 0;
   virtual ~RpcContext() = default;
 
   std::string method;
   google::protobuf::Message *response;
+  TensorMessage *tensor_response;  // Set if the response carries tensors
   std::function<void(const Status &)> done;
 
   std::shared_ptr<RpcChannel> destination;
   int num_failures;
+  uint64_t issue_time;  // In microseconds
 };
 
 class RpcChannel {
  public:
-  explicit RpcChannel(const std::string &host_port) : host_port_(host_port) { }
+  explicit RpcChannel(const std::string &host_port)
+      : host_port_(host_port), outstanding_(0), latency_(0) { }
 
   virtual ~RpcChannel() = default;
 
@@ -59,8 +68,18 @@ class RpcChannel {
 
   std::string host_port() { return host_port_; }
 
+  // The calls issued but not done yet
+  int outstanding() const { return outstanding_; }
+
+  // EWMA of the latencies in microseconds, 0 if no call is done yet
+  int64_t latency() const { return latency_; }
+
  private:
+  friend class RpcManager;
+
   std::string host_port_;
+  std::atomic<int> outstanding_;
+  std::atomic<int64_t> latency_;
 };
 
 class RpcManager {
@@ -69,6 +88,11 @@ class RpcManager {
       : num_channels_per_host_(1),
         bad_host_cleanup_interval_(1),
         bad_host_timeout_(10),
+        replica_selection_(kRoundRobin),
+        hedge_percentile_(0),
+        hedge_min_delay_(1000),
+        hedge_delay_(-1),
+        num_latencies_(0),
         next_replica_index_(0),
         shutdown_(false),
         bad_hosts_cleaner_(std::thread(&RpcManager::CleanupBadHosts, this)),
@@ -91,9 +115,30 @@ class RpcManager {
       std::function<void(const Status &)> done) = 0;
 
   std::shared_ptr<RpcChannel> GetChannel();
+  // A replica on another host, e.g. for a hedged request, nullptr if all
+  // the replicas are on exclude_host
+  std::shared_ptr<RpcChannel> GetChannel(const std::string &exclude_host);
   void MoveToBadHost(const std::string &host_port);
 
+  // Called when a call issued to a channel of GetChannel is done
+  void OnCallDone(RpcChannel *channel, uint64_t latency, bool ok);
+
+  // The delay in microseconds after which a call is re-issued to another
+  // replica if it is not done yet, -1 if hedged requests are disabled or
+  // not enough latencies are seen
+  int64_t HedgeDelay() const { return hedge_delay_; }
+
  private:
+  enum ReplicaSelection {
+    kRoundRobin,
+    // The least latency weighted by the outstanding calls
+    kLeastLoaded
+  };
+
+  static const size_t kLatencyWindow = 1024;
+  static const size_t kMinHedgeSamples = 100;
+  static const size_t kHedgeDelayUpdateInterval = 64;
+
   using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
   using Duration = std::chrono::seconds;
   // Bad host and detected time.
@@ -105,10 +150,20 @@ class RpcManager {
   void DoAddChannel(const std::string &host_port);
   void DoRemoveChannel(const std::string &host_port);
   void DoCleanupBadHosts(TimePoint now);
+  std::shared_ptr<RpcChannel> SelectChannel(const std::string *exclude_host);
 
   int num_channels_per_host_;
   Duration bad_host_cleanup_interval_;
   Duration bad_host_timeout_;
+  ReplicaSelection replica_selection_;
+  int hedge_percentile_;  // 0 to disable hedged requests
+  int64_t hedge_min_delay_;
+  std::atomic<int64_t> hedge_delay_;
+
+  // The latest latencies of the shard, for the hedge delay
+  std::vector<uint64_t> latencies_;
+  size_t num_latencies_;
+  std::mutex latency_mu_;
 
   std::vector<std::shared_ptr<RpcChannel>> channels_;
   std::vector<BadHost> bad_hosts_;
@@ -149,5 +149,70 @@ TEST_F(RpcManagerTest, BlackList) {
   EXPECT_EQ(num_times_per_replica * 2, counters[2]);
 }
 
+TEST_F(RpcManagerTest, LeastLoaded) {
+  GraphConfig config;
+  config.Add("replica_selection", "least_loaded");
+  EXPECT_TRUE(rpc_manager_.Initialize(monitor_, 0, config));
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(regs_->RegisterShard(0, std::to_string(i), Meta(), Meta()));
+  }
+
+  // The replicas without latencies are tried first
+  std::vector<uint64_t> latencies = {10000, 100, 200};
+  std::vector<int> counters(3);
+  for (int i = 0; i < 3; ++i) {
+    auto channel = rpc_manager_.GetChannel();
+    int replica = std::stoi(channel->host_port());
+    ++counters[replica];
+    rpc_manager_.OnCallDone(channel.get(), latencies[replica], true);
+  }
+  EXPECT_EQ(std::vector<int>({1, 1, 1}), counters);
+
+  // The fastest one
+  for (int i = 0; i < 100; ++i) {
+    auto channel = rpc_manager_.GetChannel();
+    int replica = std::stoi(channel->host_port());
+    ++counters[replica];
+    rpc_manager_.OnCallDone(channel.get(), latencies[replica], true);
+  }
+  EXPECT_EQ(std::vector<int>({1, 101, 1}), counters);
+
+  // The outstanding calls are counted
+  std::vector<std::shared_ptr<RpcChannel>> channels;
+  for (int i = 0; i < 4; ++i) {
+    channels.push_back(rpc_manager_.GetChannel());
+    ++counters[std::stoi(channels.back()->host_port())];
+  }
+  EXPECT_EQ(1, counters[0]);
+  EXPECT_LT(101, counters[1]);
+  EXPECT_LT(1, counters[2]);
+  for (auto &channel : channels) {
+    rpc_manager_.OnCallDone(channel.get(), 0, false);
+  }
+  for (auto &channel : channels) {
+    EXPECT_EQ(0, channel->outstanding());
+  }
+
+  // Another host
+  for (int i = 0; i < 10; ++i) {
+    auto channel = rpc_manager_.GetChannel("1");
+    EXPECT_NE("1", channel->host_port());
+    rpc_manager_.OnCallDone(channel.get(), 0, false);
+  }
+}
+
+TEST_F(RpcManagerTest, SingleHost) {
+  EXPECT_TRUE(rpc_manager_.Initialize(monitor_, 0));
+  EXPECT_TRUE(regs_->RegisterShard(0, "0", Meta(), Meta()));
+
+  EXPECT_EQ(nullptr, rpc_manager_.GetChannel("0"));
+  auto channel = rpc_manager_.GetChannel();
+  EXPECT_EQ("0", channel->host_port());
+  EXPECT_EQ(1, channel->outstanding());
+  rpc_manager_.OnCallDone(channel.get(), 0, true);
+  EXPECT_EQ(0, channel->outstanding());
+}
+
 }  // namespace
 }  // namespace euler
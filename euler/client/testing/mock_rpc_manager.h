@@ -36,6 +36,10 @@ struct MockRpcContext : public RpcContext {
   bool Initialize(const google::protobuf::Message &/*request*/) override {
     return true;
   }
+
+  bool Initialize(const TensorMessage &/*request*/) override {
+    return true;
+  }
 };
 
 class MockRpcChannel : public RpcChannel {
@@ -62,10 +62,21 @@ void AliasMethod::Init(const std::vector<float>& weights) {
   }
 }  // Init
 
+bool AliasMethod::Init(const std::vector<float>& prob,
+                       const std::vector<int64_t>& alias) {
+  if (prob.size() != alias.size()) {
+    return false;
+  }
+  prob_ = prob;
+  alias_ = alias;
+  return true;
+}
 
 int64_t AliasMethod::Next() const {
-  int64_t column = NextLong(prob_.size());
-  bool coinToss = ThreadLocalRandom() < prob_[column];
+  double u[2];
+  FillRandom(u, 2);
+  int64_t column = floor(prob_.size() * u[0]);
+  bool coinToss = u[1] < prob_[column];
   return coinToss ? column : alias_[column];
 }
 
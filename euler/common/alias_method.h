@@ -29,12 +29,19 @@ class AliasMethod {
  public:
   void Init(const std::vector<float>& weights);
 
+  // Restore the tables built by another AliasMethod
+  bool Init(const std::vector<float>& prob, const std::vector<int64_t>& alias);
+
   int64_t Next() const;
 
   size_t GetSize() const;
 
   std::string ShowData() const;
 
+  const std::vector<float>& GetProb() const { return prob_; }
+
+  const std::vector<int64_t>& GetAlias() const { return alias_; }
+
  private:
   std::vector<float> prob_;
   std::vector<int64_t> alias_;
@@ -17,6 +17,7 @@ limitations under the License.
 #define EULER_COMMON_COMPACT_WEIGHTED_COLLECTION_H_
 
 #include <iostream>
+#include <numeric>
 #include <vector>
 #include <utility>
 
@@ -28,7 +29,7 @@ namespace euler {
 namespace common {
 
 template<class T>
-size_t RandomSelect(const std::vector<float>& sum_weights,
+size_t RandomSelect(const float* sum_weights,
                     size_t begin_pos, size_t end_pos) {
   float limit_begin = begin_pos == 0 ? 0 : sum_weights[begin_pos - 1];
   float limit_end = sum_weights[end_pos];
@@ -51,6 +52,12 @@ size_t RandomSelect(const std::vector<float>& sum_weights,
   return mid;
 }
 
+template<class T>
+size_t RandomSelect(const std::vector<float>& sum_weights,
+                    size_t begin_pos, size_t end_pos) {
+  return RandomSelect<T>(sum_weights.data(), begin_pos, end_pos);
+}
+
 template<class T>
 class CompactWeightedCollection : public WeightedCollection<T> {
  public:
@@ -0,0 +1,62 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/cpu_info.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define EULER_X86_CPU
+#include <cpuid.h>
+#endif
+
+namespace euler {
+namespace common {
+
+namespace {
+
+SimdLevel DetectSimdLevel() {
+#ifdef EULER_X86_CPU
+  __builtin_cpu_init();
+  bool avx2 = __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("fma");
+  // F16C has no __builtin_cpu_supports name, read it from cpuid directly
+  unsigned int eax, ebx, ecx, edx;
+  avx2 = avx2 && __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_F16C);
+  if (avx2 && __builtin_cpu_supports("avx512f")) {
+    return kAvx512;
+  }
+  if (avx2) {
+    return kAvx2;
+  }
+#endif
+  return kScalar;
+}
+
+}  // namespace
+
+SimdLevel SupportedSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case kAvx512: return "avx512";
+    case kAvx2: return "avx2";
+    default: return "scalar";
+  }
+}
+
+}  // namespace common
+}  // namespace euler
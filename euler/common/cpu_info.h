@@ -0,0 +1,38 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_COMMON_CPU_INFO_H_
+#define EULER_COMMON_CPU_INFO_H_
+
+namespace euler {
+namespace common {
+
+// Instruction sets of the SIMD kernels, e.g. dequantization and random
+// numbers, the best one supported by both the compiler and the cpu is
+// picked at runtime.
+enum SimdLevel {
+  kScalar = 0,
+  kAvx2 = 1,    // with F16C and FMA
+  kAvx512 = 2,  // AVX-512F
+};
+
+SimdLevel SupportedSimdLevel();
+
+const char* SimdLevelName(SimdLevel level);
+
+}  // namespace common
+}  // namespace euler
+
+#endif  // EULER_COMMON_CPU_INFO_H_
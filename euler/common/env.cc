@@ -22,6 +22,18 @@ limitations under the License.
 
 namespace euler {
 
+Status StringToThreadPoolType(const std::string& type_str,
+                              ThreadPoolType* type) {
+  if (type_str == "std") {
+    *type = kStdThreadPool;
+  } else if (type_str == "work_stealing") {
+    *type = kWorkStealingThreadPool;
+  } else {
+    return Status::InvalidArgument("Invalid thread pool type: ", type_str);
+  }
+  return Status::OK();
+}
+
 Status Env::NewFileIO(Slice uri, bool readonly,
                       std::unique_ptr<FileIO>* file_io) {
   Slice scheme, host, path;
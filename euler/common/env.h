@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef EULER_COMMON_ENV_H_
 #define EULER_COMMON_ENV_H_
 
+#include <stdint.h>
+
 #include <functional>
 #include <string>
 #include <memory>
@@ -46,8 +48,27 @@ class ThreadPool {
   virtual void Shutdown() = 0;
 };
 
+enum ThreadPoolType {
+  kStdThreadPool,           // Round robin over per thread job queues
+  kWorkStealingThreadPool   // Per thread deques, idle threads steal tasks
+};
+
+// Accept "std" and "work_stealing"
+Status StringToThreadPoolType(const std::string& type_str,
+                              ThreadPoolType* type);
+
 class FileIO;
 
+// A read only region of memory, e.g. a memory mapped file
+class ReadOnlyMemoryRegion {
+ public:
+  ReadOnlyMemoryRegion() { }
+  virtual ~ReadOnlyMemoryRegion() { }
+
+  virtual const void* data() const = 0;
+  virtual uint64_t length() const = 0;
+};
+
 class Env {
  public:
   static Env* Default();
@@ -57,6 +78,9 @@ class Env {
   virtual ThreadPool* StartThreadPool(
       const std::string& name, int num_threads) = 0;
 
+  virtual ThreadPool* StartThreadPool(
+      const std::string& name, int num_threads, ThreadPoolType type) = 0;
+
   virtual Status LoadLibrary(const char* library_filename, void** handle) = 0;
 
   virtual Status GetSymbolFromLibrary(void* handle, const char* symbol_name,
@@ -64,6 +88,12 @@ class Env {
 
   virtual Status NewFileIO(Slice path, bool readonly,
                            std::unique_ptr<FileIO>* file_io);
+
+  // Map a local file read only, the pages are shared with other processes
+  // mapping the same file.
+  virtual Status NewReadOnlyMemoryRegion(
+      const std::string& path,
+      std::unique_ptr<ReadOnlyMemoryRegion>* region) = 0;
 };
 
 }  // namespace euler
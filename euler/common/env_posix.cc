@@ -14,17 +14,23 @@ limitations under the License.
 ==============================================================================*/
 
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <thread>  // NOLINT
 #include <atomic>
 #include <string>
 #include <deque>
 #include <vector>
+#include <utility>
 
 #include "euler/common/env.h"
 #include "euler/common/macros.h"
 #include "euler/common/mutex.h"
 #include "euler/common/logging.h"
+#include "euler/common/work_stealing_queue.h"
 
 namespace euler {
 
@@ -158,6 +164,208 @@ class StdThreadPool: public ThreadPool {
   std::vector<std::unique_ptr<JobQueue<ThreadFunc>>> job_queues_;
 };
 
+// Each thread owns a deque, the tasks scheduled by a thread of the pool are
+// pushed to its own deque and run in LIFO order, the others are pushed to a
+// shared queue. An idle thread takes tasks from its deque, the shared queue
+// and then the deques of the other threads, it spins for a while before
+// parking if there is no task at all.
+class WorkStealingThreadPool: public ThreadPool {
+ public:
+  WorkStealingThreadPool(const std::string& name, int num_threads)
+      : shutdown_(false), shared_num_(0), parked_num_(0) {
+    for (int i = 0; i < num_threads; ++i) {
+      queues_.emplace_back(new WorkStealingQueue<ThreadFunc>());
+    }
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back(new StdThread(name, [this, i] () { Loop(i); }));
+    }
+  }
+
+  ~WorkStealingThreadPool() override {
+    Shutdown();
+  }
+
+  void Schedule(ThreadFunc fn) override {
+    ThreadFunc* task = new ThreadFunc(std::move(fn));
+    if (current_pool_ == this) {
+      queues_[current_thread_]->Push(task);
+    } else {
+      MutexLock l(&shared_mu_);
+      shared_.push_back(task);
+      shared_num_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Pairs with the fence in Park, either the parked thread finds the task
+    // or it is seen here and woken up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_num_.load(std::memory_order_relaxed) > 0) {
+      MutexLock l(&park_mu_);
+      park_cv_.Signal();
+    }
+  }
+
+  void Shutdown() override {
+    MutexLock l(&shutdown_mu_);
+    if (shutdown_.load()) {
+      return;
+    }
+
+    shutdown_.store(true, std::memory_order_release);
+    {
+      MutexLock park_lock(&park_mu_);
+      park_cv_.SignalAll();
+    }
+
+    for (auto& thread : threads_) {
+      thread->Join();
+    }
+
+    // Drop the pending tasks as StdThreadPool does
+    for (auto& queue : queues_) {
+      while (ThreadFunc* task = queue->Pop()) {
+        delete task;
+      }
+    }
+    MutexLock shared_lock(&shared_mu_);
+    for (auto task : shared_) {
+      delete task;
+    }
+    shared_.clear();
+  }
+
+  void Join() override {
+    for (auto& thread : threads_) {
+      thread->Join();
+    }
+  }
+
+ private:
+  static const int kSpinRounds = 64;
+  // Take a task from the shared queue first once in a while, so that new
+  // tasks are not starved by the tasks spawned locally
+  static const int kSharedQueueInterval = 32;
+
+  void Loop(int i) {
+    current_pool_ = this;
+    current_thread_ = i;
+    uint64_t tick = 0;
+    while (!shutdown_.load(std::memory_order_acquire)) {
+      ThreadFunc* task = nullptr;
+      if (++tick % kSharedQueueInterval == 0) {
+        task = PopShared();
+      }
+      for (int round = 0; task == nullptr && round < kSpinRounds; ++round) {
+        task = NextTask(i);
+        if (task == nullptr) {
+          std::this_thread::yield();
+        }
+      }
+      if (task == nullptr) {
+        Park();
+        continue;
+      }
+      (*task)();
+      delete task;
+    }
+    current_pool_ = nullptr;
+  }
+
+  ThreadFunc* NextTask(int i) {
+    ThreadFunc* task = queues_[i]->Pop();
+    if (task != nullptr) {
+      return task;
+    }
+
+    task = PopShared();
+    if (task != nullptr) {
+      return task;
+    }
+
+    for (size_t j = 1; j < queues_.size(); ++j) {
+      task = queues_[(i + j) % queues_.size()]->Steal();
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    return nullptr;
+  }
+
+  ThreadFunc* PopShared() {
+    if (shared_num_.load(std::memory_order_relaxed) == 0) {
+      return nullptr;
+    }
+    MutexLock l(&shared_mu_);
+    if (shared_.empty()) {
+      return nullptr;
+    }
+    ThreadFunc* task = shared_.front();
+    shared_.pop_front();
+    shared_num_.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+
+  bool HasTask() const {
+    if (shared_num_.load(std::memory_order_relaxed) > 0) {
+      return true;
+    }
+    for (auto& queue : queues_) {
+      if (!queue->Empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Park() {
+    MutexLock l(&park_mu_);
+    parked_num_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    park_cv_.Wait(&l, [this] () {
+      return shutdown_.load() || HasTask();
+    });
+    parked_num_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  static thread_local WorkStealingThreadPool* current_pool_;
+  static thread_local int current_thread_;
+
+  std::atomic<bool> shutdown_;
+  Mutex shutdown_mu_;
+  std::vector<std::unique_ptr<StdThread>> threads_;
+  std::vector<std::unique_ptr<WorkStealingQueue<ThreadFunc>>> queues_;
+
+  Mutex shared_mu_;
+  std::deque<ThreadFunc*> shared_;
+  std::atomic<size_t> shared_num_;
+
+  Mutex park_mu_;
+  CondVar park_cv_;
+  std::atomic<int> parked_num_;
+};
+
+thread_local WorkStealingThreadPool* WorkStealingThreadPool::current_pool_ =
+    nullptr;
+thread_local int WorkStealingThreadPool::current_thread_ = 0;
+
+class PosixReadOnlyMemoryRegion: public ReadOnlyMemoryRegion {
+ public:
+  PosixReadOnlyMemoryRegion(const void* address, uint64_t length)
+      : address_(address), length_(length) {
+  }
+
+  ~PosixReadOnlyMemoryRegion() override {
+    munmap(const_cast<void*>(address_), length_);
+  }
+
+  const void* data() const override { return address_; }
+
+  uint64_t length() const override { return length_; }
+
+ private:
+  const void* const address_;
+  const uint64_t length_;
+};
+
 }  // namespace
 
 class PosixEnv: public Env {
@@ -165,11 +373,18 @@ class PosixEnv: public Env {
   Thread* StartThread(const std::string& name, ThreadFunc fn) override;
   ThreadPool* StartThreadPool(
       const std::string& name, int num_threads) override;
+  ThreadPool* StartThreadPool(
+      const std::string& name, int num_threads,
+      ThreadPoolType type) override;
 
   Status LoadLibrary(const char* library_filename, void** handle) override;
 
   Status GetSymbolFromLibrary(void* handle, const char* symbol_name,
                               void** symbol) override;
+
+  Status NewReadOnlyMemoryRegion(
+      const std::string& path,
+      std::unique_ptr<ReadOnlyMemoryRegion>* region) override;
 };
 
 Thread* PosixEnv::StartThread(const std::string &name, ThreadFunc fn) {
@@ -181,6 +396,14 @@ ThreadPool* PosixEnv::StartThreadPool(
   return new StdThreadPool(name, num_threads);
 }
 
+ThreadPool* PosixEnv::StartThreadPool(
+    const std::string &name, int num_threads, ThreadPoolType type) {
+  if (type == kWorkStealingThreadPool) {
+    return new WorkStealingThreadPool(name, num_threads);
+  }
+  return new StdThreadPool(name, num_threads);
+}
+
 Status PosixEnv::LoadLibrary(const char* library_filename, void** handle) {
   *handle = dlopen(library_filename, RTLD_NOW | RTLD_LOCAL);
   if (!*handle) {
@@ -198,6 +421,30 @@ Status PosixEnv::GetSymbolFromLibrary(void* handle, const char* symbol_name,
   return Status::OK();
 }
 
+Status PosixEnv::NewReadOnlyMemoryRegion(
+    const std::string& path,
+    std::unique_ptr<ReadOnlyMemoryRegion>* region) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Status::NotFound("Open file failed, path: ", path);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return Status::Internal("Invalid file to map, path: ", path);
+  }
+
+  void* address = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    return Status::Internal("Map file failed, path: ", path);
+  }
+
+  region->reset(new PosixReadOnlyMemoryRegion(address, st.st_size));
+  return Status::OK();
+}
+
 #if defined(POSIX)
 
 Env* Env::Default() {
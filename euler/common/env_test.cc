@@ -15,11 +15,19 @@ limitations under the License.
 
 #include "euler/common/env.h"
 
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "euler/common/logging.h"
+#include "euler/common/work_stealing_queue.h"
 
 namespace euler {
 
@@ -44,4 +52,113 @@ TEST(EnvTest, ThreadPool) {
   threadpool->Shutdown();
 }
 
+namespace {
+
+// Wait at most 10s for the counter to reach the value
+bool WaitFor(const std::atomic<int>& counter, int value) {
+  for (int i = 0; i < 10000 && counter.load() < value; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return counter.load() == value;
+}
+
+}  // namespace
+
+TEST(EnvTest, WorkStealingQueue) {
+  const int kItemNum = 100000;
+  std::vector<int> items(kItemNum);
+  WorkStealingQueue<int> queue(4);
+  ASSERT_TRUE(queue.Pop() == nullptr);
+  queue.Push(&items[0]);
+  queue.Push(&items[1]);
+  ASSERT_EQ(&items[1], queue.Pop());
+  ASSERT_EQ(&items[0], queue.Steal());
+  ASSERT_TRUE(queue.Empty());
+
+  // Each item is taken exactly once by the owner or the thieves
+  std::atomic<bool> done(false);
+  std::atomic<int> taken(0);
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.emplace_back([&] () {
+      while (!done.load() || !queue.Empty()) {
+        if (int* item = queue.Steal()) {
+          ++*item;
+          ++taken;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kItemNum; ++i) {
+    queue.Push(&items[i]);
+    if (i % 3 == 0) {
+      if (int* item = queue.Pop()) {
+        ++*item;
+        ++taken;
+      }
+    }
+  }
+  while (int* item = queue.Pop()) {
+    ++*item;
+    ++taken;
+  }
+  done.store(true);
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+  ASSERT_EQ(kItemNum, taken.load());
+  for (int i = 2; i < kItemNum; ++i) {
+    ASSERT_EQ(1, items[i]);
+  }
+}
+
+TEST(EnvTest, WorkStealingThreadPool) {
+  ThreadPoolType type = kStdThreadPool;
+  ASSERT_TRUE(StringToThreadPoolType("work_stealing", &type).ok());
+  ASSERT_EQ(kWorkStealingThreadPool, type);
+  ASSERT_FALSE(StringToThreadPoolType("unknown", &type).ok());
+
+  const int kTaskNum = 1000;
+  std::unique_ptr<ThreadPool> threadpool(
+      Env::Default()->StartThreadPool("test", 4, type));
+  std::atomic<int> counter(0);
+  for (int i = 0; i < kTaskNum; ++i) {
+    threadpool->Schedule([&threadpool, &counter] () {
+      // Tasks scheduled by the pool threads go to their own deques
+      threadpool->Schedule([&counter] () { ++counter; });
+      ++counter;
+    });
+  }
+  ASSERT_TRUE(WaitFor(counter, kTaskNum * 2));
+
+  // The tasks behind a blocked task are stolen by the other threads
+  std::atomic<int> stolen(0);
+  threadpool->Schedule([&threadpool, &stolen] () {
+    for (int i = 0; i < kTaskNum; ++i) {
+      threadpool->Schedule([&stolen] () { ++stolen; });
+    }
+    WaitFor(stolen, kTaskNum);
+  });
+  ASSERT_TRUE(WaitFor(stolen, kTaskNum));
+  threadpool->Shutdown();
+}
+
+TEST(EnvTest, ReadOnlyMemoryRegion) {
+  const std::string kPath = "/tmp/env_test_region.dat";
+  FILE* fp = fopen(kPath.c_str(), "wb");
+  ASSERT_TRUE(fp != nullptr);
+  fputs("euler", fp);
+  fclose(fp);
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  ASSERT_TRUE(Env::Default()->NewReadOnlyMemoryRegion(kPath, &region).ok());
+  ASSERT_EQ(5, region->length());
+  ASSERT_EQ("euler", std::string(static_cast<const char*>(region->data()),
+                                 region->length()));
+  remove(kPath.c_str());
+
+  ASSERT_FALSE(
+      Env::Default()->NewReadOnlyMemoryRegion(kPath, &region).ok());
+}
+
 }  // namespace euler
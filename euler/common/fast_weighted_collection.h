@@ -32,6 +32,10 @@ class FastWeightedCollection : public WeightedCollection<T> {
 
   bool Init(const std::vector<std::pair<T, float>>& id_weight_pairs) override;
 
+  // Restore a collection with the alias table built before
+  bool Init(const std::vector<T>& ids, const std::vector<float>& weights,
+            const AliasMethod& alias);
+
   std::pair<T, float> Sample() const override;
 
   size_t GetSize() const override;
@@ -44,6 +48,8 @@ class FastWeightedCollection : public WeightedCollection<T> {
 
   const std::vector<float> &GetWeights() const;
 
+  const AliasMethod &GetAlias() const;
+
  private:
   std::vector<T> ids_;
   std::vector<float> weights_;
@@ -92,6 +98,23 @@ bool FastWeightedCollection<T>::Init(
   return true;
 }
 
+template<class T>
+bool FastWeightedCollection<T>::Init(const std::vector<T>& ids,
+                                     const std::vector<float>& weights,
+                                     const AliasMethod& alias) {
+  if (ids.size() != weights.size() || alias.GetSize() != ids.size()) {
+    return false;
+  }
+  ids_ = ids;
+  weights_ = weights;
+  sum_weight_ = 0.0;
+  for (size_t i = 0; i < weights.size(); i++) {
+    sum_weight_ += weights[i];
+  }
+  alias_ = alias;
+  return true;
+}
+
 template<class T>
 std::pair<T, float> FastWeightedCollection<T>::Sample() const {
   int64_t column = alias_.Next();
@@ -129,6 +152,11 @@ template<class T>
 const std::vector<float> &FastWeightedCollection<T>::GetWeights() const {
   return weights_;
 }
+
+template<class T>
+const AliasMethod &FastWeightedCollection<T>::GetAlias() const {
+  return alias_;
+}
 }  // namespace common
 }  // namespace euler
 
@@ -0,0 +1,176 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_COMMON_FLAT_VECTOR_H_
+#define EULER_COMMON_FLAT_VECTOR_H_
+
+#include <stddef.h>
+
+#include <vector>
+#include <utility>
+
+namespace euler {
+namespace common {
+
+// A contiguous array of trivially copyable values which either owns its
+// memory or borrows read only memory owned by others, e.g. a memory mapped
+// file. Borrowed values are copied into owned memory on the first write.
+template <class T>
+class FlatVector {
+ public:
+  typedef T value_type;
+  typedef const T* const_iterator;
+
+  FlatVector() : data_(nullptr), size_(0), borrowed_(false) { }
+
+  FlatVector(const FlatVector& other)
+      : owned_(other.owned_), data_(other.data_),
+        size_(other.size_), borrowed_(other.borrowed_) {
+    if (!borrowed_) {
+      Sync();
+    }
+  }
+
+  FlatVector(FlatVector&& other) noexcept
+      : owned_(std::move(other.owned_)), data_(other.data_),
+        size_(other.size_), borrowed_(other.borrowed_) {
+    if (!borrowed_) {
+      Sync();
+    }
+    other.Reset();
+  }
+
+  FlatVector& operator=(const FlatVector& other) {
+    if (this != &other) {
+      owned_ = other.owned_;
+      data_ = other.data_;
+      size_ = other.size_;
+      borrowed_ = other.borrowed_;
+      if (!borrowed_) {
+        Sync();
+      }
+    }
+    return *this;
+  }
+
+  FlatVector& operator=(FlatVector&& other) noexcept {
+    if (this != &other) {
+      owned_ = std::move(other.owned_);
+      data_ = other.data_;
+      size_ = other.size_;
+      borrowed_ = other.borrowed_;
+      if (!borrowed_) {
+        Sync();
+      }
+      other.Reset();
+    }
+    return *this;
+  }
+
+  // Refer to size values at data, the memory must outlive this object
+  void Borrow(const T* data, size_t size) {
+    std::vector<T>().swap(owned_);
+    data_ = data;
+    size_ = size;
+    borrowed_ = true;
+  }
+
+  bool borrowed() const { return borrowed_; }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const T* data() const { return data_; }
+
+  const T& operator[](size_t i) const { return data_[i]; }
+
+  const T& back() const { return data_[size_ - 1]; }
+
+  const_iterator begin() const { return data_; }
+
+  const_iterator end() const { return data_ + size_; }
+
+  T* mutable_data() {
+    Own();
+    return owned_.data();
+  }
+
+  void push_back(const T& value) {
+    Own();
+    owned_.push_back(value);
+    Sync();
+  }
+
+  template <class Iter>
+  void append(Iter first, Iter last) {
+    Own();
+    owned_.insert(owned_.end(), first, last);
+    Sync();
+  }
+
+  void resize(size_t size, const T& value = T()) {
+    Own();
+    owned_.resize(size, value);
+    Sync();
+  }
+
+  void assign(size_t size, const T& value) {
+    Reset();
+    owned_.assign(size, value);
+    Sync();
+  }
+
+  void reserve(size_t size) {
+    Own();
+    owned_.reserve(size);
+    Sync();
+  }
+
+  void clear() {
+    Reset();
+  }
+
+ private:
+  void Own() {
+    if (borrowed_) {
+      owned_.assign(data_, data_ + size_);
+      borrowed_ = false;
+      Sync();
+    }
+  }
+
+  void Sync() {
+    data_ = owned_.data();
+    size_ = owned_.size();
+  }
+
+  void Reset() {
+    std::vector<T>().swap(owned_);
+    data_ = nullptr;
+    size_ = 0;
+    borrowed_ = false;
+  }
+
+  std::vector<T> owned_;
+  const T* data_;
+  size_t size_;
+  bool borrowed_;
+};
+
+}  // namespace common
+}  // namespace euler
+
+#endif  // EULER_COMMON_FLAT_VECTOR_H_
@@ -0,0 +1,365 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/id_bitmap.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define EULER_X86_KERNELS
+#endif
+
+namespace euler {
+
+namespace {
+
+enum BitsetOp { kAnd, kOr, kAndNot };
+
+template <BitsetOp op>
+inline uint64_t Apply(uint64_t a, uint64_t b) {
+  return op == kAnd ? a & b : op == kOr ? a | b : a & ~b;
+}
+
+template <BitsetOp op>
+inline uint32_t CombineLoop(const uint64_t* a, const uint64_t* b,
+                            uint64_t* out) {
+  for (uint32_t w = 0; w < IdBitmap::kWords; ++w) {
+    out[w] = Apply<op>(a[w], b[w]);
+  }
+  uint32_t card = 0;
+  for (uint32_t w = 0; w < IdBitmap::kWords; ++w) {
+    card += __builtin_popcountll(out[w]);
+  }
+  return card;
+}
+
+typedef uint32_t (*CombineKernel)(BitsetOp, const uint64_t*,
+                                  const uint64_t*, uint64_t*);
+
+uint32_t CombineScalar(BitsetOp op, const uint64_t* a, const uint64_t* b,
+                       uint64_t* out) {
+  switch (op) {
+    case kAnd: return CombineLoop<kAnd>(a, b, out);
+    case kOr: return CombineLoop<kOr>(a, b, out);
+    default: return CombineLoop<kAndNot>(a, b, out);
+  }
+}
+
+#ifdef EULER_X86_KERNELS
+
+// The same loops with the popcnt instruction, the cardinality of a bitset
+// otherwise costs a libgcc call per word
+__attribute__((target("popcnt")))
+uint32_t CombinePopcnt(BitsetOp op, const uint64_t* a, const uint64_t* b,
+                       uint64_t* out) {
+  switch (op) {
+    case kAnd: return CombineLoop<kAnd>(a, b, out);
+    case kOr: return CombineLoop<kOr>(a, b, out);
+    default: return CombineLoop<kAndNot>(a, b, out);
+  }
+}
+
+#endif  // EULER_X86_KERNELS
+
+CombineKernel GetCombineKernel() {
+#ifdef EULER_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("popcnt")) {
+    return CombinePopcnt;
+  }
+#endif
+  return CombineScalar;
+}
+
+uint32_t Combine(BitsetOp op, const uint64_t* a, const uint64_t* b,
+                 uint64_t* out) {
+  static const CombineKernel kernel = GetCombineKernel();
+  return kernel(op, a, b, out);
+}
+
+inline bool TestBit(const uint64_t* words, uint16_t value) {
+  return (words[value >> 6] >> (value & 63)) & 1;
+}
+
+// Intersect the sorted arrays, a short array is searched in a long one
+// instead of scanning it
+uint32_t IntersectArrays(const uint16_t* a, uint32_t na,
+                         const uint16_t* b, uint32_t nb, uint16_t* out) {
+  if (na > nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  uint16_t* cur = out;
+  if (na * 32 < nb) {
+    const uint16_t* pos = b;
+    const uint16_t* end = b + nb;
+    for (uint32_t i = 0; i < na && pos != end; ++i) {
+      pos = std::lower_bound(pos, end, a[i]);
+      if (pos != end && *pos == a[i]) {
+        *cur++ = a[i];
+      }
+    }
+  } else {
+    cur = std::set_intersection(a, a + na, b, b + nb, cur);
+  }
+  return cur - out;
+}
+
+}  // namespace
+
+const uint32_t IdBitmap::kArrayMax;
+const uint32_t IdBitmap::kWords;
+
+IdBitmap IdBitmap::FromSorted(const uint64_t* ids, size_t num) {
+  IdBitmap bitmap;
+  std::vector<uint16_t> values;
+  size_t i = 0;
+  while (i < num) {
+    uint64_t key = ids[i] >> 16;
+    values.clear();
+    for (; i < num && (ids[i] >> 16) == key; ++i) {
+      values.push_back(static_cast<uint16_t>(ids[i]));
+    }
+    bitmap.AppendArray(key, values.data(), values.size());
+  }
+  return bitmap;
+}
+
+IdBitmap IdBitmap::FromIds(std::vector<uint64_t> ids) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  return FromSorted(ids.data(), ids.size());
+}
+
+bool IdBitmap::Contains(uint64_t id) const {
+  uint64_t key = id >> 16;
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+  if (it == keys_.end() || *it != key) {
+    return false;
+  }
+  const Container& c = containers_[it - keys_.begin()];
+  uint16_t value = static_cast<uint16_t>(id);
+  if (IsBitset(c)) {
+    return TestBit(bitset(c), value);
+  }
+  return std::binary_search(array(c), array(c) + c.card, value);
+}
+
+void IdBitmap::AppendArray(uint64_t key, const uint16_t* values,
+                           uint32_t num) {
+  if (num == 0) {
+    return;
+  }
+  if (num > kArrayMax) {
+    std::vector<uint64_t> words(kWords, 0);
+    for (uint32_t i = 0; i < num; ++i) {
+      words[values[i] >> 6] |= 1ull << (values[i] & 63);
+    }
+    AppendBitset(key, words.data(), num);
+    return;
+  }
+  keys_.push_back(key);
+  containers_.push_back(Container{static_cast<uint32_t>(arrays_.size()),
+                                  num});
+  arrays_.insert(arrays_.end(), values, values + num);
+  size_ += num;
+}
+
+void IdBitmap::AppendBitset(uint64_t key, const uint64_t* words,
+                            uint32_t card) {
+  if (card == 0) {
+    return;
+  }
+  if (card <= kArrayMax) {
+    keys_.push_back(key);
+    containers_.push_back(Container{static_cast<uint32_t>(arrays_.size()),
+                                    card});
+    for (uint32_t w = 0; w < kWords; ++w) {
+      for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+        arrays_.push_back(w * 64 + __builtin_ctzll(bits));
+      }
+    }
+  } else {
+    keys_.push_back(key);
+    containers_.push_back(Container{static_cast<uint32_t>(bitsets_.size()),
+                                    card});
+    bitsets_.insert(bitsets_.end(), words, words + kWords);
+  }
+  size_ += card;
+}
+
+void IdBitmap::AppendCopy(const IdBitmap& from, size_t i) {
+  const Container& c = from.containers_[i];
+  if (IsBitset(c)) {
+    AppendBitset(from.keys_[i], from.bitset(c), c.card);
+  } else {
+    AppendArray(from.keys_[i], from.array(c), c.card);
+  }
+}
+
+IdBitmap IdBitmap::And(const IdBitmap& other) const {
+  IdBitmap result;
+  std::vector<uint64_t> words(kWords);
+  std::vector<uint16_t> values(kArrayMax);
+  size_t i = 0, j = 0;
+  while (i < keys_.size() && j < other.keys_.size()) {
+    if (keys_[i] < other.keys_[j]) {
+      ++i;
+      continue;
+    }
+    if (other.keys_[j] < keys_[i]) {
+      ++j;
+      continue;
+    }
+    const Container& a = containers_[i];
+    const Container& b = other.containers_[j];
+    if (IsBitset(a) && IsBitset(b)) {
+      uint32_t card = Combine(kAnd, bitset(a), other.bitset(b), words.data());
+      result.AppendBitset(keys_[i], words.data(), card);
+    } else if (IsBitset(a) || IsBitset(b)) {
+      const uint64_t* bits = IsBitset(a) ? bitset(a) : other.bitset(b);
+      const uint16_t* probe = IsBitset(a) ? other.array(b) : array(a);
+      uint32_t num = IsBitset(a) ? b.card : a.card;
+      uint32_t card = 0;
+      for (uint32_t k = 0; k < num; ++k) {
+        values[card] = probe[k];
+        card += TestBit(bits, probe[k]);
+      }
+      result.AppendArray(keys_[i], values.data(), card);
+    } else {
+      uint32_t card = IntersectArrays(array(a), a.card, other.array(b),
+                                      b.card, values.data());
+      result.AppendArray(keys_[i], values.data(), card);
+    }
+    ++i;
+    ++j;
+  }
+  return result;
+}
+
+IdBitmap IdBitmap::Or(const IdBitmap& other) const {
+  IdBitmap result;
+  std::vector<uint64_t> words(kWords);
+  std::vector<uint16_t> values(kArrayMax * 2);
+  size_t i = 0, j = 0;
+  while (i < keys_.size() || j < other.keys_.size()) {
+    if (j == other.keys_.size() ||
+        (i < keys_.size() && keys_[i] < other.keys_[j])) {
+      result.AppendCopy(*this, i++);
+      continue;
+    }
+    if (i == keys_.size() || other.keys_[j] < keys_[i]) {
+      result.AppendCopy(other, j++);
+      continue;
+    }
+    const Container& a = containers_[i];
+    const Container& b = other.containers_[j];
+    if (IsBitset(a) && IsBitset(b)) {
+      uint32_t card = Combine(kOr, bitset(a), other.bitset(b), words.data());
+      result.AppendBitset(keys_[i], words.data(), card);
+    } else if (IsBitset(a) || IsBitset(b)) {
+      const Container& dense = IsBitset(a) ? a : b;
+      const uint16_t* probe = IsBitset(a) ? other.array(b) : array(a);
+      uint32_t num = IsBitset(a) ? b.card : a.card;
+      memcpy(words.data(), IsBitset(a) ? bitset(a) : other.bitset(b),
+             kWords * sizeof(uint64_t));
+      uint32_t card = dense.card;
+      for (uint32_t k = 0; k < num; ++k) {
+        uint64_t bit = 1ull << (probe[k] & 63);
+        uint64_t& word = words[probe[k] >> 6];
+        card += (word & bit) == 0;
+        word |= bit;
+      }
+      result.AppendBitset(keys_[i], words.data(), card);
+    } else {
+      uint16_t* end = std::set_union(array(a), array(a) + a.card,
+                                     other.array(b),
+                                     other.array(b) + b.card, values.data());
+      result.AppendArray(keys_[i], values.data(), end - values.data());
+    }
+    ++i;
+    ++j;
+  }
+  return result;
+}
+
+IdBitmap IdBitmap::AndNot(const IdBitmap& other) const {
+  IdBitmap result;
+  std::vector<uint64_t> words(kWords);
+  std::vector<uint16_t> values(kArrayMax);
+  size_t j = 0;
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    while (j < other.keys_.size() && other.keys_[j] < keys_[i]) {
+      ++j;
+    }
+    if (j == other.keys_.size() || other.keys_[j] != keys_[i]) {
+      result.AppendCopy(*this, i);
+      continue;
+    }
+    const Container& a = containers_[i];
+    const Container& b = other.containers_[j];
+    if (IsBitset(a) && IsBitset(b)) {
+      uint32_t card = Combine(kAndNot, bitset(a), other.bitset(b),
+                              words.data());
+      result.AppendBitset(keys_[i], words.data(), card);
+    } else if (IsBitset(a)) {
+      memcpy(words.data(), bitset(a), kWords * sizeof(uint64_t));
+      uint32_t card = a.card;
+      const uint16_t* probe = other.array(b);
+      for (uint32_t k = 0; k < b.card; ++k) {
+        uint64_t bit = 1ull << (probe[k] & 63);
+        uint64_t& word = words[probe[k] >> 6];
+        card -= (word & bit) != 0;
+        word &= ~bit;
+      }
+      result.AppendBitset(keys_[i], words.data(), card);
+    } else if (IsBitset(b)) {
+      const uint64_t* bits = other.bitset(b);
+      const uint16_t* probe = array(a);
+      uint32_t card = 0;
+      for (uint32_t k = 0; k < a.card; ++k) {
+        values[card] = probe[k];
+        card += !TestBit(bits, probe[k]);
+      }
+      result.AppendArray(keys_[i], values.data(), card);
+    } else {
+      uint16_t* end = std::set_difference(array(a), array(a) + a.card,
+                                          other.array(b),
+                                          other.array(b) + b.card,
+                                          values.data());
+      result.AppendArray(keys_[i], values.data(), end - values.data());
+    }
+  }
+  return result;
+}
+
+std::vector<uint64_t> IdBitmap::ToIds() const {
+  std::vector<uint64_t> ids;
+  ids.reserve(size_);
+  ForEach([&ids] (uint64_t id) { ids.push_back(id); });
+  return ids;
+}
+
+size_t IdBitmap::MemoryBytes() const {
+  return keys_.capacity() * sizeof(uint64_t) +
+      containers_.capacity() * sizeof(Container) +
+      arrays_.capacity() * sizeof(uint16_t) +
+      bitsets_.capacity() * sizeof(uint64_t);
+}
+
+}  // namespace euler
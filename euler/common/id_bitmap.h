@@ -0,0 +1,123 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_COMMON_ID_BITMAP_H_
+#define EULER_COMMON_ID_BITMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace euler {
+
+// A compressed bitmap of 64 bits ids in the layout of Roaring bitmaps: the
+// ids are grouped into chunks of 2^16 by their high 48 bits, a chunk of at
+// most kArrayMax ids keeps its sorted low 16 bits, a denser one a bitset of
+// 1024 words. The chunks of all the containers are stored in two flat
+// pools, so the dense ids of a shard cost about 2 bytes or 1 bit each and
+// the sparse ones, e.g. the hashed edge ids, 18 bytes each.
+//
+// The set operations merge the chunks by their keys, the bitset chunks are
+// combined word by word in loops the compiler vectorizes.
+class IdBitmap {
+ public:
+  IdBitmap(): size_(0) { }
+
+  // The ids must be sorted and unique
+  static IdBitmap FromSorted(const uint64_t* ids, size_t num);
+
+  // The ids are in any order, the duplicates are dropped
+  static IdBitmap FromIds(std::vector<uint64_t> ids);
+
+  bool Contains(uint64_t id) const;
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  IdBitmap And(const IdBitmap& other) const;
+
+  IdBitmap Or(const IdBitmap& other) const;
+
+  IdBitmap AndNot(const IdBitmap& other) const;
+
+  // Call f with the ids in ascending order
+  template <typename F>
+  void ForEach(F f) const;
+
+  // The ids in ascending order
+  std::vector<uint64_t> ToIds() const;
+
+  size_t MemoryBytes() const;
+
+  static const uint32_t kArrayMax = 4096;
+  static const uint32_t kWords = 1024;
+
+ private:
+  struct Container {
+    uint32_t offset;  // Into arrays_ or bitsets_
+    uint32_t card;
+  };
+
+  static bool IsBitset(const Container& c) { return c.card > kArrayMax; }
+
+  const uint16_t* array(const Container& c) const {
+    return arrays_.data() + c.offset;
+  }
+
+  const uint64_t* bitset(const Container& c) const {
+    return bitsets_.data() + c.offset;
+  }
+
+  // Append a chunk of ascending keys, the chunk is stored as a bitset if it
+  // has more than kArrayMax values, and dropped if empty
+  void AppendArray(uint64_t key, const uint16_t* values, uint32_t num);
+
+  void AppendBitset(uint64_t key, const uint64_t* words, uint32_t card);
+
+  void AppendCopy(const IdBitmap& from, size_t i);
+
+  std::vector<uint64_t> keys_;
+  std::vector<Container> containers_;
+  std::vector<uint16_t> arrays_;
+  std::vector<uint64_t> bitsets_;
+  size_t size_;
+};
+
+template <typename F>
+void IdBitmap::ForEach(F f) const {
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    uint64_t high = keys_[i] << 16;
+    const Container& c = containers_[i];
+    if (IsBitset(c)) {
+      const uint64_t* words = bitset(c);
+      for (uint32_t w = 0; w < kWords; ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+          f(high | (w * 64 + __builtin_ctzll(bits)));
+        }
+      }
+    } else {
+      const uint16_t* values = array(c);
+      for (uint32_t j = 0; j < c.card; ++j) {
+        f(high | values[j]);
+      }
+    }
+  }
+}
+
+}  // namespace euler
+
+#endif  // EULER_COMMON_ID_BITMAP_H_
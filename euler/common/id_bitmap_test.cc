@@ -0,0 +1,126 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/id_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace euler {
+
+namespace {
+
+// Dense ids in chunk 0, medium ones in chunk 1, and sparse hashed ids
+std::vector<uint64_t> RandomIds(std::mt19937_64* rng, double dense) {
+  std::vector<uint64_t> ids;
+  std::bernoulli_distribution coin(dense);
+  for (uint64_t id = 0; id < 65536; ++id) {
+    if (coin(*rng)) {
+      ids.push_back(id);
+    }
+  }
+  for (uint64_t id = 65536; id < 65536 * 2; id += 7) {
+    if (coin(*rng)) {
+      ids.push_back(id);
+    }
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ids.push_back((*rng)() % 64 * 1000003 + (*rng)() % 3 * (1ull << 40));
+  }
+  return ids;
+}
+
+std::vector<uint64_t> Sorted(std::vector<uint64_t> ids) {
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  return ids;
+}
+
+}  // namespace
+
+TEST(IdBitmapTest, Build) {
+  std::vector<uint64_t> ids = {5, 1ull << 50, 3, 70000, 5, 3, 0};
+  IdBitmap bitmap = IdBitmap::FromIds(ids);
+  ASSERT_EQ(5, bitmap.size());
+  ASSERT_EQ(std::vector<uint64_t>({0, 3, 5, 70000, 1ull << 50}),
+            bitmap.ToIds());
+  ASSERT_TRUE(bitmap.Contains(0));
+  ASSERT_TRUE(bitmap.Contains(70000));
+  ASSERT_TRUE(bitmap.Contains(1ull << 50));
+  ASSERT_FALSE(bitmap.Contains(4));
+  ASSERT_FALSE(bitmap.Contains(70001));
+  ASSERT_FALSE(bitmap.Contains((1ull << 50) + 1));
+  ASSERT_TRUE(IdBitmap().empty());
+  ASSERT_FALSE(IdBitmap().Contains(0));
+
+  // A full chunk is a bitset of 8KB
+  std::vector<uint64_t> dense(65536);
+  for (uint64_t i = 0; i < dense.size(); ++i) {
+    dense[i] = (3ull << 16) + i;
+  }
+  IdBitmap full = IdBitmap::FromSorted(dense.data(), dense.size());
+  ASSERT_EQ(65536, full.size());
+  ASSERT_GE(8192 + 100, full.MemoryBytes());
+  ASSERT_EQ(dense, full.ToIds());
+  ASSERT_TRUE(full.Contains(3ull << 16));
+  ASSERT_FALSE(full.Contains(4ull << 16));
+}
+
+TEST(IdBitmapTest, SetOperations) {
+  // All the pairs of array and bitset chunks against std::set_*
+  std::mt19937_64 rng(7);
+  for (double da : {0.01, 0.5}) {
+    for (double db : {0.001, 0.05, 0.9}) {
+      std::vector<uint64_t> a = Sorted(RandomIds(&rng, da));
+      std::vector<uint64_t> b = Sorted(RandomIds(&rng, db));
+      IdBitmap x = IdBitmap::FromIds(a);
+      IdBitmap y = IdBitmap::FromIds(b);
+      ASSERT_EQ(a, x.ToIds());
+
+      std::vector<uint64_t> expected;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                            std::back_inserter(expected));
+      ASSERT_EQ(expected, x.And(y).ToIds());
+      ASSERT_EQ(expected, y.And(x).ToIds());
+      ASSERT_EQ(expected.size(), x.And(y).size());
+
+      expected.clear();
+      std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                     std::back_inserter(expected));
+      ASSERT_EQ(expected, x.Or(y).ToIds());
+      ASSERT_EQ(expected, y.Or(x).ToIds());
+      ASSERT_EQ(expected.size(), x.Or(y).size());
+
+      expected.clear();
+      std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(expected));
+      ASSERT_EQ(expected, x.AndNot(y).ToIds());
+      ASSERT_EQ(expected.size(), x.AndNot(y).size());
+
+      for (uint64_t id : a) {
+        ASSERT_TRUE(x.Contains(id));
+      }
+      for (uint64_t id : expected) {
+        ASSERT_FALSE(y.Contains(id));
+      }
+    }
+  }
+}
+
+}  // namespace euler
@@ -0,0 +1,141 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/id_range_set.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "euler/common/str_util.h"
+
+namespace euler {
+
+IdRangeSet IdRangeSet::Build(std::vector<uint64_t> ids, size_t max_ranges) {
+  IdRangeSet result;
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  if (ids.empty()) {
+    return result;
+  }
+
+  // Cut at the largest gaps
+  size_t num_cuts = std::min(std::max<size_t>(max_ranges, 1) - 1,
+                             ids.size() - 1);
+  std::vector<size_t> cuts(ids.size() - 1);
+  for (size_t i = 0; i < cuts.size(); ++i) {
+    cuts[i] = i;
+  }
+  auto larger_gap = [&ids] (size_t a, size_t b) {
+    return ids[a + 1] - ids[a] > ids[b + 1] - ids[b];
+  };
+  if (num_cuts < cuts.size()) {
+    std::nth_element(cuts.begin(), cuts.begin() + num_cuts, cuts.end(),
+                     larger_gap);
+  }
+  cuts.resize(num_cuts);
+  std::sort(cuts.begin(), cuts.end());
+
+  uint64_t begin = ids[0];
+  for (size_t cut : cuts) {
+    if (ids[cut + 1] - ids[cut] == 1) {  // Adjacent, no need to cut
+      continue;
+    }
+    result.begins_.push_back(begin);
+    result.ends_.push_back(ids[cut]);
+    begin = ids[cut + 1];
+  }
+  result.begins_.push_back(begin);
+  result.ends_.push_back(ids.back());
+  return result;
+}
+
+bool IdRangeSet::Contains(uint64_t id) const {
+  auto it = std::upper_bound(begins_.begin(), begins_.end(), id);
+  if (it == begins_.begin()) {
+    return false;
+  }
+  return id <= ends_[it - begins_.begin() - 1];
+}
+
+std::string IdRangeSet::ToString() const {
+  std::vector<std::string> ranges;
+  ranges.reserve(begins_.size());
+  for (size_t i = 0; i < begins_.size(); ++i) {
+    ranges.push_back(::euler::ToString(begins_[i], "-", ends_[i]));
+  }
+  return Join(ranges, ",");
+}
+
+bool IdRangeSet::FromString(const std::string& str) {
+  begins_.clear();
+  ends_.clear();
+  if (str.empty()) {
+    return true;
+  }
+  for (auto& range : Split(str, ",")) {
+    auto vec = Split(range, "-");
+    if (vec.size() != 2) {
+      return false;
+    }
+    uint64_t begin = strtoull(vec[0].c_str(), nullptr, 10);
+    uint64_t end = strtoull(vec[1].c_str(), nullptr, 10);
+    if (begin > end || (!ends_.empty() && begin <= ends_.back())) {
+      return false;
+    }
+    begins_.push_back(begin);
+    ends_.push_back(end);
+  }
+  return true;
+}
+
+IdRouter::IdRouter(const std::vector<IdRangeSet>& shards) {
+  for (auto& ranges : shards) {
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      bounds_.push_back(ranges.begin(i));
+      if (ranges.end(i) != std::numeric_limits<uint64_t>::max()) {
+        bounds_.push_back(ranges.end(i) + 1);
+      }
+    }
+  }
+  std::sort(bounds_.begin(), bounds_.end());
+  bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+
+  offsets_.reserve(bounds_.size() + 1);
+  offsets_.push_back(0);
+  for (uint64_t bound : bounds_) {
+    for (size_t i = 0; i < shards.size(); ++i) {
+      if (shards[i].Contains(bound)) {
+        shards_.push_back(i);
+      }
+    }
+    offsets_.push_back(shards_.size());
+  }
+}
+
+void IdRouter::Route(uint64_t id, const int32_t** begin,
+                     const int32_t** end) const {
+  auto it = std::upper_bound(bounds_.begin(), bounds_.end(), id);
+  if (it == bounds_.begin()) {
+    *begin = *end = nullptr;
+    return;
+  }
+  size_t segment = it - bounds_.begin() - 1;
+  *begin = shards_.data() + offsets_[segment];
+  *end = shards_.data() + offsets_[segment + 1];
+}
+
+}  // namespace euler
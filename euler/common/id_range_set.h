@@ -0,0 +1,76 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_COMMON_ID_RANGE_SET_H_
+#define EULER_COMMON_ID_RANGE_SET_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace euler {
+
+// A compact superset of a set of ids: at most a given number of sorted
+// disjoint ranges covering all the ids. Each shard publishes the ranges of
+// its nodes in graph_partition mode, so the client routes the ids only to
+// the shards which may own them.
+class IdRangeSet {
+ public:
+  IdRangeSet() { }
+
+  // Cover the ids with at most max_ranges ranges, the largest gaps between
+  // the sorted ids are left out of the ranges
+  static IdRangeSet Build(std::vector<uint64_t> ids, size_t max_ranges);
+
+  bool Contains(uint64_t id) const;
+
+  size_t size() const { return begins_.size(); }
+
+  uint64_t begin(size_t i) const { return begins_[i]; }
+
+  // Inclusive
+  uint64_t end(size_t i) const { return ends_[i]; }
+
+  // Format: "begin-end,begin-end"
+  std::string ToString() const;
+
+  bool FromString(const std::string& str);
+
+ private:
+  std::vector<uint64_t> begins_;
+  std::vector<uint64_t> ends_;
+};
+
+// Route the ids to the shards whose ranges contain them. The ranges of all
+// the shards are merged into one directory of segments, so an id is routed
+// by one binary search whatever the number of shards is.
+class IdRouter {
+ public:
+  explicit IdRouter(const std::vector<IdRangeSet>& shards);
+
+  // Set [begin, end) to the shards which may own the id, in ascending order
+  void Route(uint64_t id, const int32_t** begin, const int32_t** end) const;
+
+ private:
+  std::vector<uint64_t> bounds_;  // Segment i is [bounds_[i], bounds_[i+1])
+  // The shards of segment i are shards_[offsets_[i], offsets_[i+1])
+  std::vector<int32_t> offsets_;
+  std::vector<int32_t> shards_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_COMMON_ID_RANGE_SET_H_
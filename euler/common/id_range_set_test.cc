@@ -0,0 +1,95 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/id_range_set.h"
+
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace euler {
+
+TEST(IdRangeSetTest, Build) {
+  std::vector<uint64_t> ids = {105, 1, 2, 3, 100, 101, 1000, 3, 104};
+  auto ranges = IdRangeSet::Build(ids, 3);
+  ASSERT_EQ(3u, ranges.size());
+  ASSERT_EQ("1-3,100-105,1000-1000", ranges.ToString());
+  for (auto id : ids) {
+    ASSERT_TRUE(ranges.Contains(id));
+  }
+  ASSERT_TRUE(ranges.Contains(102));  // Covered by the range
+  ASSERT_FALSE(ranges.Contains(0));
+  ASSERT_FALSE(ranges.Contains(4));
+  ASSERT_FALSE(ranges.Contains(999));
+  ASSERT_FALSE(ranges.Contains(1001));
+
+  ranges = IdRangeSet::Build(ids, 1);
+  ASSERT_EQ("1-1000", ranges.ToString());
+
+  // Adjacent ids are never cut
+  ranges = IdRangeSet::Build({1, 2, 3, 4}, 10);
+  ASSERT_EQ("1-4", ranges.ToString());
+
+  ranges = IdRangeSet::Build({}, 10);
+  ASSERT_EQ(0u, ranges.size());
+  ASSERT_FALSE(ranges.Contains(0));
+}
+
+TEST(IdRangeSetTest, FromString) {
+  IdRangeSet ranges;
+  ASSERT_TRUE(ranges.FromString("1-3,100-105,1000-1000"));
+  ASSERT_EQ(3u, ranges.size());
+  ASSERT_EQ("1-3,100-105,1000-1000", ranges.ToString());
+  ASSERT_TRUE(ranges.FromString(""));
+  ASSERT_EQ(0u, ranges.size());
+  ASSERT_FALSE(ranges.FromString("1-3,2-5"));
+  ASSERT_FALSE(ranges.FromString("3-1"));
+  ASSERT_FALSE(ranges.FromString("abc"));
+}
+
+TEST(IdRouterTest, Route) {
+  std::vector<IdRangeSet> shards(3);
+  ASSERT_TRUE(shards[0].FromString("0-9,20-29"));
+  ASSERT_TRUE(shards[1].FromString("10-25"));
+  ASSERT_TRUE(shards[2].FromString(
+      "100-" + std::to_string(std::numeric_limits<uint64_t>::max())));
+  IdRouter router(shards);
+
+  auto route = [&router] (uint64_t id) {
+    const int32_t* begin = nullptr;
+    const int32_t* end = nullptr;
+    router.Route(id, &begin, &end);
+    return std::vector<int32_t>(begin, end);
+  };
+  ASSERT_EQ(std::vector<int32_t>({0}), route(0));
+  ASSERT_EQ(std::vector<int32_t>({0}), route(9));
+  ASSERT_EQ(std::vector<int32_t>({1}), route(10));
+  ASSERT_EQ(std::vector<int32_t>({0, 1}), route(20));
+  ASSERT_EQ(std::vector<int32_t>({0, 1}), route(25));
+  ASSERT_EQ(std::vector<int32_t>({0}), route(26));
+  ASSERT_EQ(std::vector<int32_t>(), route(30));
+  ASSERT_EQ(std::vector<int32_t>({2}), route(100));
+  ASSERT_EQ(std::vector<int32_t>({2}),
+            route(std::numeric_limits<uint64_t>::max()));
+
+  IdRouter empty({});
+  const int32_t* begin = nullptr;
+  const int32_t* end = nullptr;
+  empty.Route(1, &begin, &end);
+  ASSERT_EQ(begin, end);
+}
+
+}  // namespace euler
@@ -0,0 +1,263 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/quantization.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define EULER_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace euler {
+namespace common {
+
+namespace {
+
+typedef void (*HalfToFloatKernel)(const uint16_t*, size_t, float*);
+typedef void (*Int8ToFloatKernel)(const int8_t*, size_t, float, float,
+                                  float*);
+
+void HalfToFloatScalar(const uint16_t* src, size_t num, float* dst) {
+  for (size_t i = 0; i < num; ++i) {
+    dst[i] = HalfToFloat(src[i]);
+  }
+}
+
+void Int8ToFloatScalar(const int8_t* src, size_t num, float scale,
+                       float offset, float* dst) {
+  for (size_t i = 0; i < num; ++i) {
+    dst[i] = src[i] * scale + offset;
+  }
+}
+
+#ifdef EULER_X86_KERNELS
+
+// The kernels are compiled for their instruction sets with the target
+// attribute, so the library itself still runs on any x86-64 cpu. The tails
+// shorter than a vector go through a buffer instead of the scalar code, and
+// the upper halves of the registers are cleared before returning, otherwise
+// the SSE code of the caller stalls on every call for the short rows.
+
+__attribute__((target("avx2,f16c,fma")))
+void HalfToFloatAvx2(const uint16_t* src, size_t num, float* dst) {
+  size_t i = 0;
+  for (; i + 8 <= num; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  if (i < num) {
+    uint16_t h[8] = {0};
+    float f[8];
+    for (size_t j = i; j < num; ++j) {
+      h[j - i] = src[j];
+    }
+    _mm256_storeu_ps(f, _mm256_cvtph_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(h))));
+    for (size_t j = i; j < num; ++j) {
+      dst[j] = f[j - i];
+    }
+  }
+  _mm256_zeroupper();
+}
+
+__attribute__((target("avx2,f16c,fma")))
+void Int8ToFloatAvx2(const int8_t* src, size_t num, float scale,
+                     float offset, float* dst) {
+  __m256 s = _mm256_set1_ps(scale);
+  __m256 o = _mm256_set1_ps(offset);
+  size_t i = 0;
+  for (; i + 8 <= num; i += 8) {
+    __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+    __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q));
+    _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(f, s, o));
+  }
+  if (i < num) {
+    int8_t q[8] = {0};
+    float f[8];
+    for (size_t j = i; j < num; ++j) {
+      q[j - i] = src[j];
+    }
+    __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(q))));
+    _mm256_storeu_ps(f, _mm256_fmadd_ps(v, s, o));
+    for (size_t j = i; j < num; ++j) {
+      dst[j] = f[j - i];
+    }
+  }
+  _mm256_zeroupper();
+}
+
+__attribute__((target("avx512f")))
+void HalfToFloatAvx512(const uint16_t* src, size_t num, float* dst) {
+  size_t i = 0;
+  for (; i + 16 <= num; i += 16) {
+    __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h));
+  }
+  HalfToFloatAvx2(src + i, num - i, dst + i);
+}
+
+__attribute__((target("avx512f")))
+void Int8ToFloatAvx512(const int8_t* src, size_t num, float scale,
+                       float offset, float* dst) {
+  __m512 s = _mm512_set1_ps(scale);
+  __m512 o = _mm512_set1_ps(offset);
+  size_t i = 0;
+  for (; i + 16 <= num; i += 16) {
+    __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m512 f = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(q));
+    _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(f, s, o));
+  }
+  Int8ToFloatAvx2(src + i, num - i, scale, offset, dst + i);
+}
+
+#endif  // EULER_X86_KERNELS
+
+SimdLevel UsableLevel(SimdLevel level) {
+  return std::min(level, SupportedSimdLevel());
+}
+
+HalfToFloatKernel GetHalfToFloatKernel(SimdLevel level) {
+#ifdef EULER_X86_KERNELS
+  switch (UsableLevel(level)) {
+    case kAvx512: return HalfToFloatAvx512;
+    case kAvx2: return HalfToFloatAvx2;
+    default: break;
+  }
+#endif
+  return HalfToFloatScalar;
+}
+
+Int8ToFloatKernel GetInt8ToFloatKernel(SimdLevel level) {
+#ifdef EULER_X86_KERNELS
+  switch (UsableLevel(level)) {
+    case kAvx512: return Int8ToFloatAvx512;
+    case kAvx2: return Int8ToFloatAvx2;
+    default: break;
+  }
+#endif
+  return Int8ToFloatScalar;
+}
+
+}  // namespace
+
+uint16_t FloatToHalf(float value) {
+  uint32_t x;
+  memcpy(&x, &value, sizeof(x));
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t abs = x & 0x7fffffff;
+  if (abs >= 0x7f800000) {  // inf or nan, nan stays quiet
+    return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+  }
+  if (abs >= 0x477ff000) {  // 65520 and larger round to inf
+    return sign | 0x7c00;
+  }
+  if (abs < 0x38800000) {  // below 2^-14, subnormal half or zero
+    uint32_t exponent = abs >> 23;
+    if (exponent < 102) {  // below 2^-25, rounds to zero
+      return sign;
+    }
+    // The value is mantissa * 2^(exponent - 150), in units of 2^-24
+    uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+    uint32_t shift = 126 - exponent;
+    uint32_t h = mantissa >> shift;
+    uint32_t rest = mantissa & ((1u << shift) - 1);
+    uint32_t half = 1u << (shift - 1);
+    if (rest > half || (rest == half && (h & 1))) {
+      ++h;
+    }
+    return sign | h;
+  }
+  // Rebias the exponent from 127 to 15, a carry of the rounding goes into
+  // the exponent
+  uint32_t h = (abs >> 13) - (112 << 10);
+  uint32_t rest = abs & 0x1fff;
+  if (rest > 0x1000 || (rest == 0x1000 && (h & 1))) {
+    ++h;
+  }
+  return sign | h;
+}
+
+float HalfToFloat(uint16_t value) {
+  uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+  uint32_t exponent = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+  uint32_t x;
+  if (exponent == 0) {
+    float f = mantissa * (1.0f / (1 << 24));  // exact
+    memcpy(&x, &f, sizeof(x));
+    x |= sign;
+  } else if (exponent == 0x1f) {
+    x = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  float result;
+  memcpy(&result, &x, sizeof(result));
+  return result;
+}
+
+void FloatToHalf(const float* src, size_t num, uint16_t* dst) {
+  for (size_t i = 0; i < num; ++i) {
+    dst[i] = FloatToHalf(src[i]);
+  }
+}
+
+void HalfToFloat(const uint16_t* src, size_t num, float* dst) {
+  static const HalfToFloatKernel kernel =
+      GetHalfToFloatKernel(SupportedSimdLevel());
+  kernel(src, num, dst);
+}
+
+void HalfToFloat(const uint16_t* src, size_t num, float* dst,
+                 SimdLevel level) {
+  GetHalfToFloatKernel(level)(src, num, dst);
+}
+
+void Int8Params(float min, float max, float* scale, float* offset) {
+  *offset = min / 2 + max / 2;
+  *scale = (max - min) / 254;
+  if (!(*scale > 0) || std::isinf(*scale)) {
+    *scale = 1;
+  }
+}
+
+void FloatToInt8(const float* src, size_t num, float scale, float offset,
+                 int8_t* dst) {
+  for (size_t i = 0; i < num; ++i) {
+    float q = std::nearbyint((src[i] - offset) / scale);
+    dst[i] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+  }
+}
+
+void Int8ToFloat(const int8_t* src, size_t num, float scale, float offset,
+                 float* dst) {
+  static const Int8ToFloatKernel kernel =
+      GetInt8ToFloatKernel(SupportedSimdLevel());
+  kernel(src, num, scale, offset, dst);
+}
+
+void Int8ToFloat(const int8_t* src, size_t num, float scale, float offset,
+                 float* dst, SimdLevel level) {
+  GetInt8ToFloatKernel(level)(src, num, scale, offset, dst);
+}
+
+}  // namespace common
+}  // namespace euler
@@ -0,0 +1,57 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_COMMON_QUANTIZATION_H_
+#define EULER_COMMON_QUANTIZATION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "euler/common/cpu_info.h"
+
+namespace euler {
+namespace common {
+
+// IEEE 754 half precision, rounded to the nearest even
+uint16_t FloatToHalf(float value);
+
+float HalfToFloat(uint16_t value);
+
+void FloatToHalf(const float* src, size_t num, uint16_t* dst);
+
+void HalfToFloat(const uint16_t* src, size_t num, float* dst);
+
+// Same as above with the kernel of level, or the best supported one if
+// level is not supported
+void HalfToFloat(const uint16_t* src, size_t num, float* dst,
+                 SimdLevel level);
+
+// Affine int8 quantization, value = q * scale + offset with q in
+// [-127, 127]. The parameters map [min, max] of the values onto the range.
+void Int8Params(float min, float max, float* scale, float* offset);
+
+void FloatToInt8(const float* src, size_t num, float scale, float offset,
+                 int8_t* dst);
+
+void Int8ToFloat(const int8_t* src, size_t num, float scale, float offset,
+                 float* dst);
+
+void Int8ToFloat(const int8_t* src, size_t num, float scale, float offset,
+                 float* dst, SimdLevel level);
+
+}  // namespace common
+}  // namespace euler
+
+#endif  // EULER_COMMON_QUANTIZATION_H_
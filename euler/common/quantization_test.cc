@@ -0,0 +1,92 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/quantization.h"
+
+#include <math.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace euler {
+namespace common {
+
+TEST(QuantizationTest, Half) {
+  ASSERT_EQ(0x0000, FloatToHalf(0.0f));
+  ASSERT_EQ(0x8000, FloatToHalf(-0.0f));
+  ASSERT_EQ(0x3c00, FloatToHalf(1.0f));
+  ASSERT_EQ(0xc000, FloatToHalf(-2.0f));
+  ASSERT_EQ(0x7bff, FloatToHalf(65504.0f));
+  ASSERT_EQ(0x7c00, FloatToHalf(65520.0f));
+  ASSERT_EQ(0x0001, FloatToHalf(ldexpf(1.0f, -24)));
+  ASSERT_EQ(0x0400, FloatToHalf(ldexpf(1.0f, -14)));
+  // Ties round to even
+  ASSERT_EQ(0x3c00, FloatToHalf(1.0f + ldexpf(1.0f, -11)));
+  ASSERT_EQ(0x3c02, FloatToHalf(1.0f + 3 * ldexpf(1.0f, -11)));
+  ASSERT_TRUE(isnan(HalfToFloat(FloatToHalf(NAN))));
+
+  // Every half converts back to itself, by all the kernels
+  std::vector<uint16_t> halfs;
+  for (uint32_t h = 0; h < 0x10000; ++h) {
+    if ((h & 0x7c00) != 0x7c00) {
+      halfs.push_back(h);
+    }
+  }
+  for (int level = kScalar; level <= kAvx512; ++level) {
+    std::vector<float> values(halfs.size());
+    HalfToFloat(halfs.data(), halfs.size(), values.data(),
+                static_cast<SimdLevel>(level));
+    for (size_t i = 0; i < halfs.size(); ++i) {
+      ASSERT_EQ(halfs[i], FloatToHalf(values[i]))
+          << SimdLevelName(static_cast<SimdLevel>(level));
+    }
+  }
+}
+
+TEST(QuantizationTest, Int8) {
+  float scale, offset;
+  Int8Params(-1.0f, 3.0f, &scale, &offset);
+  ASSERT_FLOAT_EQ(1.0f, offset);
+  ASSERT_FLOAT_EQ(4.0f / 254, scale);
+
+  std::vector<float> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(-1.0f + 4.0f * i / 999);
+  }
+  std::vector<int8_t> q(values.size());
+  FloatToInt8(values.data(), values.size(), scale, offset, q.data());
+  ASSERT_EQ(-127, q.front());
+  ASSERT_EQ(127, q.back());
+  for (int level = kScalar; level <= kAvx512; ++level) {
+    std::vector<float> result(values.size());
+    Int8ToFloat(q.data(), q.size(), scale, offset, result.data(),
+                static_cast<SimdLevel>(level));
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_NEAR(values[i], result[i], scale / 2 + 1e-6);
+    }
+  }
+
+  // Constant values are exact
+  Int8Params(5.0f, 5.0f, &scale, &offset);
+  float value = 5.0f;
+  int8_t c;
+  FloatToInt8(&value, 1, scale, offset, &c);
+  Int8ToFloat(&c, 1, scale, offset, &value);
+  ASSERT_EQ(5.0f, value);
+}
+
+}  // namespace common
+}  // namespace euler
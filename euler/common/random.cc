@@ -15,16 +15,254 @@ limitations under the License.
 
 #include "euler/common/random.h"
 
+#include <time.h>
+
+#include <atomic>
+#include <random>
+
+#include "euler/common/cpu_info.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define EULER_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace euler {
 namespace common {
 
 namespace {
-  static thread_local std::default_random_engine e(time(0));
-  static thread_local std::uniform_real_distribution<double> u(0., 1.);
+
+const uint32_t kPhiloxM0 = 0xD2511F53;
+const uint32_t kPhiloxM1 = 0xCD9E8D57;
+const uint32_t kPhiloxW0 = 0x9E3779B9;
+const uint32_t kPhiloxW1 = 0xBB67AE85;
+const int kPhiloxLanes = 8;
+
+void PhiloxBlock(const uint32_t* key, uint64_t stream, uint64_t position,
+                 uint32_t* block) {
+  uint32_t c0 = static_cast<uint32_t>(position);
+  uint32_t c1 = static_cast<uint32_t>(position >> 32);
+  uint32_t c2 = static_cast<uint32_t>(stream);
+  uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+  uint32_t k0 = key[0];
+  uint32_t k1 = key[1];
+  for (int round = 0; round < 10; ++round) {
+    uint64_t p0 = static_cast<uint64_t>(kPhiloxM0) * c0;
+    uint64_t p1 = static_cast<uint64_t>(kPhiloxM1) * c2;
+    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(p1);
+    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(p0);
+    k0 += kPhiloxW0;
+    k1 += kPhiloxW1;
+  }
+  block[0] = c0;
+  block[1] = c1;
+  block[2] = c2;
+  block[3] = c3;
+}
+
+// Generate the kPhiloxLanes blocks from position
+typedef void (*PhiloxLanesKernel)(const uint32_t*, uint64_t, uint64_t,
+                                  uint32_t*);
+
+void PhiloxLanesScalar(const uint32_t* key, uint64_t stream,
+                       uint64_t position, uint32_t* blocks) {
+  for (int j = 0; j < kPhiloxLanes; ++j) {
+    PhiloxBlock(key, stream, position + j, blocks + j * 4);
+  }
+}
+
+#ifdef EULER_X86_KERNELS
+
+// The 32x32 bit products of the even and the odd lanes are computed
+// separately by _mm256_mul_epu32, and blended into the high and low halves
+__attribute__((target("avx2")))
+void PhiloxLanesAvx2(const uint32_t* key, uint64_t stream,
+                     uint64_t position, uint32_t* blocks) {
+  uint32_t low[kPhiloxLanes], high[kPhiloxLanes];
+  for (int j = 0; j < kPhiloxLanes; ++j) {
+    low[j] = static_cast<uint32_t>(position + j);
+    high[j] = static_cast<uint32_t>((position + j) >> 32);
+  }
+  __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low));
+  __m256i c1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high));
+  __m256i c2 = _mm256_set1_epi32(static_cast<uint32_t>(stream));
+  __m256i c3 = _mm256_set1_epi32(static_cast<uint32_t>(stream >> 32));
+  __m256i k0 = _mm256_set1_epi32(key[0]);
+  __m256i k1 = _mm256_set1_epi32(key[1]);
+  const __m256i m0 = _mm256_set1_epi32(kPhiloxM0);
+  const __m256i m1 = _mm256_set1_epi32(kPhiloxM1);
+  const __m256i w0 = _mm256_set1_epi32(kPhiloxW0);
+  const __m256i w1 = _mm256_set1_epi32(kPhiloxW1);
+  for (int round = 0; round < 10; ++round) {
+    __m256i p0_even = _mm256_mul_epu32(m0, c0);
+    __m256i p0_odd = _mm256_mul_epu32(m0, _mm256_srli_epi64(c0, 32));
+    __m256i p1_even = _mm256_mul_epu32(m1, c2);
+    __m256i p1_odd = _mm256_mul_epu32(m1, _mm256_srli_epi64(c2, 32));
+    __m256i hi0 = _mm256_blend_epi32(_mm256_srli_epi64(p0_even, 32),
+                                     p0_odd, 0xAA);
+    __m256i lo0 = _mm256_blend_epi32(p0_even,
+                                     _mm256_slli_epi64(p0_odd, 32), 0xAA);
+    __m256i hi1 = _mm256_blend_epi32(_mm256_srli_epi64(p1_even, 32),
+                                     p1_odd, 0xAA);
+    __m256i lo1 = _mm256_blend_epi32(p1_even,
+                                     _mm256_slli_epi64(p1_odd, 32), 0xAA);
+    c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), k0);
+    c1 = lo1;
+    c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), k1);
+    c3 = lo0;
+    k0 = _mm256_add_epi32(k0, w0);
+    k1 = _mm256_add_epi32(k1, w1);
+  }
+  // Transpose the lanes into the blocks
+  __m256i a = _mm256_unpacklo_epi32(c0, c1);  // 0 1 | 4 5
+  __m256i b = _mm256_unpackhi_epi32(c0, c1);  // 2 3 | 6 7
+  __m256i c = _mm256_unpacklo_epi32(c2, c3);
+  __m256i d = _mm256_unpackhi_epi32(c2, c3);
+  __m256i e = _mm256_unpacklo_epi64(a, c);  // block 0 | 4
+  __m256i f = _mm256_unpackhi_epi64(a, c);  // block 1 | 5
+  __m256i g = _mm256_unpacklo_epi64(b, d);  // block 2 | 6
+  __m256i h = _mm256_unpackhi_epi64(b, d);  // block 3 | 7
+  __m256i* out = reinterpret_cast<__m256i*>(blocks);
+  _mm256_storeu_si256(out, _mm256_permute2x128_si256(e, f, 0x20));
+  _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(g, h, 0x20));
+  _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(e, f, 0x31));
+  _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(g, h, 0x31));
+  _mm256_zeroupper();
+}
+
+#endif  // EULER_X86_KERNELS
+
+PhiloxLanesKernel GetPhiloxLanesKernel() {
+#ifdef EULER_X86_KERNELS
+  if (SupportedSimdLevel() >= kAvx2) {
+    return PhiloxLanesAvx2;
+  }
+#endif
+  return PhiloxLanesScalar;
+}
+
+uint64_t DefaultSeed() {
+  std::random_device device;
+  return (static_cast<uint64_t>(device()) << 32) ^ device() ^ time(0);
+}
+
+std::atomic<uint64_t> global_seed(DefaultSeed());
+// Bumped by SetRandomSeed, the threads reseed if their epochs are behind
+std::atomic<uint64_t> global_epoch(0);
+std::atomic<uint64_t> next_thread_id(0);
+
+// Constant initialized, so the accesses need no guard. The thread id is
+// assigned on the first draw.
+struct ThreadState {
+  constexpr ThreadState(): id(0), epoch(~0ULL), scopes(0), philox(0, 0) { }
+
+  uint64_t id;
+  uint64_t epoch;  // ~0 if the id is not assigned yet
+  int scopes;
+  Philox philox;
+};
+
+thread_local ThreadState thread_state;
+
+Philox* ThreadGenerator() {
+  ThreadState* state = &thread_state;
+  if (state->scopes == 0) {
+    uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+    if (epoch != state->epoch) {
+      if (state->epoch == ~0ULL) {
+        state->id = next_thread_id++;
+      }
+      state->philox = Philox(global_seed.load(std::memory_order_acquire),
+                             state->id);
+      state->epoch = epoch;
+    }
+  }
+  return &state->philox;
+}
+
 }  // namespace
 
+void Philox::Generate(uint64_t position, uint32_t* blocks) const {
+  static_assert(kBufferBlocks == kPhiloxLanes, "One block per lane");
+  static const PhiloxLanesKernel kernel = GetPhiloxLanesKernel();
+  kernel(key_, stream_, position, blocks);
+}
+
+void Philox::Fill(double* values, size_t num) {
+  size_t i = 0;
+  // Finish the buffer first so the stream is the same as drawing the values
+  // one by one
+  for (; i < num && index_ != kBufferSize; ++i) {
+    values[i] = NextDouble();
+  }
+  uint32_t blocks[kBufferSize];
+  for (; i + kBufferSize / 2 <= num; i += kBufferSize / 2) {
+    Generate(counter_, blocks);
+    counter_ += kBufferBlocks;
+    for (int j = 0; j < kBufferSize / 2; ++j) {
+      uint64_t bits = (static_cast<uint64_t>(blocks[j * 2]) << 32) |
+          blocks[j * 2 + 1];
+      values[i + j] = (bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+  }
+  for (; i < num; ++i) {
+    values[i] = NextDouble();
+  }
+}
+
+void Philox::Fill(float* values, size_t num) {
+  size_t i = 0;
+  for (; i < num && index_ != kBufferSize; ++i) {
+    values[i] = NextFloat();
+  }
+  uint32_t blocks[kBufferSize];
+  for (; i + kBufferSize <= num; i += kBufferSize) {
+    Generate(counter_, blocks);
+    counter_ += kBufferBlocks;
+    for (int j = 0; j < kBufferSize; ++j) {
+      values[i + j] = static_cast<int32_t>(blocks[j] >> 8) *
+          (1.0f / 16777216.0f);
+    }
+  }
+  for (; i < num; ++i) {
+    values[i] = NextFloat();
+  }
+}
+
 double ThreadLocalRandom() {
-  return u(e);
+  return ThreadGenerator()->NextDouble();
+}
+
+void FillRandom(double* values, size_t num) {
+  ThreadGenerator()->Fill(values, num);
+}
+
+void FillRandom(float* values, size_t num) {
+  ThreadGenerator()->Fill(values, num);
+}
+
+void SetRandomSeed(uint64_t seed) {
+  global_seed.store(seed, std::memory_order_release);
+  global_epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+ScopedRandomSeed::ScopedRandomSeed(uint64_t seed, uint64_t stream)
+    : saved_(*ThreadGenerator()) {
+  ThreadState* state = &thread_state;
+  ++state->scopes;
+  state->philox = Philox(seed, stream);
+}
+
+ScopedRandomSeed::~ScopedRandomSeed() {
+  ThreadState* state = &thread_state;
+  --state->scopes;
+  state->philox = saved_;
+}
+
+bool RandomSeeded() {
+  return thread_state.scopes > 0;
 }
 
 }  // namespace common
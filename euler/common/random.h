@@ -16,13 +16,104 @@ limitations under the License.
 #ifndef EULER_COMMON_RANDOM_H_
 #define EULER_COMMON_RANDOM_H_
 
-#include <random>
+#include <stddef.h>
+#include <stdint.h>
 
 namespace euler {
 namespace common {
 
+// The Philox4x32-10 counter-based generator. The output is a pure function
+// of (seed, stream, position), so the streams of the same seed are
+// independent and a stream can be reproduced on any thread or box. The
+// blocks of 4 outputs are generated kBufferBlocks at a time, in the lanes of
+// the AVX2 registers if supported.
+class Philox {
+ public:
+  constexpr Philox(uint64_t seed, uint64_t stream)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+        stream_(stream), counter_(0), buffer_{}, index_(kBufferSize) { }
+
+  uint32_t Next32() {
+    if (index_ == kBufferSize) {
+      Generate(counter_, buffer_);
+      counter_ += kBufferBlocks;
+      index_ = 0;
+    }
+    return buffer_[index_++];
+  }
+
+  uint64_t Next64() {
+    uint64_t high = Next32();
+    return (high << 32) | Next32();
+  }
+
+  // Uniform in [0, 1), 53 random bits
+  double NextDouble() {
+    return (Next64() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  // Uniform in [0, 1), 24 random bits
+  float NextFloat() {
+    return (Next32() >> 8) * (1.0f / 16777216.0f);
+  }
+
+  // Jump to the block of the position, a block is 4 outputs of Next32().
+  // The streams skip ahead in constant time.
+  void Seek(uint64_t position) {
+    counter_ = position;
+    index_ = kBufferSize;
+  }
+
+  // Fill the values with NextDouble() or NextFloat(), the values of whole
+  // buffers are converted in a loop without the per value branch
+  void Fill(double* values, size_t num);
+  void Fill(float* values, size_t num);
+
+ private:
+  static const int kBufferBlocks = 8;
+  static const int kBufferSize = 4 * kBufferBlocks;
+
+  // The kBufferBlocks blocks from the counter (position, stream)
+  void Generate(uint64_t position, uint32_t* blocks) const;
+
+  uint32_t key_[2];
+  uint64_t stream_;
+  uint64_t counter_;  // Position of the next block to generate
+  uint32_t buffer_[kBufferSize];
+  int index_;  // Next output in buffer_, kBufferSize if consumed
+};
+
+// Uniform in [0, 1) from the generator of the current thread. The thread
+// generators are seeded by the global seed and the thread id as the stream,
+// or by the ScopedRandomSeed the thread is running in.
 double ThreadLocalRandom();
 
+// Fill the values with ThreadLocalRandom() in a batch
+void FillRandom(double* values, size_t num);
+void FillRandom(float* values, size_t num);
+
+// Reseed the generators of all the threads, they pick up the seed on their
+// next draw. The default seed is random.
+void SetRandomSeed(uint64_t seed);
+
+// Run the current thread on the stream of the seed until the scope ends,
+// e.g. to reproduce the samples of a seeded query. The scopes can nest.
+class ScopedRandomSeed {
+ public:
+  ScopedRandomSeed(uint64_t seed, uint64_t stream);
+  ~ScopedRandomSeed();
+
+ private:
+  Philox saved_;
+
+  ScopedRandomSeed(const ScopedRandomSeed&) = delete;
+  ScopedRandomSeed& operator=(const ScopedRandomSeed&) = delete;
+};
+
+// Whether the current thread runs in a ScopedRandomSeed. The work spread to
+// the other threads does not draw from the scope, so it is not reproducible.
+bool RandomSeeded();
+
 }  // namespace common
 }  // namespace euler
 
@@ -0,0 +1,150 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/common/random.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace euler {
+namespace common {
+
+TEST(RandomTest, PhiloxKnownAnswers) {
+  // The known answers of Philox4x32-10 from Random123, the counter is
+  // (position, stream) and the key is the seed
+  Philox zero(0, 0);
+  ASSERT_EQ(0x6627e8d5u, zero.Next32());
+  ASSERT_EQ(0xe169c58du, zero.Next32());
+  ASSERT_EQ(0xbc57ac4cu, zero.Next32());
+  ASSERT_EQ(0x9b00dbd8u, zero.Next32());
+
+  Philox ones(~0ULL, ~0ULL);
+  ones.Seek(~0ULL);
+  ASSERT_EQ(0x408f276du, ones.Next32());
+  ASSERT_EQ(0x41c83b0eu, ones.Next32());
+  ASSERT_EQ(0xa20bc7c6u, ones.Next32());
+  ASSERT_EQ(0x6d5451fdu, ones.Next32());
+
+  Philox pi(0x299f31d0a4093822ULL, 0x0370734413198a2eULL);
+  pi.Seek(0x85a308d3243f6a88ULL);
+  ASSERT_EQ(0xd16cfe09u, pi.Next32());
+  ASSERT_EQ(0x94fdccebu, pi.Next32());
+  ASSERT_EQ(0x5001e420u, pi.Next32());
+  ASSERT_EQ(0x24126ea1u, pi.Next32());
+}
+
+TEST(RandomTest, Fill) {
+  // Filling draws the same values as drawing them one by one, from any
+  // offset in the block
+  for (size_t skip = 0; skip < 4; ++skip) {
+    Philox a(7, 3), b(7, 3), c(7, 3), d(7, 3);
+    for (size_t i = 0; i < skip; ++i) {
+      a.Next32();
+      b.Next32();
+      c.Next32();
+      d.Next32();
+    }
+    std::vector<double> doubles(101);
+    a.Fill(doubles.data(), doubles.size());
+    for (double value : doubles) {
+      ASSERT_EQ(b.NextDouble(), value);
+    }
+    std::vector<float> floats(103);
+    c.Fill(floats.data(), floats.size());
+    for (float value : floats) {
+      ASSERT_EQ(d.NextFloat(), value);
+    }
+    ASSERT_EQ(b.Next32(), a.Next32());
+    ASSERT_EQ(d.Next32(), c.Next32());
+  }
+
+  // Roughly uniform in [0, 1)
+  std::vector<double> values(100000);
+  FillRandom(values.data(), values.size());
+  std::vector<int> buckets(10);
+  for (double value : values) {
+    ASSERT_GE(value, 0);
+    ASSERT_LT(value, 1);
+    ++buckets[static_cast<int>(value * 10)];
+  }
+  for (int bucket : buckets) {
+    ASSERT_NEAR(10000, bucket, 500);
+  }
+}
+
+TEST(RandomTest, Streams) {
+  // The streams of a seed are different
+  Philox a(1, 0), b(1, 1), c(2, 0);
+  uint64_t x = a.Next64();
+  ASSERT_NE(x, b.Next64());
+  ASSERT_NE(x, c.Next64());
+}
+
+TEST(RandomTest, ScopedRandomSeed) {
+  ASSERT_FALSE(RandomSeeded());
+  std::vector<double> first(10), second(10);
+  {
+    ScopedRandomSeed seed(42, 5);
+    ASSERT_TRUE(RandomSeeded());
+    FillRandom(first.data(), 5);
+    {
+      // Nested scopes do not disturb the outer one
+      ScopedRandomSeed inner(43, 5);
+      ThreadLocalRandom();
+    }
+    for (size_t i = 5; i < first.size(); ++i) {
+      first[i] = ThreadLocalRandom();
+    }
+  }
+  ASSERT_FALSE(RandomSeeded());
+
+  // The same on another thread, the global seed is not used in the scope
+  SetRandomSeed(1);
+  std::thread thread([&second] () {
+    ScopedRandomSeed seed(42, 5);
+    SetRandomSeed(2);
+    FillRandom(second.data(), second.size());
+  });
+  thread.join();
+  ASSERT_EQ(first, second);
+
+  Philox expected(42, 5);
+  for (double value : first) {
+    ASSERT_EQ(expected.NextDouble(), value);
+  }
+}
+
+TEST(RandomTest, SetRandomSeed) {
+  // The thread generators are the streams of the global seed
+  auto draw = [] (std::vector<double>* values) {
+    for (auto& value : *values) {
+      value = ThreadLocalRandom();
+    }
+  };
+  std::vector<double> first(10), second(10);
+  SetRandomSeed(123);
+  draw(&first);
+  SetRandomSeed(123);
+  draw(&second);
+  ASSERT_EQ(first, second);
+  SetRandomSeed(124);
+  draw(&second);
+  ASSERT_NE(first, second);
+}
+
+}  // namespace common
+}  // namespace euler
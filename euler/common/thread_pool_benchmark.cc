@@ -0,0 +1,127 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Compare the task latency, from Schedule to the start of the task, of the
+// thread pool implementations. The workload mimics the executor: each job is
+// a chain of short tasks scheduling their successors, and a few of the tasks
+// are slow like a blocking remote call.
+//
+// Usage: thread_pool_benchmark [num_threads] [num_jobs] [chain_length]
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "euler/common/env.h"
+#include "euler/common/mutex.h"
+
+namespace euler {
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int kSlowTaskInterval = 64;
+const int kSlowTaskMicros = 2000;
+const int kTaskSpins = 2000;
+
+struct Benchmark {
+  ThreadPool* pool;
+  int chain_length;
+  std::atomic<int> seq;
+  std::vector<int64_t> latencies;  // In nanoseconds
+  std::atomic<size_t> latency_num;
+  std::atomic<int> remain_jobs;
+  Mutex mu;
+  CondVar cv;
+};
+
+void RunTask(Benchmark* bm, Clock::time_point scheduled, int step) {
+  auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - scheduled).count();
+  bm->latencies[bm->latency_num++] = latency;
+
+  if (++bm->seq % kSlowTaskInterval == 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(kSlowTaskMicros));
+  } else {
+    volatile int sink = 0;
+    for (int i = 0; i < kTaskSpins; ++i) {
+      sink = sink + i;
+    }
+  }
+
+  if (step + 1 < bm->chain_length) {
+    auto now = Clock::now();
+    bm->pool->Schedule([bm, now, step] () { RunTask(bm, now, step + 1); });
+  } else if (--bm->remain_jobs == 0) {
+    MutexLock l(&bm->mu);
+    bm->cv.SignalAll();
+  }
+}
+
+void Run(const std::string& name, ThreadPoolType type, int num_threads,
+         int num_jobs, int chain_length) {
+  Benchmark bm;
+  bm.pool = Env::Default()->StartThreadPool(name, num_threads, type);
+  bm.chain_length = chain_length;
+  bm.seq = 0;
+  bm.latencies.resize(static_cast<size_t>(num_jobs) * chain_length);
+  bm.latency_num = 0;
+  bm.remain_jobs = num_jobs;
+
+  auto begin = Clock::now();
+  for (int i = 0; i < num_jobs; ++i) {
+    auto now = Clock::now();
+    bm.pool->Schedule([&bm, now] () { RunTask(&bm, now, 0); });
+  }
+  {
+    MutexLock l(&bm.mu);
+    bm.cv.Wait(&l, [&bm] () { return bm.remain_jobs.load() == 0; });
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  delete bm.pool;
+
+  auto& latencies = bm.latencies;
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies] (double p) {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1e3;
+  };
+  printf("%-14s tasks: %zu, time: %.3fs, latency(us) p50: %.1f, "
+         "p90: %.1f, p99: %.1f, max: %.1f\n",
+         name.c_str(), latencies.size(), seconds, percentile(0.5),
+         percentile(0.9), percentile(0.99), percentile(1.0));
+}
+
+}  // namespace
+}  // namespace euler
+
+int main(int argc, char** argv) {
+  int num_threads = argc > 1 ? atoi(argv[1]) : 8;
+  int num_jobs = argc > 2 ? atoi(argv[2]) : 2000;
+  int chain_length = argc > 3 ? atoi(argv[3]) : 16;
+  printf("threads: %d, jobs: %d, chain length: %d\n",
+         num_threads, num_jobs, chain_length);
+  euler::Run("std", euler::kStdThreadPool,
+             num_threads, num_jobs, chain_length);
+  euler::Run("work_stealing", euler::kWorkStealingThreadPool,
+             num_threads, num_jobs, chain_length);
+  return 0;
+}
@@ -0,0 +1,148 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_COMMON_WORK_STEALING_QUEUE_H_
+#define EULER_COMMON_WORK_STEALING_QUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "euler/common/macros.h"
+
+namespace euler {
+
+// A lock free Chase-Lev deque of pointers. The owner thread pushes and pops
+// items at the bottom in LIFO order, other threads steal items at the top.
+// The items are not owned by the queue.
+template <class T>
+class WorkStealingQueue {
+ public:
+  explicit WorkStealingQueue(int64_t capacity = 256)
+      : top_(0), bottom_(0) {
+    int64_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    arrays_.emplace_back(new Array(size));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  // Only called by the owner
+  void Push(T* item) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Array* a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity() - 1) {
+      // Thieves may still read the old array, it is released with the queue
+      arrays_.emplace_back(a->Grow(t, b));
+      a = arrays_.back().get();
+      array_.store(a, std::memory_order_release);
+    }
+    a->Put(b, item);
+    bottom_.store(b + 1, std::memory_order_release);
+  }
+
+  // Only called by the owner, return nullptr if empty
+  T* Pop() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T* item = a->Get(b);
+    if (t == b) {
+      // The last item, race with the thieves
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // Called by any thread, return nullptr if empty or another thread wins
+  T* Steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Array* a = array_.load(std::memory_order_acquire);
+    T* item = a->Get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  bool Empty() const {
+    int64_t b = bottom_.load(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_seq_cst);
+    return b <= t;
+  }
+
+ private:
+  class Array {
+   public:
+    explicit Array(int64_t capacity)
+        : capacity_(capacity), items_(new std::atomic<T*>[capacity]) {
+    }
+
+    int64_t capacity() const { return capacity_; }
+
+    T* Get(int64_t i) const {
+      return items_[i & (capacity_ - 1)].load(std::memory_order_relaxed);
+    }
+
+    void Put(int64_t i, T* item) {
+      items_[i & (capacity_ - 1)].store(item, std::memory_order_relaxed);
+    }
+
+    Array* Grow(int64_t top, int64_t bottom) const {
+      Array* array = new Array(capacity_ * 2);
+      for (int64_t i = top; i < bottom; ++i) {
+        array->Put(i, Get(i));
+      }
+      return array;
+    }
+
+   private:
+    const int64_t capacity_;
+    std::unique_ptr<std::atomic<T*>[]> items_;
+  };
+
+  std::atomic<int64_t> top_;
+  std::atomic<int64_t> bottom_;
+  std::atomic<Array*> array_;
+  std::vector<std::unique_ptr<Array>> arrays_;  // Only used by the owner
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingQueue);
+};
+
+}  // namespace euler
+
+#endif  // EULER_COMMON_WORK_STEALING_QUEUE_H_
@@ -17,7 +17,10 @@ limitations under the License.
 
 #include <omp.h>
 
+#include <algorithm>
+
 #include "euler/common/data_types.h"
+#include "euler/common/random.h"
 
 namespace euler {
 
@@ -27,6 +30,42 @@ Graph* EulerGraph() {
   return &Graph::Instance();
 }
 
+// A candidate is accepted after this number of rejections at most, which
+// bounds a step on the nodes whose neighbors are all rejected with a high
+// probability
+const int kMaxWalkRejections = 64;
+
+// Sample the next node of a walk at node from parent, see RandomWalk.
+// Return false if node has no neighbor of edge_types.
+bool SampleWalkStep(const Graph& graph, NodeId node, NodeId parent,
+                    bool has_parent, bool parent_found,
+                    const std::vector<int>& parent_edge_types,
+                    const std::vector<int>& edge_types, float p, float q,
+                    NodeId* next) {
+  float weight;
+  int32_t type;
+  if (!has_parent || (p == 1 && q == 1)) {
+    return graph.SampleNeighbor(node, edge_types, 1, next, &weight, &type);
+  }
+  float max_bias = std::max(std::max(1 / p, 1 / q), 1.0f);
+  for (int i = 0; i < kMaxWalkRejections; ++i) {
+    if (!graph.SampleNeighbor(node, edge_types, 1, next, &weight, &type)) {
+      return false;
+    }
+    float bias = 1;
+    if (*next == parent) {
+      bias = 1 / p;  // d_tx = 0
+    } else if (parent_found &&
+               !graph.HasNeighbor(parent, parent_edge_types, *next)) {
+      bias = 1 / q;  // d_tx = 2
+    }
+    if (common::ThreadLocalRandom() * max_bias < bias) {
+      break;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 NodeIdVec SampleNode(const std::vector<int>& node_types, int count) {
@@ -50,10 +89,7 @@ bool EdgeExist(const EdgeId& eid) {
 TypeVec GetNodeType(const std::vector<NodeId>& node_ids) {
   TypeVec vec(node_ids.size());
   for (size_t i = 0 ; i < node_ids.size(); ++i) {
-    auto node = EulerGraph()->GetNodeByID(node_ids[i]);
-    if (node != nullptr) {
-      vec[i] = node->GetType();
-    } else {
+    if (!EulerGraph()->GetNodeType(node_ids[i], &vec[i])) {
       vec[i] = euler::common::DEFAULT_INT32;
     }
   }
@@ -67,10 +103,7 @@ FloatFeatureVec GetNodeFloat32Feature(const NodeIdVec& node_ids,
   #pragma omp parallel for
   #endif
   for (int32_t i = 0 ; i < static_cast<int32_t>(node_ids.size()); ++i) {
-    auto node = EulerGraph()->GetNodeByID(node_ids[i]);
-    if (node != nullptr) {
-      node->GetFloat32Feature(fids, &features[i]);
-    } else {
+    if (!EulerGraph()->GetFloat32Feature(node_ids[i], fids, &features[i])) {
       features[i].resize(fids.size());
     }
   }
@@ -84,10 +117,7 @@ UInt64FeatureVec GetNodeUint64Feature(const NodeIdVec& node_ids,
   #pragma omp parallel for
   #endif
   for (int32_t i = 0 ; i < static_cast<int32_t>(node_ids.size()); ++i) {
-    auto node = EulerGraph()->GetNodeByID(node_ids[i]);
-    if (node != nullptr) {
-      node->GetUint64Feature(fids, &features[i]);
-    } else {
+    if (!EulerGraph()->GetUint64Feature(node_ids[i], fids, &features[i])) {
       features[i].resize(fids.size());
     }
   }
@@ -101,16 +131,33 @@ BinaryFatureVec GetNodeBinaryFeature(const NodeIdVec& node_ids,
   #pragma omp parallel for
   #endif
   for (int32_t i = 0 ; i < static_cast<int32_t>(node_ids.size()); ++i) {
-    auto node = EulerGraph()->GetNodeByID(node_ids[i]);
-    if (node != nullptr) {
-      node->GetBinaryFeature(fids, &features[i]);
-    } else {
+    if (!EulerGraph()->GetBinaryFeature(node_ids[i], fids, &features[i])) {
       features[i].resize(fids.size());
     }
   }
   return features;
 }
 
+bool GetNodeDenseFeature(const NodeId* node_ids, size_t num, int fid,
+                         float* values, bool parallel) {
+  const DenseFeatureStore& store = EulerGraph()->dense_features();
+  int64_t dim = store.dim(fid);
+  if (dim == 0) {
+    return false;
+  }
+  const int64_t block = 256;
+  int64_t blocks = (num + block - 1) / block;
+  #ifdef OPENMP
+  #pragma omp parallel for if (parallel)
+  #endif
+  for (int64_t i = 0; i < blocks; ++i) {
+    size_t begin = i * block;
+    size_t count = std::min<size_t>(block, num - begin);
+    store.Gather(fid, node_ids + begin, count, values + begin * dim);
+  }
+  return true;
+}
+
 std::vector<int> GetNodeFeatureIds(const std::vector<std::string*>& ft_names) {
   std::vector<int> feature_ids(ft_names.size());
   for (size_t i = 0; i < ft_names.size(); ++i) {
@@ -212,10 +259,7 @@ IdWeightPairVec GetFullNeighbor(const NodeIdVec& node_ids,
   #pragma omp parallel for
   #endif
   for (int32_t i = 0 ; i < static_cast<int32_t>(node_ids.size()); ++i) {
-    auto node = EulerGraph()->GetNodeByID(node_ids[i]);
-    if (node != nullptr) {
-      neighbor[i] = node->GetFullNeighbor(edge_types);
-    }
+    neighbor[i] = EulerGraph()->GetFullNeighbor(node_ids[i], edge_types);
   }
   return neighbor;
 }
@@ -224,17 +268,77 @@ IdWeightPairVec SampleNeighbor(const NodeIdVec& node_ids,
                                const std::vector<int>& edge_types, int count) {
   IdWeightPairVec neighbor(node_ids.size());
   #ifdef OPENMP
-  #pragma omp parallel for
+  #pragma omp parallel for if (!common::RandomSeeded())
   #endif
   for (int32_t i = 0 ; i < static_cast<int32_t>(node_ids.size()); ++i) {
-    auto node = EulerGraph()->GetNodeByID(node_ids[i]);
-    if (node != nullptr) {
-      neighbor[i] = node->SampleNeighbor(edge_types, count);
-    }
+    neighbor[i] = EulerGraph()->SampleNeighbor(node_ids[i], edge_types,
+                                               count);
   }
   return neighbor;
 }
 
+void SampleNeighbor(const NodeId* node_ids, size_t num,
+                    const std::vector<int>& edge_types, int count,
+                    NodeId default_node, NodeId* ids, float* weights,
+                    int32_t* types, bool parallel) {
+  Graph* graph = EulerGraph();
+  #ifdef OPENMP
+  #pragma omp parallel for if (parallel)
+  #endif
+  for (int64_t i = 0; i < static_cast<int64_t>(num); ++i) {
+    size_t offset = i * count;
+    if (!graph->SampleNeighbor(node_ids[i], edge_types, count, ids + offset,
+                               weights + offset, types + offset)) {
+      std::fill(ids + offset, ids + offset + count, default_node);
+      std::fill(weights + offset, weights + offset + count, 0);
+      std::fill(types + offset, types + offset + count, 0);
+    }
+  }
+}
+
+void RandomWalk(const NodeId* nodes, const NodeId* parents,
+                const int32_t* starts, size_t num,
+                const std::vector<std::vector<int>>& schedule, float p,
+                float q, NodeId* ids, int32_t* steps, bool parallel) {
+  const Graph& graph = *EulerGraph();
+  int32_t walk_len = schedule.size();
+  size_t width = walk_len + 1;
+  #ifdef OPENMP
+  #pragma omp parallel for if (parallel)
+  #endif
+  for (int64_t i = 0; i < static_cast<int64_t>(num); ++i) {
+    NodeId* row = ids + i * width;
+    std::fill(row, row + width, common::DEFAULT_UINT64);
+    if (!graph.HasNode(nodes[i])) {
+      steps[i] = common::DEFAULT_INT32;
+      continue;
+    }
+    int32_t start = std::max(0, std::min(starts[i], walk_len));
+    NodeId node = nodes[i];
+    NodeId parent = parents[i];
+    bool parent_found = start == 0 || graph.HasNode(parent);
+    row[0] = node;
+    steps[i] = walk_len - start;
+    for (int32_t k = 1; start + k <= walk_len; ++k) {
+      int32_t s = start + k - 1;
+      NodeId next;
+      if (!SampleWalkStep(graph, node, parent, s > 0, parent_found,
+                          s > 0 ? schedule[s - 1] : schedule[s],
+                          schedule[s], p, q, &next)) {
+        break;
+      }
+      row[k] = next;
+      if (start + k < walk_len && !graph.HasNode(next)) {
+        steps[i] = k;
+        break;
+      }
+      parent = node;
+      parent_found = true;
+      node = next;
+    }
+  }
+}
+
 bool GetNodeType(const std::vector<std::string*> node_types,
                  std::vector<int>* type_ids) {
   type_ids->resize(node_types.size());
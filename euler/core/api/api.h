@@ -62,6 +62,13 @@ UInt64FeatureVec GetNodeUint64Feature(
 BinaryFatureVec GetNodeBinaryFeature(
     const NodeIdVec& node_ids, const std::vector<std::string*>& ft_names);
 
+// Gather the dense feature fid of the num nodes into values, num * dim
+// floats, the nodes not found get zeros. Return false and write nothing if
+// the feature has no dense column, see GraphLoadOptions. The blocks of the
+// nodes are gathered in parallel if parallel is true and OPENMP is enabled.
+bool GetNodeDenseFeature(const NodeId* node_ids, size_t num, int fid,
+                         float* values, bool parallel = false);
+
 // Get edge feature
 FloatFeatureVec GetEdgeFloat32Feature(const EdgeIdVec& edge_ids,
                                       const std::vector<int>& fids);
@@ -83,6 +90,38 @@ IdWeightPairVec GetFullNeighbor(const NodeIdVec& node_ids,
 IdWeightPairVec SampleNeighbor(const NodeIdVec& node_ids,
                                const std::vector<int>& edge_types, int count);
 
+// Sample count neighbors for each of the num nodes into arrays of
+// num * count elements, the neighbors of node_ids[i] are written to
+// [i * count, (i + 1) * count), or default_node with weight 0 and type 0
+// if there is no neighbor. The nodes are sampled in parallel if parallel is
+// true and OPENMP is enabled.
+void SampleNeighbor(const NodeId* node_ids, size_t num,
+                    const std::vector<int>& edge_types, int count,
+                    NodeId default_node, NodeId* ids, float* weights,
+                    int32_t* types, bool parallel = false);
+
+// Walk num random walks on the local graph, walk i resumes at step
+// starts[i] from nodes[i], coming from parents[i] if starts[i] > 0. Step s
+// follows the edge types schedule[s] and is biased as node2vec with return
+// parameter p and in-out parameter q: a neighbor sampled from the alias
+// tables is accepted with a probability proportional to 1/p if it is the
+// parent, 1 if it is also a neighbor of the parent by the edge types of the
+// previous step and 1/q otherwise. A parent not on the local graph can not
+// tell the last two cases apart, all its candidates other than itself get 1.
+//
+// Row i of ids has schedule.size() + 1 elements, nodes[i] followed by the
+// nodes visited. steps[i] is the number of the nodes visited, or
+// DEFAULT_INT32 with a row of DEFAULT_UINT64 if nodes[i] is not found. A
+// walk stops early at the first node not found on the local graph, so that
+// it can be resumed on the shard owning it, steps[i] < schedule.size() -
+// starts[i] in that case. The walks reaching a node without neighbors are
+// done, with DEFAULT_UINT64 for the rest of the steps. The walks run in
+// parallel if parallel is true and OPENMP is enabled.
+void RandomWalk(const NodeId* nodes, const NodeId* parents,
+                const int32_t* starts, size_t num,
+                const std::vector<std::vector<int>>& schedule, float p,
+                float q, NodeId* ids, int32_t* steps, bool parallel = false);
+
 bool GetNodeType(const std::vector<std::string*> node_types,
                  std::vector<int>* type_ids);
 bool GetEdgeType(const std::vector<std::string*> edge_types,
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "euler/core/dag/dag.h"
 
+#include <algorithm>
 #include <utility>
 #include <unordered_map>
 
@@ -26,7 +27,55 @@ limitations under the License.
 
 namespace euler {
 
-DAG::DAG(const std::string& name): name_(name) { }
+namespace {
+
+// The costs of the nodes when finding the critical path, the asynchronous
+// nodes, i.e. the remote ones, wait for the network and weigh most
+const int kComputeCost = 1;
+const int kAsyncCost = 8;
+
+// Add the tensor names the node refers to, the slots of the inputs and the
+// outputs are kept in the node. So are the ones of the inputs of the inner
+// nodes, which a remote node looks up to send.
+void AddSlots(DAGNodeProto* node_def, TensorSlotMap* slot_map) {
+  node_def->clear_output_slots();
+  for (int i = 0; i < node_def->output_num(); ++i) {
+    node_def->add_output_slots(slot_map->Add(OutputName(*node_def, i)));
+  }
+  node_def->clear_remote_output_slots();
+  for (auto& name : node_def->remote_output_list()) {
+    node_def->add_remote_output_slots(slot_map->Add(name));
+  }
+  node_def->clear_input_slots();
+  for (auto& name : node_def->inputs()) {
+    node_def->add_input_slots(slot_map->Add(name));
+  }
+  for (auto& name : node_def->udf_str_params()) {
+    slot_map->Add(name);
+  }
+  for (auto& name : node_def->udf_num_params()) {
+    slot_map->Add(name);
+  }
+  for (auto& dnf : node_def->dnf()) {
+    for (auto& term : Split(dnf, ",")) {
+      auto index_op_value = Split(term, " ");
+      if (index_op_value.size() == 3) {
+        slot_map->Add(index_op_value[2]);
+      }
+    }
+  }
+  for (auto& inner_node : *node_def->mutable_inner_nodes()) {
+    inner_node.clear_input_slots();
+    for (auto& name : inner_node.inputs()) {
+      inner_node.add_input_slots(slot_map->Add(name));
+    }
+  }
+}
+
+}  // namespace
+
+DAG::DAG(const std::string& name)
+    : name_(name), slot_map_(std::make_shared<TensorSlotMap>()) { }
 
 DAG::~DAG() {
   for (auto& n : nodes_) { delete n; }
@@ -34,7 +83,8 @@ DAG::~DAG() {
 }
 
 DAGNode* DAG::AddNode(const DAGNodeProto& node_def, Status* s) {
-  *s = LookupOpKernel(node_def.op());
+  OpKernel* kernel = nullptr;
+  *s = CreateOpKernel(node_def.op(), &kernel);
   if (!s->ok()) {
     return nullptr;
   }
@@ -42,7 +92,10 @@ DAGNode* DAG::AddNode(const DAGNodeProto& node_def, Status* s) {
   auto node = new DAGNode;
   node->id_ = nodes_.size();
   node->def_ = node_def;
+  node->kernel_ = kernel;
+  node->async_kernel_ = dynamic_cast<AsyncOpKernel*>(kernel);
   nodes_.emplace_back(node);
+  AddSlots(&node->def_, slot_map_.get());
   *s = Status::OK();
   return node;
 }
@@ -97,7 +150,40 @@ std::unique_ptr<DAG> DAG::NewFromProto(const DAGProto& dag_def) {
     }
   }
 
+  dag->Prioritize();
   return dag;
 }
 
+void DAG::Prioritize() {
+  // Visit the nodes from the sinks
+  std::vector<int> num_outputs(nodes_.size());
+  std::vector<DAGNode*> ready;
+  for (auto node : nodes_) {
+    num_outputs[node->id()] = node->num_outputs();
+    if (node->num_outputs() == 0) {
+      ready.push_back(node);
+    }
+  }
+  while (!ready.empty()) {
+    DAGNode* node = ready.back();
+    ready.pop_back();
+    int cost = kComputeCost;
+    if (node->async_kernel() != nullptr) {
+      cost = kAsyncCost;
+    } else if (node->kernel()->IsCheap()) {
+      cost = 0;
+    }
+    int priority = 0;
+    for (auto edge : node->output_edges()) {
+      priority = std::max(priority, edge->dst()->priority());
+    }
+    node->priority_ = priority + cost;
+    for (auto edge : node->input_edges()) {
+      if (--num_outputs[edge->src()->id()] == 0) {
+        ready.push_back(edge->src());
+      }
+    }
+  }
+}
+
 }  //  namespace euler
@@ -33,6 +33,7 @@ class DAGNode;
 class DAGEdge;
 class DAGNodeProto;
 class DAGProto;
+class TensorSlotMap;
 
 class DAG {
  public:
@@ -50,12 +51,19 @@ class DAG {
   DAGNode* AddNode(const DAGNodeProto& node_def, Status* s);
   DAGEdge* AddEdge(DAGNode* src, int x, DAGNode* dst, int y);
 
+  // The slots of the tensor names referred by the nodes, bound to the
+  // OpKernelContext by the Executor
+  std::shared_ptr<const TensorSlotMap> slot_map() const { return slot_map_; }
+
   static std::unique_ptr<DAG> NewFromProto(const DAGProto& dag_def);
 
  private:
+  void Prioritize();
+
   std::string name_;
   std::vector<DAGNode*> nodes_;
   std::vector<DAGEdge*> edges_;
+  std::shared_ptr<TensorSlotMap> slot_map_;
 
   DISALLOW_COPY_AND_ASSIGN(DAG);
 };
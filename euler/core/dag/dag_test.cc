@@ -22,6 +22,9 @@ limitations under the License.
 #include "gtest/gtest.h"
 
 #include "euler/core/dag/dag.h"
+#include "euler/core/dag/node.h"
+#include "euler/core/framework/dag.pb.h"
+#include "euler/core/framework/op_kernel.h"
 
 namespace euler {
 
@@ -31,4 +34,103 @@ TEST(DAG, Construction) {
 TEST(DAG, Query) {
 }
 
+class TestRemoteOp: public AsyncOpKernel {
+ public:
+  explicit TestRemoteOp(const std::string& name): AsyncOpKernel(name) { }
+  void AsyncCompute(const DAGNodeProto& node_def, OpKernelContext* ctx,
+                    DoneCallback callback) override {
+    callback();
+  }
+};
+
+class TestComputeOp: public OpKernel {
+ public:
+  explicit TestComputeOp(const std::string& name): OpKernel(name) { }
+  void Compute(const DAGNodeProto& node_def, OpKernelContext* ctx) override {
+  }
+};
+
+class TestCheapOp: public TestComputeOp {
+ public:
+  using TestComputeOp::TestComputeOp;
+  bool IsCheap() const override { return true; }
+};
+
+REGISTER_OP_KERNEL("TEST_REMOTE", TestRemoteOp);
+REGISTER_OP_KERNEL("TEST_COMPUTE", TestComputeOp);
+REGISTER_OP_KERNEL("TEST_CHEAP", TestCheapOp);
+
+TEST(DAG, Priority) {
+  // remote -> cheap -> compute, compute
+  DAGProto proto;
+  auto node = proto.add_nodes();
+  node->set_name("remote");
+  node->set_op("TEST_REMOTE");
+  node = proto.add_nodes();
+  node->set_name("cheap");
+  node->set_op("TEST_CHEAP");
+  node->add_inputs("remote:0");
+  node = proto.add_nodes();
+  node->set_name("compute");
+  node->set_op("TEST_COMPUTE");
+  node->add_inputs("cheap:0");
+  node = proto.add_nodes();
+  node->set_name("other");
+  node->set_op("TEST_COMPUTE");
+
+  auto dag = DAG::NewFromProto(proto);
+  ASSERT_NE(nullptr, dag);
+  auto nodes = dag->nodes();
+  ASSERT_EQ(4, nodes.size());
+  ASSERT_NE(nullptr, nodes[0]->async_kernel());
+  ASSERT_EQ(nullptr, nodes[1]->async_kernel());
+  EXPECT_EQ(nodes[2]->kernel(), nodes[3]->kernel());
+  EXPECT_EQ(9, nodes[0]->priority());
+  EXPECT_EQ(1, nodes[1]->priority());
+  EXPECT_EQ(1, nodes[2]->priority());
+  EXPECT_EQ(1, nodes[3]->priority());
+
+  node = proto.add_nodes();
+  node->set_name("unknown");
+  node->set_op("TEST_UNKNOWN");
+  EXPECT_EQ(nullptr, DAG::NewFromProto(proto));
+}
+
+TEST(DAG, Slots) {
+  // remote -> compute, the remote node sends "input" to the server
+  DAGProto proto;
+  auto node = proto.add_nodes();
+  node->set_name("remote");
+  node->set_op("TEST_REMOTE");
+  node->set_output_num(1);
+  node->add_remote_output_list("remote,0:0");
+  auto inner = node->add_inner_nodes();
+  inner->set_name("inner");
+  inner->add_inputs("input");
+  node = proto.add_nodes();
+  node->set_name("compute");
+  node->set_op("TEST_COMPUTE");
+  node->set_output_num(1);
+  node->add_inputs("remote,0:0");
+  node->add_input_slots(100);  // Overwritten
+
+  auto dag = DAG::NewFromProto(proto);
+  ASSERT_NE(nullptr, dag);
+  auto slot_map = dag->slot_map();
+  auto nodes = dag->nodes();
+  const DAGNodeProto& remote = nodes[0]->def();
+  ASSERT_EQ(1, remote.output_slots_size());
+  EXPECT_EQ(slot_map->Find("remote:0"), remote.output_slots(0));
+  ASSERT_EQ(1, remote.remote_output_slots_size());
+  EXPECT_EQ(slot_map->Find("remote,0:0"), remote.remote_output_slots(0));
+  ASSERT_EQ(1, remote.inner_nodes(0).input_slots_size());
+  EXPECT_EQ(slot_map->Find("input"), remote.inner_nodes(0).input_slots(0));
+
+  const DAGNodeProto& compute = nodes[1]->def();
+  ASSERT_EQ(1, compute.input_slots_size());
+  EXPECT_EQ(remote.remote_output_slots(0), compute.input_slots(0));
+  ASSERT_EQ(1, compute.output_slots_size());
+  EXPECT_EQ(slot_map->Find("compute:0"), compute.output_slots(0));
+}
+
 }  // namespace euler
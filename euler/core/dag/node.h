@@ -27,7 +27,9 @@ limitations under the License.
 
 namespace euler {
 
+class AsyncOpKernel;
 class DAGEdge;
+class OpKernel;
 
 typedef std::unordered_set<DAGEdge*> EdgeSet;
 
@@ -41,6 +43,16 @@ class DAGNode {
 
   const DAGNodeProto& def() const { return def_; }
 
+  // Resolved once when the node is added to the DAG
+  OpKernel* kernel() const { return kernel_; }
+
+  // nullptr if the kernel is synchronous
+  AsyncOpKernel* async_kernel() const { return async_kernel_; }
+
+  // The cost of the longest path from the node to the sinks, the ready
+  // nodes on the critical path are started first
+  int priority() const { return priority_; }
+
   int num_inputs() const { return in_edges_.size(); }
   int num_outputs() const { return out_edges_.size(); }
 
@@ -55,10 +67,13 @@ class DAGNode {
 
  private:
   friend class DAG;
-  DAGNode() { }
+  DAGNode(): kernel_(nullptr), async_kernel_(nullptr), priority_(0) { }
 
   int id_;
   DAGNodeProto def_;
+  OpKernel* kernel_;
+  AsyncOpKernel* async_kernel_;
+  int priority_;
   EdgeSet in_edges_;
   EdgeSet out_edges_;
 
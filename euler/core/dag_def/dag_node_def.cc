@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "euler/core/dag_def/dag_node_def.h"
 
+#include "euler/common/hash.h"
+
 namespace euler {
 
 void NodeDef::ToProto(DAGNodeProto* proto) {
@@ -70,10 +72,14 @@ void RemoteNodeDef::ToProto(DAGNodeProto* proto) {
   this->NodeDef::ToProto(proto);
   proto->set_shard_idx(shard_idx_);
   // inner node
+  std::string inner_nodes;
   for (std::shared_ptr<NodeDef> inner_node : nodes_) {
     DAGNodeProto* inner_proto = proto->add_inner_nodes();
     inner_node->ToProto(inner_proto);
+    inner_proto->AppendToString(&inner_nodes);
   }
+  // plan id, the servers cache the inner dag by it
+  proto->set_plan_id(hash64(inner_nodes.data(), inner_nodes.size()));
   // output list
   proto->clear_output_list();
   for (const FusionOutput& output : fusion_output_map_) {
@@ -16,8 +16,29 @@ limitations under the License.
 
 #include "euler/core/framework/allocator.h"
 
+#include <stdlib.h>
+
 namespace euler {
 
+namespace {
+
+class MallocAllocator: public Allocator {
+ public:
+  void* Allocate(size_t size) override {
+    return malloc(size);
+  }
+  void Deallocate(void* ptr) override {
+    free(ptr);
+  }
+};
+
+}  // namespace
+
+Allocator* DefaultAllocator() {
+  static MallocAllocator allocator;
+  return &allocator;
+}
+
 Allocator* AllocatorManager::Get(const std::string& name,
                                  std::function<Allocator*()> creator) {
   MutexLock l(&mu_);
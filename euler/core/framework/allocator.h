@@ -42,6 +42,9 @@ class AllocatorManager : public Singleton<AllocatorManager> {
   std::unordered_map<std::string, RefCountedPtr<Allocator>> allocators_;
 };
 
+// The allocator based on malloc and free, never deleted
+Allocator* DefaultAllocator();
+
 }  // namespace euler
 
 #endif  // EULER_CORE_FRAMEWORK_ALLOCATOR_H_
@@ -0,0 +1,121 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/framework/arena_allocator.h"
+
+#include <stdlib.h>
+
+namespace euler {
+
+namespace {
+
+// Enough for all the data types, including the string pointers
+const size_t kAlignment = 16;
+
+}  // namespace
+
+const size_t ArenaAllocator::kDefaultBlockSize;
+const size_t ArenaAllocator::kDefaultMaxRetainedBlocks;
+
+ArenaAllocator::ArenaAllocator(size_t block_size, size_t max_retained_blocks)
+    : block_size_(block_size), max_retained_blocks_(max_retained_blocks),
+      used_blocks_(0), offset_(0) {
+}
+
+ArenaAllocator::~ArenaAllocator() {
+  for (auto block : blocks_) {
+    free(block);
+  }
+  for (auto buf : large_) {
+    free(buf);
+  }
+}
+
+void* ArenaAllocator::Allocate(size_t size) {
+  size = (size + kAlignment - 1) / kAlignment * kAlignment;
+  MutexLock l(&mu_);
+  if (size > block_size_) {
+    void* buf = malloc(size);
+    if (buf != nullptr) {
+      large_.push_back(buf);
+    }
+    return buf;
+  }
+
+  if (used_blocks_ == 0 || offset_ + size > block_size_) {
+    if (used_blocks_ == blocks_.size()) {
+      char* block = static_cast<char*>(malloc(block_size_));
+      if (block == nullptr) {
+        return nullptr;
+      }
+      blocks_.push_back(block);
+    }
+    ++used_blocks_;
+    offset_ = 0;
+  }
+  void* buf = blocks_[used_blocks_ - 1] + offset_;
+  offset_ += size;
+  return buf;
+}
+
+void ArenaAllocator::Reset() {
+  MutexLock l(&mu_);
+  for (auto buf : large_) {
+    free(buf);
+  }
+  large_.clear();
+  while (blocks_.size() > max_retained_blocks_) {
+    free(blocks_.back());
+    blocks_.pop_back();
+  }
+  used_blocks_ = 0;
+  offset_ = 0;
+}
+
+size_t ArenaAllocator::num_blocks() {
+  MutexLock l(&mu_);
+  return blocks_.size();
+}
+
+ArenaPool::ArenaPool(size_t capacity, size_t block_size)
+    : capacity_(capacity), block_size_(block_size), next_(0) {
+}
+
+RefCountedPtr<ArenaAllocator> ArenaPool::Acquire() {
+  {
+    MutexLock l(&mu_);
+    for (size_t i = 0; i < arenas_.size(); ++i) {
+      size_t index = (next_ + i) % arenas_.size();
+      // Only referred by the pool, no other one can refer it but us
+      if (arenas_[index]->RefCountIsOne()) {
+        next_ = index + 1;
+        arenas_[index]->Reset();
+        return arenas_[index];
+      }
+    }
+    if (arenas_.size() < capacity_) {
+      arenas_.push_back(RefCountedPtr<ArenaAllocator>::Create(block_size_));
+      return arenas_.back();
+    }
+  }
+  return RefCountedPtr<ArenaAllocator>::Create(block_size_);
+}
+
+size_t ArenaPool::size() {
+  MutexLock l(&mu_);
+  return arenas_.size();
+}
+
+}  // namespace euler
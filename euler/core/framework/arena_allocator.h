@@ -0,0 +1,90 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_FRAMEWORK_ARENA_ALLOCATOR_H_
+#define EULER_CORE_FRAMEWORK_ARENA_ALLOCATOR_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "euler/common/mutex.h"
+#include "euler/common/refcount.h"
+#include "euler/core/framework/allocator.h"
+
+namespace euler {
+
+// Allocate memory by bumping a pointer in large blocks. Deallocate does
+// nothing, all the memory is released at once by Reset, which is the case
+// of the tensors of a query: they die together with the query.
+class ArenaAllocator : public Allocator {
+ public:
+  static const size_t kDefaultBlockSize = 256 * 1024;
+  static const size_t kDefaultMaxRetainedBlocks = 16;
+
+  explicit ArenaAllocator(
+      size_t block_size = kDefaultBlockSize,
+      size_t max_retained_blocks = kDefaultMaxRetainedBlocks);
+
+  ~ArenaAllocator();
+
+  void* Allocate(size_t size) override;
+
+  void Deallocate(void* buf) override { }
+
+  // Release all the allocated memory, at most max_retained_blocks blocks
+  // are kept for the following allocations
+  void Reset();
+
+  size_t block_size() const { return block_size_; }
+
+  // The blocks allocated by malloc, excluding the ones larger than a block
+  size_t num_blocks();
+
+ private:
+  Mutex mu_;
+  const size_t block_size_;
+  const size_t max_retained_blocks_;
+  std::vector<char*> blocks_;  // Guard by mu_
+  size_t used_blocks_;         // Guard by mu_
+  size_t offset_;              // Offset in the last used block, guard by mu_
+  std::vector<void*> large_;   // Allocations larger than a block
+};
+
+// Recycle the arenas across queries. An arena is reused only when all the
+// buffers allocated from it are released, which may be later than its
+// query, e.g. the outputs referred by a grpc byte buffer.
+class ArenaPool {
+ public:
+  explicit ArenaPool(size_t capacity,
+                     size_t block_size = ArenaAllocator::kDefaultBlockSize);
+
+  // Return an empty arena. A new arena out of the pool is returned if all
+  // the capacity arenas are in use
+  RefCountedPtr<ArenaAllocator> Acquire();
+
+  size_t size();
+
+ private:
+  Mutex mu_;
+  const size_t capacity_;
+  const size_t block_size_;
+  std::vector<RefCountedPtr<ArenaAllocator>> arenas_;  // Guard by mu_
+  size_t next_;  // Where to start looking for a free arena, guard by mu_
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_FRAMEWORK_ARENA_ALLOCATOR_H_
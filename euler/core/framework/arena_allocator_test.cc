@@ -0,0 +1,120 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/framework/arena_allocator.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/tensor.h"
+
+namespace euler {
+
+TEST(ArenaAllocatorTest, Allocate) {
+  ArenaAllocator arena(1024, 2);
+  char* a = static_cast<char*>(arena.Allocate(10));
+  char* b = static_cast<char*>(arena.Allocate(100));
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(a) % 16);
+  ASSERT_EQ(a + 16, b);
+  ASSERT_EQ(1, arena.num_blocks());
+  memset(a, 1, 10);
+  memset(b, 2, 100);
+
+  // Not enough in the first block
+  char* c = static_cast<char*>(arena.Allocate(1000));
+  ASSERT_NE(nullptr, c);
+  memset(c, 3, 1000);
+  ASSERT_EQ(2, arena.num_blocks());
+
+  // Larger than a block
+  char* d = static_cast<char*>(arena.Allocate(4096));
+  ASSERT_NE(nullptr, d);
+  memset(d, 4, 4096);
+  ASSERT_EQ(2, arena.num_blocks());
+  ASSERT_EQ(1, a[9]);
+  ASSERT_EQ(2, b[99]);
+
+  // Blocks are reused after reset
+  arena.Allocate(1000);
+  ASSERT_EQ(3, arena.num_blocks());
+  arena.Reset();
+  ASSERT_EQ(2, arena.num_blocks());
+  ASSERT_EQ(a, arena.Allocate(1000));
+  ASSERT_EQ(c, arena.Allocate(1000));
+  ASSERT_EQ(2, arena.num_blocks());
+}
+
+TEST(ArenaAllocatorTest, Tensor) {
+  auto arena = RefCountedPtr<ArenaAllocator>::Create();
+  {
+    Tensor tensor(arena.get(), {3}, DataType::kString);
+    for (int i = 0; i < 3; ++i) {
+      *tensor.Raw<std::string*>()[i] = "value";
+    }
+    ASSERT_FALSE(arena->RefCountIsOne());
+  }
+  ASSERT_TRUE(arena->RefCountIsOne());
+}
+
+TEST(ArenaPoolTest, Acquire) {
+  ArenaPool pool(2, 1024);
+  void* buf = nullptr;
+  {
+    auto arena = pool.Acquire();
+    buf = arena->Allocate(100);
+    ASSERT_EQ(1, pool.size());
+  }
+
+  // Recycled
+  auto arena1 = pool.Acquire();
+  ASSERT_EQ(1, pool.size());
+  ASSERT_EQ(buf, arena1->Allocate(100));
+
+  // Still referred by a buffer
+  Buffer* buffer = new Buffer(arena1.get(), 100);
+  arena1 = pool.Acquire();
+  ASSERT_EQ(2, pool.size());
+  auto arena2 = pool.Acquire();
+  ASSERT_EQ(2, pool.size());
+  ASSERT_NE(arena1.get(), arena2.get());
+
+  // Released by the buffer
+  buffer->Unref();
+  auto arena3 = pool.Acquire();
+  ASSERT_NE(arena2.get(), arena3.get());
+  ASSERT_EQ(buf, arena3->Allocate(100));
+}
+
+TEST(ArenaPoolTest, Context) {
+  Tensor* tensor = nullptr;
+  void* data = nullptr;
+  {
+    OpKernelContext ctx;
+    ASSERT_TRUE(ctx.Allocate("a", {100}, DataType::kInt64, &tensor).ok());
+    data = tensor->Raw<void>();
+  }
+
+  // The memory is reused by the next context
+  OpKernelContext ctx;
+  ASSERT_TRUE(ctx.Allocate("b", {100}, DataType::kInt64, &tensor).ok());
+  ASSERT_EQ(data, tensor->Raw<void>());
+}
+
+}  // namespace euler
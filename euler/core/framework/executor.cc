@@ -15,20 +15,27 @@ limitations under the License.
 
 #include "euler/core/framework/executor.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "euler/common/env.h"
+#include "euler/common/hash.h"
+#include "euler/common/random.h"
 #include "euler/common/signal.h"
 #include "euler/common/logging.h"
 #include "euler/core/dag/node.h"
 #include "euler/core/dag/edge.h"
 #include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/tracer.h"
 
 namespace euler {
 
 Executor::Executor(DAG* dag, ThreadPool* thread_pool, OpKernelContext* ctx)
     : dag_(dag), thread_pool_(thread_pool), ctx_(ctx),
       ref_(dag->num_nodes()), remain_node_(dag->num_nodes()) {
+  ctx_->BindSlots(dag->slot_map());
   for (auto& node : dag->nodes()) {
     ref_[node->id()] = node->num_inputs();
   }
@@ -47,9 +54,7 @@ void Executor::RunInternal() {
       frontier.emplace_back(node);
     }
   }
-  for (auto& node : frontier) {
-    Run(node);
-  }
+  RunReady(&frontier, false);
 }
 
 void Executor::Run(DoneCallback callback) {
@@ -57,35 +62,84 @@ void Executor::Run(DoneCallback callback) {
   RunInternal();
 }
 
-void Executor::Run(DAGNode* node) {
-  OpKernel* op_base = nullptr;
+void Executor::RunReady(std::vector<DAGNode*>* ready, bool in_place) {
+  std::stable_sort(ready->begin(), ready->end(),
+                   [] (const DAGNode* a, const DAGNode* b) {
+                     return a->priority() > b->priority();
+                   });
+  DAGNode* local = nullptr;
+  size_t num_cheap = 0;
+  for (auto node : *ready) {
+    if (node->kernel()->IsCheap()) {
+      ++num_cheap;
+    } else if (in_place && local == nullptr) {
+      local = node;
+    } else {
+      Schedule(node);
+    }
+  }
 
-  auto s = CreateOpKernel(node->op(), &op_base);
-  if (!s.ok()) {
-    EULER_LOG(FATAL) << "Create kernel: " << node->name() << " failed!";
+  // The DAG is not done until the nodes below run, so the executor is alive
+  for (size_t i = 0; num_cheap > 0; ++i) {
+    DAGNode* node = (*ready)[i];
+    if (node->kernel()->IsCheap()) {
+      --num_cheap;
+      Run(node, in_place);
+    }
+  }
+  if (local != nullptr) {
+    Run(local, true);
   }
+}
 
-  AsyncOpKernel* op = dynamic_cast<AsyncOpKernel*>(op_base);
-  if (op != nullptr) {  // Async op
-    thread_pool_->Schedule([this, node, op] () {
-        op->AsyncCompute(node->def(), ctx_, [this, node] () {
-            RunDone(node);
-        });
+void Executor::Run(DAGNode* node, bool in_place) {
+  Tracer* tracer = ctx_->tracer();
+  uint64_t start = tracer != nullptr ? Tracer::NowMicros() : 0;
+  // Each node draws from its own stream of the seed, so the samples do not
+  // depend on the order or the threads the nodes run on
+  std::unique_ptr<common::ScopedRandomSeed> seed;
+  if (ctx_->seeded()) {
+    const std::string& name = node->name();
+    seed.reset(new common::ScopedRandomSeed(
+        ctx_->seed(), hash64(name.data(), name.size())));
+  }
+  AsyncOpKernel* op = node->async_kernel();
+  if (op != nullptr) {
+    uint64_t thread = tracer != nullptr ? Tracer::CurrentThread() : 0;
+    // Not to compute the successors on the thread of the async kernel,
+    // e.g. the rpc completion thread
+    op->AsyncCompute(node->def(), ctx_, [this, node, tracer, start, thread] () {
+        if (tracer != nullptr) {
+          tracer->AddSpan({node->name(), node->op(), Tracer::kClientProcess,
+                           thread, start, Tracer::NowMicros()});
+        }
+        RunDone(node, false);
     });
   } else {
-    thread_pool_->Schedule([this, node, op_base] () {
-        op_base->Compute(node->def(), ctx_);
-        RunDone(node);});
+    node->kernel()->Compute(node->def(), ctx_);
+    seed.reset();
+    if (tracer != nullptr) {
+      tracer->AddSpan(node->name(), node->op(), start, Tracer::NowMicros());
+    }
+    RunDone(node, in_place);
   }
 }
 
-void Executor::RunDone(DAGNode* node) {
+void Executor::Schedule(DAGNode* node) {
+  thread_pool_->Schedule([this, node] () { Run(node, true); });
+}
+
+void Executor::RunDone(DAGNode* node, bool in_place) {
+  std::vector<DAGNode*> ready;
   for (auto edge : node->output_edges()) {
     auto dst = edge->dst();
     if (--ref_[dst->id()] == 0) {
-      Run(dst);
+      ready.push_back(dst);
     }
   }
+  if (!ready.empty()) {
+    RunReady(&ready, in_place);
+  }
 
   if (--remain_node_ == 0) {
     callback_();
@@ -38,8 +38,16 @@ class Executor {
 
  private:
   void RunInternal();
-  void Run(DAGNode* node);
-  void RunDone(DAGNode* node);
+
+  // Start the nodes just made ready. The cheap ones run inline, the others
+  // are scheduled by priority so the remote ones are issued first. If
+  // in_place, the most urgent one runs on the calling thread.
+  void RunReady(std::vector<DAGNode*>* ready, bool in_place);
+
+  // The successors of a synchronous node are run in place if in_place
+  void Run(DAGNode* node, bool in_place);
+  void Schedule(DAGNode* node);
+  void RunDone(DAGNode* node, bool in_place);
 
  private:
   DAG* dag_;
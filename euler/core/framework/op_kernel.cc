@@ -26,11 +26,15 @@ limitations under the License.
 #include "euler/core/framework/types.h"
 #include "euler/core/framework/tensor.h"
 #include "euler/core/framework/tensor_util.h"
+#include "euler/core/framework/tracer.h"
 
 namespace euler {
 
 namespace {
 
+// The arenas kept for the concurrent queries
+const size_t kContextArenaPoolSize = 64;
+
 class OpKernelCache {
  public:
   ~OpKernelCache() {
@@ -77,37 +81,89 @@ void AsyncOpKernel::Compute(const DAGNodeProto& node_def,
   sig.Wait();
 }
 
+// Never deleted, the tensors may be released after the exit
+static ArenaPool* ContextArenaPool() {
+  static ArenaPool* pool = new ArenaPool(kContextArenaPoolSize);
+  return pool;
+}
+
+OpKernelContext::OpKernelContext()
+    : allocator_(ContextArenaPool()->Acquire()), seeded_(false), seed_(0) {
+}
+
+int TensorSlotMap::Add(const std::string& name) {
+  auto it = slots_.insert({name, static_cast<int>(names_.size())});
+  if (it.second) {
+    names_.push_back(name);
+  }
+  return it.first->second;
+}
+
 OpKernelContext::~OpKernelContext() {
   MutexLock l(&mu_);
   std::unordered_set<Tensor*> set;
   for (auto& item : tensor_map_) {
-    if (set.find(item.second) == set.end()) {
-      set.insert(item.second);
-      delete item.second;
-    }
+    set.insert(item.second);
   }
   tensor_map_.clear();
+  int num_slots = slot_map_ == nullptr ? 0 : slot_map_->size();
+  for (int i = 0; i < num_slots; ++i) {
+    Tensor* tensor = slots_[i].load();
+    if (tensor != nullptr) {
+      set.insert(tensor);
+    }
+  }
+  for (auto tensor : set) {
+    delete tensor;
+  }
 }
 
-class MallocAllocator: public Allocator {
- public:
-  void* Allocate(size_t size) override {
-    return malloc(size);
+void OpKernelContext::BindSlots(
+    std::shared_ptr<const TensorSlotMap> slot_map) {
+  MutexLock l(&mu_);
+  if (slot_map_ != nullptr) {
+    for (int i = 0; i < slot_map_->size(); ++i) {
+      Tensor* tensor = slots_[i].load();
+      if (tensor != nullptr) {
+        tensor_map_.insert({slot_map_->name(i), tensor});
+      }
+    }
   }
-  void Deallocate(void* ptr) override {
-    free(ptr);
+
+  slot_map_ = std::move(slot_map);
+  slots_.reset();
+  if (slot_map_ == nullptr) {
+    return;
   }
-};
+  slots_.reset(new std::atomic<Tensor*>[slot_map_->size()]);
+  for (int i = 0; i < slot_map_->size(); ++i) {
+    auto it = tensor_map_.find(slot_map_->name(i));
+    if (it == tensor_map_.end()) {
+      slots_[i].store(nullptr);
+    } else {
+      slots_[i].store(it->second);
+      tensor_map_.erase(it);
+    }
+  }
+}
 
-static Allocator* ContextTensorAllocator() {
-  static MallocAllocator allocator;
-  return &allocator;
+Status OpKernelContext::AddToSlot(int slot, Tensor* tensor) {
+  Tensor* expected = nullptr;
+  if (!slots_[slot].compare_exchange_strong(expected, tensor)) {
+    return Status::Internal("Tensor '", slot_map_->name(slot), "' exists!");
+  }
+  return Status::OK();
 }
 
 Status OpKernelContext::Allocate(const std::string& name,
                                  const TensorShape& shape,
                                  DataType type, Tensor** tensor) {
-  *tensor = new Tensor(ContextTensorAllocator(), shape, type);
+  int s = slot(name);
+  if (s >= 0) {
+    return Allocate(s, shape, type, tensor);
+  }
+
+  *tensor = new Tensor(allocator_.get(), shape, type);
   if (!(*tensor)->Initialized()) {
     return Status::Internal("Allocate memory for tensor failed, shape:",
                             shape.DebugString(), ", DataType: ", type);
@@ -123,6 +179,57 @@ Status OpKernelContext::Allocate(const std::string& name,
   return Status::OK();
 }
 
+Status OpKernelContext::Allocate(int slot, const TensorShape& shape,
+                                 DataType type, Tensor** tensor) {
+  *tensor = new Tensor(allocator_.get(), shape, type);
+  if (!(*tensor)->Initialized()) {
+    return Status::Internal("Allocate memory for tensor failed, shape:",
+                            shape.DebugString(), ", DataType: ", type);
+  }
+  auto s = AddToSlot(slot, *tensor);
+  if (!s.ok()) {
+    delete (*tensor);
+    *tensor = nullptr;
+  }
+  return s;
+}
+
+Status OpKernelContext::input(const DAGNodeProto& node_def, int i,
+                              Tensor** tensor) {
+  if (slot_map_ != nullptr && i < node_def.input_slots_size()) {
+    return this->tensor(node_def.input_slots(i), tensor);
+  }
+  return this->tensor(node_def.inputs(i), tensor);
+}
+
+Status OpKernelContext::AllocateOutput(const DAGNodeProto& node_def, int i,
+                                       const TensorShape& shape,
+                                       DataType type, Tensor** tensor) {
+  if (slot_map_ != nullptr && i < node_def.output_slots_size()) {
+    return Allocate(node_def.output_slots(i), shape, type, tensor);
+  }
+  return Allocate(OutputName(node_def, i), shape, type, tensor);
+}
+
+Status OpKernelContext::AddRemoteOutput(const DAGNodeProto& node_def, int i,
+                                        Tensor* tensor) {
+  if (slot_map_ != nullptr && i < node_def.remote_output_slots_size()) {
+    auto s = AddToSlot(node_def.remote_output_slots(i), tensor);
+    if (!s.ok()) {
+      delete tensor;
+    }
+    return s;
+  }
+  return AddTensor(node_def.remote_output_list(i), tensor);
+}
+
+Tracer* OpKernelContext::EnableTrace() {
+  if (tracer_ == nullptr) {
+    tracer_.reset(new Tracer());
+  }
+  return tracer_.get();
+}
+
 Status OpKernelContext::Allocate(const TensorProto& proto) {
   Tensor* tensor = nullptr;
   TensorShape tensor_shape =
@@ -144,9 +251,31 @@ Status OpKernelContext::Allocate(const std::string& name,
   return Decode(proto, tensor);
 }
 
+Status OpKernelContext::AddTensor(const std::string& name, Tensor* tensor) {
+  int s = slot(name);
+  if (s >= 0) {
+    auto status = AddToSlot(s, tensor);
+    if (!status.ok()) {
+      delete tensor;
+    }
+    return status;
+  }
+
+  MutexLock l(&mu_);
+  if (!tensor_map_.insert({name, tensor}).second) {
+    delete tensor;
+    return Status::Internal("Tensor: ", name, " Exists!");
+  }
+  return Status::OK();
+}
 
 Status OpKernelContext::AddAlias(const std::string& name,
                                  Tensor* tensor) {
+  int s = slot(name);
+  if (s >= 0) {
+    return AddToSlot(s, tensor);
+  }
+
   MutexLock l(&mu_);
   auto it = tensor_map_.find(name);
   if (it != tensor_map_.end()) {
@@ -157,6 +286,11 @@ Status OpKernelContext::AddAlias(const std::string& name,
 }
 
 Status OpKernelContext::tensor(const std::string& name, Tensor** tensor) {
+  int s = slot(name);
+  if (s >= 0) {
+    return this->tensor(s, tensor);
+  }
+
   *tensor = nullptr;
   {
     MutexLock l(&mu_);
@@ -169,7 +303,22 @@ Status OpKernelContext::tensor(const std::string& name, Tensor** tensor) {
   return Status::OK();
 }
 
+Status OpKernelContext::tensor(int slot, Tensor** tensor) {
+  *tensor = slots_[slot].load();
+  if (*tensor == nullptr) {
+    return Status::NotFound("Tensor '", slot_map_->name(slot),
+                            "' not found!");
+  }
+  return Status::OK();
+}
+
 Status OpKernelContext::RemoveAlias(const std::string& name) {
+  int s = slot(name);
+  if (s >= 0) {
+    slots_[s].store(nullptr);
+    return Status::OK();
+  }
+
   MutexLock l(&mu_);
   auto it =  tensor_map_.find(name);
   if (it != tensor_map_.end()) {
@@ -179,6 +328,12 @@ Status OpKernelContext::RemoveAlias(const std::string& name) {
 }
 
 Status OpKernelContext::Deallocate(const std::string& name) {
+  int s = slot(name);
+  if (s >= 0) {
+    delete slots_[s].exchange(nullptr);
+    return Status::OK();
+  }
+
   MutexLock l(&mu_);
   auto it = tensor_map_.find(name);
   if (it != tensor_map_.end()) {
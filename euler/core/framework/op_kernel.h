@@ -17,13 +17,16 @@ limitations under the License.
 #ifndef EULER_CORE_FRAMEWORK_OP_KERNEL_H_
 #define EULER_CORE_FRAMEWORK_OP_KERNEL_H_
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "euler/core/framework/types.h"
 #include "euler/common/status.h"
+#include "euler/core/framework/arena_allocator.h"
 #include "euler/core/framework/tensor.h"
 #include "euler/core/framework/tensor_shape.h"
 #include "euler/core/framework/attr_value.h"
@@ -34,6 +37,7 @@ namespace euler {
 
 class DAGNodeProto;
 class OpKernelContext;
+class Tracer;
 
 class OpKernel {
  public:
@@ -51,6 +55,11 @@ class OpKernel {
   // An asynchronous OpKernel must subclass AsyncOpKernel.
   virtual void Compute(const DAGNodeProto& node_def, OpKernelContext* ctx) = 0;
 
+  // A cheap kernel, e.g. one only aliasing its inputs, is run inline by the
+  // Executor on the thread which makes it ready, saving a hop through the
+  // thread pool.
+  virtual bool IsCheap() const { return false; }
+
   const std::string& name() const { return name_; }
 
  private:
@@ -70,6 +79,28 @@ class AsyncOpKernel: public OpKernel {
                             OpKernelContext* ctx, DoneCallback callback) = 0;
 };
 
+// Map the tensor names of a DAG to the integer slots. It is built once with
+// the DAG and immutable after that, so it is read without locking.
+class TensorSlotMap {
+ public:
+  // Return the slot of the name, a new slot is added if not found
+  int Add(const std::string& name);
+
+  // Return -1 if not found
+  int Find(const std::string& name) const {
+    auto it = slots_.find(name);
+    return it == slots_.end() ? -1 : it->second;
+  }
+
+  int size() const { return names_.size(); }
+
+  const std::string& name(int slot) const { return names_[slot]; }
+
+ private:
+  std::unordered_map<std::string, int> slots_;
+  std::vector<std::string> names_;
+};
+
 class OpKernelContext {
  public:
   // OpKernelContext maintains the state in the OpKernel computation.
@@ -79,6 +110,11 @@ class OpKernelContext {
   //
   // All OpKernel retrieve their tensor inputs from the OpKernelContext
   // and allocate their output in the OpKernelContext.
+  //
+  // The tensors are allocated from an arena recycled across the contexts,
+  // their memory is released at once after the context and the tensors
+  // are destroyed.
+  OpKernelContext();
   ~OpKernelContext();
 
   Status Allocate(const std::string& name, const TensorShape& shape,
@@ -88,6 +124,9 @@ class OpKernelContext {
 
   Status Allocate(const std::string& name, const TensorProto& tensor_def);
 
+  // Add a tensor created outside, the context takes the ownership
+  Status AddTensor(const std::string& name, Tensor* tensor);
+
   Status AddAlias(const std::string& name, Tensor* tensor);
 
   Status tensor(const std::string& name, Tensor** tensor);
@@ -98,9 +137,69 @@ class OpKernelContext {
   // !!! Attention: iff tensor has alias, it's not safe to be deallocated
   Status Deallocate(const std::string& name);
 
+  // The tensors whose names are in the slot map are kept in the slots and
+  // accessed without locking, the others are kept in a map guarded by a
+  // mutex. The tensors already in the context are moved to the new slots.
+  // Must not be called concurrently with the other methods, e.g. it is
+  // called by the Executor before running the DAG.
+  void BindSlots(std::shared_ptr<const TensorSlotMap> slot_map);
+
+  // Return the slot of the name, or -1 if the name has no slot. Kernels
+  // resolving the same names repeatedly can keep the slots and access the
+  // tensors without hashing the names.
+  int slot(const std::string& name) const {
+    return slot_map_ == nullptr ? -1 : slot_map_->Find(name);
+  }
+
+  Status tensor(int slot, Tensor** tensor);
+
+  Status Allocate(int slot, const TensorShape& shape, DataType type,
+                  Tensor** tensor);
+
+  // The input i of the node through the slot resolved when the node is
+  // added to the DAG, see DAGNodeProto.input_slots. The name is looked up
+  // instead if no slot map is bound, e.g. the node is run without an
+  // Executor. The node must be of the DAG whose slot map is bound.
+  Status input(const DAGNodeProto& node_def, int i, Tensor** tensor);
+
+  // Allocate the output i of the node likewise
+  Status AllocateOutput(const DAGNodeProto& node_def, int i,
+                        const TensorShape& shape, DataType type,
+                        Tensor** tensor);
+
+  // Add the tensor created outside as the remote output i of the node
+  // likewise, the context takes the ownership
+  Status AddRemoteOutput(const DAGNodeProto& node_def, int i,
+                         Tensor* tensor);
+
+  // Record the spans of the execution, see Tracer
+  Tracer* EnableTrace();
+
+  // nullptr if the trace is not enabled
+  Tracer* tracer() const { return tracer_.get(); }
+
+  // Draw the samples of the execution from the streams of the seed, see
+  // Executor. Must be called before running.
+  void set_seed(uint64_t seed) {
+    seed_ = seed;
+    seeded_ = true;
+  }
+
+  bool seeded() const { return seeded_; }
+
+  uint64_t seed() const { return seed_; }
+
  private:
+  Status AddToSlot(int slot, Tensor* tensor);
+
+  RefCountedPtr<ArenaAllocator> allocator_;
+  std::shared_ptr<const TensorSlotMap> slot_map_;
+  std::unique_ptr<std::atomic<Tensor*>[]> slots_;
   Mutex mu_;
   std::unordered_map<std::string, Tensor*> tensor_map_;  // Guard by mu_
+  std::unique_ptr<Tracer> tracer_;
+  bool seeded_;
+  uint64_t seed_;
 };
 
 #define REGISTER_OP_KERNEL(name, cls) \
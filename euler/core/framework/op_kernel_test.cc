@@ -0,0 +1,139 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/framework/op_kernel.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "euler/core/framework/allocator.h"
+#include "euler/core/framework/dag_node.pb.h"
+
+namespace euler {
+
+TEST(TensorSlotMapTest, AddAndFind) {
+  TensorSlotMap slot_map;
+  ASSERT_EQ(0, slot_map.Add("a:0"));
+  ASSERT_EQ(1, slot_map.Add("b:0"));
+  ASSERT_EQ(0, slot_map.Add("a:0"));
+  ASSERT_EQ(2, slot_map.size());
+  ASSERT_EQ(1, slot_map.Find("b:0"));
+  ASSERT_EQ(-1, slot_map.Find("c:0"));
+  ASSERT_EQ("b:0", slot_map.name(1));
+}
+
+TEST(OpKernelContextTest, Slots) {
+  OpKernelContext ctx;
+  Tensor* input = nullptr;
+  ASSERT_TRUE(ctx.Allocate("input", {2}, DataType::kInt32, &input).ok());
+  ASSERT_EQ(-1, ctx.slot("input"));
+
+  auto slot_map = std::make_shared<TensorSlotMap>();
+  slot_map->Add("output:0");
+  slot_map->Add("input");
+  ctx.BindSlots(slot_map);
+
+  // The existing tensor is moved to its slot
+  int input_slot = ctx.slot("input");
+  ASSERT_EQ(1, input_slot);
+  Tensor* t = nullptr;
+  ASSERT_TRUE(ctx.tensor(input_slot, &t).ok());
+  ASSERT_EQ(input, t);
+  ASSERT_TRUE(ctx.tensor("input", &t).ok());
+  ASSERT_EQ(input, t);
+
+  // Accessed by the slot or the name
+  int output_slot = ctx.slot("output:0");
+  ASSERT_FALSE(ctx.tensor(output_slot, &t).ok());
+  Tensor* output = nullptr;
+  ASSERT_TRUE(ctx.Allocate(output_slot, {3}, DataType::kFloat,
+                           &output).ok());
+  ASSERT_TRUE(ctx.tensor("output:0", &t).ok());
+  ASSERT_EQ(output, t);
+  ASSERT_FALSE(ctx.Allocate("output:0", {3}, DataType::kFloat, &t).ok());
+  ASSERT_EQ(nullptr, t);
+
+  // Names without slot
+  ASSERT_TRUE(ctx.AddAlias("alias", output).ok());
+  ASSERT_TRUE(ctx.tensor("alias", &t).ok());
+  ASSERT_EQ(output, t);
+  ASSERT_TRUE(ctx.RemoveAlias("alias").ok());
+  ASSERT_FALSE(ctx.tensor("alias", &t).ok());
+
+  ASSERT_TRUE(ctx.RemoveAlias("output:0").ok());
+  ASSERT_FALSE(ctx.tensor(output_slot, &t).ok());
+  ASSERT_TRUE(ctx.AddTensor("output:0", output).ok());
+  ASSERT_TRUE(ctx.Deallocate("output:0").ok());
+  ASSERT_FALSE(ctx.tensor("output:0", &t).ok());
+
+  // Rebind to another DAG, tensors are kept
+  auto other = std::make_shared<TensorSlotMap>();
+  other->Add("other:0");
+  ctx.BindSlots(other);
+  ASSERT_EQ(-1, ctx.slot("input"));
+  ASSERT_TRUE(ctx.tensor("input", &t).ok());
+  ASSERT_EQ(input, t);
+}
+
+TEST(OpKernelContextTest, NodeSlots) {
+  DAGNodeProto node_def;
+  node_def.set_name("node");
+  node_def.set_output_num(1);
+  node_def.add_inputs("input");
+  node_def.add_input_slots(1);
+  node_def.add_output_slots(0);
+  node_def.add_remote_output_list("remote");
+  node_def.add_remote_output_slots(2);
+
+  // By name without the slots bound
+  OpKernelContext unbound;
+  Tensor* input = nullptr;
+  Tensor* t = nullptr;
+  ASSERT_TRUE(unbound.Allocate("input", {2}, DataType::kInt32, &input).ok());
+  ASSERT_TRUE(unbound.input(node_def, 0, &t).ok());
+  ASSERT_EQ(input, t);
+  Tensor* output = nullptr;
+  ASSERT_TRUE(unbound.AllocateOutput(node_def, 0, {3}, DataType::kFloat,
+                                     &output).ok());
+  ASSERT_TRUE(unbound.tensor("node:0", &t).ok());
+  ASSERT_EQ(output, t);
+
+  // By the slots of the node otherwise
+  auto slot_map = std::make_shared<TensorSlotMap>();
+  slot_map->Add("node:0");
+  slot_map->Add("input");
+  slot_map->Add("remote");
+  OpKernelContext ctx;
+  ctx.BindSlots(slot_map);
+  ASSERT_TRUE(ctx.Allocate("input", {2}, DataType::kInt32, &input).ok());
+  ASSERT_TRUE(ctx.input(node_def, 0, &t).ok());
+  ASSERT_EQ(input, t);
+  ASSERT_TRUE(ctx.AllocateOutput(node_def, 0, {3}, DataType::kFloat,
+                                 &output).ok());
+  ASSERT_TRUE(ctx.tensor(0, &t).ok());
+  ASSERT_EQ(output, t);
+  Tensor* remote = new Tensor(DefaultAllocator(), TensorShape({1}),
+                              DataType::kInt32);
+  ASSERT_TRUE(ctx.AddRemoteOutput(node_def, 0, remote).ok());
+  ASSERT_TRUE(ctx.tensor("remote", &t).ok());
+  ASSERT_EQ(remote, t);
+  // The tensor is deleted if it can not be added
+  ASSERT_FALSE(ctx.AddRemoteOutput(
+      node_def, 0, new Tensor(DefaultAllocator(), TensorShape({1}),
+                              DataType::kInt32)).ok());
+}
+
+}  // namespace euler
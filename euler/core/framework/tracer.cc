@@ -0,0 +1,109 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/framework/tracer.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <set>
+#include <utility>
+
+#include "euler/common/time_utils.h"
+
+namespace euler {
+
+namespace {
+
+void AppendJsonString(const std::string& value, std::string* out) {
+  out->push_back('"');
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out->append(buf);
+    } else {
+      out->push_back(c);
+    }
+  }
+  out->push_back('"');
+}
+
+}  // namespace
+
+const int32_t Tracer::kClientProcess;
+
+uint64_t Tracer::CurrentThread() {
+  static std::atomic<uint64_t> next_thread(0);
+  static thread_local uint64_t thread = ++next_thread;
+  return thread;
+}
+
+uint64_t Tracer::NowMicros() {
+  return TimeUtils::NowMicros();
+}
+
+void Tracer::AddSpan(Span span) {
+  MutexLock l(&mu_);
+  spans_.push_back(std::move(span));
+}
+
+void Tracer::AddSpan(const std::string& name, const std::string& category,
+                     uint64_t start, uint64_t end) {
+  AddSpan({name, category, kClientProcess, CurrentThread(), start, end});
+}
+
+std::vector<Tracer::Span> Tracer::spans() {
+  MutexLock l(&mu_);
+  return spans_;
+}
+
+std::string Tracer::ToChromeTrace() {
+  std::vector<Span> spans = this->spans();
+  std::set<int32_t> processes;
+  std::string out = "{\"traceEvents\":[";
+  for (size_t i = 0; i < spans.size(); ++i) {
+    const Span& span = spans[i];
+    processes.insert(span.process);
+    if (i > 0) {
+      out += ",";
+    }
+    out += "{\"name\":";
+    AppendJsonString(span.name, &out);
+    out += ",\"cat\":";
+    AppendJsonString(span.category, &out);
+    uint64_t duration = span.end > span.start ? span.end - span.start : 0;
+    out += ",\"ph\":\"X\",\"ts\":" + std::to_string(span.start) +
+        ",\"dur\":" + std::to_string(duration) +
+        ",\"pid\":" + std::to_string(span.process) +
+        ",\"tid\":" + std::to_string(span.thread) + "}";
+  }
+  // Name the processes
+  for (int32_t process : processes) {
+    std::string name = process == kClientProcess ? "client" :
+        "shard " + std::to_string(process - 1);
+    out += ",{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" +
+        std::to_string(process) + ",\"args\":{\"name\":";
+    AppendJsonString(name, &out);
+    out += "}}";
+  }
+  out += "]}";
+  return out;
+}
+
+}  // namespace euler
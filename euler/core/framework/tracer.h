@@ -0,0 +1,67 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_FRAMEWORK_TRACER_H_
+#define EULER_CORE_FRAMEWORK_TRACER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "euler/common/mutex.h"
+
+namespace euler {
+
+// Collect the spans of a query, e.g. the compiling, the DAG nodes and the
+// remote calls, together with the spans returned by the servers, and export
+// them in the Chrome trace_event format to be viewed in chrome://tracing.
+class Tracer {
+ public:
+  struct Span {
+    std::string name;
+    std::string category;  // e.g. the op of a DAG node
+    int32_t process;       // kClientProcess or the shard index + 1
+    uint64_t thread;
+    uint64_t start;        // Micros
+    uint64_t end;
+  };
+
+  static const int32_t kClientProcess = 0;
+
+  // A small id of the calling thread, stable through the thread's life
+  static uint64_t CurrentThread();
+
+  static uint64_t NowMicros();
+
+  // Thread safe
+  void AddSpan(Span span);
+
+  // A span of the calling thread in the client process
+  void AddSpan(const std::string& name, const std::string& category,
+               uint64_t start, uint64_t end);
+
+  std::vector<Span> spans();
+
+  std::string ToChromeTrace();
+
+ private:
+  Mutex mu_;
+  std::vector<Span> spans_;  // Guard by mu_
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_FRAMEWORK_TRACER_H_
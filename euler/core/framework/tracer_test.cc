@@ -0,0 +1,56 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/framework/tracer.h"
+
+#include <string>
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+namespace euler {
+
+TEST(TracerTest, CurrentThread) {
+  uint64_t thread = Tracer::CurrentThread();
+  EXPECT_EQ(thread, Tracer::CurrentThread());
+  uint64_t other = 0;
+  std::thread t([&other] () { other = Tracer::CurrentThread(); });
+  t.join();
+  EXPECT_NE(0, other);
+  EXPECT_NE(thread, other);
+}
+
+TEST(TracerTest, ChromeTrace) {
+  Tracer tracer;
+  EXPECT_EQ("{\"traceEvents\":[]}", tracer.ToChromeTrace());
+
+  tracer.AddSpan({"API_GET_NODE,1", "API_GET_NODE", 2, 7, 100, 150});
+  tracer.AddSpan({"a\"b", "op", Tracer::kClientProcess, 3, 120, 110});
+  ASSERT_EQ(2, tracer.spans().size());
+
+  std::string expected =
+      "{\"traceEvents\":["
+      "{\"name\":\"API_GET_NODE,1\",\"cat\":\"API_GET_NODE\",\"ph\":\"X\","
+      "\"ts\":100,\"dur\":50,\"pid\":2,\"tid\":7},"
+      "{\"name\":\"a\\\"b\",\"cat\":\"op\",\"ph\":\"X\","
+      "\"ts\":120,\"dur\":0,\"pid\":0,\"tid\":3},"
+      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+      "\"args\":{\"name\":\"client\"}},"
+      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,"
+      "\"args\":{\"name\":\"shard 1\"}}]}";
+  EXPECT_EQ(expected, tracer.ToChromeTrace());
+}
+
+}  // namespace euler
@@ -0,0 +1,726 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/graph/compact_node_store.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+#include "euler/common/logging.h"
+#include "euler/common/bytes_io.h"
+#include "euler/common/random.h"
+#include "euler/common/compact_weighted_collection.h"
+
+namespace euler {
+
+namespace {
+
+using euler::common::NodeID;
+using euler::common::IDWeightPair;
+
+inline uint64_t HashID(NodeID id) {
+  // MurmurHash3 64 bit finalizer
+  id ^= id >> 33;
+  id *= 0xff51afd7ed558ccdULL;
+  id ^= id >> 33;
+  id *= 0xc4ceb9fe1a85ec53ULL;
+  id ^= id >> 33;
+  return id;
+}
+
+// Neighbors of one row, laid out the same as NeighborInfo
+struct RowNeighbors {
+  const int32_t* group_ends;
+  const float* group_weights;
+  int32_t group_num;
+  const NodeID* neighbors;
+  const float* neighbors_weight;
+  const NodeID* sorted_neighbors;
+  const uint64_t* group_alias;
+  const float* alias_prob;
+  const int32_t* alias_index;
+
+  int32_t GroupBegin(int32_t edge_type) const {
+    return edge_type == 0 ? 0 : group_ends[edge_type - 1];
+  }
+
+  float GroupWeight(int32_t edge_type) const {
+    return edge_type == 0 ? group_weights[0] :
+        group_weights[edge_type] - group_weights[edge_type - 1];
+  }
+
+  float SumWeight() const {
+    return group_num == 0 ? 0 : group_weights[group_num - 1];
+  }
+
+  float Weight(int32_t idx) const {
+    return idx == 0 ? neighbors_weight[0] :
+        neighbors_weight[idx] - neighbors_weight[idx - 1];
+  }
+};
+
+RowNeighbors GetRowNeighbors(const CsrNeighbors& csr, size_t row) {
+  RowNeighbors ni;
+  uint64_t group_begin = csr.group_offsets[row];
+  uint64_t begin = csr.offsets[row];
+  ni.group_ends = csr.group_ends.data() + group_begin;
+  ni.group_weights = csr.group_weights.data() + group_begin;
+  ni.group_num = csr.group_offsets[row + 1] - group_begin;
+  ni.neighbors = csr.neighbors.data() + begin;
+  ni.neighbors_weight = csr.neighbors_weight.data() + begin;
+  ni.sorted_neighbors = csr.sorted_neighbors.empty() ?
+      ni.neighbors : csr.sorted_neighbors.data() + begin;
+  ni.group_alias = csr.group_alias.data() + group_begin;
+  ni.alias_prob = csr.alias_prob.data();
+  ni.alias_index = csr.alias_index.data();
+  return ni;
+}
+
+void AppendNeighbors(const NeighborInfo& ni, CsrNeighbors* csr) {
+  const auto& collection = ni.edge_group_collection;
+  float sum_weight = 0;
+  for (size_t i = 0; i < collection.GetSize(); ++i) {
+    sum_weight += collection.Get(i).second;
+    csr->group_weights.push_back(sum_weight);
+  }
+  csr->group_ends.append(ni.neighbor_groups_idx.begin(),
+                         ni.neighbor_groups_idx.begin() + collection.GetSize());
+  csr->group_offsets.push_back(csr->group_ends.size());
+
+  for (size_t i = 0; i < collection.GetSize(); ++i) {
+    if (i < ni.group_alias.size() && ni.group_alias[i].GetSize() > 0) {
+      csr->group_alias.push_back(csr->alias_prob.size());
+      const auto& prob = ni.group_alias[i].GetProb();
+      const auto& alias = ni.group_alias[i].GetAlias();
+      csr->alias_prob.append(prob.begin(), prob.end());
+      csr->alias_index.append(alias.begin(), alias.end());
+    } else {
+      csr->group_alias.push_back(kNoAlias);
+    }
+  }
+
+  if (!ni.sorted_neighbors.empty() && csr->sorted_neighbors.empty()) {
+    csr->sorted_neighbors.append(csr->neighbors.begin(),
+                                 csr->neighbors.end());
+  }
+  if (csr->neighbors.size() == csr->sorted_neighbors.size()) {
+    const auto& sorted = ni.sorted_neighbors.empty() ?
+        ni.neighbors : ni.sorted_neighbors;
+    csr->sorted_neighbors.append(sorted.begin(), sorted.end());
+  }
+  csr->neighbors.append(ni.neighbors.begin(), ni.neighbors.end());
+  csr->neighbors_weight.append(ni.neighbors_weight.begin(),
+                               ni.neighbors_weight.end());
+  csr->offsets.push_back(csr->neighbors.size());
+}
+
+template <class T, class Values>
+void AppendFeature(const std::vector<int32_t>& features_idx,
+                   const Values& features, size_t row,
+                   std::vector<FeatureColumn<T>>* columns) {
+  while (columns->size() < features_idx.size()) {
+    columns->emplace_back();
+    columns->back().offsets.resize(row + 1, 0);
+  }
+  for (size_t fid = 0; fid < columns->size(); ++fid) {
+    auto& column = (*columns)[fid];
+    if (fid < features_idx.size()) {
+      int32_t pre = fid == 0 ? 0 : features_idx[fid - 1];
+      column.values.append(features.begin() + pre,
+                           features.begin() + features_idx[fid]);
+    }
+    column.offsets.push_back(column.values.size());
+  }
+}
+
+template <class T, class NumT, class ValueT>
+void GetFeature(const std::vector<FeatureColumn<T>>& columns, size_t row,
+                const std::vector<int32_t>& fids,
+                std::vector<NumT>* feature_nums,
+                std::vector<ValueT>* feature_values) {
+  for (auto fid : fids) {
+    if (fid >= 0 && fid < static_cast<int32_t>(columns.size())) {
+      auto& column = columns[fid];
+      feature_nums->push_back(column.offsets[row + 1] - column.offsets[row]);
+    } else {
+      feature_nums->push_back(0);
+    }
+  }
+  for (auto fid : fids) {
+    if (fid >= 0 && fid < static_cast<int32_t>(columns.size())) {
+      auto& column = columns[fid];
+      feature_values->insert(feature_values->end(),
+                             column.values.begin() + column.offsets[row],
+                             column.values.begin() + column.offsets[row + 1]);
+    }
+  }
+}
+
+template <class T, class VecT>
+void GetFeatureVec(const std::vector<FeatureColumn<T>>& columns, size_t row,
+                   const std::vector<int32_t>& fids,
+                   std::vector<VecT>* feature_values) {
+  for (auto fid : fids) {
+    if (fid >= 0 && fid < static_cast<int32_t>(columns.size())) {
+      auto& column = columns[fid];
+      feature_values->emplace_back(
+          column.values.begin() + column.offsets[row],
+          column.values.begin() + column.offsets[row + 1]);
+    } else {
+      feature_values->emplace_back();
+    }
+  }
+}
+
+template <class T>
+bool WriteFeature(const std::vector<FeatureColumn<T>>& columns, size_t row,
+                  BytesWriter* writer) {
+  std::vector<int32_t> features_idx;
+  std::vector<T> features;
+  for (auto& column : columns) {
+    features.insert(features.end(),
+                    column.values.begin() + column.offsets[row],
+                    column.values.begin() + column.offsets[row + 1]);
+    features_idx.push_back(features.size());
+  }
+  return writer->Write(features_idx) && writer->Write(features);
+}
+
+bool WriteNeighbors(const RowNeighbors& ni, BytesWriter* writer) {
+  std::vector<int32_t> group_ids(ni.group_num);
+  std::vector<float> group_weights(ni.group_num);
+  for (int32_t i = 0; i < ni.group_num; ++i) {
+    group_ids[i] = i;
+    group_weights[i] = ni.GroupWeight(i);
+  }
+  int32_t size = ni.group_num == 0 ? 0 : ni.group_ends[ni.group_num - 1];
+  return writer->Write(group_ids) && writer->Write(group_weights) &&
+      writer->Write(std::vector<int32_t>(ni.group_ends,
+                                         ni.group_ends + ni.group_num)) &&
+      writer->Write(std::vector<NodeID>(ni.neighbors, ni.neighbors + size)) &&
+      writer->Write(std::vector<float>(ni.neighbors_weight,
+                                       ni.neighbors_weight + size));
+}
+
+// Call output(i, id, weight, type) for each of the count samples,
+// return false if nothing is sampled
+template <class Output>
+bool SampleRowNeighbor(
+    const RowNeighbors& ni, const std::vector<int32_t>& edge_types,
+    int32_t count, Output output) {
+  euler::common::CompactWeightedCollection<int32_t> sub_edge_group_collection;
+  bool sub_group = edge_types.size() > 1 &&
+      edge_types.size() < static_cast<size_t>(ni.group_num);
+  if (sub_group) {
+    std::vector<std::pair<int32_t, float>> edge_type_weight(edge_types.size());
+    for (size_t i = 0; i < edge_types.size(); ++i) {
+      int32_t edge_type = edge_types[i];
+      if (edge_type >= 0 && edge_type < ni.group_num) {
+        edge_type_weight[i] = {edge_type, ni.GroupWeight(edge_type)};
+      } else {
+        EULER_LOG(ERROR) << "input edge types vec error:" << edge_type;
+        return false;
+      }
+    }
+    sub_edge_group_collection.Init(edge_type_weight);
+  }
+
+  // The two uniforms of each alias draw are generated in batches, a batch
+  // covers at most the remaining samples
+  const int32_t kBatch = 64;
+  double uniforms[2 * kBatch];
+  int32_t batch_used = kBatch;
+  for (int32_t i = 0; i < count; ++i) {
+    int32_t edge_type = 0;
+    if (edge_types.size() == 1) {
+      edge_type = edge_types[0];
+      if (edge_type < 0 || edge_type >= ni.group_num) {
+        return false;
+      }
+      if (ni.group_ends[edge_type] - 1 < ni.GroupBegin(edge_type)) {
+        return false;
+      }
+    } else if (sub_group) {
+      if (sub_edge_group_collection.GetSumWeight() == 0) {
+        return false;
+      }
+      edge_type = sub_edge_group_collection.Sample().first;
+    } else {  // sampling in all edge groups
+      if (ni.SumWeight() == 0) {
+        return false;
+      }
+      edge_type = euler::common::RandomSelect<int32_t>(
+          ni.group_weights, 0, ni.group_num - 1);
+    }
+    size_t mid = 0;
+    uint64_t alias = ni.group_alias[edge_type];
+    if (alias != kNoAlias) {
+      int32_t size = ni.group_ends[edge_type] - ni.GroupBegin(edge_type);
+      if (batch_used == kBatch) {
+        euler::common::FillRandom(uniforms,
+                                  2 * std::min(kBatch, count - i));
+        batch_used = 0;
+      }
+      const double* u = uniforms + 2 * batch_used++;
+      int32_t column = floor(size * u[0]);
+      bool coin_toss = u[1] < ni.alias_prob[alias + column];
+      mid = ni.GroupBegin(edge_type) +
+          (coin_toss ? column : ni.alias_index[alias + column]);
+    } else {
+      mid = euler::common::RandomSelect<NodeID>(
+          ni.neighbors_weight, ni.GroupBegin(edge_type),
+          ni.group_ends[edge_type] - 1);
+    }
+    output(i, ni.neighbors[mid], ni.Weight(mid), edge_type);
+  }
+  return count > 0;
+}
+
+std::vector<IDWeightPair> SampleRowNeighbor(
+    const RowNeighbors& ni, const std::vector<int32_t>& edge_types,
+    int32_t count) {
+  std::vector<IDWeightPair> vec(count);
+  auto output = [&vec] (int32_t i, NodeID id, float weight, int32_t type) {
+    vec[i] = std::make_tuple(id, weight, type);
+  };
+  if (!SampleRowNeighbor(ni, edge_types, count, output)) {
+    vec.clear();
+  }
+  return vec;
+}
+
+std::vector<IDWeightPair> GetRowFullNeighbor(
+    const RowNeighbors& ni, const std::vector<int32_t>& edge_types) {
+  std::vector<IDWeightPair> vec;
+  vec.reserve(edge_types.size() * 2);
+  for (auto edge_type : edge_types) {
+    if (edge_type >= 0 && edge_type < ni.group_num) {
+      int32_t end_idx = ni.group_ends[edge_type];
+      for (int32_t j = ni.GroupBegin(edge_type); j < end_idx; ++j) {
+        vec.emplace_back(ni.neighbors[j], ni.Weight(j), edge_type);
+      }
+    }
+  }
+  return vec;
+}
+
+std::vector<IDWeightPair> GetRowSortedFullNeighbor(
+    const RowNeighbors& ni, const std::vector<int32_t>& edge_types) {
+  std::vector<IDWeightPair> vec;
+  vec.reserve(edge_types.size() * 2);
+  if (edge_types.size() == 0) {
+    return vec;
+  }
+  std::vector<int32_t> ptr_list(ni.group_num);
+  std::priority_queue<std::pair<NodeID, int32_t>,
+      std::vector<std::pair<NodeID, int32_t>>, NodeComparison> min_heap;
+  for (auto edge_type : edge_types) {
+    if (edge_type >= 0 && edge_type < ni.group_num &&
+        ni.group_ends[edge_type] - ni.GroupBegin(edge_type) > 0) {
+      int32_t begin_idx = ni.GroupBegin(edge_type);
+      min_heap.push({ni.neighbors[begin_idx], edge_type});
+      ptr_list[edge_type] = begin_idx;
+    }
+  }
+  while (!min_heap.empty()) {
+    int32_t edge_type = min_heap.top().second;
+    min_heap.pop();
+    int32_t ptr = ptr_list[edge_type]++;
+    vec.emplace_back(ni.neighbors[ptr], ni.Weight(ptr), edge_type);
+    if (ptr_list[edge_type] < ni.group_ends[edge_type]) {
+      min_heap.push({ni.neighbors[ptr_list[edge_type]], edge_type});
+    }
+  }
+  return vec;
+}
+
+std::vector<IDWeightPair> GetRowTopKNeighbor(
+    const RowNeighbors& ni, const std::vector<int32_t>& edge_types,
+    int32_t k) {
+  std::vector<IDWeightPair> vec;
+  if (k <= 0 || edge_types.size() == 0) {
+    return vec;
+  }
+  std::priority_queue<IDWeightPair, std::vector<IDWeightPair>,
+                      NodeWeightComparision> min_heap;
+  for (auto edge_type : edge_types) {
+    if (edge_type < 0 || edge_type >= ni.group_num) {
+      EULER_LOG(ERROR) << "input edge types vec error:"<< edge_type;
+      return vec;
+    }
+    for (int32_t j = ni.GroupBegin(edge_type);
+         j < ni.group_ends[edge_type]; ++j) {
+      if (static_cast<int32_t>(min_heap.size()) < k) {
+        min_heap.emplace(ni.neighbors[j], ni.Weight(j), edge_type);
+      } else if (std::get<1>(min_heap.top()) < ni.Weight(j)) {
+        min_heap.pop();
+        min_heap.emplace(ni.neighbors[j], ni.Weight(j), edge_type);
+      }
+    }
+  }
+  vec.resize(min_heap.size());
+  while (!min_heap.empty()) {
+    vec[min_heap.size() - 1] = min_heap.top();
+    min_heap.pop();
+  }
+  return vec;
+}
+
+void DumpNeighbors(const CsrNeighbors& csr, SnapshotWriter* writer) {
+  writer->Add(csr.group_offsets);
+  writer->Add(csr.group_ends);
+  writer->Add(csr.group_weights);
+  writer->Add(csr.offsets);
+  writer->Add(csr.neighbors);
+  writer->Add(csr.neighbors_weight);
+  writer->Add(csr.sorted_neighbors);
+  writer->Add(csr.group_alias);
+  writer->Add(csr.alias_prob);
+  writer->Add(csr.alias_index);
+}
+
+bool LoadNeighbors(SnapshotReader* reader, CsrNeighbors* csr) {
+  return reader->Next(&csr->group_offsets) &&
+      reader->Next(&csr->group_ends) &&
+      reader->Next(&csr->group_weights) &&
+      reader->Next(&csr->offsets) &&
+      reader->Next(&csr->neighbors) &&
+      reader->Next(&csr->neighbors_weight) &&
+      reader->Next(&csr->sorted_neighbors) &&
+      reader->Next(&csr->group_alias) &&
+      reader->Next(&csr->alias_prob) &&
+      reader->Next(&csr->alias_index);
+}
+
+template <class T>
+void DumpFeature(const std::vector<FeatureColumn<T>>& columns,
+                 SnapshotWriter* writer) {
+  for (auto& column : columns) {
+    writer->Add(column.offsets);
+    writer->Add(column.values);
+  }
+}
+
+template <class T>
+bool LoadFeature(SnapshotReader* reader, size_t column_num,
+                 std::vector<FeatureColumn<T>>* columns) {
+  columns->resize(column_num);
+  for (auto& column : *columns) {
+    if (!reader->Next(&column.offsets) || !reader->Next(&column.values)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+CompactNodeStore::CompactNodeStore() : index_mask_(0) {
+  out_.group_offsets.push_back(0);
+  out_.offsets.push_back(0);
+  in_.group_offsets.push_back(0);
+  in_.offsets.push_back(0);
+}
+
+void CompactNodeStore::Reserve(size_t size) {
+  ids_.reserve(size);
+  types_.reserve(size);
+  weights_.reserve(size);
+  out_.offsets.reserve(size + 1);
+  out_.group_offsets.reserve(size + 1);
+  in_.offsets.reserve(size + 1);
+  in_.group_offsets.reserve(size + 1);
+  size_t capacity = 16;
+  while (capacity < size * 2) {
+    capacity <<= 1;
+  }
+  if (capacity > index_.size()) {
+    RebuildIndex(capacity);
+  }
+}
+
+bool CompactNodeStore::Append(const Node& node) {
+  if (Find(node.id_) >= 0) {
+    return false;
+  }
+  if (ids_.size() >= UINT32_MAX - 1) {
+    EULER_LOG(ERROR) << "Too many nodes for compact node store";
+    return false;
+  }
+
+  size_t row = ids_.size();
+  ids_.push_back(node.id_);
+  types_.push_back(node.type_);
+  weights_.push_back(node.weight_);
+
+  AppendNeighbors(node.neighbor_info_, &out_);
+  AppendNeighbors(node.in_neighbor_info_, &in_);
+
+  AppendFeature(node.uint64_features_idx_, node.uint64_features_,
+                row, &uint64_features_);
+  AppendFeature(node.float_features_idx_, node.float_features_,
+                row, &float_features_);
+  AppendFeature(node.binary_features_idx_, node.binary_features_,
+                row, &binary_features_);
+
+  InsertIndex(row);
+  return true;
+}
+
+int64_t CompactNodeStore::Find(NodeID id) const {
+  if (index_.empty()) {
+    return -1;
+  }
+  for (uint64_t slot = HashID(id) & index_mask_; ;
+       slot = (slot + 1) & index_mask_) {
+    uint32_t value = index_[slot];
+    if (value == 0) {
+      return -1;
+    }
+    if (ids_[value - 1] == id) {
+      return value - 1;
+    }
+  }
+}
+
+void CompactNodeStore::InsertIndex(uint32_t row) {
+  // Keep the load factor no more than 0.5
+  if ((ids_.size() << 1) > index_.size()) {
+    RebuildIndex(index_.empty() ? 16 : index_.size() << 1);
+    return;
+  }
+  uint32_t* index = index_.mutable_data();
+  uint64_t slot = HashID(ids_[row]) & index_mask_;
+  while (index[slot] != 0) {
+    slot = (slot + 1) & index_mask_;
+  }
+  index[slot] = row + 1;
+}
+
+void CompactNodeStore::RebuildIndex(size_t capacity) {
+  index_.assign(capacity, 0);
+  index_mask_ = capacity - 1;
+  uint32_t* index = index_.mutable_data();
+  for (uint32_t row = 0; row < ids_.size(); ++row) {
+    uint64_t slot = HashID(ids_[row]) & index_mask_;
+    while (index[slot] != 0) {
+      slot = (slot + 1) & index_mask_;
+    }
+    index[slot] = row + 1;
+  }
+}
+
+std::vector<IDWeightPair> CompactNodeStore::SampleNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types, int32_t count) const {
+  return SampleRowNeighbor(GetRowNeighbors(out_, row), edge_types, count);
+}
+
+bool CompactNodeStore::SampleNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types, int32_t count,
+    NodeID* ids, float* weights, int32_t* types) const {
+  auto output = [ids, weights, types] (int32_t i, NodeID id, float weight,
+                                       int32_t type) {
+    ids[i] = id;
+    weights[i] = weight;
+    types[i] = type;
+  };
+  return SampleRowNeighbor(GetRowNeighbors(out_, row), edge_types, count,
+                           output);
+}
+
+std::vector<IDWeightPair> CompactNodeStore::SampleInNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types, int32_t count) const {
+  return SampleRowNeighbor(GetRowNeighbors(in_, row), edge_types, count);
+}
+
+std::vector<IDWeightPair> CompactNodeStore::GetFullNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types) const {
+  return GetRowFullNeighbor(GetRowNeighbors(out_, row), edge_types);
+}
+
+std::vector<IDWeightPair> CompactNodeStore::GetFullInNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types) const {
+  return GetRowFullNeighbor(GetRowNeighbors(in_, row), edge_types);
+}
+
+bool CompactNodeStore::HasNeighbor(size_t row,
+                                   const std::vector<int32_t>& edge_types,
+                                   NodeID id) const {
+  RowNeighbors ni = GetRowNeighbors(out_, row);
+  for (auto edge_type : edge_types) {
+    if (edge_type >= 0 && edge_type < ni.group_num) {
+      if (std::binary_search(ni.sorted_neighbors + ni.GroupBegin(edge_type),
+                             ni.sorted_neighbors + ni.group_ends[edge_type],
+                             id)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::vector<IDWeightPair> CompactNodeStore::GetSortedFullNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types) const {
+  return GetRowSortedFullNeighbor(GetRowNeighbors(out_, row), edge_types);
+}
+
+std::vector<IDWeightPair> CompactNodeStore::GetSortedFullInNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types) const {
+  return GetRowSortedFullNeighbor(GetRowNeighbors(in_, row), edge_types);
+}
+
+std::vector<IDWeightPair> CompactNodeStore::GetTopKNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types, int32_t k) const {
+  return GetRowTopKNeighbor(GetRowNeighbors(out_, row), edge_types, k);
+}
+
+std::vector<IDWeightPair> CompactNodeStore::GetTopKInNeighbor(
+    size_t row, const std::vector<int32_t>& edge_types, int32_t k) const {
+  return GetRowTopKNeighbor(GetRowNeighbors(in_, row), edge_types, k);
+}
+
+void CompactNodeStore::GetUint64Feature(
+    size_t row, const std::vector<int32_t>& fids,
+    std::vector<uint32_t>* feature_nums,
+    std::vector<uint64_t>* feature_values) const {
+  GetFeature(uint64_features_, row, fids, feature_nums, feature_values);
+}
+
+void CompactNodeStore::GetUint64Feature(
+    size_t row, const std::vector<int32_t>& fids,
+    std::vector<std::vector<uint64_t>>* feature_values) const {
+  GetFeatureVec(uint64_features_, row, fids, feature_values);
+}
+
+void CompactNodeStore::ClearFloat32Feature(int32_t fid) {
+  if (fid >= 0 && fid < static_cast<int32_t>(float_features_.size())) {
+    float_features_[fid].offsets.assign(size() + 1, 0);
+    float_features_[fid].values.clear();
+  }
+}
+
+void CompactNodeStore::GetFloat32Feature(
+    size_t row, const std::vector<int32_t>& fids,
+    std::vector<uint32_t>* feature_nums,
+    std::vector<float>* feature_values) const {
+  GetFeature(float_features_, row, fids, feature_nums, feature_values);
+}
+
+void CompactNodeStore::GetFloat32Feature(
+    size_t row, const std::vector<int32_t>& fids,
+    std::vector<std::vector<float>>* feature_values) const {
+  GetFeatureVec(float_features_, row, fids, feature_values);
+}
+
+void CompactNodeStore::GetBinaryFeature(
+    size_t row, const std::vector<int32_t>& fids,
+    std::vector<uint32_t>* feature_nums,
+    std::vector<char>* feature_values) const {
+  GetFeature(binary_features_, row, fids, feature_nums, feature_values);
+}
+
+void CompactNodeStore::GetBinaryFeature(
+    size_t row, const std::vector<int32_t>& fids,
+    std::vector<std::string>* feature_values) const {
+  GetFeatureVec(binary_features_, row, fids, feature_values);
+}
+
+bool CompactNodeStore::Serialize(size_t row, std::string* s) const {
+  BytesWriter bytes_writer;
+  if (!bytes_writer.Write(ids_[row]) || !bytes_writer.Write(types_[row]) ||
+      !bytes_writer.Write(weights_[row])) {
+    EULER_LOG(ERROR) << "node info error";
+    return false;
+  }
+
+  if (!WriteNeighbors(GetRowNeighbors(out_, row), &bytes_writer) ||
+      !WriteNeighbors(GetRowNeighbors(in_, row), &bytes_writer)) {
+    EULER_LOG(ERROR) << "neighbor info error, node_id: " << ids_[row];
+    return false;
+  }
+
+  if (!WriteFeature(uint64_features_, row, &bytes_writer) ||
+      !WriteFeature(float_features_, row, &bytes_writer)) {
+    EULER_LOG(ERROR) << "feature error, node_id: " << ids_[row];
+    return false;
+  }
+
+  std::vector<int32_t> binary_features_idx;
+  std::string binary_features;
+  for (auto& column : binary_features_) {
+    binary_features.append(column.values.begin() + column.offsets[row],
+                           column.values.begin() + column.offsets[row + 1]);
+    binary_features_idx.push_back(binary_features.size());
+  }
+  if (!bytes_writer.Write(binary_features_idx) ||
+      !bytes_writer.Write(binary_features)) {
+    EULER_LOG(ERROR) << "binary feature error, node_id: " << ids_[row];
+    return false;
+  }
+
+  *s = bytes_writer.data();
+  return true;
+}
+
+void CompactNodeStore::DumpSnapshot(SnapshotWriter* writer) const {
+  std::vector<uint64_t> column_nums = {uint64_features_.size(),
+                                       float_features_.size(),
+                                       binary_features_.size()};
+  writer->Copy(column_nums);
+  writer->Add(ids_);
+  writer->Add(types_);
+  writer->Add(weights_);
+  writer->Add(index_);
+  DumpNeighbors(out_, writer);
+  DumpNeighbors(in_, writer);
+  DumpFeature(uint64_features_, writer);
+  DumpFeature(float_features_, writer);
+  DumpFeature(binary_features_, writer);
+}
+
+bool CompactNodeStore::LoadSnapshot(SnapshotReader* reader) {
+  std::vector<uint64_t> column_nums;
+  if (!reader->Next(&column_nums) || column_nums.size() != 3 ||
+      !reader->Next(&ids_) || !reader->Next(&types_) ||
+      !reader->Next(&weights_) || !reader->Next(&index_) ||
+      !LoadNeighbors(reader, &out_) || !LoadNeighbors(reader, &in_) ||
+      !LoadFeature(reader, column_nums[0], &uint64_features_) ||
+      !LoadFeature(reader, column_nums[1], &float_features_) ||
+      !LoadFeature(reader, column_nums[2], &binary_features_)) {
+    EULER_LOG(ERROR) << "Invalid compact node store in snapshot";
+    return false;
+  }
+  if (types_.size() != ids_.size() || weights_.size() != ids_.size() ||
+      out_.offsets.size() != ids_.size() + 1 ||
+      in_.offsets.size() != ids_.size() + 1 ||
+      out_.group_alias.size() != out_.group_ends.size() ||
+      in_.group_alias.size() != in_.group_ends.size() ||
+      (!out_.sorted_neighbors.empty() &&
+       out_.sorted_neighbors.size() != out_.neighbors.size()) ||
+      (!in_.sorted_neighbors.empty() &&
+       in_.sorted_neighbors.size() != in_.neighbors.size()) ||
+      index_.size() < ids_.size() * 2 ||
+      (index_.size() & (index_.size() - 1)) != 0) {
+    EULER_LOG(ERROR) << "Inconsistent compact node store in snapshot";
+    return false;
+  }
+  index_mask_ = index_.size() - 1;
+  return true;
+}
+
+}  // namespace euler
@@ -0,0 +1,193 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_GRAPH_COMPACT_NODE_STORE_H_
+#define EULER_CORE_GRAPH_COMPACT_NODE_STORE_H_
+
+#include <stdint.h>
+
+#include <vector>
+#include <string>
+
+#include "euler/common/data_types.h"
+#include "euler/common/flat_vector.h"
+#include "euler/core/graph/node.h"
+#include "euler/core/graph/graph_snapshot.h"
+
+namespace euler {
+
+// Global CSR arrays of the out or in neighbors of all the nodes in a store.
+// Row r owns edge groups [group_offsets[r], group_offsets[r + 1]) and
+// neighbors [offsets[r], offsets[r + 1]). group_ends and neighbors_weight
+// are local to the row, the same as NeighborInfo in node.h. The alias tables
+// of the groups are copied from the nodes appended.
+struct CsrNeighbors {
+  euler::common::FlatVector<uint64_t> group_offsets;
+  euler::common::FlatVector<int32_t> group_ends;
+  // cumulative weights of the groups
+  euler::common::FlatVector<float> group_weights;
+  euler::common::FlatVector<uint64_t> offsets;
+  euler::common::FlatVector<euler::common::NodeID> neighbors;
+  // cumulative weights of neighbors
+  euler::common::FlatVector<float> neighbors_weight;
+  // The neighbors with each group sorted by id for HasNeighbor, empty until
+  // a node with unsorted groups is appended, see NeighborInfo.
+  euler::common::FlatVector<euler::common::NodeID> sorted_neighbors;
+  // Offsets of the alias tables of the groups in alias_prob and alias_index,
+  // kNoAlias for the groups sampled by binary search, see
+  // Node::BuildNeighborAlias.
+  euler::common::FlatVector<uint64_t> group_alias;
+  euler::common::FlatVector<float> alias_prob;
+  euler::common::FlatVector<int32_t> alias_index;  // local to the group
+};
+
+const uint64_t kNoAlias = UINT64_MAX;
+
+// Values of one feature for all the nodes, the value of row r is
+// [offsets[r], offsets[r + 1]).
+template <class T>
+struct FeatureColumn {
+  euler::common::FlatVector<uint64_t> offsets;
+  euler::common::FlatVector<T> values;
+};
+
+// Columnar storage of all the nodes of a graph shard. A node is addressed by
+// a dense row number, rows are found by an open addressing id index. Compared
+// to a heap allocated Node per vertex it has no per-node allocation and all
+// the lookups read contiguous memory. All the arrays can be borrowed from a
+// memory mapped snapshot, see graph_snapshot.h.
+class CompactNodeStore {
+ public:
+  CompactNodeStore();
+
+  // Append a copy of the node, return false if the node id already exists.
+  bool Append(const Node& node);
+
+  // Return the row of the node, -1 if not found.
+  int64_t Find(euler::common::NodeID id) const;
+
+  size_t size() const { return ids_.size(); }
+
+  void Reserve(size_t size);
+
+  euler::common::NodeID GetID(size_t row) const { return ids_[row]; }
+
+  int32_t GetType(size_t row) const { return types_[row]; }
+
+  float GetWeight(size_t row) const { return weights_[row]; }
+
+  // The following accessors have the same semantic as the ones of Node
+
+  std::vector<euler::common::IDWeightPair>
+  SampleNeighbor(size_t row, const std::vector<int32_t>& edge_types,
+                 int32_t count) const;
+
+  bool SampleNeighbor(size_t row, const std::vector<int32_t>& edge_types,
+                      int32_t count, euler::common::NodeID* ids,
+                      float* weights, int32_t* types) const;
+
+  std::vector<euler::common::IDWeightPair>
+  SampleInNeighbor(size_t row, const std::vector<int32_t>& edge_types,
+                   int32_t count) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetFullNeighbor(size_t row, const std::vector<int32_t>& edge_types) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetFullInNeighbor(size_t row, const std::vector<int32_t>& edge_types) const;
+
+  bool HasNeighbor(size_t row, const std::vector<int32_t>& edge_types,
+                   euler::common::NodeID id) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetSortedFullNeighbor(size_t row,
+                        const std::vector<int32_t>& edge_types) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetSortedFullInNeighbor(size_t row,
+                          const std::vector<int32_t>& edge_types) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetTopKNeighbor(size_t row, const std::vector<int32_t>& edge_types,
+                  int32_t k) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetTopKInNeighbor(size_t row, const std::vector<int32_t>& edge_types,
+                    int32_t k) const;
+
+  void GetUint64Feature(
+      size_t row, const std::vector<int32_t>& fids,
+      std::vector<uint32_t>* feature_nums,
+      std::vector<uint64_t>* feature_values) const;
+
+  void GetUint64Feature(
+      size_t row, const std::vector<int32_t>& fids,
+      std::vector<std::vector<uint64_t>>* feature_values) const;
+
+  void GetFloat32Feature(
+      size_t row, const std::vector<int32_t>& fids,
+      std::vector<uint32_t>* feature_nums,
+      std::vector<float>* feature_values) const;
+
+  void GetFloat32Feature(
+      size_t row, const std::vector<int32_t>& fids,
+      std::vector<std::vector<float>>* feature_values) const;
+
+  void GetBinaryFeature(
+      size_t row, const std::vector<int32_t>& fids,
+      std::vector<uint32_t>* feature_nums,
+      std::vector<char>* feature_values) const;
+
+  void GetBinaryFeature(
+      size_t row, const std::vector<int32_t>& fids,
+      std::vector<std::string>* feature_values) const;
+
+  // Drop the values of the float feature fid of all the rows
+  void ClearFloat32Feature(int32_t fid);
+
+  // Serialize a row with the same binary format as Node::Serialize
+  bool Serialize(size_t row, std::string* s) const;
+
+  // Add all the arrays of the store to a snapshot
+  void DumpSnapshot(SnapshotWriter* writer) const;
+
+  // Refer to the arrays of a snapshot instead of owning them, the store
+  // copies an array when it is modified later.
+  bool LoadSnapshot(SnapshotReader* reader);
+
+ private:
+  void InsertIndex(uint32_t row);
+
+  void RebuildIndex(size_t capacity);
+
+  euler::common::FlatVector<euler::common::NodeID> ids_;
+  euler::common::FlatVector<int32_t> types_;
+  euler::common::FlatVector<float> weights_;
+
+  // Open addressing table of row + 1, 0 means an empty slot
+  euler::common::FlatVector<uint32_t> index_;
+  uint64_t index_mask_;
+
+  CsrNeighbors out_;
+  CsrNeighbors in_;
+
+  std::vector<FeatureColumn<uint64_t>> uint64_features_;
+  std::vector<FeatureColumn<float>> float_features_;
+  std::vector<FeatureColumn<char>> binary_features_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_GRAPH_COMPACT_NODE_STORE_H_
@@ -0,0 +1,197 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "euler/core/graph/compact_node_store.h"
+#include "euler/core/graph/node.h"
+
+namespace euler {
+
+Node* GetNode(euler::common::NodeID id) {
+  Node* node = new Node(id, 1.0 * id, id % 2);
+  std::vector<std::vector<uint64_t>> neighbor_ids;
+  std::vector<std::vector<float>> neighbor_weight;
+  neighbor_ids.push_back({id + 1, id + 3, id + 5});
+  neighbor_weight.push_back({1, 3, 1});
+  neighbor_ids.push_back({});
+  neighbor_weight.push_back({});
+  neighbor_ids.push_back({id + 10, id + 11, id + 12, id + 13});
+  neighbor_weight.push_back({1, 1, 2, 2});
+
+  std::vector<std::vector<uint64_t>> uint64_features;
+  uint64_features.push_back({id, id + 1, id + 2});
+  uint64_features.push_back({id + 3});
+  std::vector<std::vector<float>> float_features;
+  float_features.push_back({1.1f * id, 1.2f});
+  float_features.push_back({2.1f, 2.2f, 2.3f * id});
+  std::vector<std::string> binary_features;
+  binary_features.push_back("iam" + std::to_string(id));
+
+  if (!node->Init(neighbor_ids, neighbor_weight, uint64_features,
+                  float_features, binary_features)) {
+    delete node;
+    return nullptr;
+  }
+  return node;
+}
+
+TEST(CompactNodeStoreTest, SameAsNode) {
+  const int kNodeNum = 1000;
+  std::vector<std::unique_ptr<Node>> nodes;
+  CompactNodeStore store;
+  for (int i = 0; i < kNodeNum; ++i) {
+    nodes.emplace_back(GetNode(i * 7 + 1));
+    ASSERT_TRUE(nodes.back() != nullptr);
+    ASSERT_TRUE(store.Append(*nodes.back()));
+  }
+  ASSERT_FALSE(store.Append(*nodes[0]));
+  ASSERT_EQ(kNodeNum, store.size());
+  ASSERT_EQ(-1, store.Find(2));
+
+  for (auto& node : nodes) {
+    int64_t row = store.Find(node->GetID());
+    ASSERT_GE(row, 0);
+    ASSERT_EQ(node->GetID(), store.GetID(row));
+    ASSERT_EQ(node->GetType(), store.GetType(row));
+    ASSERT_EQ(node->GetWeight(), store.GetWeight(row));
+
+    std::vector<int32_t> edge_types{0, 2};
+    ASSERT_EQ(node->GetFullNeighbor(edge_types),
+              store.GetFullNeighbor(row, edge_types));
+    ASSERT_EQ(node->GetSortedFullNeighbor(edge_types),
+              store.GetSortedFullNeighbor(row, edge_types));
+    ASSERT_EQ(node->GetTopKNeighbor(edge_types, 3),
+              store.GetTopKNeighbor(row, edge_types, 3));
+    for (auto& neighbor : node->GetFullNeighbor({0, 1, 2})) {
+      euler::common::NodeID id = std::get<0>(neighbor);
+      bool has = std::get<2>(neighbor) == 2;
+      ASSERT_EQ(has, node->HasNeighbor({1, 2}, id));
+      ASSERT_EQ(has, store.HasNeighbor(row, {1, 2}, id));
+    }
+    ASSERT_FALSE(store.HasNeighbor(row, edge_types, node->GetID()));
+
+    std::vector<int32_t> fids{1, 0, 5};
+    std::vector<std::vector<uint64_t>> u1, u2;
+    node->GetUint64Feature(fids, &u1);
+    store.GetUint64Feature(row, fids, &u2);
+    ASSERT_EQ(u1, u2);
+
+    std::vector<uint32_t> n1, n2;
+    std::vector<float> f1, f2;
+    node->GetFloat32Feature(fids, &n1, &f1);
+    store.GetFloat32Feature(row, fids, &n2, &f2);
+    ASSERT_EQ(n1, n2);
+    ASSERT_EQ(f1, f2);
+
+    std::vector<std::string> b1, b2;
+    node->GetBinaryFeature({0}, &b1);
+    store.GetBinaryFeature(row, {0}, &b2);
+    ASSERT_EQ(b1, b2);
+
+    std::string s1, s2;
+    ASSERT_TRUE(node->Serialize(&s1));
+    ASSERT_TRUE(store.Serialize(row, &s2));
+    ASSERT_EQ(s1, s2);
+  }
+}
+
+TEST(CompactNodeStoreTest, HasUnsortedNeighbor) {
+  std::vector<std::unique_ptr<Node>> nodes;
+  CompactNodeStore store;
+  nodes.emplace_back(GetNode(1));  // sorted groups before the unsorted ones
+  for (euler::common::NodeID id = 2; id < 4; ++id) {
+    nodes.emplace_back(new Node(id, 1, 0));
+    ASSERT_TRUE(nodes.back()->Init({{id + 9, id + 3, id + 7}, {id + 1}},
+                                   {{1, 1, 1}, {1}}, {}, {}, {}));
+  }
+  for (auto& node : nodes) {
+    ASSERT_TRUE(store.Append(*node));
+  }
+
+  for (size_t row = 0; row < nodes.size(); ++row) {
+    for (auto& neighbor : nodes[row]->GetFullNeighbor({0, 1, 2})) {
+      euler::common::NodeID id = std::get<0>(neighbor);
+      ASSERT_TRUE(nodes[row]->HasNeighbor({0, 1, 2}, id));
+      ASSERT_TRUE(store.HasNeighbor(row, {0, 1, 2}, id));
+    }
+  }
+  ASSERT_TRUE(nodes[1]->HasNeighbor({0}, 5));
+  ASSERT_FALSE(nodes[1]->HasNeighbor({1}, 5));
+  ASSERT_FALSE(nodes[1]->HasNeighbor({0}, 3));
+  ASSERT_TRUE(store.HasNeighbor(1, {0}, 5));
+  ASSERT_FALSE(store.HasNeighbor(1, {1}, 5));
+  ASSERT_FALSE(store.HasNeighbor(1, {0}, 3));
+  ASSERT_EQ(nodes[2]->GetFullNeighbor({0}), store.GetFullNeighbor(2, {0}));
+}
+
+TEST(CompactNodeStoreTest, SampleNeighbor) {
+  std::unique_ptr<Node> node(GetNode(0));
+  CompactNodeStore store;
+  ASSERT_TRUE(store.Append(*node));
+
+  auto r = store.SampleNeighbor(0, {2}, 100000);
+  ASSERT_EQ(r.size(), 100000);
+  std::vector<int32_t> cnts(14);
+  for (auto& i : r) {
+    cnts[std::get<0>(i)] += 1;
+    ASSERT_EQ(2, std::get<2>(i));
+  }
+  ASSERT_TRUE(cnts[11] * 1.0 / cnts[10] > 0.8 &&
+              cnts[11] * 1.0 / cnts[10] < 1.2);
+  ASSERT_TRUE(cnts[12] * 1.0 / cnts[11] > 1.8 &&
+              cnts[12] * 1.0 / cnts[11] < 2.2);
+
+  r = store.SampleNeighbor(0, {}, 100000);
+  ASSERT_EQ(r.size(), 100000);
+  cnts.assign(14, 0);
+  for (auto& i : r) {
+    cnts[std::get<0>(i)] += 1;
+  }
+  ASSERT_TRUE(cnts[3] * 1.0 / cnts[1] > 2.8 && cnts[3] * 1.0 / cnts[1] < 3.2);
+  ASSERT_TRUE(cnts[12] * 1.0 / cnts[3] > 0.5 &&
+              cnts[12] * 1.0 / cnts[3] < 0.8);
+
+  ASSERT_TRUE(store.SampleNeighbor(0, {1}, 10).empty());
+  ASSERT_TRUE(store.SampleNeighbor(0, {3}, 10).empty());
+  ASSERT_TRUE(store.SampleInNeighbor(0, {0}, 10).empty());
+}
+
+TEST(CompactNodeStoreTest, AliasSampleNeighbor) {
+  std::unique_ptr<Node> node(GetNode(0));
+  node->BuildNeighborAlias(4);  // only group 2 gets an alias table
+  CompactNodeStore store;
+  ASSERT_TRUE(store.Append(*node));
+
+  auto r = store.SampleNeighbor(0, {0, 2}, 100000);
+  ASSERT_EQ(r.size(), 100000);
+  std::vector<int32_t> cnts(14);
+  for (auto& i : r) {
+    cnts[std::get<0>(i)] += 1;
+  }
+  ASSERT_TRUE(cnts[11] * 1.0 / cnts[10] > 0.8 &&
+              cnts[11] * 1.0 / cnts[10] < 1.2);
+  ASSERT_TRUE(cnts[12] * 1.0 / cnts[11] > 1.8 &&
+              cnts[12] * 1.0 / cnts[11] < 2.2);
+  ASSERT_TRUE(cnts[3] * 1.0 / cnts[1] > 2.8 && cnts[3] * 1.0 / cnts[1] < 3.2);
+  ASSERT_TRUE(cnts[12] * 1.0 / cnts[3] > 0.5 &&
+              cnts[12] * 1.0 / cnts[3] < 0.8);
+}
+
+}  // namespace euler
@@ -0,0 +1,252 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/graph/dense_feature_store.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "euler/common/logging.h"
+#include "euler/common/quantization.h"
+
+namespace euler {
+
+namespace {
+
+using euler::common::NodeID;
+
+// Rows looked up before the copies of a block are started
+const size_t kGatherBlock = 16;
+
+inline uint64_t HashID(NodeID id) {
+  // MurmurHash3 64 bit finalizer, the same as CompactNodeStore
+  id ^= id >> 33;
+  id *= 0xff51afd7ed558ccdULL;
+  id ^= id >> 33;
+  id *= 0xc4ceb9fe1a85ec53ULL;
+  id ^= id >> 33;
+  return id;
+}
+
+}  // namespace
+
+void DenseFeatureStore::Build(const std::vector<NodeID>& ids,
+                              const std::vector<int32_t>& fids,
+                              const std::vector<int64_t>& dims,
+                              const FeatureReader& reader,
+                              FeatureQuantization quantization) {
+  ids_ = ids;
+  size_t capacity = 16;
+  while (capacity < ids_.size() * 2) {
+    capacity <<= 1;
+  }
+  index_.assign(capacity, 0);
+  index_mask_ = capacity - 1;
+  for (uint32_t row = 0; row < ids_.size(); ++row) {
+    uint64_t slot = HashID(ids_[row]) & index_mask_;
+    while (index_[slot] != 0) {
+      slot = (slot + 1) & index_mask_;
+    }
+    index_[slot] = row + 1;
+  }
+
+  columns_.clear();
+  for (size_t i = 0; i < fids.size(); ++i) {
+    if (fids[i] < 0 || dims[i] <= 0) {
+      continue;
+    }
+    if (fids[i] >= static_cast<int32_t>(columns_.size())) {
+      columns_.resize(fids[i] + 1);
+    }
+    columns_[fids[i]].dim = dims[i];
+  }
+
+  // The first pass checks the widths and finds the ranges of the values, so
+  // the columns are encoded directly without a float copy
+  std::vector<float> mins(columns_.size(), std::numeric_limits<float>::max());
+  std::vector<float> maxs(columns_.size(),
+                          std::numeric_limits<float>::lowest());
+  std::vector<std::vector<float>> values;
+  for (size_t row = 0; row < ids_.size(); ++row) {
+    values.clear();
+    if (!reader(ids_[row], fids, &values)) {
+      continue;
+    }
+    for (size_t i = 0; i < fids.size() && i < values.size(); ++i) {
+      if (dim(fids[i]) == 0 || values[i].empty()) {
+        continue;
+      }
+      if (static_cast<int64_t>(values[i].size()) != dim(fids[i])) {
+        EULER_LOG(WARNING) << "Feature " << fids[i] << " of node "
+                           << ids_[row] << " has " << values[i].size()
+                           << " values instead of " << dim(fids[i])
+                           << ", no dense column for it";
+        columns_[fids[i]] = Column();
+        continue;
+      }
+      auto range = std::minmax_element(values[i].begin(), values[i].end());
+      mins[fids[i]] = std::min(mins[fids[i]], *range.first);
+      maxs[fids[i]] = std::max(maxs[fids[i]], *range.second);
+    }
+  }
+
+  for (size_t fid = 0; fid < columns_.size(); ++fid) {
+    Column& column = columns_[fid];
+    if (column.dim == 0) {
+      continue;
+    }
+    size_t num = ids_.size() * column.dim;
+    column.quantization.type = quantization;
+    if (quantization == kFp16Quantization) {
+      column.fp16_values.assign(num, 0);
+    } else if (quantization == kInt8Quantization) {
+      // The missing rows are zeros, keep 0 in the range
+      float min = std::min(mins[fid], 0.0f);
+      float max = std::max(maxs[fid], 0.0f);
+      euler::common::Int8Params(min, max, &column.quantization.scale,
+                                &column.quantization.offset);
+      float zero = 0;
+      int8_t q = 0;
+      euler::common::FloatToInt8(&zero, 1, column.quantization.scale,
+                                 column.quantization.offset, &q);
+      column.int8_values.assign(num, q);
+    } else {
+      column.values.assign(num, 0);
+    }
+  }
+
+  for (size_t row = 0; row < ids_.size(); ++row) {
+    values.clear();
+    if (!reader(ids_[row], fids, &values)) {
+      continue;
+    }
+    for (size_t i = 0; i < fids.size() && i < values.size(); ++i) {
+      if (dim(fids[i]) == 0 || values[i].empty()) {
+        continue;
+      }
+      Column& column = columns_[fids[i]];
+      size_t begin = row * column.dim;
+      switch (column.quantization.type) {
+        case kFp16Quantization:
+          euler::common::FloatToHalf(values[i].data(), column.dim,
+                                     column.fp16_values.data() + begin);
+          break;
+        case kInt8Quantization:
+          euler::common::FloatToInt8(values[i].data(), column.dim,
+                                     column.quantization.scale,
+                                     column.quantization.offset,
+                                     column.int8_values.data() + begin);
+          break;
+        default:
+          std::copy(values[i].begin(), values[i].end(),
+                    column.values.begin() + begin);
+      }
+    }
+  }
+}
+
+const char* DenseFeatureStore::Column::data() const {
+  switch (quantization.type) {
+    case kFp16Quantization:
+      return reinterpret_cast<const char*>(fp16_values.data());
+    case kInt8Quantization:
+      return reinterpret_cast<const char*>(int8_values.data());
+    default:
+      return reinterpret_cast<const char*>(values.data());
+  }
+}
+
+size_t DenseFeatureStore::Column::value_bytes() const {
+  return values.size() * sizeof(float) +
+      fp16_values.size() * sizeof(uint16_t) + int8_values.size();
+}
+
+size_t DenseFeatureStore::ValueBytes() const {
+  size_t bytes = 0;
+  for (auto& column : columns_) {
+    bytes += column.value_bytes();
+  }
+  return bytes;
+}
+
+int64_t DenseFeatureStore::Find(NodeID id) const {
+  if (index_.empty()) {
+    return -1;
+  }
+  for (uint64_t slot = HashID(id) & index_mask_; ;
+       slot = (slot + 1) & index_mask_) {
+    uint32_t value = index_[slot];
+    if (value == 0) {
+      return -1;
+    }
+    if (ids_[value - 1] == id) {
+      return value - 1;
+    }
+  }
+}
+
+void DenseFeatureStore::Gather(int32_t fid, const NodeID* ids, size_t num,
+                               float* values) const {
+  const Column& column = columns_[fid];
+  const size_t dim = column.dim;
+  const char* data = column.data();
+  const size_t row_bytes =
+      ids_.empty() ? 0 : column.value_bytes() / ids_.size();
+  int64_t rows[kGatherBlock];
+  for (size_t begin = 0; begin < num; begin += kGatherBlock) {
+    size_t end = std::min(num, begin + kGatherBlock);
+    // Look up the whole block and prefetch the rows, so the cache misses of
+    // the rows overlap instead of stalling every copy
+    for (size_t i = begin; i < end; ++i) {
+      int64_t row = Find(ids[i]);
+      rows[i - begin] = row;
+      if (row >= 0) {
+        __builtin_prefetch(data + row * row_bytes);
+      }
+    }
+    for (size_t i = begin; i < end; ++i) {
+      int64_t row = rows[i - begin];
+      if (row >= 0) {
+        GetRow(fid, row, values + i * dim);
+      } else {
+        memset(values + i * dim, 0, dim * sizeof(float));
+      }
+    }
+  }
+}
+
+void DenseFeatureStore::GetRow(int32_t fid, int64_t row,
+                               float* values) const {
+  const Column& column = columns_[fid];
+  size_t begin = row * column.dim;
+  switch (column.quantization.type) {
+    case kFp16Quantization:
+      euler::common::HalfToFloat(column.fp16_values.data() + begin,
+                                 column.dim, values);
+      break;
+    case kInt8Quantization:
+      euler::common::Int8ToFloat(column.int8_values.data() + begin,
+                                 column.dim, column.quantization.scale,
+                                 column.quantization.offset, values);
+      break;
+    default:
+      memcpy(values, column.values.data() + begin,
+             column.dim * sizeof(float));
+  }
+}
+
+}  // namespace euler
@@ -0,0 +1,107 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_GRAPH_DENSE_FEATURE_STORE_H_
+#define EULER_CORE_GRAPH_DENSE_FEATURE_STORE_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+#include "euler/common/data_types.h"
+#include "euler/core/graph/graph_meta.h"
+
+namespace euler {
+
+// Fixed width float features of all the nodes of a shard in row major
+// [rows x dim] columns, so a batch of nodes is gathered straight into an
+// output tensor without the per node containers. Only the features whose
+// values all have the dim in the graph meta get a column, the rows of the
+// nodes without the feature are zeros. The columns can be kept as fp16 or
+// int8 instead, which are dequantized by the SIMD kernels of quantization.h
+// while gathered, the zeros of int8 are within half a step.
+class DenseFeatureStore {
+ public:
+  // Read the float features fids of a node into values, one vector per fid
+  typedef std::function<bool(euler::common::NodeID id,
+                              const std::vector<int32_t>& fids,
+                              std::vector<std::vector<float>>* values)>
+      FeatureReader;
+
+  DenseFeatureStore() : index_mask_(0) { }
+
+  // Build the columns of the candidate features fids with the dims from the
+  // nodes ids, the features with any value of another width are dropped.
+  // The int8 columns are scaled by the min and max of each feature.
+  void Build(const std::vector<euler::common::NodeID>& ids,
+             const std::vector<int32_t>& fids,
+             const std::vector<int64_t>& dims,
+             const FeatureReader& reader,
+             FeatureQuantization quantization = kNoQuantization);
+
+  // The width of the column of fid, 0 if the feature has no column
+  int64_t dim(int32_t fid) const {
+    return fid >= 0 && fid < static_cast<int32_t>(columns_.size()) ?
+        columns_[fid].dim : 0;
+  }
+
+  // The encoding of the column of fid, which must exist
+  const FeatureQuantizationInfo& quantization(int32_t fid) const {
+    return columns_[fid].quantization;
+  }
+
+  size_t size() const { return ids_.size(); }
+
+  // Bytes of the values of all the columns
+  size_t ValueBytes() const;
+
+  // Return the row of the node, -1 if not found
+  int64_t Find(euler::common::NodeID id) const;
+
+  // Copy the rows of the nodes to values, num x dim(fid) floats. The rows
+  // of the nodes not found are zeros. The column of fid must exist.
+  void Gather(int32_t fid, const euler::common::NodeID* ids, size_t num,
+              float* values) const;
+
+  // Copy a row found by Find to dim(fid) floats
+  void GetRow(int32_t fid, int64_t row, float* values) const;
+
+ private:
+  struct Column {
+    Column() : dim(0) { }
+
+    int64_t dim;
+    FeatureQuantizationInfo quantization;
+    // Only the one of the encoding is used
+    std::vector<float> values;
+    std::vector<uint16_t> fp16_values;
+    std::vector<int8_t> int8_values;
+
+    const char* data() const;
+
+    size_t value_bytes() const;
+  };
+
+  std::vector<euler::common::NodeID> ids_;
+  // Open addressing table of row + 1, 0 means an empty slot
+  std::vector<uint32_t> index_;
+  uint64_t index_mask_;
+  std::vector<Column> columns_;  // By fid
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_GRAPH_DENSE_FEATURE_STORE_H_
@@ -0,0 +1,122 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/graph/dense_feature_store.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace euler {
+
+using euler::common::NodeID;
+
+TEST(DenseFeatureStoreTest, Gather) {
+  // Node i has feature 0 [i, i + 0.5], feature 1 of a varying width and
+  // feature 2 only on the even nodes
+  std::vector<NodeID> ids;
+  for (NodeID id = 1; id <= 100; ++id) {
+    ids.push_back(id * 7);
+  }
+  auto reader = [] (NodeID id, const std::vector<int32_t>& fids,
+                    std::vector<std::vector<float>>* values) {
+    if (id == 7 * 100) {
+      return false;
+    }
+    values->resize(fids.size());
+    for (size_t i = 0; i < fids.size(); ++i) {
+      if (fids[i] == 0) {
+        (*values)[i] = {static_cast<float>(id), id + 0.5f};
+      } else if (fids[i] == 1) {
+        (*values)[i].resize(id % 3 + 1, 1.0f);
+      } else if (id % 2 == 0) {
+        (*values)[i] = {1, 2, 3};
+      }
+    }
+    return true;
+  };
+
+  DenseFeatureStore store;
+  store.Build(ids, {0, 1, 2}, {2, 2, 3}, reader);
+  ASSERT_EQ(100, store.size());
+  ASSERT_EQ(2, store.dim(0));
+  ASSERT_EQ(0, store.dim(1));
+  ASSERT_EQ(3, store.dim(2));
+  ASSERT_EQ(0, store.dim(3));
+  ASSERT_EQ(0, store.Find(7));
+  ASSERT_EQ(-1, store.Find(8));
+
+  std::vector<NodeID> batch = {14, 8, 700, 21};
+  for (int i = 0; i < 50; ++i) {
+    batch.push_back(7 * (i + 1));
+  }
+  std::vector<float> values(batch.size() * 2, -1);
+  store.Gather(0, batch.data(), batch.size(), values.data());
+  std::vector<float> expected = {14, 14.5, 0, 0, 0, 0, 21, 21.5};
+  for (int i = 0; i < 50; ++i) {
+    expected.push_back(7 * (i + 1));
+    expected.push_back(7 * (i + 1) + 0.5);
+  }
+  ASSERT_EQ(expected, values);
+
+  values.assign(6, -1);
+  store.Gather(2, batch.data(), 2, values.data());
+  ASSERT_EQ(std::vector<float>({1, 2, 3, 0, 0, 0}), values);
+}
+
+TEST(DenseFeatureStoreTest, Quantization) {
+  std::vector<NodeID> ids;
+  for (NodeID id = 0; id < 100; ++id) {
+    ids.push_back(id);
+  }
+  auto reader = [] (NodeID id, const std::vector<int32_t>& fids,
+                    std::vector<std::vector<float>>* values) {
+    values->resize(fids.size());
+    for (int32_t j = 0; j < 20; ++j) {
+      (*values)[0].push_back(id * 0.25f - j);
+    }
+    return true;
+  };
+  std::vector<NodeID> batch = {3, 1000, 99};
+
+  DenseFeatureStore fp16;
+  fp16.Build(ids, {0}, {20}, reader, kFp16Quantization);
+  ASSERT_EQ(kFp16Quantization, fp16.quantization(0).type);
+  ASSERT_EQ(100 * 20 * 2, fp16.ValueBytes());
+  std::vector<float> values(batch.size() * 20, -1);
+  fp16.Gather(0, batch.data(), batch.size(), values.data());
+  for (int32_t j = 0; j < 20; ++j) {
+    // Multiples of 0.25 below 2048 are exact in fp16
+    ASSERT_EQ(0.75f - j, values[j]);
+    ASSERT_EQ(0, values[20 + j]);
+    ASSERT_EQ(24.75f - j, values[40 + j]);
+  }
+
+  DenseFeatureStore int8;
+  int8.Build(ids, {0}, {20}, reader, kInt8Quantization);
+  const FeatureQuantizationInfo& info = int8.quantization(0);
+  ASSERT_EQ(kInt8Quantization, info.type);
+  ASSERT_FLOAT_EQ(-19.0f / 2 + 24.75f / 2, info.offset);
+  ASSERT_FLOAT_EQ((24.75f + 19.0f) / 254, info.scale);
+  ASSERT_EQ(100 * 20, int8.ValueBytes());
+  int8.Gather(0, batch.data(), batch.size(), values.data());
+  for (int32_t j = 0; j < 20; ++j) {
+    ASSERT_NEAR(0.75f - j, values[j], info.scale / 2 + 1e-5);
+    ASSERT_NEAR(0, values[20 + j], info.scale / 2 + 1e-5);
+    ASSERT_NEAR(24.75f - j, values[40 + j], info.scale / 2 + 1e-5);
+  }
+}
+
+}  // namespace euler
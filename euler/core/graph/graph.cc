@@ -13,15 +13,28 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <thread>  // NOLINT
 #include <unordered_set>
 
 #include "euler/core/graph/graph.h"
 
 #include "euler/core/graph/graph_builder.h"
+#include "euler/core/graph/graph_snapshot.h"
 #include "euler/common/server_register.h"
 
 namespace euler {
 
+namespace {
+
+// Keep the node_id_ranges shard meta small enough for the zookeeper node
+const size_t kMaxNodeIdRanges = 1024;
+
+}  // namespace
+
 Graph::~Graph() {
   auto n_map_it = node_map_.begin();
   while (n_map_it != node_map_.end()) {
@@ -36,6 +49,44 @@ Graph::~Graph() {
   }
 }
 
+GraphLoadOptions::GraphLoadOptions()
+    : reader_num(4),
+      parser_num(std::max(1u, std::thread::hardware_concurrency())),
+      max_pending_bytes(1LL << 30),
+      neighbor_sampler_type(kBinarySearchSampler),
+      alias_min_degree(0),
+      dense_feature_columns(false),
+      dense_feature_quantization(kNoQuantization) {
+}
+
+Status StringToNeighborSamplerType(const std::string& sampler_type_string,
+                                   NeighborSamplerType* sampler_type) {
+  if (sampler_type_string == "binary_search") {
+    *sampler_type = kBinarySearchSampler;
+  } else if (sampler_type_string == "alias") {
+    *sampler_type = kAliasSampler;
+  } else {
+    return Status::InvalidArgument("Invalid neighbor sampler type: ",
+                                   sampler_type_string);
+  }
+  return Status::OK();
+}
+
+Status StringToFeatureQuantization(const std::string& quantization_string,
+                                   FeatureQuantization* quantization) {
+  if (quantization_string == "none") {
+    *quantization = kNoQuantization;
+  } else if (quantization_string == "fp16") {
+    *quantization = kFp16Quantization;
+  } else if (quantization_string == "int8") {
+    *quantization = kInt8Quantization;
+  } else {
+    return Status::InvalidArgument("Invalid feature quantization: ",
+                                   quantization_string);
+  }
+  return Status::OK();
+}
+
 Status StringToSamplerType(const std::string &sampler_type_string,
                            GlobalSamplerType *smt) {
   if (sampler_type_string == "none") {
@@ -69,10 +120,24 @@ Status StringToDataType(const std::string &data_type_string,
   return Status::OK();
 }
 
+Status StringToStorageType(const std::string &storage_type_string,
+                           GraphStorageType *storage_type) {
+  if (storage_type_string == "node") {
+    *storage_type = kNodeStore;
+  } else if (storage_type_string == "compact" ||
+             storage_type_string == "snapshot") {
+    *storage_type = kCompactStore;
+  } else {
+    return Status::Internal("Invalid storage type: ", storage_type_string);
+  }
+  return Status::OK();
+}
+
 Status Graph::Init(int shard_index, int shard_number,
                    const std::string& sampler_type,
                    const std::string& data_path,
-                   const std::string& load_data_type) {
+                   const std::string& load_data_type,
+                   const std::string& storage_type) {
   if (!initialized_) {
     if (shard_number <= 0 || shard_index_ >= shard_number) {
       EULER_LOG(ERROR) << "Invalid shard index:" << shard_index
@@ -100,18 +165,33 @@ Status Graph::Init(int shard_index, int shard_number,
     GraphDataType data_type = kLoadNode;
     RETURN_IF_ERROR(StringToDataType(load_data_type, &data_type));
 
-    RETURN_IF_ERROR(
-        GraphBuilder().Build(this, data_path, smt, filter, data_type));
+    GraphStorageType storage = kNodeStore;
+    RETURN_IF_ERROR(StringToStorageType(storage_type, &storage));
+    set_storage_type(storage);
+
+    if (storage_type == "snapshot" && (data_type & kLoadNode)) {
+      RETURN_IF_ERROR(InitFromSnapshot(data_path, smt, filter, data_type));
+    } else {
+      RETURN_IF_ERROR(
+          GraphBuilder().Build(this, data_path, smt, filter, data_type));
+    }
 
     if (meta_.partitions_num_ <= 0) {
       EULER_LOG(ERROR) << "Graph partitions_num must > 0";
       return Status::Internal("Graph partitions_num must > 0");
     }
 
+    if ((load_options_.dense_feature_columns ||
+         load_options_.dense_feature_quantization != kNoQuantization) &&
+        (data_type & kLoadNode)) {
+      BuildDenseFeatures();
+    }
+
     EULER_LOG(INFO) << "Build graph successfully, shard Index: " << shard_index_
                     << ", shard number: " << shard_number_
                     << ", data path: " << data_path
-                    << ", sampler_type: " << sampler_type;
+                    << ", sampler_type: " << sampler_type
+                    << ", storage_type: " << storage_type;
 
     initialized_ = true;
   }
@@ -119,6 +199,136 @@ Status Graph::Init(int shard_index, int shard_number,
   return Status::OK();
 }
 
+void Graph::BuildDenseFeatures() {
+  std::vector<int32_t> fids;
+  std::vector<int64_t> dims;
+  for (auto& item : meta_.node_feature_info_) {
+    if (std::get<0>(item.second) == kDense) {
+      fids.push_back(std::get<1>(item.second));
+      dims.push_back(std::get<2>(item.second));
+    }
+  }
+
+  std::vector<euler::common::NodeID> ids;
+  if (storage_type_ == kCompactStore) {
+    ids.reserve(compact_store_.size());
+    for (size_t row = 0; row < compact_store_.size(); ++row) {
+      ids.push_back(compact_store_.GetID(row));
+    }
+  } else {
+    ids.reserve(node_map_.size());
+    for (auto& item : node_map_) {
+      ids.push_back(item.first);
+    }
+    // Nearby ids get nearby rows
+    std::sort(ids.begin(), ids.end());
+  }
+
+  FeatureQuantization quantization = load_options_.dense_feature_quantization;
+  dense_features_.Build(
+      ids, fids, dims,
+      [this] (euler::common::NodeID id, const std::vector<int32_t>& fids,
+              std::vector<std::vector<float>>* values) {
+        return GetStoredFloat32Feature(id, fids, values);
+      },
+      quantization);
+  EULER_LOG(INFO) << "Build dense feature columns of " << ids.size()
+                  << " nodes, " << dense_features_.ValueBytes() << " bytes";
+  if (quantization == kNoQuantization) {
+    return;
+  }
+
+  // The quantized features are only kept in the columns
+  std::vector<int32_t> quantized_fids;
+  for (auto& item : meta_.node_feature_info_) {
+    int32_t fid = std::get<1>(item.second);
+    if (std::get<0>(item.second) == kDense && dense_features_.dim(fid) > 0) {
+      quantized_fids.push_back(fid);
+      meta_.SetFeatureQuantization(item.first,
+                                   dense_features_.quantization(fid));
+    }
+  }
+  if (storage_type_ == kCompactStore) {
+    for (auto fid : quantized_fids) {
+      compact_store_.ClearFloat32Feature(fid);
+    }
+  } else {
+    for (auto& item : node_map_) {
+      item.second->ClearFloat32Feature(quantized_fids);
+    }
+  }
+}
+
+Status Graph::InitFromSnapshot(const std::string& data_path,
+                               GlobalSamplerType smt,
+                               FileIO::FilterFunc filter,
+                               GraphDataType data_type) {
+  Slice scheme, host, path;
+  ParseURI(data_path, &scheme, &host, &path);
+  if (scheme != "file") {
+    return Status::InvalidArgument("Snapshot needs a local data path: ",
+                                   data_path);
+  }
+  std::string snapshot_path = JoinPath(
+      path, ToString("euler_", shard_index_, "_", shard_number_, ".snapshot"));
+
+  // Everything the nodes in the snapshot depend on
+  std::string source = ToString(
+      "data_type ", data_type,
+      "\nneighbor_sampler_type ", load_options_.neighbor_sampler_type,
+      "\nalias_min_degree ", load_options_.alias_min_degree, "\n");
+  RETURN_IF_ERROR(AppendFilesFingerprint(
+      path.ToString(),
+      [] (const std::string& filename) { return filename == "euler.meta"; },
+      &source));
+  RETURN_IF_ERROR(AppendFilesFingerprint(JoinPath(path, "Node"), filter,
+                                         &source));
+  if (data_type & kLoadEdge) {
+    RETURN_IF_ERROR(AppendFilesFingerprint(JoinPath(path, "Edge"), filter,
+                                           &source));
+  }
+
+  Status s = LoadSnapshot(snapshot_path, source);
+  if (s.code() == ErrorCode::DATA_LOSS) {
+    // Drop what is loaded from the corrupt snapshot, it is unmapped already
+    meta_ = GraphMeta();
+    compact_store_ = CompactNodeStore();
+    node_weight_sums_.clear();
+    node_samplers_.clear();
+    global_sampler_ok_ = false;
+  }
+  if (s.code() == ErrorCode::NOT_FOUND ||
+      s.code() == ErrorCode::FAILED_PRECONDITION ||
+      s.code() == ErrorCode::DATA_LOSS) {
+    EULER_LOG(INFO) << "No valid snapshot found (" << s << "), build graph "
+                    << "from data files and write snapshot: "
+                    << snapshot_path;
+    RETURN_IF_ERROR(
+        GraphBuilder().Build(this, data_path, smt, filter, data_type));
+    // The graph is ready even if the snapshot can not be written, e.g. to
+    // a read only data path
+    s = DumpSnapshot(snapshot_path, source);
+    if (!s.ok()) {
+      EULER_LOG(ERROR) << "Dump snapshot failed: " << s;
+    }
+    return Status::OK();
+  }
+  RETURN_IF_ERROR(s);
+
+  if ((smt == kNode || smt == kAll) && !global_sampler_ok_) {
+    BuildGlobalSampler();
+  }
+  if (data_type & kLoadEdge) {
+    GlobalSamplerType edge_smt = kNone;
+    if (smt == kEdge || smt == kAll) {
+      edge_smt = kEdge;
+    }
+    RETURN_IF_ERROR(
+        GraphBuilder().Build(this, data_path, edge_smt, filter, kLoadEdge));
+  }
+  return Status::OK();
+}
+
 std::vector<Meta> Graph::GetRegisterInfo() {
   Meta meta, shard_meta;
   meta["num_shards"] = std::to_string(shard_number_);
@@ -126,6 +336,8 @@ std::vector<Meta> Graph::GetRegisterInfo() {
   shard_meta["node_sum_weight"] = Join(GetNodeWeightSums(), ",");
   shard_meta["edge_sum_weight"] = Join(GetEdgeWeightSums(), ",");
   shard_meta["graph_label"] = Join(GetGraphLabel(), ",");
+  shard_meta["node_id_ranges"] =
+      GetNodeIdRanges(kMaxNodeIdRanges).ToString();
 
   std::string graph_meta;
   meta_.Serialize(&graph_meta);
@@ -159,7 +371,177 @@ euler::common::EdgeID Graph::UIDToEdgeId(UID uid) {
   return eid;
 }
 
+IdRangeSet Graph::GetNodeIdRanges(size_t max_ranges) const {
+  std::vector<uint64_t> ids;
+  if (storage_type_ == kCompactStore) {
+    ids.reserve(compact_store_.size());
+    for (size_t i = 0; i < compact_store_.size(); ++i) {
+      ids.push_back(compact_store_.GetID(i));
+    }
+  } else {
+    ids.reserve(node_map_.size());
+    for (auto& it : node_map_) {
+      ids.push_back(it.first);
+    }
+  }
+  return IdRangeSet::Build(std::move(ids), max_ranges);
+}
+
+bool Graph::HasNode(euler::common::NodeID id) const {
+  if (storage_type_ == kCompactStore) {
+    return compact_store_.Find(id) >= 0;
+  }
+  return node_map_.find(id) != node_map_.end();
+}
+
+bool Graph::GetNodeType(euler::common::NodeID id, int32_t* type) const {
+  if (storage_type_ == kCompactStore) {
+    int64_t row = compact_store_.Find(id);
+    if (row < 0) {
+      return false;
+    }
+    *type = compact_store_.GetType(row);
+    return true;
+  }
+
+  auto it = node_map_.find(id);
+  if (it == node_map_.end()) {
+    return false;
+  }
+  *type = it->second->GetType();
+  return true;
+}
+
+std::vector<euler::common::IDWeightPair> Graph::SampleNeighbor(
+    euler::common::NodeID id, const std::vector<int32_t>& edge_types,
+    int32_t count) const {
+  if (storage_type_ == kCompactStore) {
+    int64_t row = compact_store_.Find(id);
+    if (row < 0) {
+      return std::vector<euler::common::IDWeightPair>();
+    }
+    return compact_store_.SampleNeighbor(row, edge_types, count);
+  }
+
+  auto it = node_map_.find(id);
+  if (it == node_map_.end()) {
+    return std::vector<euler::common::IDWeightPair>();
+  }
+  return it->second->SampleNeighbor(edge_types, count);
+}
+
+bool Graph::SampleNeighbor(
+    euler::common::NodeID id, const std::vector<int32_t>& edge_types,
+    int32_t count, euler::common::NodeID* ids, float* weights,
+    int32_t* types) const {
+  if (storage_type_ == kCompactStore) {
+    int64_t row = compact_store_.Find(id);
+    return row >= 0 &&
+        compact_store_.SampleNeighbor(row, edge_types, count,
+                                      ids, weights, types);
+  }
+
+  auto it = node_map_.find(id);
+  return it != node_map_.end() &&
+      it->second->SampleNeighbor(edge_types, count, ids, weights, types);
+}
+
+std::vector<euler::common::IDWeightPair> Graph::GetFullNeighbor(
+    euler::common::NodeID id, const std::vector<int32_t>& edge_types) const {
+  if (storage_type_ == kCompactStore) {
+    int64_t row = compact_store_.Find(id);
+    if (row < 0) {
+      return std::vector<euler::common::IDWeightPair>();
+    }
+    return compact_store_.GetFullNeighbor(row, edge_types);
+  }
+
+  auto it = node_map_.find(id);
+  if (it == node_map_.end()) {
+    return std::vector<euler::common::IDWeightPair>();
+  }
+  return it->second->GetFullNeighbor(edge_types);
+}
+
+bool Graph::HasNeighbor(euler::common::NodeID id,
+                        const std::vector<int32_t>& edge_types,
+                        euler::common::NodeID neighbor) const {
+  if (storage_type_ == kCompactStore) {
+    int64_t row = compact_store_.Find(id);
+    return row >= 0 && compact_store_.HasNeighbor(row, edge_types, neighbor);
+  }
+
+  auto it = node_map_.find(id);
+  return it != node_map_.end() &&
+      it->second->HasNeighbor(edge_types, neighbor);
+}
+
+#define GET_FEATURE(FUNC)                                   \
+  if (storage_type_ == kCompactStore) {                     \
+    int64_t row = compact_store_.Find(id);                  \
+    if (row < 0) {                                          \
+      return false;                                         \
+    }                                                       \
+    compact_store_.FUNC(row, fids, feature_values);         \
+    return true;                                            \
+  }                                                         \
+  auto it = node_map_.find(id);                             \
+  if (it == node_map_.end()) {                              \
+    return false;                                           \
+  }                                                         \
+  it->second->FUNC(fids, feature_values);                   \
+  return true;
+
+bool Graph::GetUint64Feature(
+    euler::common::NodeID id, const std::vector<int32_t>& fids,
+    std::vector<std::vector<uint64_t>>* feature_values) const {
+  GET_FEATURE(GetUint64Feature);
+}
+
+bool Graph::GetStoredFloat32Feature(
+    euler::common::NodeID id, const std::vector<int32_t>& fids,
+    std::vector<std::vector<float>>* feature_values) const {
+  GET_FEATURE(GetFloat32Feature);
+}
+
+bool Graph::GetFloat32Feature(
+    euler::common::NodeID id, const std::vector<int32_t>& fids,
+    std::vector<std::vector<float>>* feature_values) const {
+  size_t begin = feature_values->size();
+  if (!GetStoredFloat32Feature(id, fids, feature_values)) {
+    return false;
+  }
+  if (load_options_.dense_feature_quantization == kNoQuantization) {
+    return true;
+  }
+  // Fill the quantized features cleared from the nodes, the stores give one
+  // value, maybe empty, for each of the fids
+  int64_t row = dense_features_.Find(id);
+  for (size_t i = 0; i < fids.size() && row >= 0; ++i) {
+    int64_t dim = dense_features_.dim(fids[i]);
+    if (dim > 0) {
+      std::vector<float>& values = (*feature_values)[begin + i];
+      values.resize(dim);
+      dense_features_.GetRow(fids[i], row, values.data());
+    }
+  }
+  return true;
+}
+
+bool Graph::GetBinaryFeature(
+    euler::common::NodeID id, const std::vector<int32_t>& fids,
+    std::vector<std::string>* feature_values) const {
+  GET_FEATURE(GetBinaryFeature);
+}
+
+#undef GET_FEATURE
+
 bool Graph::AddNode(Node* n) {
+  if (storage_type_ == kCompactStore) {
+    compact_store_.Append(*n);
+    delete n;
+    return true;
+  }
   euler::common::NodeID node_id = n->GetID();
   node_map_[node_id] = n;
   return true;
@@ -167,11 +549,25 @@ bool Graph::AddNode(Node* n) {
 
 bool Graph::AddNodeFrom(
     const std::unordered_map<euler::common::NodeID, Node*>& map) {
+  if (storage_type_ == kCompactStore) {
+    for (auto &it : map) {
+      compact_store_.Append(*it.second);
+      delete it.second;
+    }
+    return true;
+  }
   node_map_.insert(map.begin(), map.end());
   return true;
 }
 
 bool Graph::AddNodeFrom(const std::vector<Node*>& vec) {
+  if (storage_type_ == kCompactStore) {
+    for (auto &it : vec) {
+      compact_store_.Append(*it);
+      delete it;
+    }
+    return true;
+  }
   for (auto &it : vec) {
      node_map_.insert({it->GetID(), it});
   }
@@ -203,6 +599,9 @@ bool Graph::AddEdgeFrom(const std::vector<Edge*>& vec) {
 }
 
 int64_t Graph::getNodeSize() {
+    if (storage_type_ == kCompactStore) {
+      return compact_store_.size();
+    }
     return node_map_.size();
 }
 
@@ -211,6 +610,10 @@ int64_t Graph::getEdgeSize() {
 }
 
 void Graph::reserveNodeMap(size_t size) {
+  if (storage_type_ == kCompactStore) {
+    compact_store_.Reserve(size);
+    return;
+  }
   node_map_.reserve(size);
 }
 
@@ -352,6 +755,12 @@ bool Graph::BuildGlobalSampler() {
     norm_weights[type].push_back(it.second->GetWeight());
     node_weight_sums_[type] += it.second->GetWeight();
   }
+  for (size_t row = 0; row < compact_store_.size(); ++row) {
+    int32_t type = compact_store_.GetType(row);
+    node_ids[type].push_back(compact_store_.GetID(row));
+    norm_weights[type].push_back(compact_store_.GetWeight(row));
+    node_weight_sums_[type] += compact_store_.GetWeight(row);
+  }
 
   for (size_t type = 0; type < node_weight_sums_.size(); type++) {
     for (size_t idx = 0; idx < norm_weights[type].size(); idx++) {
@@ -446,6 +855,11 @@ std::vector<std::string> Graph::GetGraphLabel() {
       it->second->GetBinaryFeature({label_id}, &graph_label);
       label_set.insert(graph_label[0]);
     }
+    for (size_t row = 0; row < compact_store_.size(); ++row) {
+      std::vector<std::string> graph_label;
+      compact_store_.GetBinaryFeature(row, {label_id}, &graph_label);
+      label_set.insert(graph_label[0]);
+    }
   }
   std::vector<std::string> label_vec;
   label_vec.reserve(label_set.size());
@@ -469,10 +883,16 @@ void Graph::ShowGraph() {
     ++cnt;
     ++it;
   }
+  for (size_t row = 0; row < compact_store_.size(); row += 500000) {
+    std::string s;
+    if (compact_store_.Serialize(row, &s)) {
+      std::cout << s << std::endl;
+    }
+  }
 }
 
 bool Graph::Dump(euler::FileIO* file_io) const {
-  uint32_t size = node_map_.size();
+  uint32_t size = node_map_.size() + compact_store_.size();
   if (!file_io->Append(size)) {
     return false;
   }
@@ -483,6 +903,13 @@ bool Graph::Dump(euler::FileIO* file_io) const {
     }
     file_io->Append(s);
   }
+  for (size_t row = 0; row < compact_store_.size(); ++row) {
+    std::string s;
+    if (!compact_store_.Serialize(row, &s)) {
+      return false;
+    }
+    file_io->Append(s);
+  }
 
   uint32_t edge_size = edge_map_.size();
   if (!file_io->Append(edge_size)) {
@@ -498,6 +925,101 @@ bool Graph::Dump(euler::FileIO* file_io) const {
   return true;
 }
 
+Status Graph::DumpSnapshot(const std::string& path,
+                           const std::string& source) const {
+  if (storage_type_ != kCompactStore) {
+    return Status::FailedPrecondition(
+        "Snapshot is only available for compact storage");
+  }
+
+  SnapshotWriter writer;
+  writer.Copy(source);
+  GraphMeta meta = meta_;
+  std::string meta_str;
+  meta.Serialize(&meta_str);
+  writer.Copy(meta_str);
+
+  compact_store_.DumpSnapshot(&writer);
+
+  std::vector<uint32_t> sampler_ok = {global_sampler_ok_};
+  writer.Copy(sampler_ok);
+  if (global_sampler_ok_) {
+    writer.Add(node_weight_sums_);
+    for (auto& sampler : node_samplers_) {
+      writer.Add(sampler.GetIds());
+      writer.Add(sampler.GetWeights());
+      writer.Add(sampler.GetAlias().GetProb());
+      writer.Add(sampler.GetAlias().GetAlias());
+    }
+  }
+
+  // Write to a temporary file first so that a partial snapshot is never
+  // visible to the other processes
+  std::string tmp_path = ToString(path, ".tmp.", getpid());
+  Status s = writer.Write(tmp_path);
+  if (!s.ok()) {
+    remove(tmp_path.c_str());
+    return s;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    return Status::Internal("Rename ", tmp_path, " to ", path, " failed");
+  }
+  EULER_LOG(INFO) << "Dump snapshot successfully, path: " << path;
+  return Status::OK();
+}
+
+Status Graph::LoadSnapshot(const std::string& path,
+                           const std::string& source) {
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  RETURN_IF_ERROR(Env::Default()->NewReadOnlyMemoryRegion(path, &region));
+  SnapshotReader reader;
+  RETURN_IF_ERROR(reader.Init(region.get()));
+
+  std::string snapshot_source;
+  if (!reader.Next(&snapshot_source)) {
+    return Status::DataLoss("Invalid snapshot: ", path);
+  }
+  if (snapshot_source != source) {
+    return Status::FailedPrecondition("Stale snapshot: ", path);
+  }
+
+  std::string meta_str;
+  std::vector<uint32_t> sampler_ok;
+  if (!reader.Next(&meta_str) || !meta_.Deserialize(meta_str) ||
+      !compact_store_.LoadSnapshot(&reader) ||
+      !reader.Next(&sampler_ok) || sampler_ok.size() != 1) {
+    return Status::DataLoss("Invalid snapshot: ", path);
+  }
+
+  if (sampler_ok[0]) {
+    if (!reader.Next(&node_weight_sums_)) {
+      return Status::DataLoss("Invalid node sampler in snapshot: ", path);
+    }
+    std::vector<int32_t> node_type_ids;
+    node_samplers_.resize(node_weight_sums_.size());
+    for (size_t type = 0; type < node_samplers_.size(); ++type) {
+      std::vector<euler::common::NodeID> ids;
+      std::vector<float> weights, prob;
+      std::vector<int64_t> alias;
+      euler::common::AliasMethod alias_method;
+      if (!reader.Next(&ids) || !reader.Next(&weights) ||
+          !reader.Next(&prob) || !reader.Next(&alias) ||
+          !alias_method.Init(prob, alias) ||
+          !node_samplers_[type].Init(ids, weights, alias_method)) {
+        return Status::DataLoss("Invalid node sampler in snapshot: ", path);
+      }
+      node_type_ids.push_back(type);
+    }
+    node_type_collection_.Init(node_type_ids, node_weight_sums_);
+    global_sampler_ok_ = true;
+  }
+
+  storage_type_ = kCompactStore;
+  snapshot_region_ = std::move(region);
+  EULER_LOG(INFO) << "Load snapshot successfully, path: " << path
+                  << ", node count: " << compact_store_.size();
+  return Status::OK();
+}
 
 FeatureType Graph::GetNodeFeatureType(const std::string &feature_name) const {
   return meta_.GetFeatureType(feature_name);
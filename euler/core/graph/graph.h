@@ -27,22 +27,78 @@ limitations under the License.
 
 #include "euler/common/logging.h"
 #include "euler/common/status.h"
+#include "euler/common/env.h"
 #include "euler/common/data_types.h"
 #include "euler/common/file_io.h"
+#include "euler/common/id_range_set.h"
 #include "euler/common/server_monitor.h"
 #include "euler/core/graph/node.h"
 #include "euler/core/graph/edge.h"
 #include "euler/core/graph/graph_meta.h"
+#include "euler/core/graph/compact_node_store.h"
+#include "euler/core/graph/dense_feature_store.h"
 #include "euler/common/fast_weighted_collection.h"
 #include "euler/common/compact_weighted_collection.h"
 
 namespace euler {
 
+// Defined in graph_builder.h
+enum GlobalSamplerType : int;
+enum GraphDataType : int;
+
+// Storage engine of graph nodes, the storage type string "snapshot" is
+// kCompactStore mapped from a snapshot file, see Graph::LoadSnapshot.
+enum GraphStorageType {
+  kNodeStore,     // A heap allocated Node per vertex
+  kCompactStore   // Columnar CSR arrays, see CompactNodeStore
+};
+
+// How a neighbor is drawn from the neighbors of an edge type
+enum NeighborSamplerType {
+  kBinarySearchSampler,  // Binary search over the cumulative weights
+  kAliasSampler          // Alias tables built at load time
+};
+
+Status StringToNeighborSamplerType(const std::string& sampler_type_string,
+                                   NeighborSamplerType* sampler_type);
+
+// "none", "fp16" or "int8"
+Status StringToFeatureQuantization(const std::string& quantization_string,
+                                   FeatureQuantization* quantization);
+
+// Options of loading the data files, see GraphBuilder
+struct GraphLoadOptions {
+  GraphLoadOptions();
+
+  int reader_num;  // threads reading records from the data files
+  int parser_num;  // threads deserializing the records
+  // Bytes of the records read but not added to the graph yet
+  int64_t max_pending_bytes;
+
+  NeighborSamplerType neighbor_sampler_type;
+  // Only the neighbor groups with no less neighbors get alias tables with
+  // kAliasSampler, the others are still sampled by binary search. Each alias
+  // table takes 12 bytes per neighbor for the node store and 8 bytes per
+  // neighbor for the compact store.
+  int32_t alias_min_degree;
+  // Keep the fixed width dense float features also in [nodes x dim] columns
+  // to gather batches directly, see DenseFeatureStore. It takes another
+  // 4 * dim bytes per node for each of the features.
+  bool dense_feature_columns;
+  // Keep the dense feature columns as fp16 or int8 scaled per feature, see
+  // GraphMeta::GetFeatureQuantization. The features are then only kept in
+  // the columns, which take 2 or 1 * dim bytes per node instead of the
+  // 4 * dim bytes of the nodes, and Dump writes the nodes without them.
+  // It implies dense_feature_columns.
+  FeatureQuantization dense_feature_quantization;
+};
+
 class Graph {
  public:
   Graph()
       : global_sampler_ok_(0),
         global_edge_sampler_ok_(0),
+        storage_type_(kNodeStore),
         initialized_(false),
         shard_index_(0),
         shard_number_(0) {
@@ -53,7 +109,8 @@ class Graph {
   Status Init(int shard_index, int shard_number,
               const std::string& sampler_type,
               const std::string& data_path,
-              const std::string& load_data_type);
+              const std::string& load_data_type,
+              const std::string& storage_type = "node");
 
   std::vector<Meta> GetRegisterInfo();
 
@@ -84,7 +141,14 @@ class Graph {
   std::vector<euler::common::EdgeID>
   SampleEdge(const std::vector<int>& edge_types, int count) const;
 
+  // Only available for kNodeStore, the storage agnostic node accessors
+  // below are preferred.
   Node* GetNodeByID(euler::common::NodeID id) const {
+    if (storage_type_ != kNodeStore) {
+      EULER_LOG(FATAL) << "Node objects are not available for compact "
+                       << "storage, use the node accessors of Graph instead.";
+    }
+
     auto it = node_map_.find(id);
     if (it != node_map_.end()) {
       return it->second;
@@ -106,6 +170,51 @@ class Graph {
     return nullptr;
   }
 
+  bool HasNode(euler::common::NodeID id) const;
+
+  // The ranges covering the node ids of the shard, published in the shard
+  // meta to route the ids to the shards in graph_partition mode
+  IdRangeSet GetNodeIdRanges(size_t max_ranges) const;
+
+  bool GetNodeType(euler::common::NodeID id, int32_t* type) const;
+
+  std::vector<euler::common::IDWeightPair>
+  SampleNeighbor(euler::common::NodeID id,
+                 const std::vector<int32_t>& edge_types,
+                 int32_t count) const;
+
+  // Write count samples to the arrays, return false and write nothing if
+  // the node is not found or has no neighbor to sample
+  bool SampleNeighbor(euler::common::NodeID id,
+                      const std::vector<int32_t>& edge_types, int32_t count,
+                      euler::common::NodeID* ids, float* weights,
+                      int32_t* types) const;
+
+  std::vector<euler::common::IDWeightPair>
+  GetFullNeighbor(euler::common::NodeID id,
+                  const std::vector<int32_t>& edge_types) const;
+
+  // Whether the node is found and has neighbor with one of the edge types
+  bool HasNeighbor(euler::common::NodeID id,
+                   const std::vector<int32_t>& edge_types,
+                   euler::common::NodeID neighbor) const;
+
+  // The feature accessors return false if the node is not found, otherwise
+  // append one value for each of the fids, empty for the unknown ones
+  bool GetUint64Feature(
+      euler::common::NodeID id, const std::vector<int32_t>& fids,
+      std::vector<std::vector<uint64_t>>* feature_values) const;
+
+  bool GetFloat32Feature(
+      euler::common::NodeID id, const std::vector<int32_t>& fids,
+      std::vector<std::vector<float>>* feature_values) const;
+
+  bool GetBinaryFeature(
+      euler::common::NodeID id, const std::vector<int32_t>& fids,
+      std::vector<std::string>* feature_values) const;
+
+  // Graph takes the ownership of the nodes added, for kCompactStore the
+  // nodes are copied into the compact store and deleted at once.
   bool AddNode(Node* n);
 
   bool AddNodeFrom(const std::unordered_map<euler::common::NodeID, Node*>& map);
@@ -152,6 +261,19 @@ class Graph {
 
   bool Dump(euler::FileIO* file_io) const;
 
+  // Write the meta, the compact node store and the global node sampler to a
+  // local snapshot file, only available for kCompactStore. source tells the
+  // data files and the options the graph is built from.
+  Status DumpSnapshot(const std::string& path,
+                      const std::string& source) const;
+
+  // Map a snapshot file written by DumpSnapshot read only and serve the
+  // nodes from it in place, the pages of the file are shared by all the
+  // processes loading the same snapshot. Edges are not in the snapshot.
+  // Fails with FAILED_PRECONDITION before touching the graph if the snapshot
+  // is written by another version or from another source.
+  Status LoadSnapshot(const std::string& path, const std::string& source);
+
   FeatureType GetNodeFeatureType(const std::string &feature_name) const;
 
   int32_t GetNodeFeatureId(const std::string &feature_name) const;
@@ -162,8 +284,23 @@ class Graph {
 
   void set_meta(const GraphMeta& meta) { meta_ = meta; }
 
+  void set_storage_type(GraphStorageType type) { storage_type_ = type; }
+
+  // Takes effect on the following Init
+  void set_load_options(const GraphLoadOptions& options) {
+    load_options_ = options;
+  }
+
+  const GraphLoadOptions& load_options() const { return load_options_; }
+
+  GraphStorageType storage_type() const { return storage_type_; }
+
   const GraphMeta& graph_meta() const { return meta_; }
 
+  // Empty unless GraphLoadOptions::dense_feature_columns or
+  // dense_feature_quantization is set
+  const DenseFeatureStore& dense_features() const { return dense_features_; }
+
   bool GetNodeTypeByName(const std::string& name, int* type_id) {
     auto it = meta_.node_type_map_.find(name);
     if (it == meta_.node_type_map_.end()) {
@@ -194,8 +331,25 @@ class Graph {
   euler::common::EdgeIDHashFunc eid_hash_;
   bool global_sampler_ok_;
   bool global_edge_sampler_ok_;
+  GraphStorageType storage_type_;
+  CompactNodeStore compact_store_;
 
  private:
+  // Load the nodes from the snapshot of the shard in the data path, the
+  // snapshot is written after the first build from the data files and
+  // rewritten once the data files, the meta or the load options change, or
+  // once it is found corrupt.
+  Status InitFromSnapshot(const std::string& data_path,
+                          GlobalSamplerType smt,
+                          FileIO::FilterFunc filter,
+                          GraphDataType data_type);
+
+  void BuildDenseFeatures();
+
+  bool GetStoredFloat32Feature(
+      euler::common::NodeID id, const std::vector<int32_t>& fids,
+      std::vector<std::vector<float>>* feature_values) const;
+
   bool initialized_;
   int shard_index_;
   int shard_number_;
@@ -206,6 +360,9 @@ class Graph {
       node_samplers_;
   std::vector<euler::common::FastWeightedCollection<euler::common::EdgeID>>
       edge_samplers_;
+  std::unique_ptr<ReadOnlyMemoryRegion> snapshot_region_;
+  GraphLoadOptions load_options_;
+  DenseFeatureStore dense_features_;
 };
 
 }  // namespace euler
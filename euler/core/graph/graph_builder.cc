@@ -21,16 +21,22 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <utility>
 
 #include "euler/common/logging.h"
 #include "euler/common/env.h"
 #include "euler/core/graph/graph_meta.h"
 #include "euler/core/graph/graph.h"
+#include "euler/common/mutex.h"
 #include "euler/common/signal.h"
 
 namespace euler {
 
+namespace {
+
 enum TaskType { kLoadNodeTask, kLoadEdgeTask };
 
 std::string TaskTypeString(TaskType type) {
@@ -44,164 +50,300 @@ std::string TaskTypeString(TaskType type) {
   }
 }
 
-struct TaskInfo {
-  FileIO *dir;
-  std::vector<std::string>* files;
-  int start;
-  int end;
+}  // namespace
+
+struct FileTask {
+  FileIO* dir;
+  std::string file;
   TaskType type;
-  NodeVec node_vec;
-  EdgeVec edge_vec;
 };
 
-Status GraphBuilder::Build(Graph* graph, Slice path,
-                           GlobalSamplerType sampler_type,
-                           FileIO::FilterFunc filter,
-                           GraphDataType data_type) {
-  int thread_num = 8;
-  int job_num = thread_num * 8;
+namespace {
 
-  std::vector<TaskInfo> task_infos;
-  std::unique_ptr<FileIO> node_dir, edge_dir;
-  std::vector<std::string> node_files, edge_files;
+// Records are passed between the stages in batches of about this size
+const size_t kBatchBytes = 4 << 20;
 
-  if (data_type & kLoadNode) {
-    auto node_dir_path = JoinPath(path, "Node");
-    RETURN_IF_ERROR(Env::Default()->NewFileIO(node_dir_path, true, &node_dir));
+// A blocking queue bounded by the total cost of the elements in it. An
+// element is always accepted by an empty queue even if it is too costly.
+template <typename T>
+class BoundedQueue {
+ public:
+  BoundedQueue(size_t capacity, int producer_num)
+      : capacity_(capacity), cost_(0), producer_num_(producer_num),
+        cancelled_(false) {
+  }
 
-    if (!node_dir->initialized() || !node_dir->IsDirectory()) {
-      EULER_LOG(ERROR) << "No such directory found, path: " << node_dir_path;
-      return Status::NotFound("Directory ", node_dir_path, " not found!");
+  // Return false if the queue is cancelled
+  bool Push(T&& element, size_t cost) {
+    MutexLock l(&mu_);
+    cv_.Wait(&l, [this, cost] () {
+        return cancelled_ || cost_ == 0 || cost_ + cost <= capacity_;
+      });
+    if (cancelled_) {
+      return false;
     }
+    cost_ += cost;
+    elements_.emplace_back(std::move(element), cost);
+    cv_.SignalAll();
+    return true;
+  }
 
-    node_files = node_dir->ListDirectory(filter);
-    int job_size = node_files.size() / job_num;
-    if (node_files.size() % job_num != 0) {
-      ++job_size;
+  // Return false if the queue is cancelled or all the producers are done
+  // and the queue is drained
+  bool Pop(T* element) {
+    MutexLock l(&mu_);
+    cv_.Wait(&l, [this] () {
+        return cancelled_ || !elements_.empty() || producer_num_ == 0;
+      });
+    if (cancelled_ || elements_.empty()) {
+      return false;
     }
+    *element = std::move(elements_.front().first);
+    cost_ -= elements_.front().second;
+    elements_.pop_front();
+    cv_.SignalAll();
+    return true;
+  }
 
-    for (int i = 0; i < job_num; ++i) {
-      task_infos.emplace_back();
-      auto& task_info = task_infos.back();
-      task_info.dir = node_dir.get();
-      task_info.files = &node_files;
-      task_info.start = i * job_size;
-      task_info.end = task_info.start + job_size;
-      task_info.type = kLoadNodeTask;
-    }
+  void ProducerDone() {
+    MutexLock l(&mu_);
+    --producer_num_;
+    cv_.SignalAll();
   }
 
-  if (data_type & kLoadEdge) {
-    auto edge_dir_path = JoinPath(path, "Edge");
-    RETURN_IF_ERROR(Env::Default()->NewFileIO(edge_dir_path, true, &edge_dir));
+  void Cancel() {
+    MutexLock l(&mu_);
+    cancelled_ = true;
+    cv_.SignalAll();
+  }
 
-    if (!edge_dir->initialized() || !edge_dir->IsDirectory()) {
-      EULER_LOG(ERROR) << "No such directory found, path: " << edge_dir_path;
-      return Status::NotFound("Directory ", edge_dir_path, " not found!");
-    }
+  // Take the elements left after the queue is cancelled
+  std::deque<std::pair<T, size_t>> Drain() {
+    MutexLock l(&mu_);
+    return std::move(elements_);
+  }
 
-    edge_files = edge_dir->ListDirectory(filter);
-    int job_size = edge_files.size() / job_num;
-    if (edge_files.size() % job_num != 0) {
-      ++job_size;
-    }
+ private:
+  Mutex mu_;
+  CondVar cv_;
+  size_t capacity_;
+  size_t cost_;
+  int producer_num_;
+  bool cancelled_;
+  std::deque<std::pair<T, size_t>> elements_;
+};
+
+struct RecordBatch {
+  const FileTask* task;
+  std::vector<std::string> records;
+  size_t bytes;
+};
 
-    for (int i = 0; i < job_num; ++i) {
-      task_infos.emplace_back();
-      auto& task_info = task_infos.back();
-      task_info.dir = edge_dir.get();
-      task_info.files = &edge_files;
-      task_info.start = i * job_size;
-      task_info.end = task_info.start + job_size;
-      task_info.type = kLoadEdgeTask;
+struct ParsedBatch {
+  NodeVec node_vec;
+  EdgeVec edge_vec;
+};
+
+void DeleteParsed(ParsedBatch* batch) {
+  for (auto node : batch->node_vec) {
+    delete node;
+  }
+  for (auto edge : batch->edge_vec) {
+    delete edge;
+  }
+}
+
+template <class T>
+bool ParseRecords(const std::vector<std::string>& records,
+                  std::vector<T*>* vec) {
+  vec->reserve(records.size());
+  for (auto& record : records) {
+    T* t = new T;
+    if (!t->DeSerialize(record)) {
+      delete t;
+      return false;
     }
+    vec->push_back(t);
   }
+  return true;
+}
 
-  std::unique_ptr<ThreadPool> thread_pool(
-      Env::Default()->StartThreadPool("GraphBuilder", thread_num));
-  std::atomic<bool> success(true);
-  std::atomic<int> counter(task_infos.size());
-  Signal signal;
-  for (auto &task_info : task_infos) {
-    thread_pool->Schedule(
-        [this, &counter, &signal, &task_info, &success] () {
-          if (success && !LoadData(&task_info)) {
-            success = false;
-          }
-          if (--counter == 0) {
-            signal.Notify();
-          }
-        });
+Status ListFiles(Slice path, TaskType type, FileIO::FilterFunc filter,
+                 std::unique_ptr<FileIO>* dir, std::vector<FileTask>* tasks) {
+  auto dir_path = JoinPath(path, TaskTypeString(type));
+  RETURN_IF_ERROR(Env::Default()->NewFileIO(dir_path, true, dir));
+
+  if (!(*dir)->initialized() || !(*dir)->IsDirectory()) {
+    EULER_LOG(ERROR) << "No such directory found, path: " << dir_path;
+    return Status::NotFound("Directory ", dir_path, " not found!");
   }
 
-  if (data_type) {
-    signal.Wait();
+  for (auto& file : (*dir)->ListDirectory(filter)) {
+    tasks->push_back({dir->get(), file, type});
   }
-  thread_pool->Shutdown();
+  return Status::OK();
+}
+
+}  // namespace
+
+Status GraphBuilder::Build(Graph* graph, Slice path,
+                           GlobalSamplerType sampler_type,
+                           FileIO::FilterFunc filter,
+                           GraphDataType data_type) {
+  std::vector<FileTask> tasks;
+  std::unique_ptr<FileIO> node_dir, edge_dir;
+
+  if (data_type & kLoadNode) {
+    RETURN_IF_ERROR(ListFiles(path, kLoadNodeTask, filter, &node_dir, &tasks));
+  }
+
+  if (data_type & kLoadEdge) {
+    RETURN_IF_ERROR(ListFiles(path, kLoadEdgeTask, filter, &edge_dir, &tasks));
+  }
+
+  Status s = LoadData(graph, tasks);
 
   GraphMeta meta;
   auto meta_path = JoinPath(path, "euler.meta");
   RETURN_IF_ERROR(LoadMeta(meta_path, &meta));
   graph->set_meta(meta);
 
-  if (!success) {
+  if (!s.ok()) {
     EULER_LOG(ERROR) << "Load data error!";
-    return Status::Internal("Load data failed!");
+    return s;
   }
 
-  RETURN_IF_ERROR(
-      AddToGraph(graph, task_infos.data(),
-                  task_infos.data() + task_infos.size()));
+  EULER_LOG(INFO) << "Graph Node Count:" << graph->getNodeSize();
+  EULER_LOG(INFO) << "Graph Edge Count:" << graph->getEdgeSize();
+
   RETURN_IF_ERROR(BuildSampler(graph, sampler_type));
   EULER_LOG(INFO) << "Graph build completely!";
   return Status::OK();
 }
 
-Status GraphBuilder::AddToGraph(
-    Graph* graph, const TaskInfo* start, const TaskInfo* end) {
-  for (; start < end; ++start) {
-    const auto& task_info = *start;
-    graph->AddNodeFrom(task_info.node_vec);
-    graph->AddEdgeFrom(task_info.edge_vec);
+Status GraphBuilder::LoadData(Graph* graph,
+                              const std::vector<FileTask>& tasks) {
+  if (tasks.empty()) {
+    return Status::OK();
   }
 
-  EULER_LOG(INFO) << "Graph Node Count:" << graph->getNodeSize();
-  EULER_LOG(INFO) << "Graph Edge Count:" << graph->getEdgeSize();
-
-  return Status::OK();
-}
+  const GraphLoadOptions& options = graph->load_options();
+  int reader_num = std::max(1, std::min(options.reader_num,
+                                        static_cast<int>(tasks.size())));
+  int parser_num = std::max(1, options.parser_num);
+  size_t capacity = std::max<int64_t>(options.max_pending_bytes / 2,
+                                      kBatchBytes);
 
-bool GraphBuilder::LoadData(TaskInfo* task_info) {
-  auto& files = *task_info->files;
-  int start = task_info->start;
-  int end = std::min(task_info->end, static_cast<int>(files.size()));
-  for (; start < end; ++start) {
-    auto reader = task_info->dir->Open(files[start], true);
-    std::string file_name =
-        JoinPath(TaskTypeString(task_info->type), files[start]);
-    if (reader == nullptr) {
-      EULER_LOG(ERROR) << "Open file " << file_name << " failed!!";
-      return false;
-    }
-    bool success;
-    switch (task_info->type) {
-      case kLoadNodeTask:
-        success = ParseNodes(reader.get(), &task_info->node_vec);
+  BoundedQueue<RecordBatch> record_queue(capacity, reader_num);
+  BoundedQueue<ParsedBatch> parsed_queue(capacity, parser_num);
+  std::atomic<size_t> next_task(0);
+  std::atomic<bool> success(true);
+  auto fail = [&record_queue, &parsed_queue, &success] () {
+    success = false;
+    record_queue.Cancel();
+    parsed_queue.Cancel();
+  };
+
+  // Readers take the files one by one, so a large file only keeps one
+  // reader busy while the batches of it are parsed in parallel.
+  auto read = [&tasks, &next_task, &record_queue, &fail] () {
+    for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+      const FileTask& task = tasks[i];
+      std::string file_name = JoinPath(TaskTypeString(task.type), task.file);
+      auto reader = task.dir->Open(task.file, true);
+      if (reader == nullptr) {
+        EULER_LOG(ERROR) << "Open file " << file_name << " failed!!";
+        fail();
         break;
-      case kLoadEdgeTask:
-        success = ParseEdges(reader.get(), &task_info->edge_vec);
+      }
+
+      RecordBatch batch{&task, {}, 0};
+      std::string record;
+      bool pushed = true;
+      while (pushed && reader->Read(&record)) {
+        batch.bytes += record.size();
+        batch.records.push_back(std::move(record));
+        if (batch.bytes >= kBatchBytes) {
+          pushed = record_queue.Push(std::move(batch), batch.bytes);
+          batch = RecordBatch{&task, {}, 0};
+        }
+      }
+      if (!pushed || (!batch.records.empty() &&
+                      !record_queue.Push(std::move(batch), batch.bytes))) {
         break;
-      default:
-        assert(false);
+      }
+      EULER_LOG(INFO) << "load data file ok: " << file_name;
     }
-    if (!success) {
-      EULER_LOG(ERROR) << file_name << " data error!";
-      return false;
+    record_queue.ProducerDone();
+  };
+
+  auto parse = [&record_queue, &parsed_queue, &fail, &options] () {
+    RecordBatch batch;
+    while (record_queue.Pop(&batch)) {
+      ParsedBatch parsed;
+      bool ok = batch.task->type == kLoadNodeTask ?
+          ParseRecords(batch.records, &parsed.node_vec) :
+          ParseRecords(batch.records, &parsed.edge_vec);
+      if (ok && options.neighbor_sampler_type == kAliasSampler) {
+        for (auto node : parsed.node_vec) {
+          node->BuildNeighborAlias(options.alias_min_degree);
+        }
+      }
+      if (!ok) {
+        EULER_LOG(ERROR) << JoinPath(TaskTypeString(batch.task->type),
+                                     batch.task->file) << " data error!";
+        DeleteParsed(&parsed);
+        fail();
+        break;
+      }
+      if (!parsed_queue.Push(std::move(parsed), batch.bytes)) {
+        DeleteParsed(&parsed);
+        break;
+      }
     }
-    EULER_LOG(INFO) << "load data file ok: " << file_name;
+    parsed_queue.ProducerDone();
+  };
+
+  std::unique_ptr<ThreadPool> readers(
+      Env::Default()->StartThreadPool("GraphReader", reader_num));
+  std::unique_ptr<ThreadPool> parsers(
+      Env::Default()->StartThreadPool("GraphParser", parser_num));
+  Signal signal;
+  std::atomic<int> counter(reader_num + parser_num);
+  auto run = [&counter, &signal] (std::function<void()> fn) {
+    return [fn, &counter, &signal] () {
+      fn();
+      if (--counter == 0) {
+        signal.Notify();
+      }
+    };
+  };
+  for (int i = 0; i < reader_num; ++i) {
+    readers->Schedule(run(read));
+  }
+  for (int i = 0; i < parser_num; ++i) {
+    parsers->Schedule(run(parse));
   }
 
-  return true;
+  // Insert in the calling thread while reading and parsing go on
+  ParsedBatch parsed;
+  while (parsed_queue.Pop(&parsed)) {
+    graph->AddNodeFrom(parsed.node_vec);
+    graph->AddEdgeFrom(parsed.edge_vec);
+  }
+
+  signal.Wait();
+  readers->Shutdown();
+  parsers->Shutdown();
+
+  for (auto& it : parsed_queue.Drain()) {
+    DeleteParsed(&it.first);
+  }
+
+  if (!success) {
+    return Status::Internal("Load data failed!");
+  }
+  return Status::OK();
 }
 
 Status GraphBuilder::BuildSampler(Graph* graph,
@@ -307,28 +449,4 @@ Status GraphBuilder::LoadMeta(Slice meta_path, GraphMeta* meta) {
   return Status::OK();
 }
 
-bool GraphBuilder::ParseNodes(FileIO* reader, NodeVec* node_vec) {
-  std::string node_info;
-  while (reader->Read(&node_info)) {
-    Node* node = new Node;
-    if (!node->DeSerialize(node_info)) {
-      return false;
-    }
-    node_vec->emplace_back(node);
-  }
-  return true;
-}
-
-bool GraphBuilder::ParseEdges(FileIO* reader, EdgeVec* edge_vec) {
-  std::string edge_info;
-  while (reader->Read(&edge_info)) {
-    Edge* edge = new Edge;
-    if (!edge->DeSerialize(edge_info)) {
-      return false;
-    }
-    edge_vec->emplace_back(edge);
-  }
-  return true;
-}
-
 }  // namespace euler
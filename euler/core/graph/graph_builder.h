@@ -32,14 +32,14 @@ limitations under the License.
 
 namespace euler {
 
-enum GlobalSamplerType {
+enum GlobalSamplerType : int {
   kEdge,
   kNode,
   kAll,
   kNone
 };
 
-enum GraphDataType {
+enum GraphDataType : int {
   kLoadNone = 0,
   kLoadNode = 1,
   kLoadEdge = 2,
@@ -57,8 +57,13 @@ typedef std::unordered_map<
 
 typedef std::vector<Edge*> EdgeVec;
 
-struct TaskInfo;
+struct FileTask;
 
+// GraphBuilder loads the data files with a pipeline: reader threads stream
+// records from the files in batches, parser threads deserialize the batches
+// and the calling thread adds the parsed nodes and edges to the graph. The
+// thread numbers and the bytes buffered between the stages are set by the
+// GraphLoadOptions of the graph.
 class GraphBuilder {
  public:
   Status Build(Graph* graph, Slice path, GlobalSamplerType sampler_type,
@@ -69,16 +74,10 @@ class GraphBuilder {
 
   Status BuildSampler(Graph* graph, GlobalSamplerType sampler_type);
 
-  bool ParseNodes(FileIO* reader, NodeVec* node_vec);
-
-  bool ParseEdges(FileIO* reader, EdgeVec* edge_vec);
-
-  bool LoadData(TaskInfo* task_info);
+  Status LoadData(Graph* graph, const std::vector<FileTask>& tasks);
 
   Status LoadMeta(Slice meta_path, GraphMeta* meta);
 
-  Status AddToGraph(Graph* graph, const TaskInfo* start, const TaskInfo* end);
-
   GraphBuilder() { }
 };
 
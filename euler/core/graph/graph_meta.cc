@@ -69,6 +69,19 @@ FeatureInfo GraphMeta::GetEdgeFeatureInfo(
 
 #undef FIND_INFO
 
+void GraphMeta::SetFeatureQuantization(const std::string& feature_name,
+                                       const FeatureQuantizationInfo& info) {
+  node_feature_quantization_[feature_name] = info;
+}
+
+FeatureQuantizationInfo GraphMeta::GetFeatureQuantization(
+    const std::string& feature_name) const {
+  auto it = node_feature_quantization_.find(feature_name);
+  if (it == node_feature_quantization_.end()) {
+    return FeatureQuantizationInfo();
+  }
+  return it->second;
+}
 
 uint64_t GraphMeta::GetNodeCount() const {
   return node_count_;
@@ -96,7 +109,15 @@ std::string GraphMeta::ToString() const {
       case kDense: ss << "Dense"; break;
       case UNK: ss << "UNK"; break;
     }
-    ss << ", Dim: " << std::get<2>(it.second) << ";\n";
+    ss << ", Dim: " << std::get<2>(it.second);
+    FeatureQuantizationInfo quantization = GetFeatureQuantization(it.first);
+    if (quantization.type == kFp16Quantization) {
+      ss << ", Quantization: fp16";
+    } else if (quantization.type == kInt8Quantization) {
+      ss << ", Quantization: int8, Scale: " << quantization.scale
+         << ", Offset: " << quantization.offset;
+    }
+    ss << ";\n";
   }
   ss << "\n";
 
@@ -38,6 +38,23 @@ typedef std::tuple<FeatureType, int32_t, int64_t> FeatureInfo;
 typedef std::unordered_map<
   std::string, std::tuple<FeatureType, int32_t, int64_t>> FeatureInfoMap;
 
+// In memory encoding of the dense float features, see
+// GraphLoadOptions::dense_feature_quantization
+enum FeatureQuantization {
+  kNoQuantization = 0,
+  kFp16Quantization = 1,
+  kInt8Quantization = 2
+};
+
+// value = quantized * scale + offset, scale 1 and offset 0 except for int8
+struct FeatureQuantizationInfo {
+  FeatureQuantizationInfo() : type(kNoQuantization), scale(1), offset(0) { }
+
+  FeatureQuantization type;
+  float scale;
+  float offset;
+};
+
 class GraphMeta {
  public:
   GraphMeta()
@@ -112,6 +129,14 @@ class GraphMeta {
     return edge_type_map_;
   }
 
+  // Quantization of a node feature chosen when the graph is loaded, it is
+  // not part of the serialized meta
+  void SetFeatureQuantization(const std::string& feature_name,
+                              const FeatureQuantizationInfo& info);
+
+  FeatureQuantizationInfo GetFeatureQuantization(
+      const std::string& feature_name) const;
+
   uint64_t GetNodeCount() const;
 
   uint64_t GetEdgeCount() const;
@@ -134,6 +159,8 @@ class GraphMeta {
   FeatureInfoMap edge_feature_info_;
   std::unordered_map<std::string, uint32_t> node_type_map_;
   std::unordered_map<std::string, uint32_t> edge_type_map_;
+  std::unordered_map<std::string, FeatureQuantizationInfo>
+      node_feature_quantization_;
 };
 
 }  // namespace euler
@@ -0,0 +1,166 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/graph/graph_snapshot.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "euler/common/logging.h"
+#include "euler/common/file_io.h"
+#include "euler/common/str_util.h"
+
+namespace euler {
+
+namespace {
+
+const uint64_t kSnapshotMagic = 0x504e5352454c5545ULL;  // "EULERSNP"
+const uint32_t kSnapshotVersion = 3;
+const uint64_t kSnapshotAlignment = 64;
+
+inline uint64_t Align(uint64_t offset) {
+  return (offset + kSnapshotAlignment - 1) & ~(kSnapshotAlignment - 1);
+}
+
+}  // namespace
+
+void SnapshotWriter::Add(const void* data, size_t bytes) {
+  sections_.emplace_back(data, bytes);
+}
+
+void SnapshotWriter::Copy(const void* data, size_t bytes) {
+  copies_.emplace_back(static_cast<const char*>(data), bytes);
+  Add(copies_.back().data(), bytes);
+}
+
+Status SnapshotWriter::Write(const std::string& path) const {
+  std::unique_ptr<FileIO> writer;
+  RETURN_IF_ERROR(Env::Default()->NewFileIO(path, false, &writer));
+
+  uint32_t section_num = sections_.size();
+  std::vector<uint64_t> directory;
+  uint64_t offset = Align(sizeof(kSnapshotMagic) + sizeof(kSnapshotVersion) +
+                          sizeof(section_num) +
+                          section_num * 2 * sizeof(uint64_t));
+  for (auto& section : sections_) {
+    directory.push_back(offset);
+    directory.push_back(section.second);
+    offset = Align(offset + section.second);
+  }
+
+  uint64_t written = 0;
+  char padding[kSnapshotAlignment];
+  memset(padding, 0, sizeof(padding));
+  auto write = [&writer, &written] (const void* data, size_t bytes) {
+    written += bytes;
+    return bytes == 0 || writer->WriteData(data, bytes);
+  };
+
+  bool success = write(&kSnapshotMagic, sizeof(kSnapshotMagic)) &&
+      write(&kSnapshotVersion, sizeof(kSnapshotVersion)) &&
+      write(&section_num, sizeof(section_num)) &&
+      write(directory.data(), directory.size() * sizeof(uint64_t));
+  for (size_t i = 0; success && i < sections_.size(); ++i) {
+    success = write(padding, directory[i * 2] - written) &&
+        write(sections_[i].first, sections_[i].second);
+  }
+  if (!success) {
+    return Status::Internal("Write snapshot failed, path: ", path);
+  }
+  return Status::OK();
+}
+
+Status SnapshotReader::Init(const ReadOnlyMemoryRegion* region) {
+  base_ = static_cast<const char*>(region->data());
+  length_ = region->length();
+  section_ = 0;
+
+  uint64_t magic = 0;
+  uint32_t version = 0;
+  size_t header_size = sizeof(magic) + sizeof(version) + sizeof(section_num_);
+  if (length_ < header_size) {
+    return Status::DataLoss("Snapshot is truncated");
+  }
+  memcpy(&magic, base_, sizeof(magic));
+  memcpy(&version, base_ + sizeof(magic), sizeof(version));
+  memcpy(&section_num_, base_ + sizeof(magic) + sizeof(version),
+         sizeof(section_num_));
+  if (magic != kSnapshotMagic) {
+    return Status::DataLoss("Invalid snapshot magic");
+  }
+  if (version != kSnapshotVersion) {
+    // Written by another release, the snapshot is stale rather than invalid
+    return Status::FailedPrecondition("Snapshot version ", version,
+                                      " is not ", kSnapshotVersion);
+  }
+  if (length_ < header_size + section_num_ * 2 * sizeof(uint64_t)) {
+    return Status::DataLoss("Snapshot is truncated");
+  }
+  return Status::OK();
+}
+
+bool SnapshotReader::NextSection(size_t elem_size, const char** data,
+                                 size_t* bytes) {
+  if (section_ >= section_num_) {
+    EULER_LOG(ERROR) << "No more sections in snapshot";
+    return false;
+  }
+
+  const char* directory = base_ + sizeof(uint64_t) + sizeof(uint32_t) * 2;
+  uint64_t entry[2];
+  memcpy(entry, directory + section_ * sizeof(entry), sizeof(entry));
+  ++section_;
+
+  uint64_t offset = entry[0];
+  uint64_t size = entry[1];
+  if (offset > length_ || size > length_ - offset ||
+      offset % kSnapshotAlignment != 0 || size % elem_size != 0) {
+    EULER_LOG(ERROR) << "Invalid snapshot section: " << section_ - 1
+                     << ", offset: " << offset << ", bytes: " << size;
+    return false;
+  }
+  *data = base_ + offset;
+  *bytes = size;
+  return true;
+}
+
+Status AppendFilesFingerprint(const std::string& dir,
+                              FileIO::FilterFunc filter,
+                              std::string* fingerprint) {
+  std::unique_ptr<FileIO> dir_io;
+  RETURN_IF_ERROR(Env::Default()->NewFileIO(dir, true, &dir_io));
+  if (!dir_io->initialized() || !dir_io->IsDirectory()) {
+    return Status::NotFound("Directory ", dir, " not found!");
+  }
+
+  auto files = dir_io->ListDirectory(filter);
+  std::sort(files.begin(), files.end());
+  for (auto& file : files) {
+    std::string file_path = JoinPath(dir, file);
+    struct stat st;
+    if (stat(file_path.c_str(), &st) != 0) {
+      return Status::Internal("Stat ", file_path, " failed");
+    }
+    fingerprint->append(ToString(file, " ", st.st_size, " ",
+                                 st.st_mtim.tv_sec, ".", st.st_mtim.tv_nsec,
+                                 "\n"));
+  }
+  return Status::OK();
+}
+
+}  // namespace euler
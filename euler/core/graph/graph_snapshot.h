@@ -0,0 +1,136 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_GRAPH_GRAPH_SNAPSHOT_H_
+#define EULER_CORE_GRAPH_GRAPH_SNAPSHOT_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "euler/common/env.h"
+#include "euler/common/status.h"
+#include "euler/common/file_io.h"
+#include "euler/common/flat_vector.h"
+
+namespace euler {
+
+// A graph snapshot is a sequence of raw arrays, called sections, which can be
+// memory mapped and used in place:
+//
+//   magic(uint64) version(uint32) section_num(uint32)
+//   section_num * {offset(uint64), bytes(uint64)}
+//   sections, each of them aligned to kSnapshotAlignment
+//
+// The writer and the reader must agree on the order of the sections.
+class SnapshotWriter {
+ public:
+  // The data is referenced until Write returns
+  void Add(const void* data, size_t bytes);
+
+  template <class T>
+  void Add(const std::vector<T>& v) {
+    Add(v.data(), v.size() * sizeof(T));
+  }
+
+  template <class T>
+  void Add(const euler::common::FlatVector<T>& v) {
+    Add(v.data(), v.size() * sizeof(T));
+  }
+
+  // Same as Add but the data is copied, for small arrays like metadata
+  void Copy(const void* data, size_t bytes);
+
+  template <class T>
+  void Copy(const std::vector<T>& v) {
+    Copy(v.data(), v.size() * sizeof(T));
+  }
+
+  void Copy(const std::string& s) {
+    Copy(s.data(), s.size());
+  }
+
+  Status Write(const std::string& path) const;
+
+ private:
+  std::vector<std::pair<const void*, size_t>> sections_;
+  std::deque<std::string> copies_;
+};
+
+class SnapshotReader {
+ public:
+  // The region must outlive the reader and the arrays borrowed from it
+  Status Init(const ReadOnlyMemoryRegion* region);
+
+  // Borrow the next section
+  template <class T>
+  bool Next(euler::common::FlatVector<T>* v) {
+    const char* data = nullptr;
+    size_t bytes = 0;
+    if (!NextSection(sizeof(T), &data, &bytes)) {
+      return false;
+    }
+    v->Borrow(reinterpret_cast<const T*>(data), bytes / sizeof(T));
+    return true;
+  }
+
+  // Copy the next section
+  template <class T>
+  bool Next(std::vector<T>* v) {
+    const char* data = nullptr;
+    size_t bytes = 0;
+    if (!NextSection(sizeof(T), &data, &bytes)) {
+      return false;
+    }
+    const T* begin = reinterpret_cast<const T*>(data);
+    v->assign(begin, begin + bytes / sizeof(T));
+    return true;
+  }
+
+  bool Next(std::string* s) {
+    const char* data = nullptr;
+    size_t bytes = 0;
+    if (!NextSection(1, &data, &bytes)) {
+      return false;
+    }
+    s->assign(data, bytes);
+    return true;
+  }
+
+  bool End() const { return section_ == section_num_; }
+
+ private:
+  bool NextSection(size_t elem_size, const char** data, size_t* bytes);
+
+  const char* base_ = nullptr;
+  uint64_t length_ = 0;
+  uint32_t section_num_ = 0;
+  uint32_t section_ = 0;
+};
+
+// Append the names, sizes and modification times of the files in the local
+// directory dir accepted by filter to fingerprint. A snapshot records the
+// fingerprint of the data files it is built from and is stale once they
+// change.
+Status AppendFilesFingerprint(const std::string& dir,
+                              FileIO::FilterFunc filter,
+                              std::string* fingerprint);
+
+}  // namespace euler
+
+#endif  // EULER_CORE_GRAPH_GRAPH_SNAPSHOT_H_
@@ -0,0 +1,256 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "euler/common/env.h"
+#include "euler/core/graph/graph.h"
+#include "euler/core/graph/graph_snapshot.h"
+#include "euler/core/graph/compact_node_store.h"
+
+namespace euler {
+
+Node* GetNode(euler::common::NodeID id) {
+  Node* node = new Node(id, 1.0 * id, id % 2);
+  std::vector<std::vector<uint64_t>> neighbor_ids;
+  std::vector<std::vector<float>> neighbor_weight;
+  neighbor_ids.push_back({id + 1, id + 3});
+  neighbor_weight.push_back({1, 3});
+  neighbor_ids.push_back({id + 10, id + 11, id + 12});
+  neighbor_weight.push_back({1, 2, 2});
+
+  std::vector<std::vector<uint64_t>> uint64_features;
+  uint64_features.push_back({id, id + 1});
+  std::vector<std::vector<float>> float_features;
+  float_features.push_back({1.1f * id});
+  std::vector<std::string> binary_features;
+  binary_features.push_back("iam" + std::to_string(id));
+
+  if (!node->Init(neighbor_ids, neighbor_weight, uint64_features,
+                  float_features, binary_features)) {
+    delete node;
+    return nullptr;
+  }
+  return node;
+}
+
+TEST(GraphSnapshotTest, CompactNodeStore) {
+  const int kNodeNum = 100;
+  const std::string kPath = "/tmp/graph_snapshot_test.snapshot";
+  CompactNodeStore store;
+  for (int i = 0; i < kNodeNum; ++i) {
+    std::unique_ptr<Node> node(GetNode(i * 3 + 1));
+    ASSERT_TRUE(node != nullptr);
+    ASSERT_TRUE(store.Append(*node));
+  }
+  SnapshotWriter writer;
+  store.DumpSnapshot(&writer);
+  ASSERT_TRUE(writer.Write(kPath).ok());
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  ASSERT_TRUE(Env::Default()->NewReadOnlyMemoryRegion(kPath, &region).ok());
+  SnapshotReader reader;
+  ASSERT_TRUE(reader.Init(region.get()).ok());
+  CompactNodeStore loaded;
+  ASSERT_TRUE(loaded.LoadSnapshot(&reader));
+  ASSERT_TRUE(reader.End());
+
+  ASSERT_EQ(store.size(), loaded.size());
+  ASSERT_EQ(-1, loaded.Find(2));
+  for (size_t row = 0; row < store.size(); ++row) {
+    ASSERT_EQ(static_cast<int64_t>(row), loaded.Find(store.GetID(row)));
+    std::string s1, s2;
+    ASSERT_TRUE(store.Serialize(row, &s1));
+    ASSERT_TRUE(loaded.Serialize(row, &s2));
+    ASSERT_EQ(s1, s2);
+  }
+
+  // Modifying a loaded store copies the mapped arrays
+  std::unique_ptr<Node> node(GetNode(2));
+  ASSERT_TRUE(loaded.Append(*node));
+  ASSERT_EQ(static_cast<int64_t>(kNodeNum), loaded.Find(2));
+  ASSERT_EQ(0, loaded.Find(1));
+
+  remove(kPath.c_str());
+}
+
+TEST(GraphSnapshotTest, InvalidSnapshot) {
+  const std::string kPath = "/tmp/graph_snapshot_test_invalid.snapshot";
+  SnapshotWriter writer;
+  writer.Copy(std::string("not a graph"));
+  ASSERT_TRUE(writer.Write(kPath).ok());
+
+  Graph graph;
+  ASSERT_FALSE(graph.LoadSnapshot(kPath, "").ok());
+  ASSERT_EQ(ErrorCode::NOT_FOUND,
+            graph.LoadSnapshot("/tmp/not_exist.snapshot", "").code());
+
+  FILE* fp = fopen(kPath.c_str(), "wb");
+  fputs("short", fp);
+  fclose(fp);
+  ASSERT_FALSE(graph.LoadSnapshot(kPath, "").ok());
+  remove(kPath.c_str());
+}
+
+TEST(GraphSnapshotTest, StaleSnapshot) {
+  const std::string kPath = "/tmp/euler/euler_0_1.snapshot";
+  remove(kPath.c_str());
+  struct stat built_st, loaded_st, rebuilt_st;
+
+  Graph built;
+  ASSERT_TRUE(built.Init(0, 1, "node", "/tmp/euler", "node", "snapshot").ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &built_st));
+  Graph loaded;
+  ASSERT_TRUE(loaded.Init(0, 1, "node", "/tmp/euler", "node", "snapshot").ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &loaded_st));
+  ASSERT_EQ(built_st.st_ino, loaded_st.st_ino);
+  Graph other;
+  ASSERT_EQ(ErrorCode::FAILED_PRECONDITION,
+            other.LoadSnapshot(kPath, "other source").code());
+
+  // Other load options rewrite the snapshot
+  GraphLoadOptions options;
+  options.neighbor_sampler_type = kAliasSampler;
+  Graph rebuilt;
+  rebuilt.set_load_options(options);
+  ASSERT_TRUE(
+      rebuilt.Init(0, 1, "node", "/tmp/euler", "node", "snapshot").ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &rebuilt_st));
+  ASSERT_NE(built_st.st_ino, rebuilt_st.st_ino);
+  ASSERT_EQ(built.getNodeSize(), rebuilt.getNodeSize());
+
+  // So does another data type
+  Graph all;
+  ASSERT_TRUE(all.Init(0, 1, "node", "/tmp/euler", "all", "snapshot").ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &loaded_st));
+  ASSERT_NE(rebuilt_st.st_ino, loaded_st.st_ino);
+
+  // And so does a data file modified
+  const std::string kDataPath = "/tmp/euler/Node/data_1.dat";
+  struct stat data_st;
+  ASSERT_EQ(0, stat(kDataPath.c_str(), &data_st));
+  struct timespec times[2] = {data_st.st_atim, data_st.st_mtim};
+  times[1].tv_sec -= 1;
+  ASSERT_EQ(0, utimensat(AT_FDCWD, kDataPath.c_str(), times, 0));
+  Graph touched;
+  Status s = touched.Init(0, 1, "node", "/tmp/euler", "all", "snapshot");
+  times[1] = data_st.st_mtim;
+  ASSERT_EQ(0, utimensat(AT_FDCWD, kDataPath.c_str(), times, 0));
+  ASSERT_TRUE(s.ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &rebuilt_st));
+  ASSERT_NE(rebuilt_st.st_ino, loaded_st.st_ino);
+
+  // As well as the graph meta modified
+  const std::string kMetaPath = "/tmp/euler/euler.meta";
+  struct stat meta_st;
+  ASSERT_EQ(0, stat(kMetaPath.c_str(), &meta_st));
+  times[0] = meta_st.st_atim;
+  times[1] = meta_st.st_mtim;
+  times[1].tv_sec -= 1;
+  ASSERT_EQ(0, utimensat(AT_FDCWD, kMetaPath.c_str(), times, 0));
+  Graph meta_touched;
+  s = meta_touched.Init(0, 1, "node", "/tmp/euler", "all", "snapshot");
+  times[1] = meta_st.st_mtim;
+  ASSERT_EQ(0, utimensat(AT_FDCWD, kMetaPath.c_str(), times, 0));
+  ASSERT_TRUE(s.ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &loaded_st));
+  ASSERT_NE(rebuilt_st.st_ino, loaded_st.st_ino);
+  remove(kPath.c_str());
+}
+
+TEST(GraphSnapshotTest, CorruptSnapshot) {
+  const std::string kPath = "/tmp/euler/euler_0_1.snapshot";
+  remove(kPath.c_str());
+
+  Graph built;
+  ASSERT_TRUE(built.Init(0, 1, "node", "/tmp/euler", "all", "snapshot").ok());
+  struct stat built_st, rebuilt_st;
+  ASSERT_EQ(0, stat(kPath.c_str(), &built_st));
+
+  // A truncated snapshot is rebuilt from the data files
+  ASSERT_EQ(0, truncate(kPath.c_str(), built_st.st_size / 2));
+  Graph rebuilt;
+  ASSERT_TRUE(
+      rebuilt.Init(0, 1, "node", "/tmp/euler", "all", "snapshot").ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &rebuilt_st));
+  ASSERT_EQ(built_st.st_size, rebuilt_st.st_size);
+  ASSERT_EQ(built.getNodeSize(), rebuilt.getNodeSize());
+
+  // So is one with a bad magic
+  {
+    std::ofstream out(kPath, std::ios::binary | std::ios::trunc);
+    out << std::string(64, 'x');
+  }
+  Graph garbage;
+  ASSERT_TRUE(
+      garbage.Init(0, 1, "node", "/tmp/euler", "all", "snapshot").ok());
+  ASSERT_EQ(0, stat(kPath.c_str(), &rebuilt_st));
+  ASSERT_EQ(built_st.st_size, rebuilt_st.st_size);
+  ASSERT_EQ(built.getNodeSize(), garbage.getNodeSize());
+  remove(kPath.c_str());
+}
+
+TEST(GraphSnapshotTest, Graph) {
+  const std::string kPath = "/tmp/euler/euler_0_1.snapshot";
+  remove(kPath.c_str());
+
+  // The first build writes the snapshot, the second one loads it
+  Graph built;
+  ASSERT_TRUE(built.Init(0, 1, "node", "/tmp/euler", "all", "snapshot").ok());
+  Graph loaded;
+  ASSERT_TRUE(loaded.Init(0, 1, "node", "/tmp/euler", "all", "snapshot").ok());
+  remove(kPath.c_str());
+
+  ASSERT_EQ(kCompactStore, loaded.storage_type());
+  ASSERT_EQ(built.getNodeSize(), loaded.getNodeSize());
+  ASSERT_EQ(built.getEdgeSize(), loaded.getEdgeSize());
+  ASSERT_EQ(built.GetNodeWeightSums(), loaded.GetNodeWeightSums());
+  ASSERT_EQ(built.graph_meta().ToString(), loaded.graph_meta().ToString());
+  ASSERT_TRUE(loaded.GlobalNodeSamplerOk());
+
+  std::vector<int32_t> edge_types{0, 1};
+  std::vector<int32_t> fids{0, 1};
+  for (euler::common::NodeID id = 1; id <= 6; ++id) {
+    ASSERT_TRUE(loaded.HasNode(id));
+    ASSERT_EQ(built.GetFullNeighbor(id, edge_types),
+              loaded.GetFullNeighbor(id, edge_types));
+    std::vector<std::vector<float>> f1, f2;
+    ASSERT_TRUE(built.GetFloat32Feature(id, fids, &f1));
+    ASSERT_TRUE(loaded.GetFloat32Feature(id, fids, &f2));
+    ASSERT_EQ(f1, f2);
+  }
+
+  for (int type = 0; type < 2; ++type) {
+    auto samples = loaded.SampleNode(type, 100);
+    ASSERT_EQ(100, samples.size());
+    for (auto id : samples) {
+      int32_t node_type = -1;
+      ASSERT_TRUE(loaded.GetNodeType(id, &node_type));
+      ASSERT_EQ(type, node_type);
+    }
+  }
+}
+
+}  // namespace euler
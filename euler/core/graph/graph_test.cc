@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <map>
@@ -166,6 +167,108 @@ TEST(GraphTest, Node) {
   }
 }
 
+TEST(GraphTest, CompactStorage) {
+  Graph* g = GetLocalGraph();
+  Graph compact;
+  ASSERT_TRUE(compact.Init(0, 1, "all", "/tmp/euler", "all", "compact").ok());
+  ASSERT_EQ(kCompactStore, compact.storage_type());
+  ASSERT_EQ(g->getNodeSize(), compact.getNodeSize());
+  ASSERT_EQ(g->GetNodeWeightSums(), compact.GetNodeWeightSums());
+  ASSERT_FALSE(compact.HasNode(100));
+
+  std::vector<int32_t> edge_types{0, 1};
+  std::vector<int32_t> fids{0, 1};
+  for (euler::common::NodeID id = 1; id <= 6; ++id) {
+    ASSERT_TRUE(compact.HasNode(id));
+    int32_t t1 = -1, t2 = -1;
+    ASSERT_TRUE(g->GetNodeType(id, &t1));
+    ASSERT_TRUE(compact.GetNodeType(id, &t2));
+    ASSERT_EQ(t1, t2);
+    ASSERT_EQ(g->GetFullNeighbor(id, edge_types),
+              compact.GetFullNeighbor(id, edge_types));
+
+    std::vector<std::vector<float>> f1, f2;
+    ASSERT_TRUE(g->GetFloat32Feature(id, fids, &f1));
+    ASSERT_TRUE(compact.GetFloat32Feature(id, fids, &f2));
+    ASSERT_EQ(f1, f2);
+
+    std::vector<std::vector<uint64_t>> u1, u2;
+    ASSERT_TRUE(g->GetUint64Feature(id, fids, &u1));
+    ASSERT_TRUE(compact.GetUint64Feature(id, fids, &u2));
+    ASSERT_EQ(u1, u2);
+
+    auto r = compact.SampleNeighbor(id, edge_types, 10);
+    auto full = g->GetFullNeighbor(id, edge_types);
+    ASSERT_EQ(full.empty() ? 0 : 10, r.size());
+  }
+}
+
+TEST(GraphTest, LoadOptions) {
+  Graph* g = GetLocalGraph();
+  GraphLoadOptions options;
+  options.reader_num = 2;
+  options.parser_num = 3;
+  options.max_pending_bytes = 1;  // one batch in each queue at most
+  Graph graph;
+  graph.set_load_options(options);
+  ASSERT_TRUE(graph.Init(0, 1, "all", "/tmp/euler", "all").ok());
+  ASSERT_EQ(g->getNodeSize(), graph.getNodeSize());
+  ASSERT_EQ(g->getEdgeSize(), graph.getEdgeSize());
+  ASSERT_EQ(g->GetNodeWeightSums(), graph.GetNodeWeightSums());
+  ASSERT_EQ(g->GetEdgeWeightSums(), graph.GetEdgeWeightSums());
+  for (euler::common::NodeID id = 1; id <= 6; ++id) {
+    ASSERT_EQ(g->GetFullNeighbor(id, {0, 1}),
+              graph.GetFullNeighbor(id, {0, 1}));
+  }
+}
+
+TEST(GraphTest, AliasNeighborSampler) {
+  GraphLoadOptions options;
+  ASSERT_TRUE(StringToNeighborSamplerType(
+      "alias", &options.neighbor_sampler_type).ok());
+  ASSERT_FALSE(StringToNeighborSamplerType(
+      "unknown", &options.neighbor_sampler_type).ok());
+  for (auto storage_type : {"node", "compact"}) {
+    Graph graph;
+    graph.set_load_options(options);
+    ASSERT_TRUE(
+        graph.Init(0, 1, "node", "/tmp/euler", "node", storage_type).ok());
+    for (euler::common::NodeID id = 1; id <= 6; ++id) {
+      auto full = graph.GetFullNeighbor(id, {0, 1});
+      auto samples = graph.SampleNeighbor(id, {0, 1}, 100);
+      ASSERT_EQ(full.empty() ? 0 : 100, samples.size());
+      for (auto& sample : samples) {
+        ASSERT_TRUE(std::find(full.begin(), full.end(), sample) != full.end());
+      }
+    }
+  }
+}
+
+TEST(GraphTest, SampleNeighborToArrays) {
+  const int32_t kCount = 50;
+  for (auto storage_type : {"node", "compact"}) {
+    Graph graph;
+    ASSERT_TRUE(
+        graph.Init(0, 1, "node", "/tmp/euler", "node", storage_type).ok());
+    std::vector<euler::common::NodeID> ids(kCount, 0);
+    std::vector<float> weights(kCount, 0);
+    std::vector<int32_t> types(kCount, -1);
+    ASSERT_FALSE(graph.SampleNeighbor(100, {0, 1}, kCount, ids.data(),
+                                      weights.data(), types.data()));
+    ASSERT_EQ(-1, types[0]);
+    for (euler::common::NodeID id = 1; id <= 6; ++id) {
+      auto full = graph.GetFullNeighbor(id, {0, 1});
+      ASSERT_EQ(!full.empty(),
+                graph.SampleNeighbor(id, {0, 1}, kCount, ids.data(),
+                                     weights.data(), types.data()));
+      for (int32_t i = 0; !full.empty() && i < kCount; ++i) {
+        auto sample = std::make_tuple(ids[i], weights[i], types[i]);
+        ASSERT_TRUE(std::find(full.begin(), full.end(), sample) != full.end());
+      }
+    }
+  }
+}
+
 TEST(GraphTest, SampleNode) {
   auto g = GetLocalGraph();
   EULER_LOG(INFO)<< "node_sample_distribution";
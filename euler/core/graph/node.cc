@@ -33,6 +33,35 @@ bool id_cmp(std::pair<euler::common::NodeID, float> a,
   return (a.first < b.first);
 }
 
+namespace {
+
+// Keep a copy of the neighbors with each group sorted by id for the binary
+// searches of HasNeighbor, left empty if the groups are sorted already
+void BuildSortedNeighbors(NeighborInfo* ni) {
+  ni->sorted_neighbors.clear();
+  size_t group_num = ni->neighbor_groups_idx.size();
+  size_t i = 0;
+  for (; i < group_num; ++i) {
+    int32_t begin = i == 0 ? 0 : ni->neighbor_groups_idx[i - 1];
+    int32_t end = ni->neighbor_groups_idx[i];
+    if (!std::is_sorted(ni->neighbors.begin() + begin,
+                        ni->neighbors.begin() + end)) {
+      break;
+    }
+  }
+  if (i == group_num) {
+    return;
+  }
+  ni->sorted_neighbors = ni->neighbors;
+  for (; i < group_num; ++i) {
+    int32_t begin = i == 0 ? 0 : ni->neighbor_groups_idx[i - 1];
+    int32_t end = ni->neighbor_groups_idx[i];
+    std::sort(ni->sorted_neighbors.begin() + begin,
+              ni->sorted_neighbors.begin() + end);
+  }
+}
+
+}  // namespace
 
 bool Node::Init(const std::vector<std::vector<uint64_t>>& neighbor_ids,
                     const std::vector<std::vector<float>>& neighbor_weights,
@@ -92,16 +121,70 @@ bool Node::Init(const std::vector<std::vector<uint64_t>>& neighbor_ids,
                 back_inserter(binary_features_));
     }
 
+    BuildSortedNeighbors(&neighbor_info_);
     return true;
 }
 
-inline std::vector<euler::common::IDWeightPair> Node::__SampleNeighbor(
+namespace {
+
+void BuildGroupAlias(int32_t min_degree, NeighborInfo* ni) {
+  size_t group_num = ni->edge_group_collection.GetSize();
+  ni->group_alias.clear();
+  ni->group_alias.resize(group_num);
+  for (size_t i = 0; i < group_num; ++i) {
+    int32_t begin = i == 0 ? 0 : ni->neighbor_groups_idx[i - 1];
+    int32_t end = ni->neighbor_groups_idx[i];
+    float sum_weight = ni->edge_group_collection.Get(i).second;
+    if (end - begin < std::max(min_degree, 1) || sum_weight <= 0) {
+      continue;
+    }
+    std::vector<float> norm_weights(end - begin);
+    float pre_sum_weight = begin == 0 ? 0 : ni->neighbors_weight[begin - 1];
+    for (int32_t j = begin; j < end; ++j) {
+      norm_weights[j - begin] =
+          (ni->neighbors_weight[j] - pre_sum_weight) / sum_weight;
+      pre_sum_weight = ni->neighbors_weight[j];
+    }
+    ni->group_alias[i].Init(norm_weights);
+  }
+}
+
+}  // namespace
+
+void Node::BuildNeighborAlias(int32_t min_degree) {
+  BuildGroupAlias(min_degree, &neighbor_info_);
+  BuildGroupAlias(min_degree, &in_neighbor_info_);
+}
+
+void Node::ClearFloat32Feature(const std::vector<int32_t>& fids) {
+  std::vector<bool> cleared(float_features_idx_.size(), false);
+  for (auto fid : fids) {
+    if (fid >= 0 && fid < static_cast<int32_t>(cleared.size())) {
+      cleared[fid] = true;
+    }
+  }
+  std::vector<int32_t> features_idx;
+  std::vector<float> features;
+  int32_t pre = 0;
+  for (size_t fid = 0; fid < float_features_idx_.size(); ++fid) {
+    if (!cleared[fid]) {
+      features.insert(features.end(), float_features_.begin() + pre,
+                      float_features_.begin() + float_features_idx_[fid]);
+    }
+    pre = float_features_idx_[fid];
+    features_idx.push_back(features.size());
+  }
+  features.shrink_to_fit();
+  float_features_idx_.swap(features_idx);
+  float_features_.swap(features);
+}
+
+template <class Output>
+inline bool Node::__SampleNeighbor(
     const std::vector<int32_t>& edge_types,
     int32_t count,
-    const NeighborInfo& ni) const {
-  std::vector<euler::common::IDWeightPair> err_vec;
-  std::vector<euler::common::IDWeightPair> empty_vec;
-  std::vector<euler::common::IDWeightPair> vec(count);
+    const NeighborInfo& ni,
+    Output output) const {
   euler::common::CompactWeightedCollection<int32_t> sub_edge_group_collection_;
   if (edge_types.size() > 1 &&
       edge_types.size() < ni.edge_group_collection.GetSize()) {
@@ -114,7 +197,7 @@ inline std::vector<euler::common::IDWeightPair> Node::__SampleNeighbor(
         edge_type_weight[i] = ni.edge_group_collection.Get(edge_type);
       } else {
         EULER_LOG(ERROR) << "input edge types vec error:" << edge_type;
-        return err_vec;
+        return false;
       }
     }
     sub_edge_group_collection_.Init(edge_type_weight);
@@ -126,23 +209,23 @@ inline std::vector<euler::common::IDWeightPair> Node::__SampleNeighbor(
       edge_type = edge_types[0];
       if (edge_type < 0 || edge_type >=
           static_cast<int32_t>(ni.edge_group_collection.GetSize())) {
-        return err_vec;
+        return false;
       }
       int32_t pre_idx = edge_type == 0 ? 0 :
                         ni.neighbor_groups_idx[edge_type - 1];
       int32_t cur_idx = ni.neighbor_groups_idx[edge_type] - 1;
       if (cur_idx < pre_idx) {
-        return empty_vec;
+        return false;
       }
     } else if (edge_types.size() > 1 &&
                edge_types.size() < ni.edge_group_collection.GetSize()) {
       if (sub_edge_group_collection_.GetSumWeight() == 0) {
-        return empty_vec;
+        return false;
       }
       edge_type = sub_edge_group_collection_.Sample().first;
     } else {  // sampling in all edge groups
       if (ni.edge_group_collection.GetSumWeight() == 0) {
-        return empty_vec;
+        return false;
       }
       edge_type = ni.edge_group_collection.Sample().first;
     }
@@ -150,26 +233,58 @@ inline std::vector<euler::common::IDWeightPair> Node::__SampleNeighbor(
     int32_t interval_idx_begin = edge_type == 0 ? 0 :
                                  ni.neighbor_groups_idx[edge_type - 1];
     int32_t interval_idx_end = ni.neighbor_groups_idx[edge_type] - 1;
-    size_t mid = euler::common::RandomSelect<euler::common::NodeID>(
-        ni.neighbors_weight, interval_idx_begin, interval_idx_end);
+    size_t mid = 0;
+    if (!ni.group_alias.empty() && ni.group_alias[edge_type].GetSize() > 0) {
+      mid = interval_idx_begin + ni.group_alias[edge_type].Next();
+    } else {
+      mid = euler::common::RandomSelect<euler::common::NodeID>(
+          ni.neighbors_weight, interval_idx_begin, interval_idx_end);
+    }
     float pre_sum_weight = mid <= 0 ? 0 : ni.neighbors_weight[mid - 1];
-    vec[i] = std::make_tuple(ni.neighbors[mid],
-                             ni.neighbors_weight[mid] - pre_sum_weight,
-                             edge_type);
+    output(i, ni.neighbors[mid], ni.neighbors_weight[mid] - pre_sum_weight,
+           edge_type);
   }
-  return vec;
+  return count > 0;
 }
 
 std::vector<euler::common::IDWeightPair>
 Node::SampleNeighbor(const std::vector<int32_t>& edge_types,
                      int32_t count) const {
-  return __SampleNeighbor(edge_types, count, neighbor_info_);
+  std::vector<euler::common::IDWeightPair> vec(count);
+  auto output = [&vec] (int32_t i, euler::common::NodeID id, float weight,
+                        int32_t type) {
+    vec[i] = std::make_tuple(id, weight, type);
+  };
+  if (!__SampleNeighbor(edge_types, count, neighbor_info_, output)) {
+    vec.clear();
+  }
+  return vec;
+}
+
+bool Node::SampleNeighbor(const std::vector<int32_t>& edge_types,
+                          int32_t count, euler::common::NodeID* ids,
+                          float* weights, int32_t* types) const {
+  auto output = [ids, weights, types] (int32_t i, euler::common::NodeID id,
+                                       float weight, int32_t type) {
+    ids[i] = id;
+    weights[i] = weight;
+    types[i] = type;
+  };
+  return __SampleNeighbor(edge_types, count, neighbor_info_, output);
 }
 
 std::vector<euler::common::IDWeightPair>
 Node::SampleInNeighbor(const std::vector<int32_t>& edge_types,
                        int32_t count) const {
-  return __SampleNeighbor(edge_types, count, in_neighbor_info_);
+  std::vector<euler::common::IDWeightPair> vec(count);
+  auto output = [&vec] (int32_t i, euler::common::NodeID id, float weight,
+                        int32_t type) {
+    vec[i] = std::make_tuple(id, weight, type);
+  };
+  if (!__SampleNeighbor(edge_types, count, in_neighbor_info_, output)) {
+    vec.clear();
+  }
+  return vec;
 }
 
 
@@ -207,6 +322,26 @@ Node::GetFullInNeighbor(const std::vector<int32_t>& edge_types) const {
   return __GetFullNeighbor(edge_types, in_neighbor_info_);
 }
 
+bool Node::HasNeighbor(const std::vector<int32_t>& edge_types,
+                       euler::common::NodeID id) const {
+  const NeighborInfo& ni = neighbor_info_;
+  const std::vector<euler::common::NodeID>& neighbors =
+      ni.sorted_neighbors.empty() ? ni.neighbors : ni.sorted_neighbors;
+  for (int32_t edge_type : edge_types) {
+    if (edge_type >= 0 &&
+        edge_type < static_cast<int32_t>(ni.edge_group_collection.GetSize())) {
+      int32_t begin_idx = (edge_type == 0) ?
+                          0 : ni.neighbor_groups_idx[edge_type - 1];
+      int32_t end_idx = ni.neighbor_groups_idx[edge_type];
+      if (std::binary_search(neighbors.begin() + begin_idx,
+                             neighbors.begin() + end_idx, id)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 inline std::vector<euler::common::IDWeightPair> Node::__GetSortedFullNeighbor(
   const std::vector<int32_t>& edge_types,
   const NeighborInfo& ni) const {
@@ -359,6 +494,8 @@ Node::GetTopKInNeighbor(const std::vector<int32_t>& edge_types,
       int32_t now = FEATURES_IDX[fid];                                     \
       F_VALUES_PTR->emplace_back(TYPE(FEATURES.begin() + pre,              \
                                  FEATURES.begin() + now));                 \
+    } else {                                                               \
+      F_VALUES_PTR->emplace_back();                                        \
     }                                                                      \
   }                                                                        \
 }
@@ -456,6 +593,17 @@ bool Node::DeSerialize(const char* s, size_t size) {
     return false;
   }
 
+  int32_t group_begin = 0;
+  for (int32_t group_end : neighbor_info_.neighbor_groups_idx) {
+    if (group_end < group_begin ||
+        group_end > static_cast<int32_t>(neighbor_info_.neighbors.size())) {
+      EULER_LOG(ERROR) << "neighbor groups idx error, node_id: " << id_;
+      return false;
+    }
+    group_begin = group_end;
+  }
+  BuildSortedNeighbors(&neighbor_info_);
+
   edge_group_ids.clear();
   edge_group_weights.clear();
   if (!bytes_reader.Read(&edge_group_ids)) {
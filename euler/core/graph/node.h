@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "euler/common/data_types.h"
 #include "euler/common/timmer.h"
+#include "euler/common/alias_method.h"
 #include "euler/common/weighted_collection.h"
 #include "euler/common/compact_weighted_collection.h"
 
@@ -54,6 +55,12 @@ class NeighborInfo{
   std::vector<int32_t> neighbor_groups_idx;
   std::vector<euler::common::NodeID> neighbors;
   std::vector<float> neighbors_weight;
+  // The neighbors with each group sorted by id, empty if the groups already
+  // are, only built for the out neighbors.
+  std::vector<euler::common::NodeID> sorted_neighbors;
+  // Alias tables of the neighbor groups, empty if not built, an empty table
+  // for the groups sampled by binary search.
+  std::vector<euler::common::AliasMethod> group_alias;
 };
 
 class Node {
@@ -78,10 +85,24 @@ class Node {
 
   float GetWeight() const {return weight_;}
 
+  // Build alias tables for the out and in neighbor groups with no less than
+  // min_degree neighbors, sampling in such a group is O(1) instead of a
+  // binary search over the cumulative weights.
+  void BuildNeighborAlias(int32_t min_degree);
+
+  // Drop the values of the float features fids, which read as empty later
+  void ClearFloat32Feature(const std::vector<int32_t>& fids);
+
   // Randomly sample neighbors with the specified edge types
   virtual std::vector<euler::common::IDWeightPair>
   SampleNeighbor(const std::vector<int32_t>& edge_types, int32_t count) const;
 
+  // Same as above but write the count samples to the arrays directly,
+  // return false and write nothing if there is no neighbor to sample
+  bool SampleNeighbor(const std::vector<int32_t>& edge_types, int32_t count,
+                      euler::common::NodeID* ids, float* weights,
+                      int32_t* types) const;
+
   // Randomly sample in-neighbors with the specified edge types
   virtual std::vector<euler::common::IDWeightPair>
   SampleInNeighbor(const std::vector<int32_t>& edge_types, int32_t count) const;
@@ -94,6 +115,11 @@ class Node {
   virtual std::vector<euler::common::IDWeightPair>
   GetFullInNeighbor(const std::vector<int32_t>& edge_types) const;
 
+  // Whether id is a neighbor with one of the specified edge types, a binary
+  // search of each group in its sorted copy of the neighbors
+  bool HasNeighbor(const std::vector<int32_t>& edge_types,
+                   euler::common::NodeID id) const;
+
   // Get all the neighbor nodes of the specified edge types, sorted by node ids
   virtual std::vector<euler::common::IDWeightPair>
   GetSortedFullNeighbor(const std::vector<int32_t>& edge_types) const;
@@ -162,6 +188,8 @@ class Node {
   int32_t type_;
 
  private:
+  friend class CompactNodeStore;
+
   std::vector<int32_t> uint64_features_idx_;
 
   std::vector<uint64_t> uint64_features_;
@@ -178,10 +206,14 @@ class Node {
 
   NeighborInfo in_neighbor_info_;
 
-  inline std::vector<euler::common::IDWeightPair> __SampleNeighbor(
+  // Call output(i, id, weight, type) for each of the count samples,
+  // return false if nothing is sampled
+  template <class Output>
+  inline bool __SampleNeighbor(
     const std::vector<int32_t>& edge_types,
     int32_t count,
-    const NeighborInfo& ni) const;
+    const NeighborInfo& ni,
+    Output output) const;
 
   inline std::vector<euler::common::IDWeightPair> __GetFullNeighbor(
     const std::vector<int32_t>& edge_types,
@@ -16,6 +16,7 @@ limitations under the License.
 #include <vector>
 #include <string>
 #include <iostream>
+#include <memory>
 
 #include "gtest/gtest.h"
 
@@ -158,4 +159,35 @@ TEST(NodeTest, FastNodeFunction) {
   }
 }
 
+TEST(NodeTest, AliasSampleNeighbor) {
+  std::unique_ptr<Node> fn(GetNode());
+  ASSERT_TRUE(fn != nullptr);
+  fn->BuildNeighborAlias(3);  // group 1 has only 2 neighbors
+  {
+    std::vector<int32_t> edge_types{2};
+    auto r = fn->SampleNeighbor(edge_types, 100000);
+    ASSERT_EQ(r.size(), 100000);
+    std::vector<int32_t> cnts(4);
+    for (auto i : r) {
+      cnts[std::get<0>(i) - 10] += 1;
+      ASSERT_EQ(2, std::get<2>(i));
+    }
+    ASSERT_TRUE(cnts[1] * 1.0 / cnts[0] > 0.8 && cnts[1] * 1.0 / cnts[0] < 1.2);
+    ASSERT_TRUE(cnts[2] * 1.0 / cnts[1] >1.8 && cnts[2] * 1.0 / cnts[1] < 2.2);
+    ASSERT_TRUE(cnts[2] * 1.0 / cnts[3] > 0.8 && cnts[2] * 1.0/cnts[3] < 1.2);
+  }
+  {
+    std::vector<int32_t> edge_types{0, 1};
+    auto r = fn->SampleNeighbor(edge_types, 100000);
+    ASSERT_EQ(r.size(), 100000);
+    std::vector<int32_t> cnts(6);
+    for (auto i : r) {
+      cnts[std::get<0>(i)] += 1;
+    }
+    ASSERT_TRUE(cnts[3] * 1.0 / cnts[1] > 2.8 && cnts[3] * 1.0 / cnts[1] < 3.2);
+    ASSERT_TRUE(cnts[4] * 1.0 / cnts[2] > 1.8 && cnts[4] * 1.0 / cnts[2] < 2.2);
+    ASSERT_TRUE(cnts[3] * 1.0 / cnts[4] > 6.8 && cnts[3] * 1.0 / cnts[4] < 8.2);
+  }
+}
+
 }  // namespace euler
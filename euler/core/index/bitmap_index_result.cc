@@ -0,0 +1,183 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/index/bitmap_index_result.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "euler/common/logging.h"
+#include "euler/core/index/common_index_result.h"
+
+namespace euler {
+
+std::shared_ptr<BitmapIndexResult>
+BitmapIndexResult::From(std::shared_ptr<IndexResult> indexResult) {
+  if (indexResult == nullptr) {
+    return nullptr;
+  }
+  if (indexResult->GetType() == BITMAPINDEXRESULT) {
+    return std::static_pointer_cast<BitmapIndexResult>(indexResult);
+  }
+
+  auto ids = indexResult->GetIds();
+  auto weights = indexResult->GetWeights();
+  if (ids.size() != weights.size()) {
+    EULER_LOG(ERROR) << "Index result " << indexResult->GetName()
+                     << " has " << ids.size() << " ids but "
+                     << weights.size() << " weights";
+    weights.resize(ids.size(), 1.0f);
+  }
+  std::vector<std::pair<uint64_t, float>> data(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    data[i] = std::make_pair(ids[i], weights[i]);
+  }
+  auto f = [](const std::pair<uint64_t, float>& a,
+              const std::pair<uint64_t, float>& b) {return a.first < b.first;};
+  std::stable_sort(data.begin(), data.end(), f);
+  auto g = [](const std::pair<uint64_t, float>& a,
+              const std::pair<uint64_t, float>& b) {
+    return a.first == b.first;
+  };
+  data.erase(std::unique(data.begin(), data.end(), g), data.end());
+
+  auto source = std::make_shared<WeightSource>();
+  ids.resize(data.size());
+  source->weights.resize(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    ids[i] = data[i].first;
+    source->weights[i] = data[i].second;
+  }
+  source->ids = IdBitmap::FromSorted(ids.data(), ids.size());
+
+  auto result = std::make_shared<BitmapIndexResult>("bitmap");
+  result->bitmap_ = source->ids;
+  result->sources_.push_back(source);
+  return result;
+}
+
+const std::vector<float>& BitmapIndexResult::Weights() const {
+  if (weights_ != nullptr) {
+    return *weights_;
+  }
+  if (sources_.size() == 1 && sources_[0]->ids.size() == bitmap_.size()) {
+    // The result is the converted one
+    weights_ = std::shared_ptr<const std::vector<float>>(
+        sources_[0], &sources_[0]->weights);
+    return *weights_;
+  }
+
+  // Walk the sorted ids of each source along the sorted ids of the result
+  auto ids = bitmap_.ToIds();
+  auto weights = std::make_shared<std::vector<float>>(ids.size(), 0.0f);
+  std::vector<bool> filled(ids.size(), false);
+  for (auto& source : sources_) {
+    size_t i = 0;
+    size_t rank = 0;
+    source->ids.ForEach([&] (uint64_t id) {
+      while (i < ids.size() && ids[i] < id) {
+        ++i;
+      }
+      if (i < ids.size() && ids[i] == id && !filled[i]) {
+        (*weights)[i] = source->weights[rank];
+        filled[i] = true;
+      }
+      ++rank;
+    });
+  }
+  weights_ = weights;
+  return *weights_;
+}
+
+std::vector<uint64_t> BitmapIndexResult::GetIds() const {
+  return bitmap_.ToIds();
+}
+
+std::vector<float> BitmapIndexResult::GetWeights() const {
+  return Weights();
+}
+
+std::vector<uint64_t> BitmapIndexResult::GetSortedIds() const {
+  return GetIds();
+}
+
+std::vector<std::pair<uint64_t, float>>
+BitmapIndexResult::Sample(size_t count) const {
+  std::vector<std::pair<uint64_t, float>> result;
+  if (bitmap_.empty()) {
+    return result;
+  }
+  if (sampler_ == nullptr) {
+    auto p = std::make_shared<
+        euler::common::FastWeightedCollection<uint64_t>>();
+    p->Init(GetIds(), Weights());
+    sampler_ = p;
+  }
+  result.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    result[i] = sampler_->Sample();
+  }
+  return result;
+}
+
+std::shared_ptr<IndexResult>
+BitmapIndexResult::Intersection(std::shared_ptr<IndexResult> indexResult) {
+  auto other = From(indexResult);
+  auto result = std::make_shared<BitmapIndexResult>("bitmap");
+  result->bitmap_ = bitmap_.And(other->bitmap_);
+  result->sources_ = sources_;
+  return result;
+}
+
+std::shared_ptr<IndexResult>
+BitmapIndexResult::Union(std::shared_ptr<IndexResult> indexResult) {
+  auto other = From(indexResult);
+  auto result = std::make_shared<BitmapIndexResult>("bitmap");
+  result->bitmap_ = bitmap_.Or(other->bitmap_);
+  result->sources_ = sources_;
+  result->sources_.insert(result->sources_.end(), other->sources_.begin(),
+                          other->sources_.end());
+  return result;
+}
+
+std::shared_ptr<IndexResult>
+BitmapIndexResult::Difference(std::shared_ptr<IndexResult> indexResult) {
+  auto other = From(indexResult);
+  auto result = std::make_shared<BitmapIndexResult>("bitmap");
+  result->bitmap_ = bitmap_.AndNot(other->bitmap_);
+  result->sources_ = sources_;
+  return result;
+}
+
+std::shared_ptr<IndexResult> BitmapIndexResult::ToCommonIndexResult() {
+  auto ids = GetIds();
+  auto& weights = Weights();
+  std::vector<std::pair<uint64_t, float>> data(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    data[i] = std::make_pair(ids[i], weights[i]);
+  }
+  return std::make_shared<CommonIndexResult>("common", data);
+}
+
+float BitmapIndexResult::SumWeight() const {
+  float sum = 0;
+  for (float w : Weights()) {
+    sum += w;
+  }
+  return sum;
+}
+
+}  // namespace euler
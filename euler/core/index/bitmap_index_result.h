@@ -0,0 +1,93 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_INDEX_BITMAP_INDEX_RESULT_H_
+#define EULER_CORE_INDEX_BITMAP_INDEX_RESULT_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "euler/core/index/index_result.h"
+#include "euler/common/id_bitmap.h"
+#include "euler/common/fast_weighted_collection.h"
+
+namespace euler {
+
+// An index result as a compressed bitmap of its ids, the results of the
+// conjunctions and disjunctions of the index searches are combined by the
+// bitmap operations only. The weights stay with the searched results they
+// come from, an id takes the weight of the leftmost of them containing it
+// like the sorted merges of CommonIndexResult, and are only gathered for
+// GetWeights, Sample and SumWeight.
+class BitmapIndexResult : public IndexResult {
+ public:
+  explicit BitmapIndexResult(const std::string& name):
+      IndexResult(BITMAPINDEXRESULT, name) {}
+
+  // Convert any index result, a BitmapIndexResult is shared as is
+  static std::shared_ptr<BitmapIndexResult>
+  From(std::shared_ptr<IndexResult> indexResult);
+
+  const IdBitmap& bitmap() const { return bitmap_; }
+
+  // The ids are sorted
+  std::vector<uint64_t> GetIds() const override;
+
+  std::vector<float> GetWeights() const override;
+
+  std::vector<uint64_t> GetSortedIds() const override;
+
+  std::vector<std::pair<uint64_t, float>> Sample(size_t count) const override;
+
+  std::shared_ptr<IndexResult>
+  Intersection(std::shared_ptr<IndexResult> indexResult) override;
+
+  std::shared_ptr<IndexResult>
+  Union(std::shared_ptr<IndexResult> indexResult) override;
+
+  // The ids of this result not in indexResult
+  std::shared_ptr<IndexResult>
+  Difference(std::shared_ptr<IndexResult> indexResult);
+
+  std::shared_ptr<IndexResult> ToCommonIndexResult() override;
+
+  float SumWeight() const override;
+
+  size_t size() const override { return bitmap_.size(); }
+
+  ~BitmapIndexResult() {}
+
+ private:
+  // The ids and weights of a converted result, the weights are in the order
+  // of the ids
+  struct WeightSource {
+    IdBitmap ids;
+    std::vector<float> weights;
+  };
+
+  const std::vector<float>& Weights() const;
+
+  IdBitmap bitmap_;
+  std::vector<std::shared_ptr<const WeightSource>> sources_;
+  mutable std::shared_ptr<const std::vector<float>> weights_;
+  mutable std::shared_ptr<
+     euler::common::FastWeightedCollection<uint64_t>> sampler_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_INDEX_BITMAP_INDEX_RESULT_H_
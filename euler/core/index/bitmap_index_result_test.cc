@@ -0,0 +1,88 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "euler/core/index/bitmap_index_result.h"
+#include "euler/core/index/common_index_result.h"
+#include "euler/core/index/hash_sample_index.h"
+#include "euler/core/index/range_sample_index.h"
+
+namespace euler {
+
+using std::vector;
+using std::string;
+using std::pair;
+using std::make_pair;
+
+TEST(BitmapIndexResultTest, Func) {
+  HashSampleIndex<uint64_t, string> hsIndex("hash");
+  ASSERT_TRUE(hsIndex.AddItem("red", {4, 2, 6}, {1.0, 2.0, 3.0}));
+  ASSERT_TRUE(hsIndex.AddItem("blue", {1, 5}, {1.0, 2.0}));
+  RangeSampleIndex<uint64_t, float> rsIndex("range");
+  rsIndex.Init({1, 2, 3, 4, 5, 6}, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0},
+               {10.0, 10.0, 10.0, 10.0, 10.0, 10.0});
+
+  auto red = BitmapIndexResult::From(hsIndex.Search(EQ, "red"));
+  ASSERT_EQ(BITMAPINDEXRESULT, red->GetType());
+  ASSERT_EQ(red, BitmapIndexResult::From(red));
+  ASSERT_EQ(vector<uint64_t>({2, 4, 6}), red->GetIds());
+  ASSERT_EQ(vector<float>({2.0, 1.0, 3.0}), red->GetWeights());
+  ASSERT_EQ(6, red->SumWeight());
+  ASSERT_TRUE(red->bitmap().Contains(4));
+  ASSERT_FALSE(red->bitmap().Contains(5));
+
+  // (red and value < 5) or blue, the weights of the ids in red come from
+  // red and the others from blue
+  auto r = red->Intersection(rsIndex.Search(LESS, "5"));
+  ASSERT_EQ(vector<uint64_t>({2, 4}), r->GetIds());
+  ASSERT_EQ(vector<float>({2.0, 1.0}), r->GetWeights());
+  r = r->Union(hsIndex.Search(EQ, "blue"));
+  ASSERT_EQ(vector<uint64_t>({1, 2, 4, 5}), r->GetIds());
+  ASSERT_EQ(vector<float>({1.0, 2.0, 1.0, 2.0}), r->GetWeights());
+  ASSERT_EQ(6, r->SumWeight());
+
+  auto d = std::static_pointer_cast<BitmapIndexResult>(r)->Difference(red);
+  ASSERT_EQ(vector<uint64_t>({1, 5}), d->GetIds());
+
+  auto c = r->ToCommonIndexResult();
+  ASSERT_EQ(COMMONINDEXRESULT, c->GetType());
+  ASSERT_EQ(r->GetIds(), c->GetIds());
+  ASSERT_EQ(r->GetWeights(), c->GetWeights());
+
+  // The common results intersect with the bitmap ones
+  vector<pair<uint64_t, float>> data = {make_pair(2, 5.0), make_pair(3, 1.0)};
+  std::shared_ptr<IndexResult> common(new CommonIndexResult("common", data));
+  ASSERT_EQ(vector<uint64_t>({2}), common->Intersection(r)->GetIds());
+  ASSERT_EQ(vector<float>({5.0}), common->Intersection(r)->GetWeights());
+
+  // Sampled by the weights
+  auto b = BitmapIndexResult::From(r);
+  auto samples = b->Sample(60000);
+  ASSERT_EQ(60000, samples.size());
+  vector<int32_t> cnts(6);
+  for (auto& s : samples) {
+    ASSERT_TRUE(b->bitmap().Contains(s.first));
+    cnts[s.first] += 1;
+  }
+  ASSERT_NEAR(2.0, cnts[2] * 1.0 / cnts[1], 0.1);
+  ASSERT_NEAR(2.0, cnts[5] * 1.0 / cnts[4], 0.1);
+  ASSERT_TRUE(d->Intersection(red)->Sample(10).empty());
+}
+
+}  // namespace euler
@@ -81,13 +81,8 @@ template<typename T1, typename T2>
 std::vector<float> HashIndexResult<T1, T2>::GetWeights() const {
   std::vector<float> result;
   for (auto& it : data_) {
-    size_t start = result.size() + 1;
     std::copy(it.second->GetWeights().begin(),
               it.second->GetWeights().end(), back_inserter(result));
-    size_t end = result.size();
-    for (size_t j = end; j > start; --j) {
-      result[j - 1] -= result[j -2];
-    }
   }
   return result;
 }
@@ -55,6 +55,11 @@ class HashRangeSampleIndex : public SampleIndex {
 
   bool Deserialize(FileIO* file_io);
 
+  // The sorted ids followed by the range index of each of them
+  void DumpSnapshot(SnapshotWriter* writer) const override;
+
+  bool LoadSnapshot(SnapshotReader* reader) override;
+
   bool Merge(std::shared_ptr<SampleIndex> hrIndex) override;
 
   bool Merge(const HashRangeSampleIndex<T1, T2>& hrIndex);
@@ -123,6 +128,44 @@ bool HashRangeSampleIndex<T1, T2>::Serialize(FileIO* file_io) const {
   return true;
 }
 
+template<typename T1, typename T2>
+void HashRangeSampleIndex<T1, T2>::DumpSnapshot(SnapshotWriter* writer) const {
+  std::vector<IdType> ids;
+  ids.reserve(data_.size());
+  for (auto& it : data_) {
+    ids.push_back(it.first);
+  }
+  std::sort(ids.begin(), ids.end());
+  writer->Copy(ids);
+  for (auto id : ids) {
+    data_.at(id)->DumpSnapshot(writer);
+  }
+}
+
+template<typename T1, typename T2>
+bool HashRangeSampleIndex<T1, T2>::LoadSnapshot(SnapshotReader* reader) {
+  std::vector<IdType> ids;
+  if (!reader->Next(&ids)) {
+    EULER_LOG(ERROR) << "read hash range sample index snapshot error";
+    return false;
+  }
+  data_.clear();
+  data_.reserve(ids.size());
+  for (auto id : ids) {
+    RangeIndex rindex =
+      RangeIndex(new RangeSampleIndex<T1, T2>(GetName() + "_" + ToString(id)));
+    if (!rindex->LoadSnapshot(reader)) {
+      EULER_LOG(ERROR) << "read hash range sample index range value error";
+      return false;
+    }
+    if (!data_.insert(std::make_pair(id, rindex)).second) {
+      EULER_LOG(ERROR) << "insert range value error";
+      return false;
+    }
+  }
+  return true;
+}
+
 template<typename T1, typename T2>
 std::shared_ptr<IndexResult> HashRangeSampleIndex<T1, T2>::Search(
     IndexSearchType op,
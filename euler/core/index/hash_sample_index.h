@@ -55,6 +55,12 @@ class HashSampleIndex : public SampleIndex {
 
   uint32_t SerializeSize() const;
 
+  // The keys are sorted, the ids, weights and alias tables of all the keys
+  // are concatenated and sliced by the key offsets
+  void DumpSnapshot(SnapshotWriter* writer) const override;
+
+  bool LoadSnapshot(SnapshotReader* reader) override;
+
   std::shared_ptr<IndexResult>
   Search(IndexSearchType op, const std::string& values) const override;
 
@@ -152,6 +158,82 @@ bool HashSampleIndex<T1, T2>::Deserialize(FileIO* file_io) {
   return true;
 }
 
+template<typename T1, typename T2>
+void HashSampleIndex<T1, T2>::DumpSnapshot(SnapshotWriter* writer) const {
+  std::vector<ValueType> keys = GetKeys();
+  std::sort(keys.begin(), keys.end());
+  std::vector<uint64_t> offsets = {0};
+  std::vector<IdType> ids;
+  std::vector<float> weights;
+  std::vector<float> prob;
+  std::vector<int64_t> alias;
+  for (auto& key : keys) {
+    const FWC& fwc = *data_.at(key);
+    const euler::common::AliasMethod& alias_method = fwc.GetAlias();
+    ids.insert(ids.end(), fwc.GetIds().begin(), fwc.GetIds().end());
+    weights.insert(weights.end(),
+                   fwc.GetWeights().begin(), fwc.GetWeights().end());
+    prob.insert(prob.end(),
+                alias_method.GetProb().begin(), alias_method.GetProb().end());
+    alias.insert(alias.end(), alias_method.GetAlias().begin(),
+                 alias_method.GetAlias().end());
+    offsets.push_back(ids.size());
+  }
+  DumpSnapshotValues(keys, writer);
+  writer->Copy(offsets);
+  writer->Copy(ids);
+  writer->Copy(weights);
+  writer->Copy(prob);
+  writer->Copy(alias);
+}
+
+template<typename T1, typename T2>
+bool HashSampleIndex<T1, T2>::LoadSnapshot(SnapshotReader* reader) {
+  std::vector<ValueType> keys;
+  euler::common::FlatVector<uint64_t> offsets;
+  euler::common::FlatVector<IdType> ids;
+  euler::common::FlatVector<float> weights;
+  euler::common::FlatVector<float> prob;
+  euler::common::FlatVector<int64_t> alias;
+  if (!LoadSnapshotValues(reader, &keys) || !reader->Next(&offsets) ||
+      !reader->Next(&ids) || !reader->Next(&weights) ||
+      !reader->Next(&prob) || !reader->Next(&alias)) {
+    EULER_LOG(ERROR) << "read hash sample index snapshot error";
+    return false;
+  }
+  if (offsets.size() != keys.size() + 1 || offsets[0] != 0 ||
+      offsets.back() != ids.size() || weights.size() != ids.size() ||
+      prob.size() != ids.size() || alias.size() != ids.size()) {
+    EULER_LOG(ERROR) << "hash sample index snapshot size not match";
+    return false;
+  }
+
+  data_.clear();
+  data_.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    uint64_t begin = offsets[i];
+    uint64_t end = offsets[i + 1];
+    if (end < begin || end > ids.size()) {
+      EULER_LOG(ERROR) << "invalid offsets in hash sample index snapshot";
+      return false;
+    }
+    euler::common::AliasMethod alias_method;
+    std::shared_ptr<FWC> fwcp(new FWC());
+    if (!alias_method.Init(
+            std::vector<float>(prob.data() + begin, prob.data() + end),
+            std::vector<int64_t>(alias.data() + begin, alias.data() + end)) ||
+        !fwcp->Init(
+            std::vector<IdType>(ids.data() + begin, ids.data() + end),
+            std::vector<float>(weights.data() + begin, weights.data() + end),
+            alias_method)) {
+      EULER_LOG(ERROR) << "restore hash sample index sampler error";
+      return false;
+    }
+    data_[keys[i]] = fwcp;
+  }
+  return true;
+}
+
 template<typename T1, typename T2>
 bool HashSampleIndex<T1, T2>::AddItem(ValueType value,
                                       const std::vector<IdType>& ids,
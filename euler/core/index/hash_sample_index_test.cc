@@ -20,6 +20,7 @@ limitations under the License.
 #include "gtest/gtest.h"
 
 #include "euler/core/index/hash_sample_index.h"
+#include "euler/core/index/index_manager.h"
 #include "euler/common/env.h"
 
 using std::string;
@@ -414,6 +415,44 @@ TEST(HashSampleIndexTest, DeserializeFileIO) {
   ASSERT_TRUE(cnts[2]*1.0/cnts[1] > 1.9 && cnts[2]*1.0/cnts[1] < 2.1);
 }
 
+TEST(HashSampleIndexTest, Snapshot) {
+  std::string filename = "hash_sample_test.snapshot";
+  HashSampleIndex<int32_t, string> hsIndex("hash");
+  vector<int32_t> ids = {0, 1, 2};
+  vector<float> weights = {2.0, 4.0, 8.0};
+  ASSERT_TRUE(hsIndex.AddItem("name", ids, weights));
+  ASSERT_TRUE(hsIndex.AddItem("", {2}, {1.0}));
+  ASSERT_TRUE(hsIndex.AddItem("age", {}, {}));
+
+  IndexManager im;
+  ASSERT_TRUE(im.DumpSnapshot(hsIndex, filename, "source").ok());
+  HashSampleIndex<int32_t, string> hsIndex2("hash");
+  ASSERT_EQ(ErrorCode::FAILED_PRECONDITION,
+            im.LoadSnapshot(filename, "other", &hsIndex2).code());
+  ASSERT_TRUE(im.LoadSnapshot(filename, "source", &hsIndex2).ok());
+  HashSampleIndex<int32_t, float> badIndex("hash");
+  ASSERT_FALSE(im.LoadSnapshot(filename, "source", &badIndex).ok());
+  if (system("rm -f hash_sample_test.snapshot") < 0) {
+    return;
+  }
+
+  auto keys = hsIndex2.GetKeys();
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ(keys, vector<string>({"", "age", "name"}));
+  ASSERT_EQ(hsIndex2.Search(EQ, "age")->GetIds().size(), 0);
+  ASSERT_EQ(hsIndex2.Search(NOT_EQ, "name")->GetIds(),
+            vector<uint64_t>({2}));
+
+  auto v = hsIndex2.Search(EQ, "name")->Sample(100000);
+  vector<int32_t> cnts(3);
+  for (auto& i : v) {
+    cnts[i.first] += 1;
+    ASSERT_EQ(i.second, weights[i.first]);
+  }
+  ASSERT_TRUE(cnts[1]*1.0/cnts[0] > 1.9 && cnts[1]*1.0/cnts[0] < 2.1);
+  ASSERT_TRUE(cnts[2]*1.0/cnts[1] > 1.9 && cnts[2]*1.0/cnts[1] < 2.1);
+}
+
 TEST(HashSampleIndexTest, Union) {
   HashSampleIndex<int32_t, string> hsIndex("hash");
   {
@@ -15,31 +15,46 @@ limitations under the License.
 
 #include "euler/core/index/index_manager.h"
 
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "euler/common/bytes_compute.h"
 #include "euler/common/env.h"
 #include "euler/common/logging.h"
 #include "euler/common/server_register.h"
+#include "euler/common/signal.h"
+#include "euler/common/str_util.h"
+#include "euler/core/graph/graph_snapshot.h"
 
 namespace euler {
 
 bool IndexManager::DeserializeMeta(FileIO* file_io,
                                    const std::string& name) {
   IndexMetaRecord record;
-  if (!file_io->Read(&record.type)) {
+  return DeserializeMeta(file_io, name, &record);
+}
+
+bool IndexManager::DeserializeMeta(FileIO* file_io, const std::string& name,
+                                   IndexMetaRecord* record) {
+  if (!file_io->Read(&record->type)) {
     EULER_LOG(ERROR) << "read type error";
     return false;
   }
-  if (!file_io->Read(&record.idType)) {
+  if (!file_io->Read(&record->idType)) {
     EULER_LOG(ERROR) << "read idtype error";
     return false;
   }
-  if (!file_io->Read(&record.valueType)) {
+  if (!file_io->Read(&record->valueType)) {
     EULER_LOG(ERROR) << "read valuetype error";
     return false;
   }
-  meta_.AddMeta(name, record);
+  MutexLock l(&mu_);
+  meta_.AddMeta(name, *record);
   return true;
 }
 
@@ -73,12 +88,20 @@ IndexManager::ReadIndex(Slice path, const std::string& index_name) {
   }
 
   auto meta_reader = dir_reader->Open("meta", true);
-  if (!DeserializeMeta(meta_reader.get(), index_name)) {
+  IndexMetaRecord record;
+  if (!DeserializeMeta(meta_reader.get(), index_name, &record)) {
     EULER_LOG(ERROR) << "deserialize " << index_name << " meta error";
     return std::shared_ptr<SampleIndex>();;
   }
 
-  auto filter = [this] (const std::string& filename) {
+  if (use_snapshot_) {
+    return ReadIndexSnapshot(new_path, dir_reader.get(), index_name, record);
+  }
+  return ReadIndexFiles(dir_reader.get(), index_name, record);
+}
+
+FileIO::FilterFunc IndexManager::ShardFilter() const {
+  return [this] (const std::string& filename) {
     auto vec = Split(filename, "_.");
     if (vec.size() == 3 &&
         atoi(vec[1].c_str()) % shard_number_ == shard_index_ &&
@@ -87,10 +110,13 @@ IndexManager::ReadIndex(Slice path, const std::string& index_name) {
     }
     return false;
   };
+}
 
-  auto record = meta_.GetMetaRecord(index_name);
+std::shared_ptr<SampleIndex>
+IndexManager::ReadIndexFiles(FileIO* dir_reader, const std::string& index_name,
+                             const IndexMetaRecord& record) const {
   std::vector<std::shared_ptr<SampleIndex>> result;
-  auto files = dir_reader->ListDirectory(filter);
+  auto files = dir_reader->ListDirectory(ShardFilter());
   for (auto& file : files) {
     EULER_LOG(INFO) << " load file " << file;
     auto reader = dir_reader->Open(file, true);
@@ -113,11 +139,101 @@ IndexManager::ReadIndex(Slice path, const std::string& index_name) {
     EULER_LOG(ERROR) << "merge " << index_name << " index failed!";
     return std::shared_ptr<SampleIndex>();
   }
-  EULER_LOG(INFO) << "Deserialize IndexManager "
-                  << path << " successfully!";
+  EULER_LOG(INFO) << "Deserialize index " << index_name << " successfully!";
   return index;
 }
 
+std::shared_ptr<SampleIndex>
+IndexManager::ReadIndexSnapshot(const std::string& dir, FileIO* dir_reader,
+                                const std::string& index_name,
+                                const IndexMetaRecord& record) const {
+  Slice scheme, host, path;
+  ParseURI(dir, &scheme, &host, &path);
+  if (scheme != "file") {
+    EULER_LOG(ERROR) << "Index snapshot needs a local data path: " << dir;
+    return std::shared_ptr<SampleIndex>();
+  }
+  std::string snapshot_path = JoinPath(
+      path, ToString("index_", shard_index_, "_", shard_number_, ".snapshot"));
+
+  // Everything the index in the snapshot depends on
+  std::string source = ToString("type ", record.type,
+                                "\nid_type ", record.idType,
+                                "\nvalue_type ", record.valueType, "\n");
+  Status s = AppendFilesFingerprint(path.ToString(), ShardFilter(), &source);
+  if (!s.ok()) {
+    EULER_LOG(ERROR) << "Fingerprint index files failed: " << s;
+    return std::shared_ptr<SampleIndex>();
+  }
+
+  auto index = GetIndexByType(index_name, record.type,
+                              record.idType, record.valueType);
+  s = LoadSnapshot(snapshot_path, source, index.get());
+  if (s.ok()) {
+    EULER_LOG(INFO) << "Load index snapshot successfully, path: "
+                    << snapshot_path;
+    return index;
+  }
+  if (s.code() != ErrorCode::NOT_FOUND &&
+      s.code() != ErrorCode::FAILED_PRECONDITION) {
+    EULER_LOG(ERROR) << "Load index snapshot failed: " << s;
+    return std::shared_ptr<SampleIndex>();
+  }
+
+  EULER_LOG(INFO) << "No valid index snapshot found (" << s << "), load "
+                  << index_name << " from data files and write snapshot: "
+                  << snapshot_path;
+  index = ReadIndexFiles(dir_reader, index_name, record);
+  if (index != nullptr) {
+    s = DumpSnapshot(*index, snapshot_path, source);
+    if (!s.ok()) {
+      EULER_LOG(ERROR) << "Dump index snapshot failed: " << s;
+    }
+  }
+  return index;
+}
+
+Status IndexManager::DumpSnapshot(const SampleIndex& index,
+                                  const std::string& path,
+                                  const std::string& source) const {
+  SnapshotWriter writer;
+  writer.Copy(source);
+  index.DumpSnapshot(&writer);
+
+  // Write to a temporary file first so that a partial snapshot is never
+  // visible to the other processes
+  std::string tmp_path = ToString(path, ".tmp.", getpid());
+  Status s = writer.Write(tmp_path);
+  if (!s.ok()) {
+    remove(tmp_path.c_str());
+    return s;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    return Status::Internal("Rename ", tmp_path, " to ", path, " failed");
+  }
+  return Status::OK();
+}
+
+Status IndexManager::LoadSnapshot(const std::string& path,
+                                  const std::string& source,
+                                  SampleIndex* index) const {
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  RETURN_IF_ERROR(Env::Default()->NewReadOnlyMemoryRegion(path, &region));
+  SnapshotReader reader;
+  RETURN_IF_ERROR(reader.Init(region.get()));
+  std::string snapshot_source;
+  if (!reader.Next(&snapshot_source)) {
+    return Status::DataLoss("Invalid index snapshot: ", path);
+  }
+  if (snapshot_source != source) {
+    return Status::FailedPrecondition("Stale index snapshot: ", path);
+  }
+  if (!index->LoadSnapshot(&reader) || !reader.End()) {
+    return Status::DataLoss("Invalid index snapshot: ", path);
+  }
+  return Status::OK();
+}
+
 Status IndexManager::Deserialize(Slice path) {
   std::unique_ptr<FileIO> dir_reader;
   RETURN_IF_ERROR(Env::Default()->NewFileIO(path, true, &dir_reader));
@@ -129,12 +245,34 @@ Status IndexManager::Deserialize(Slice path) {
   auto default_filter = [](const std::string& ){return true;};
   auto index_names = dir_reader->ListDirectory(default_filter);
 
-  for (auto& name : index_names) {
-    auto index = ReadIndex(path, name);
-    if (index == nullptr) {
-      return Status::Internal("invalid index: ", name);
+  // The indexes are independent, load each of them in a thread
+  std::vector<std::shared_ptr<SampleIndex>> indexes(index_names.size());
+  if (!index_names.empty()) {
+    int thread_num = std::min<size_t>(
+        index_names.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::unique_ptr<ThreadPool> loaders(
+        Env::Default()->StartThreadPool("IndexLoader", thread_num));
+    std::string dir = path.ToString();
+    Signal signal;
+    std::atomic<size_t> counter(index_names.size());
+    for (size_t i = 0; i < index_names.size(); ++i) {
+      loaders->Schedule([this, i, &dir, &index_names, &indexes,
+                         &counter, &signal] () {
+        indexes[i] = ReadIndex(dir, index_names[i]);
+        if (--counter == 0) {
+          signal.Notify();
+        }
+      });
+    }
+    signal.Wait();
+    loaders->Shutdown();
+  }
+
+  for (size_t i = 0; i < index_names.size(); ++i) {
+    if (indexes[i] == nullptr) {
+      return Status::Internal("invalid index: ", index_names[i]);
     }
-    index_[name] = index;
+    index_[index_names[i]] = indexes[i];
   }
   EULER_LOG(INFO) << "load index success ";
   EULER_LOG(INFO) <<"Index names are as follows:";
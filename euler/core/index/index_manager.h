@@ -26,14 +26,25 @@ limitations under the License.
 #include "euler/core/index/range_sample_index.h"
 #include "euler/core/index/hash_range_sample_index.h"
 #include "euler/common/file_io.h"
+#include "euler/common/mutex.h"
 #include "euler/common/slice.h"
 #include "euler/common/server_monitor.h"
 
 namespace euler {
 
+// The indexes of a shard, each of them in a directory of the index path
+// with a meta file and the index_<n>.dat files. The directories are loaded
+// in parallel.
+//
+// With use_snapshot each index of the shard is also kept in a local snapshot
+// file index_<shard>_<shard_num>.snapshot of its directory, written after
+// the first load from the data files. Its sections are the sorted arrays and
+// the alias tables of the index, which are memory mapped and copied into the
+// index without parsing the data files or rebuilding the samplers. The
+// snapshot is rewritten once the meta record or the data files change.
 class IndexManager {
  public:
-  IndexManager(): shard_index_(0), shard_number_(1) { }
+  IndexManager(): shard_index_(0), shard_number_(1), use_snapshot_(false) { }
 
   std::shared_ptr<SampleIndex> ReadIndex(Slice path, const std::string& name);
 
@@ -64,7 +75,33 @@ class IndexManager {
     shard_number_ = shard_number;
   }
 
+  void set_use_snapshot(bool use_snapshot) {
+    use_snapshot_ = use_snapshot;
+  }
+
+  // source tells the data files and the meta the index is loaded from
+  Status DumpSnapshot(const SampleIndex& index, const std::string& path,
+                      const std::string& source) const;
+
+  // Fails with FAILED_PRECONDITION if the snapshot is written by another
+  // version or from another source
+  Status LoadSnapshot(const std::string& path, const std::string& source,
+                      SampleIndex* index) const;
+
  private:
+  bool DeserializeMeta(FileIO* file_io, const std::string& index_name,
+                       IndexMetaRecord* record);
+
+  // Accept the index_<n>.dat files of the shard
+  FileIO::FilterFunc ShardFilter() const;
+
+  std::shared_ptr<SampleIndex> ReadIndexFiles(FileIO* dir_reader,
+      const std::string& index_name, const IndexMetaRecord& record) const;
+
+  std::shared_ptr<SampleIndex> ReadIndexSnapshot(const std::string& dir,
+      FileIO* dir_reader, const std::string& index_name,
+      const IndexMetaRecord& record) const;
+
   template<typename IdType>
   std::shared_ptr<SampleIndex>
        GetHashIndex(const std::string& key, IndexDataType valueType) const;
@@ -83,7 +120,9 @@ class IndexManager {
  private:
   int shard_index_;
   int shard_number_;
+  bool use_snapshot_;
 
+  Mutex mu_;  // Guard meta_ while loading the indexes
   IndexMeta meta_;
   std::unordered_map<std::string, std::shared_ptr<SampleIndex> > index_;
 };
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <stdio.h>
+#include <unistd.h>
+
 #include <iostream>
 #include <string>
 #include <vector>
@@ -69,5 +72,56 @@ TEST(IndexManagerTest, Deserialize) {
   }
 }
 
+TEST(IndexManagerTest, Snapshot) {
+  std::vector<std::string> names = {
+      "att", "edge_att", "edge_type", "edge_value", "graph_label",
+      "node_type", "price"};
+  IndexManager expected;
+  ASSERT_TRUE(expected.Deserialize("/tmp/euler/Index").ok());
+
+  // Written from the data files at the first load and mapped at the second
+  for (int i = 0; i < 2; ++i) {
+    IndexManager im;
+    im.set_use_snapshot(true);
+    ASSERT_TRUE(im.Deserialize("/tmp/euler/Index").ok());
+    for (auto& name : names) {
+      auto snapshot = "/tmp/euler/Index/" + name + "/index_0_1.snapshot";
+      ASSERT_EQ(access(snapshot.c_str(), F_OK), 0) << snapshot;
+    }
+    ASSERT_EQ(im.GetIndex("node_type")->Search(EQ, "0")->GetSortedIds(),
+              expected.GetIndex("node_type")->Search(EQ, "0")
+                  ->GetSortedIds());
+    ASSERT_EQ(im.GetIndex("price")->Search(GREATER, "2")->GetSortedIds(),
+              expected.GetIndex("price")->Search(GREATER, "2")
+                  ->GetSortedIds());
+    ASSERT_EQ(im.GetIndex("att")->Search(LESS, "1::5")->GetSortedIds(),
+              expected.GetIndex("att")->Search(LESS, "1::5")
+                  ->GetSortedIds());
+    ASSERT_EQ(im.GetIndex("edge_value")->Search(LESS, "30")->GetWeights(),
+              expected.GetIndex("edge_value")->Search(LESS, "30")
+                  ->GetWeights());
+  }
+
+  // A snapshot from another source is rewritten from the data files
+  auto stale = "/tmp/euler/Index/node_type/index_0_1.snapshot";
+  ASSERT_TRUE(expected.DumpSnapshot(*expected.GetIndex("price"), stale,
+                                    "stale").ok());
+  IndexManager rebuilt;
+  rebuilt.set_use_snapshot(true);
+  ASSERT_TRUE(rebuilt.Deserialize("/tmp/euler/Index").ok());
+  ASSERT_EQ(rebuilt.GetIndex("node_type")->Search(EQ, "0")->GetSortedIds(),
+            expected.GetIndex("node_type")->Search(EQ, "0")->GetSortedIds());
+  IndexManager loaded;
+  loaded.set_use_snapshot(true);
+  ASSERT_TRUE(loaded.Deserialize("/tmp/euler/Index").ok());
+  ASSERT_EQ(loaded.GetIndex("node_type")->Search(EQ, "1")->GetSortedIds(),
+            expected.GetIndex("node_type")->Search(EQ, "1")->GetSortedIds());
+
+  for (auto& name : names) {
+    auto snapshot = "/tmp/euler/Index/" + name + "/index_0_1.snapshot";
+    ASSERT_EQ(remove(snapshot.c_str()), 0);
+  }
+}
+
 }  // namespace euler
 
@@ -32,7 +32,8 @@ enum IndexType : int32_t {
 enum IndexResultType : int32_t {
   HASHINDEXRESULT = 0,
   RANGEINDEXRESULT,
-  COMMONINDEXRESULT
+  COMMONINDEXRESULT,
+  BITMAPINDEXRESULT
 };
 
 enum IndexSearchType : int32_t {
@@ -22,6 +22,7 @@ limitations under the License.
 #include <utility>
 
 #include "euler/core/index/index_types.h"
+#include "euler/core/graph/graph_snapshot.h"
 
 namespace euler {
 
@@ -51,6 +52,53 @@ inline OutputIter intersection(PairIter first1, PairIter last1,
   return result;
 }
 
+// Snapshot sections of the values of an index, the strings are written as
+// their end offsets and the concatenated chars
+template<typename T>
+inline void DumpSnapshotValues(const std::vector<T>& values,
+                               SnapshotWriter* writer) {
+  writer->Copy(values);
+}
+
+inline void DumpSnapshotValues(const std::vector<std::string>& values,
+                               SnapshotWriter* writer) {
+  std::vector<uint64_t> ends;
+  std::string chars;
+  ends.reserve(values.size());
+  for (auto& value : values) {
+    chars += value;
+    ends.push_back(chars.size());
+  }
+  writer->Copy(ends);
+  writer->Copy(chars);
+}
+
+template<typename T>
+inline bool LoadSnapshotValues(SnapshotReader* reader,
+                               std::vector<T>* values) {
+  return reader->Next(values);
+}
+
+inline bool LoadSnapshotValues(SnapshotReader* reader,
+                               std::vector<std::string>* values) {
+  std::vector<uint64_t> ends;
+  std::string chars;
+  if (!reader->Next(&ends) || !reader->Next(&chars)) {
+    return false;
+  }
+  values->clear();
+  values->reserve(ends.size());
+  uint64_t begin = 0;
+  for (auto end : ends) {
+    if (end < begin || end > chars.size()) {
+      return false;
+    }
+    values->emplace_back(chars, begin, end - begin);
+    begin = end;
+  }
+  return true;
+}
+
 }  // namespace euler
 
 #endif  // EULER_CORE_INDEX_INDEX_UTIL_H_
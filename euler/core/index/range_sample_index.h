@@ -19,6 +19,7 @@ limitations under the License.
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <string>
 
@@ -54,6 +55,11 @@ class RangeSampleIndex : public SampleIndex {
 
   bool Deserialize_ori(FileIO* file_io);
 
+  // The ids and the cumulative weights sorted by the values
+  void DumpSnapshot(SnapshotWriter* writer) const override;
+
+  bool LoadSnapshot(SnapshotReader* reader) override;
+
   // values must sorted
   bool Init(const std::vector<IdType>& ids,
             const std::vector<ValueType>& values,
@@ -391,6 +397,27 @@ bool RangeSampleIndex<T1, T2>::Deserialize_ori(FileIO* file_io) {
   return true;
 }
 
+template<typename T1, typename T2>
+void RangeSampleIndex<T1, T2>::DumpSnapshot(SnapshotWriter* writer) const {
+  writer->Add(ids_);
+  DumpSnapshotValues(values_, writer);
+  writer->Add(sum_weights_);
+}
+
+template<typename T1, typename T2>
+bool RangeSampleIndex<T1, T2>::LoadSnapshot(SnapshotReader* reader) {
+  if (!reader->Next(&ids_) || !LoadSnapshotValues(reader, &values_) ||
+      !reader->Next(&sum_weights_)) {
+    EULER_LOG(ERROR) << "read range sample index snapshot error";
+    return false;
+  }
+  if (ids_.size() != values_.size() || ids_.size() != sum_weights_.size()) {
+    EULER_LOG(ERROR) << "id, value, weight size not equal";
+    return false;
+  }
+  return true;
+}
+
 // values must sorted
 template<typename T1, typename T2>
 bool RangeSampleIndex<T1, T2>::Init(const std::vector<IdType>& ids,
@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "euler/core/index/index_types.h"
 #include "euler/core/index/index_result.h"
+#include "euler/core/graph/graph_snapshot.h"
 #include "euler/common/file_io.h"
 #include "euler/common/slice.h"
 
@@ -37,6 +38,13 @@ class SampleIndex {
 
   virtual uint32_t SerializeSize() const = 0;
 
+  // Append the arrays of the index to a snapshot, see IndexManager
+  virtual void DumpSnapshot(SnapshotWriter* writer) const = 0;
+
+  // Restore the index from the sections written by DumpSnapshot, nothing
+  // is parsed, sorted or rebuilt
+  virtual bool LoadSnapshot(SnapshotReader* reader) = 0;
+
   virtual std::string GetName() const {
     return name_;
   }
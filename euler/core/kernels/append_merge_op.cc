@@ -40,7 +40,7 @@ void AppendMerge::Compute(const DAGNodeProto& node_def,
   std::vector<size_t> shape_vec;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    if (node_def.inputs(i) != "") ctx->tensor(node_def.inputs(i), &t);
+    if (node_def.inputs(i) != "") ctx->input(node_def, i, &t);
     if (i % 2 == 0) {  // input data
       input_datas.push_back(t);
       total_num += t->NumElements();
@@ -59,11 +59,10 @@ void AppendMerge::Compute(const DAGNodeProto& node_def,
   shape_vec[0] = total_num / other_dim;
 
   // merge output result
-  std::string output_name = OutputName(node_def, 0);
   Tensor* output_tensor = nullptr;
   TensorShape shape(shape_vec);
-  ctx->Allocate(output_name, shape, data_type,
-                &output_tensor);
+  ctx->AllocateOutput(node_def, 0, shape, data_type,
+                      &output_tensor);
   int32_t output_offset = 0;
   for (size_t i = 0; i < input_datas.size(); ++i) {
     if (merge_idxs[i] != nullptr) {
@@ -98,11 +97,10 @@ void AppendMerge::Compute(const DAGNodeProto& node_def,
     int32_t split_num = static_cast<int32_t>(input_datas.size());
     int32_t offset = 0;
     for (int32_t i = 0; i < split_num; ++i) {
-      std::string output_name = OutputName(node_def, i + 1);
       Tensor* output_tensor = nullptr;
       size_t size = input_datas[i]->Shape().Dims()[0];
-      ctx->Allocate(output_name, {size}, kInt32,
-                    &output_tensor);
+      ctx->AllocateOutput(node_def, i + 1, {size}, kInt32,
+                          &output_tensor);
       if (merge_idxs[i] != nullptr) {
         offset = merge_idxs[i]->Raw<int32_t>()[0];
       } else {
@@ -28,6 +28,8 @@ class As: public OpKernel {
   explicit As(const std::string& name) : OpKernel(name) {}
   void Compute(const DAGNodeProto& node_def,
                OpKernelContext* ctx) override;
+
+  bool IsCheap() const override { return true; }
 };
 
 void As::Compute(const DAGNodeProto& node_def,
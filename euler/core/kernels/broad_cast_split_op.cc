@@ -28,6 +28,8 @@ class BroadCastSplit: public OpKernel {
   explicit BroadCastSplit(const std::string& name) : OpKernel(name) {}
   void Compute(const DAGNodeProto& node_def,
                OpKernelContext* ctx) override;
+
+  bool IsCheap() const override { return true; }
 };
 
 void BroadCastSplit::Compute(const DAGNodeProto& node_def,
@@ -22,6 +22,7 @@ limitations under the License.
 #include <unordered_map>
 
 #include "euler/common/str_util.h"
+#include "euler/core/index/bitmap_index_result.h"
 
 namespace euler {
 
@@ -75,11 +76,27 @@ Status GetEdgeIds(const DAGNodeProto& node_def, int index,
   return Status::OK();
 }
 
-std::shared_ptr<IndexResult> QueryIndex(
-    const DAGNodeProto& node_def, OpKernelContext* ctx) {
+namespace {
+
+// Evaluate the DNF of the node, value_of maps the value of a term to the
+// searched one. The terms on the same index are combined by the index
+// results themselves, e.g. two ranges of a range index, and the others as
+// bitmaps.
+template <typename ValueOf>
+std::shared_ptr<IndexResult> EvaluateDNF(const DAGNodeProto& node_def,
+                                         ValueOf value_of) {
   IndexManager& index_manager = IndexManager::Instance();
-  std::shared_ptr<IndexResult> result(nullptr);
+  auto combine = [] (std::shared_ptr<IndexResult> a,
+                     std::shared_ptr<IndexResult> b, bool conjunction) {
+    if (a->GetType() != BITMAPINDEXRESULT &&
+        a->GetName() == b->GetName()) {
+      return conjunction ? a->Intersection(b) : a->Union(b);
+    }
+    auto bitmap = BitmapIndexResult::From(a);
+    return conjunction ? bitmap->Intersection(b) : bitmap->Union(b);
+  };
 
+  std::shared_ptr<IndexResult> result(nullptr);
   for (const auto& dnf : node_def.dnf()) {
     auto tokens = Split(dnf, ",");
     std::shared_ptr<IndexResult> row_result(nullptr);
@@ -91,30 +108,48 @@ std::shared_ptr<IndexResult> QueryIndex(
       }
       auto& fn = v[0];
       auto& op = v[1];
-      auto value = GetParams(ctx, v[2]);
       auto index = index_manager.GetIndex(fn);
       if (index == nullptr) {
         EULER_LOG(ERROR) << "No index on field: " << fn;
         return nullptr;
       }
 
-      auto tmp = index->Search(op, value);
-      if (row_result == nullptr) {
-        row_result = tmp;
-      } else {
-        row_result->Intersection(tmp);
+      auto tmp = index->Search(op, value_of(v[2]));
+      if (tmp == nullptr) {
+        EULER_LOG(ERROR) << "Invalid search on field: " << token;
+        return nullptr;
       }
+      row_result = row_result == nullptr ? tmp :
+          combine(row_result, tmp, true);
     }
 
-    if (result == nullptr) {
-      result = row_result;
-    } else {
-      result->Union(row_result);
+    if (row_result != nullptr) {
+      result = result == nullptr ? row_result :
+          combine(result, row_result, false);
     }
   }
   return result;
 }
 
+IdBitmap ToBitmap(std::shared_ptr<IndexResult> result) {
+  if (result == nullptr) {
+    return IdBitmap();
+  }
+  if (result->GetType() == BITMAPINDEXRESULT) {
+    return static_cast<BitmapIndexResult*>(result.get())->bitmap();
+  }
+  return IdBitmap::FromIds(result->GetIds());
+}
+
+}  // namespace
+
+std::shared_ptr<IndexResult> QueryIndex(
+    const DAGNodeProto& node_def, OpKernelContext* ctx) {
+  return EvaluateDNF(node_def, [ctx] (const std::string& value) {
+    return GetParams(ctx, value);
+  });
+}
+
 std::vector<std::shared_ptr<IndexResult>> QueryIndex(
     const std::string& index_name,
     const std::vector<std::string>& value) {
@@ -134,75 +169,26 @@ std::vector<std::shared_ptr<IndexResult>> QueryIndex(
 std::vector<std::shared_ptr<IndexResult>> QueryNeighborIndex(
     const DAGNodeProto& node_def, const NodeIdVec& root_ids,
     OpKernelContext* ctx) {
-  IndexManager& index_manager = IndexManager::Instance();
   std::vector<std::shared_ptr<IndexResult>> results(root_ids.size());
   for (size_t i = 0; i < root_ids.size(); ++i) {
-    std::shared_ptr<IndexResult> result(nullptr);
-    for (const auto& dnf : node_def.dnf()) {
-      auto tokens = Split(dnf, ",");
-      std::shared_ptr<IndexResult> row_result(nullptr);
-      for (auto& token : tokens) {
-        auto v = Split(token, " ");
-        if (v.size() != 3) {
-          EULER_LOG(ERROR) << "DNF must be triple";
-          return results;
-        }
-        auto& fn = v[0];
-        auto& op = v[1];
-        auto value = ToString(root_ids[i], "::", GetParams(ctx, v[2]));
-        auto index = index_manager.GetIndex(fn);
-        if (index == nullptr) {
-          EULER_LOG(ERROR) << "No index on field: " << fn;
-          return results;
-        }
-
-        auto tmp = index->Search(op, value);
-        if (row_result == nullptr) {
-          row_result = tmp;
-        } else {
-          row_result->Intersection(tmp);
-        }
-      }
-      if (result == nullptr) {
-        result = row_result;
-      } else {
-        result->Union(row_result);
-      }
-    }
-    results[i] = result;
+    results[i] = EvaluateDNF(node_def, [&] (const std::string& value) {
+      return ToString(root_ids[i], "::", GetParams(ctx, value));
+    });
   }
   return results;
 }
 
-std::unordered_set<Graph::UID> QueryIndexIds(
-    const DAGNodeProto& node_def, OpKernelContext* ctx) {
-  auto result = QueryIndex(node_def, ctx);
-  if (result == nullptr) {
-    return std::unordered_set<Graph::UID>();
-  }
-
-  auto filtered_ids = result->GetIds();
-  return std::unordered_set<Graph::UID>(
-      filtered_ids.begin(), filtered_ids.end());
+IdBitmap QueryIndexIds(const DAGNodeProto& node_def, OpKernelContext* ctx) {
+  return ToBitmap(QueryIndex(node_def, ctx));
 }
 
-std::vector<std::unordered_set<Graph::UID>>
-QueryNeighborIndexIds(const DAGNodeProto& node_def,
-                      const NodeIdVec& root_ids,
-                      OpKernelContext* ctx) {
-  std::vector<std::unordered_set<Graph::UID>> results;
+std::vector<IdBitmap> QueryNeighborIndexIds(const DAGNodeProto& node_def,
+                                            const NodeIdVec& root_ids,
+                                            OpKernelContext* ctx) {
+  std::vector<IdBitmap> results;
   results.reserve(root_ids.size());
-  std::vector<std::shared_ptr<IndexResult>> index_results =
-      QueryNeighborIndex(node_def, root_ids, ctx);
-  for (auto index_result : index_results) {
-    if (index_result == nullptr) {
-      results.push_back(std::unordered_set<Graph::UID>());
-    } else {
-      auto filtered_ids = index_result->GetIds();
-      std::unordered_set<Graph::UID> result(
-        filtered_ids.begin(), filtered_ids.end());
-      results.emplace_back(result);
-    }
+  for (auto& index_result : QueryNeighborIndex(node_def, root_ids, ctx)) {
+    results.push_back(ToBitmap(index_result));
   }
   return results;
 }
@@ -248,11 +234,10 @@ std::vector<Graph::UID> SampleByIndex(
   return ids;
 }
 
-void Filter(const std::unordered_set<Graph::UID>& range,
-            std::vector<Graph::UID>* target) {
+void Filter(const IdBitmap& range, std::vector<Graph::UID>* target) {
   auto cur = target->data();
   for (auto it = target->begin(); it != target->end(); ++it) {
-    if (range.find(*it) != range.end()) {  // contains
+    if (range.Contains(*it)) {
       *cur++ = *it;
     }
   }
@@ -265,7 +250,7 @@ void FilerByIndex(const DAGNodeProto& node_def,
   if (node_def.dnf_size() > 0) {
     auto filter_ids = QueryIndexIds(node_def, ctx);
     if (uids->empty()) {
-      std::copy(filter_ids.begin(), filter_ids.end(), uids->begin());
+      *uids = filter_ids.ToIds();
     } else {
       Filter(filter_ids, uids);
     }
@@ -333,6 +318,43 @@ void FillNeighbor(const DAGNodeProto& node_def,
   }
 }
 
+void SampleNeighborToOutput(const DAGNodeProto& node_def,
+                            OpKernelContext* ctx, const NodeId* node_ids,
+                            size_t num, const std::vector<int>& edge_types,
+                            int count, NodeId default_node) {
+  auto allocate = [&node_def, ctx] (int index, const TensorShape& shape,
+                                    DataType type, Tensor** tensor) {
+    auto name = OutputName(node_def, index);
+    if (!ctx->Allocate(name, shape, type, tensor).ok()) {
+      EULER_LOG(ERROR) << "Allocate output tensor '" << name << "' failed!";
+      return false;
+    }
+    return true;
+  };
+
+  Tensor* index_tensor = nullptr;
+  Tensor* id_tensor = nullptr;
+  Tensor* weight_tensor = nullptr;
+  Tensor* type_tensor = nullptr;
+  TensorShape value_shape({num * count});
+  if (!allocate(0, TensorShape({num, 2}), DataType::kInt32, &index_tensor) ||
+      !allocate(1, value_shape, DataType::kUInt64, &id_tensor) ||
+      !allocate(2, value_shape, DataType::kFloat, &weight_tensor) ||
+      !allocate(3, value_shape, DataType::kInt32, &type_tensor)) {
+    return;
+  }
+
+  auto index_data = index_tensor->Raw<int32_t>();
+  for (size_t i = 0; i < num; ++i) {
+    index_data[i * 2] = i * count;
+    index_data[i * 2 + 1] = (i + 1) * count;
+  }
+  SampleNeighbor(node_ids, num, edge_types, count, default_node,
+                 id_tensor->Raw<uint64_t>(), weight_tensor->Raw<float>(),
+                 type_tensor->Raw<int32_t>(),
+                 ParallelSample(num * count));
+}
+
 void FillNeighborEdge(const DAGNodeProto& node_def,
                       OpKernelContext* ctx, const IdWeightPairVec& result,
                       const NodeIdVec& root_nodes) {
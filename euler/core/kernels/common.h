@@ -24,6 +24,8 @@ limitations under the License.
 #include <unordered_map>
 
 #include "euler/core/api/api.h"
+#include "euler/common/id_bitmap.h"
+#include "euler/common/random.h"
 #include "euler/common/status.h"
 #include "euler/core/graph/graph.h"
 #include "euler/core/framework/op_kernel.h"
@@ -32,6 +34,19 @@ limitations under the License.
 
 namespace euler {
 
+// Batches with at least this number of samples are sampled in parallel
+const size_t kParallelSampleNum = 4096;
+
+// Whether to draw num samples in parallel, the samples of a seeded query
+// are drawn on its own thread to be reproducible
+inline bool ParallelSample(size_t num) {
+  return num >= kParallelSampleNum && !common::RandomSeeded();
+}
+
+// Batches with at least this number of dense feature values are gathered in
+// parallel
+const size_t kParallelGatherNum = 65536;
+
 struct IdWeightType {
   uint64_t id_;
   float w_;
@@ -65,7 +80,9 @@ std::vector<std::shared_ptr<IndexResult>> QueryNeighborIndex(
     const DAGNodeProto& node_def, const NodeIdVec& root_ids,
     OpKernelContext* ctx);
 
-std::vector<std::unordered_set<Graph::UID>> QueryNeighborIndexIds(
+// The ids of the neighbor index results of the root nodes, as bitmaps to be
+// probed by the neighbors
+std::vector<IdBitmap> QueryNeighborIndexIds(
     const DAGNodeProto& node_def,
     const NodeIdVec& root_ids,
     OpKernelContext* ctx);
@@ -77,6 +94,8 @@ SampleNeighborIndexIds(
     size_t count,
     OpKernelContext* ctx);
 
+// Evaluate the DNF of the node, the results of the conjunctions and
+// disjunctions across the indexes are BitmapIndexResults
 std::shared_ptr<IndexResult> QueryIndex(const DAGNodeProto& node_def,
                                         OpKernelContext* ctx);
 
@@ -84,15 +103,14 @@ std::vector<std::shared_ptr<IndexResult>> QueryIndex(
     const std::string& index_name,
     const std::vector<std::string>& value);
 
-std::unordered_set<Graph::UID> QueryIndexIds(const DAGNodeProto& node_def,
-                                             OpKernelContext* ctx);
+IdBitmap QueryIndexIds(const DAGNodeProto& node_def, OpKernelContext* ctx);
 
 std::vector<Graph::UID> SampleByIndex(
     const DAGNodeProto& node_def, int count,
     OpKernelContext* ctx);
 
-void Filter(const std::unordered_set<Graph::UID>& range,
-            std::vector<Graph::UID>* target);
+// Keep the ids of target in range, in their order
+void Filter(const IdBitmap& range, std::vector<Graph::UID>* target);
 
 void FilerByIndex(const DAGNodeProto& node_def,
                   OpKernelContext* ctx,
@@ -101,6 +119,13 @@ void FilerByIndex(const DAGNodeProto& node_def,
 void FillNeighbor(const DAGNodeProto& node_def,
                   OpKernelContext* ctx, const IdWeightPairVec& result);
 
+// Sample count neighbors for each of the num nodes and write them to the
+// outputs in the same layout as FillNeighbor, without intermediate vectors
+void SampleNeighborToOutput(const DAGNodeProto& node_def,
+                            OpKernelContext* ctx, const NodeId* node_ids,
+                            size_t num, const std::vector<int>& edge_types,
+                            int count, NodeId default_node);
+
 void FillNeighborEdge(const DAGNodeProto& node_def,
                       OpKernelContext* ctx, const IdWeightPairVec& result,
                       const NodeIdVec& root_nodes);
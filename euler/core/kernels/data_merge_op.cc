@@ -81,7 +81,7 @@ void DataMerge::Compute(const DAGNodeProto& node_def,
   std::vector<size_t> shape;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    ctx->tensor(node_def.inputs(i), &t);
+    ctx->input(node_def, i, &t);
     if (i % 3 == 0) {  // data
       datas.push_back(t);
       datas_num += t->NumElements();
@@ -123,8 +123,7 @@ void DataMerge::Compute(const DAGNodeProto& node_def,
   }
   Tensor* data_result = nullptr;
 
-  std::string output_name = OutputName(node_def, 0);
-  ctx->Allocate(output_name, data_shape, data_type, &data_result);
+  ctx->AllocateOutput(node_def, 0, data_shape, data_type, &data_result);
   if (data_type == DataType::kUInt64) {
     CONCURRENT_MERGE(uint64_t);
   } else if (data_type == DataType::kFloat) {
@@ -197,7 +196,7 @@ void GPDataMerge::Compute(const DAGNodeProto& node_def,
   size_t bucket_num = 0;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    ctx->tensor(node_def.inputs(i), &t);
+    ctx->input(node_def, i, &t);
     if (i % 3 == 0) {  // data
       datas.push_back(t);
       data_type = t->Type();
@@ -262,13 +261,11 @@ void GPDataMerge::Compute(const DAGNodeProto& node_def,
 
   /* merge data into data_result */
   Tensor* data_result = nullptr;
-  std::string output_name = OutputName(node_def, 0);
-  ctx->Allocate(output_name, data_shape, data_type, &data_result);
+  ctx->AllocateOutput(node_def, 0, data_shape, data_type, &data_result);
   for (size_t i = 0; i < shard_num; ++i) {
     /* generate merge index for each shard */
-    std::string output_name = OutputName(node_def, i + 1);
     Tensor* merge_idx_tensor = nullptr;
-    ctx->Allocate(output_name, datas[i]->Shape(),
+    ctx->AllocateOutput(node_def, i + 1, datas[i]->Shape(),
         DataType::kInt32, &merge_idx_tensor);
     for (int32_t j = 0; j < merge_idxs[i]->NumElements(); ++j) {
       int32_t merge_idx = merge_idxs[i]->Raw<int32_t>()[j];
@@ -282,4 +282,68 @@ TEST(GPDataMergeOpTest, Execute2) {
   }
 }
 
+// A shard gives the nodes it doesn't own empty rows, the dense rows of the
+// owners are merged even if they start with the default value
+TEST(GPDataMergeOpTest, DenseRowsStartWithDefault) {
+  OpKernelContext ctx;
+
+  // create op proto
+  DAGNodeProto node_proto;
+  node_proto.set_name("GP_DATA_MERGE,0");
+  node_proto.set_op("GP_DATA_MERGE");
+  node_proto.add_inputs("API_GET_P,0:1");  // data
+  node_proto.add_inputs("API_GET_P,0:0");  // idx
+  node_proto.add_inputs("ID_SPLIT,2:1");  // merge idx
+  node_proto.add_inputs("API_GET_P,1:1");  // data
+  node_proto.add_inputs("API_GET_P,1:0");  // idx
+  node_proto.add_inputs("ID_SPLIT,2:3");  // merge idx
+
+  // put input tensor into context
+  TensorShape shard_idx_shape({2, 2});
+  TensorShape shard_data_shape({2});
+  TensorShape merge_idx_shape({2});
+  Tensor* data0 = nullptr;
+  Tensor* idx0 = nullptr;
+  Tensor* merge_idx0 = nullptr;
+  Tensor* data1 = nullptr;
+  Tensor* idx1 = nullptr;
+  Tensor* merge_idx1 = nullptr;
+  ctx.Allocate("API_GET_P,0:1", shard_data_shape, DataType::kFloat, &data0);
+  ctx.Allocate("API_GET_P,0:0", shard_idx_shape, DataType::kInt32, &idx0);
+  ctx.Allocate("ID_SPLIT,2:1", merge_idx_shape, DataType::kInt32, &merge_idx0);
+  ctx.Allocate("API_GET_P,1:1", shard_data_shape, DataType::kFloat, &data1);
+  ctx.Allocate("API_GET_P,1:0", shard_idx_shape, DataType::kInt32, &idx1);
+  ctx.Allocate("ID_SPLIT,2:3", merge_idx_shape, DataType::kInt32, &merge_idx1);
+
+  // shard 0 owns node 1, shard 1 owns node 0
+  std::vector<float> data0_v = {2.0, 3.0};
+  std::vector<int32_t> idx0_v = {0, 0, 0, 2};
+  std::vector<int32_t> merge_idx0_v = {0, 1};
+  std::vector<float> data1_v = {0.0, 1.0};
+  std::vector<int32_t> idx1_v = {0, 2, 2, 2};
+  std::vector<int32_t> merge_idx1_v = {0, 1};
+  std::copy(data0_v.begin(), data0_v.end(), data0->Raw<float>());
+  std::copy(idx0_v.begin(), idx0_v.end(), idx0->Raw<int32_t>());
+  std::copy(merge_idx0_v.begin(), merge_idx0_v.end(),
+            merge_idx0->Raw<int32_t>());
+  std::copy(data1_v.begin(), data1_v.end(), data1->Raw<float>());
+  std::copy(idx1_v.begin(), idx1_v.end(), idx1->Raw<int32_t>());
+  std::copy(merge_idx1_v.begin(), merge_idx1_v.end(),
+            merge_idx1->Raw<int32_t>());
+
+  // create op and run
+  OpKernel* data_merge = nullptr;
+  CreateOpKernel("GP_DATA_MERGE", &data_merge);
+  data_merge->Compute(node_proto, &ctx);
+
+  // check result
+  Tensor* output = nullptr;
+  std::vector<float> data_result = {0.0, 1.0, 2.0, 3.0};
+  ctx.tensor("GP_DATA_MERGE,0:0", &output);
+  ASSERT_EQ(data_result.size(), output->NumElements());
+  for (size_t i = 0; i < data_result.size(); ++i) {
+    ASSERT_EQ(data_result[i], output->Raw<float>()[i]);
+  }
+}
+
 }  // namespace euler
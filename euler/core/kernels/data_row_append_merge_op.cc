@@ -54,13 +54,13 @@ void DataRowAppendMergeOp::Compute(const DAGNodeProto& node_def,
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     if (i % 3 == 0) {  // data
       Tensor* t = nullptr;
-      ctx->tensor(node_def.inputs(i), &t);
+      ctx->input(node_def, i, &t);
       datas.push_back(t);
       count += t->NumElements();
       data_type = t->Type();
     } else if (i % 3 == 1) {  // data idx
       Tensor* t = nullptr;
-      ctx->tensor(node_def.inputs(i), &t);
+      ctx->input(node_def, i, &t);
       data_idxs.push_back(t);
 
       if (row == -1) row = t->NumElements() / 2;
@@ -71,10 +71,9 @@ void DataRowAppendMergeOp::Compute(const DAGNodeProto& node_def,
   }
 
   // output
-  std::string output_name = OutputName(node_def, 0);
   Tensor* output_tensor = nullptr;
-  ctx->Allocate(output_name, {count},
-                data_type, &output_tensor);
+  ctx->AllocateOutput(node_def, 0, {count},
+                      data_type, &output_tensor);
 
   if (data_type == DataType::kUInt64) {
     ROW_MERGE(uint64_t);
@@ -67,6 +67,67 @@ void Fill(const Result& result, size_t feature_idx,
   }
 }
 
+// Gather a fixed width dense feature from its column straight into the data
+// tensor. The index tensor is still emitted for the merging ops and the
+// clients, it is computed from the dim. The nodes not in this shard get
+// empty rows as in the other paths, GP_DATA_MERGE picks the owner shard of
+// a node by its non empty row.
+void FillDense(const NodeIdVec& node_ids, int32_t fid, int64_t dim,
+               size_t feature_idx, const std::string& name,
+               OpKernelContext* ctx) {
+  const DenseFeatureStore& store = Graph::Instance().dense_features();
+  size_t found = 0;
+  for (auto id : node_ids) {
+    if (store.Find(id) >= 0) {
+      ++found;
+    }
+  }
+
+  std::string idx_output = OutputName(name, 2 * feature_idx);
+  Tensor* idx_t = nullptr;
+  auto s = ctx->Allocate(idx_output, TensorShape({node_ids.size(), 2}),
+                         DataType::kInt32, &idx_t);
+  if (!s.ok()) {
+    EULER_LOG(ERROR) << "Allocate output tensor: "
+                     << idx_output << " failed!";
+    return;
+  }
+
+  std::string data_output = OutputName(name, 2 * feature_idx + 1);
+  size_t num = found * dim;
+  Tensor* data_t = nullptr;
+  s = ctx->Allocate(data_output, TensorShape({num}), DataType::kFloat,
+                    &data_t);
+  if (!s.ok()) {
+    EULER_LOG(ERROR) << "Allocate output tensor: "
+                     << data_output << " failed!";
+    return;
+  }
+
+  auto idx = idx_t->Raw<int32_t>();
+  if (found == node_ids.size()) {
+    for (size_t j = 0; j < node_ids.size(); ++j) {
+      idx[j * 2] = j * dim;
+      idx[j * 2 + 1] = (j + 1) * dim;
+    }
+    GetNodeDenseFeature(node_ids.data(), node_ids.size(), fid,
+                        data_t->Raw<float>(), num >= kParallelGatherNum);
+    return;
+  }
+
+  float* data = data_t->Raw<float>();
+  int32_t offset = 0;
+  for (size_t j = 0; j < node_ids.size(); ++j) {
+    idx[j * 2] = offset;
+    int64_t row = store.Find(node_ids[j]);
+    if (row >= 0) {
+      store.GetRow(fid, row, data + offset);
+      offset += dim;
+    }
+    idx[j * 2 + 1] = offset;
+  }
+}
+
 }  // namespace
 
 #define UDF_FILL(ID_VEC, FEATURE_FUNC0, FEATURE_FUNC1,             \
@@ -187,10 +248,17 @@ void GetFeatureOp::Compute(const DAGNodeProto& node_def, OpKernelContext* ctx) {
                 GetNodeBinaryFeature(node_ids, {feature_ids[i]}), i,
                 outname, DataType::kInt8, ctx);
             break;
-          default:
+          default: {
+            int32_t fid = graph.GetNodeFeatureId(*feature_ids[i]);
+            int64_t dim = graph.dense_features().dim(fid);
+            if (dim > 0) {
+              FillDense(node_ids, fid, dim, i, outname, ctx);
+              break;
+            }
             Fill<FloatFeatureVec, float>(
                 GetNodeFloat32Feature(node_ids, {feature_ids[i]}), i,
                 outname, DataType::kFloat, ctx);
+          }
         }
       }
     }
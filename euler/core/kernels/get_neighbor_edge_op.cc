@@ -67,7 +67,7 @@ void GetNeighborEdgeOp::Compute(
       for (auto& iw : item) {
         EdgeId eid(node_ids[idx], std::get<0>(iw), std::get<2>(iw));
         Graph::UID uid = graph.EdgeIdToUID(eid);
-        if (filter_ids.find(uid) != filter_ids.end()) {
+        if (filter_ids.Contains(uid)) {
           *cur++ = iw;
         }
       }
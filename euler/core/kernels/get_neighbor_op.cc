@@ -94,7 +94,7 @@ void GetNeighborOp::Compute(const DAGNodeProto& node_def,
       for (auto& item : res) {
         auto cur = item.data();
         for (auto& iw : item) {
-          if (filter_ids.find(std::get<0>(iw)) != filter_ids.end()) {
+          if (filter_ids.Contains(std::get<0>(iw))) {
             *cur++ = iw;
           }
         }
@@ -108,7 +108,7 @@ void GetNeighborOp::Compute(const DAGNodeProto& node_def,
       for (size_t i = 0; i < res.size(); ++i) {
         auto cur = res[i].data();
         for (auto& iw : res[i]) {
-          if (filters[i].find(std::get<0>(iw)) != filters[i].end()) {
+          if (filters[i].Contains(std::get<0>(iw))) {
             *cur++ = iw;
           }
         }
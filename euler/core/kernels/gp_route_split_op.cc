@@ -0,0 +1,90 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string.h>
+
+#include <vector>
+#include <string>
+
+#include "euler/core/kernels/gp_route_split_op.h"
+#include "euler/core/framework/tensor.h"
+#include "euler/client/query_proxy.h"
+#include "euler/common/str_util.h"
+
+namespace euler {
+
+void GPRouteSplit::Compute(const DAGNodeProto& node_def,
+                           OpKernelContext* ctx) {
+  int32_t split_num = split_num_;
+  const IdRouter* router = router_;
+  if (split_num == 0) {
+    QueryProxy* proxy = QueryProxy::GetInstance();
+    split_num = proxy->GetShardNum();
+    router = proxy->GetIdRouter();
+  }
+
+  Tensor* ids_tensor = nullptr;
+  ctx->tensor(node_def.inputs(0), &ids_tensor);
+  const std::vector<size_t>& dims = ids_tensor->Shape().Dims();
+  size_t id_width = dims.size() > 1 ? dims[1] : 1;
+  int32_t ids_num = dims.empty() ? 0 : dims[0];
+  auto ids = ids_tensor->Raw<uint64_t>();
+
+  std::vector<std::vector<int32_t>> merge_idx(split_num);
+  for (int32_t i = 0; i < ids_num; ++i) {
+    uint64_t id = ids[i * id_width];
+    const int32_t* begin = nullptr;
+    const int32_t* end = nullptr;
+    if (router != nullptr) {
+      router->Route(id, &begin, &end);
+    }
+    if (router == nullptr) {
+      for (int32_t j = 0; j < split_num; ++j) {
+        merge_idx[j].push_back(i);
+      }
+    } else if (begin == end) {  // Not found anywhere
+      merge_idx[id % split_num].push_back(i);
+    } else {
+      for (auto shard = begin; shard != end; ++shard) {
+        merge_idx[*shard].push_back(i);
+      }
+    }
+  }
+
+  for (int32_t i = 0; i < split_num; ++i) {
+    std::vector<size_t> shape = dims;
+    if (!shape.empty()) {
+      shape[0] = merge_idx[i].size();
+    }
+    Tensor* split_ids = nullptr;
+    ctx->Allocate(OutputName(node_def, i * 2), TensorShape(shape),
+                  ids_tensor->Type(), &split_ids);
+    auto out = split_ids->Raw<uint64_t>();
+    for (size_t j = 0; j < merge_idx[i].size(); ++j) {
+      memcpy(out + j * id_width, ids + merge_idx[i][j] * id_width,
+             id_width * sizeof(uint64_t));
+    }
+
+    Tensor* merge_idx_t = nullptr;
+    ctx->Allocate(OutputName(node_def, i * 2 + 1), {merge_idx[i].size()},
+                  DataType::kInt32, &merge_idx_t);
+    std::copy(merge_idx[i].begin(), merge_idx[i].end(),
+              merge_idx_t->Raw<int32_t>());
+  }
+}
+
+REGISTER_OP_KERNEL("GP_ROUTE_SPLIT", GPRouteSplit);
+
+}  // namespace euler
@@ -0,0 +1,59 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_KERNELS_GP_ROUTE_SPLIT_OP_H_
+#define EULER_CORE_KERNELS_GP_ROUTE_SPLIT_OP_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "euler/common/id_range_set.h"
+#include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/dag_node.pb.h"
+
+namespace euler {
+
+// Split the ids of graph_partition mode to the shards which may own them
+// according to the node id ranges published by the shards, edge ids are
+// routed by their source node ids. Each id is sent to at least one shard,
+// so the merge ops see every merge index, an id covered by no shard is sent
+// to shard id % split_num. Without the ranges the ids are broadcast to all
+// the shards.
+//
+// Outputs: ids for shard i at 2 * i, their merge index at 2 * i + 1
+class GPRouteSplit: public OpKernel {
+ public:
+  // Route to the shards of the QueryProxy with its id router
+  explicit GPRouteSplit(const std::string& name)
+      : OpKernel(name), split_num_(0), router_(nullptr) { }
+
+  // Route to split_num shards with the router not owned, broadcast if the
+  // router is nullptr
+  GPRouteSplit(const std::string& name, int32_t split_num,
+               const IdRouter* router)
+      : OpKernel(name), split_num_(split_num), router_(router) { }
+
+  void Compute(const DAGNodeProto& node_def,
+               OpKernelContext* ctx) override;
+
+ private:
+  int32_t split_num_;  // 0 for the QueryProxy
+  const IdRouter* router_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_KERNELS_GP_ROUTE_SPLIT_OP_H_
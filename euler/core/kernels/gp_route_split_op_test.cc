@@ -0,0 +1,126 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "euler/common/id_range_set.h"
+#include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/tensor.h"
+#include "euler/core/framework/types.pb.h"
+#include "euler/core/framework/dag_node.pb.h"
+#include "euler/core/kernels/gp_route_split_op.h"
+
+namespace euler {
+
+class GPRouteSplitOpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    node_proto_.set_name("GP_ROUTE_SPLIT,0");
+    node_proto_.set_op("GP_ROUTE_SPLIT");
+    node_proto_.add_inputs("ids,0:0");
+  }
+
+  void Split(const std::vector<std::string>& ranges,
+             const std::vector<uint64_t>& ids, size_t id_width = 1) {
+    std::vector<IdRangeSet> shards(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      ASSERT_TRUE(shards[i].FromString(ranges[i]));
+    }
+    IdRouter router(shards);
+    Split(ranges.size(), &router, ids, id_width);
+  }
+
+  void Split(int32_t split_num, const IdRouter* router,
+             const std::vector<uint64_t>& ids, size_t id_width = 1) {
+    std::vector<size_t> shape = {ids.size() / id_width};
+    if (id_width > 1) {
+      shape.push_back(id_width);
+    }
+    Tensor* ids_t = nullptr;
+    ctx_.Allocate("ids,0:0", TensorShape(shape), DataType::kUInt64, &ids_t);
+    std::copy(ids.begin(), ids.end(), ids_t->Raw<uint64_t>());
+
+    GPRouteSplit split("GP_ROUTE_SPLIT", split_num, router);
+    split.Compute(node_proto_, &ctx_);
+  }
+
+  std::vector<uint64_t> SplitIds(int32_t shard) {
+    Tensor* t = nullptr;
+    EXPECT_TRUE(ctx_.tensor(OutputName(node_proto_, shard * 2), &t).ok());
+    return std::vector<uint64_t>(t->Raw<uint64_t>(),
+                                 t->Raw<uint64_t>() + t->NumElements());
+  }
+
+  std::vector<int32_t> MergeIdx(int32_t shard) {
+    Tensor* t = nullptr;
+    EXPECT_TRUE(
+        ctx_.tensor(OutputName(node_proto_, shard * 2 + 1), &t).ok());
+    return std::vector<int32_t>(t->Raw<int32_t>(),
+                                t->Raw<int32_t>() + t->NumElements());
+  }
+
+  DAGNodeProto node_proto_;
+  OpKernelContext ctx_;
+};
+
+TEST_F(GPRouteSplitOpTest, CoveringShard) {
+  Split({"0-9", "10-19", "20-29"}, {5, 15, 25, 12});
+  ASSERT_EQ(std::vector<uint64_t>({5}), SplitIds(0));
+  ASSERT_EQ(std::vector<int32_t>({0}), MergeIdx(0));
+  ASSERT_EQ(std::vector<uint64_t>({15, 12}), SplitIds(1));
+  ASSERT_EQ(std::vector<int32_t>({1, 3}), MergeIdx(1));
+  ASSERT_EQ(std::vector<uint64_t>({25}), SplitIds(2));
+  ASSERT_EQ(std::vector<int32_t>({2}), MergeIdx(2));
+}
+
+TEST_F(GPRouteSplitOpTest, OverlappingRanges) {
+  Split({"0-19", "10-29"}, {5, 15, 25});
+  ASSERT_EQ(std::vector<uint64_t>({5, 15}), SplitIds(0));
+  ASSERT_EQ(std::vector<int32_t>({0, 1}), MergeIdx(0));
+  ASSERT_EQ(std::vector<uint64_t>({15, 25}), SplitIds(1));
+  ASSERT_EQ(std::vector<int32_t>({1, 2}), MergeIdx(1));
+}
+
+TEST_F(GPRouteSplitOpTest, Uncovered) {
+  // 100 and 32 are in no range, they go to shard id % 3
+  Split({"0-9", "10-19", "20-29"}, {100, 5, 32});
+  ASSERT_EQ(std::vector<uint64_t>({5}), SplitIds(0));
+  ASSERT_EQ(std::vector<int32_t>({1}), MergeIdx(0));
+  ASSERT_EQ(std::vector<uint64_t>({100}), SplitIds(1));
+  ASSERT_EQ(std::vector<int32_t>({0}), MergeIdx(1));
+  ASSERT_EQ(std::vector<uint64_t>({32}), SplitIds(2));
+  ASSERT_EQ(std::vector<int32_t>({2}), MergeIdx(2));
+}
+
+TEST_F(GPRouteSplitOpTest, Broadcast) {
+  Split(2, nullptr, {5, 15, 25});
+  for (int32_t shard = 0; shard < 2; ++shard) {
+    ASSERT_EQ(std::vector<uint64_t>({5, 15, 25}), SplitIds(shard));
+    ASSERT_EQ(std::vector<int32_t>({0, 1, 2}), MergeIdx(shard));
+  }
+}
+
+TEST_F(GPRouteSplitOpTest, EdgeIds) {
+  // Routed by the source node ids
+  Split({"0-9", "10-19"}, {15, 1, 0, 5, 12, 1}, 3);
+  ASSERT_EQ(std::vector<uint64_t>({5, 12, 1}), SplitIds(0));
+  ASSERT_EQ(std::vector<int32_t>({1}), MergeIdx(0));
+  ASSERT_EQ(std::vector<uint64_t>({15, 1, 0}), SplitIds(1));
+  ASSERT_EQ(std::vector<int32_t>({0}), MergeIdx(1));
+}
+
+}  // namespace euler
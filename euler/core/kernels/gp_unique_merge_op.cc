@@ -48,7 +48,7 @@ void GPUniqueMerge::Compute(const DAGNodeProto& node_def,
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
     if (i % 2 == 0) {  // input data
-      ctx->tensor(node_def.inputs(i), &t);
+      ctx->input(node_def, i, &t);
       input_datas.push_back(t);
       if (t->Type() != kUInt64) {
         EULER_LOG(FATAL) << "unique merge not support this kind of data";
@@ -80,23 +80,21 @@ void GPUniqueMerge::Compute(const DAGNodeProto& node_def,
     }
   }
 
-  std::string output_name = OutputName(node_def, 0);
   Tensor* output_tensor = nullptr;
   data_shape[0] = unique_map.size();
   TensorShape result_shape(data_shape);
-  ctx->Allocate(output_name, result_shape, data_type,
-                &output_tensor);
+  ctx->AllocateOutput(node_def, 0, result_shape, data_type,
+                      &output_tensor);
   std::copy(unique_result.begin(), unique_result.end(),
             output_tensor->Raw<uint64_t>());
 
   // add merge index for next merge
   int32_t split_num = input_datas.size();
   for (int32_t i = 0; i < split_num; ++i) {
-    std::string output_name = OutputName(node_def, i + 1);
     Tensor* output_tensor = nullptr;
     size_t size = input_datas[i]->Shape().Dims()[0];
-    ctx->Allocate(output_name, {size}, kInt32,
-                  &output_tensor);
+    ctx->AllocateOutput(node_def, i + 1, {size}, kInt32,
+                        &output_tensor);
     for (size_t j = 0; j < size; ++j) {
       std::string key = DataToString(
           input_datas[i]->Raw<uint64_t>() + j * offset,
@@ -38,7 +38,7 @@ void IdxMerge::Compute(const DAGNodeProto& node_def,
   int32_t offset = 1;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    ctx->tensor(node_def.inputs(i), &t);
+    ctx->input(node_def, i, &t);
     if (i % 2 == 0) {  // id
       idxs.push_back(t);
       ids_num += t->Shape().Dims()[0];
@@ -51,12 +51,11 @@ void IdxMerge::Compute(const DAGNodeProto& node_def,
   }
 
   /* merge output result */
-  std::string output_name = OutputName(node_def, 0);
   Tensor* idx_result = nullptr;
   std::vector<size_t> idx_shape_v = idxs[0]->Shape().Dims();
   idx_shape_v[0] = ids_num;
   TensorShape idx_shape(idx_shape_v);
-  ctx->Allocate(output_name, idx_shape, DataType::kInt32, &idx_result);
+  ctx->AllocateOutput(node_def, 0, idx_shape, DataType::kInt32, &idx_result);
 
   for (size_t i = 0; i < idxs.size(); ++i) {
     Tensor* merge_t = merge_idxs[i];
@@ -92,7 +91,7 @@ void GPIdxMerge::Compute(const DAGNodeProto& node_def,
   size_t ids_num = 0;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    ctx->tensor(node_def.inputs(i), &t);
+    ctx->input(node_def, i, &t);
     if (i % 2 == 0) {  // id
       idxs.push_back(t);
       ids_num += t->Shape().Dims()[0];
@@ -117,10 +116,9 @@ void GPIdxMerge::Compute(const DAGNodeProto& node_def,
   ids_num = merge_idx2size.size();
 
   /* merge output result */
-  std::string output_name = OutputName(node_def, 0);
   Tensor* idx_result = nullptr;
   TensorShape idx_shape({ids_num, 2});
-  ctx->Allocate(output_name, idx_shape, DataType::kInt32, &idx_result);
+  ctx->AllocateOutput(node_def, 0, idx_shape, DataType::kInt32, &idx_result);
   for (size_t i = 0; i < idxs.size(); ++i) {
     Tensor* merge_t = merge_idxs[i];
     for (size_t j = 0; j < idxs[i]->Shape().Dims()[0]; ++j) {
@@ -37,7 +37,7 @@ void IdxRowAppendMergeOp::Compute(const DAGNodeProto& node_def,
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     if (i % 2 == 0) {  // input data
       Tensor* t = nullptr;
-      ctx->tensor(node_def.inputs(i), &t);
+      ctx->input(node_def, i, &t);
       input_datas.push_back(t);
       if (row == -1) row = t->NumElements() / 2;
       if (row != t->NumElements() / 2) {
@@ -47,10 +47,9 @@ void IdxRowAppendMergeOp::Compute(const DAGNodeProto& node_def,
   }
 
   // output
-  std::string output_name = OutputName(node_def, 0);
   Tensor* output_tensor = nullptr;
-  ctx->Allocate(output_name, {static_cast<size_t>(row), 2},
-                DataType::kInt32, &output_tensor);
+  ctx->AllocateOutput(node_def, 0, {static_cast<size_t>(row), 2},
+                      DataType::kInt32, &output_tensor);
   int32_t offset = 0;
   for (int32_t i = 0; i < row; ++i) {
     int32_t size = 0;
@@ -38,7 +38,7 @@ void MultiTypeDataMerge::Compute(const DAGNodeProto& node_def,
   size_t types_num = 0;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    if (node_def.inputs(i) != "") ctx->tensor(node_def.inputs(i), &t);
+    if (node_def.inputs(i) != "") ctx->input(node_def, i, &t);
     if (i % 3 == 0) {  // data
       datas.push_back(t);
     } else if (i % 3 == 1) {  // idx
@@ -51,10 +51,9 @@ void MultiTypeDataMerge::Compute(const DAGNodeProto& node_def,
   for (size_t i = 0; i < datas.size(); ++i) {
     node_cnt += datas[i]->NumElements();
   }
-  std::string output_name = OutputName(node_def, 0);
   Tensor* data_result = nullptr;
   TensorShape data_shape({node_cnt});
-  ctx->Allocate(output_name, data_shape, DataType::kUInt64, &data_result);
+  ctx->AllocateOutput(node_def, 0, data_shape, DataType::kUInt64, &data_result);
   int32_t base_addr = 0;
   for (size_t i = 0; i < types_num; ++i) {  // each type
     for (size_t j = 0; j < datas.size(); ++j) {  // each shard
@@ -37,7 +37,7 @@ void MultiTypeIdxMerge::Compute(const DAGNodeProto& node_def,
   size_t types_num = 0;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    if (node_def.inputs(i) != "") ctx->tensor(node_def.inputs(i), &t);
+    if (node_def.inputs(i) != "") ctx->input(node_def, i, &t);
     if (i % 2 == 0) {
       idxs.push_back(t);
       types_num = t->Shape().Dims()[0];
@@ -45,10 +45,9 @@ void MultiTypeIdxMerge::Compute(const DAGNodeProto& node_def,
   }
 
   /* merge output result */
-  std::string output_name = OutputName(node_def, 0);
   Tensor* idx_result = nullptr;
   TensorShape idx_shape({types_num, 2});
-  ctx->Allocate(output_name, idx_shape, DataType::kInt32, &idx_result);
+  ctx->AllocateOutput(node_def, 0, idx_shape, DataType::kInt32, &idx_result);
   int32_t base_addr = 0;
   for (size_t i = 0; i < types_num; ++i) {
     int32_t cnt = 0;
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include <algorithm>
 #include <iostream>
+#include <set>
+#include <utility>
 
 #include "gtest/gtest.h"
 
@@ -120,6 +122,22 @@ TEST_F(OpKernelTest, GetNode) {
 
     PrintVector(ids_t->Raw<uint64_t>(), ids_t->Shape().Dims()[0], -1);
   }
+
+  // With DNF on two indexes, (price > 3.5 and node_type == 1) or price < 2
+  {
+    proto.clear_dnf();
+    proto.mutable_dnf()->Add()->assign("price gt 3.5,node_type eq 1");
+    proto.mutable_dnf()->Add()->assign("price lt 2.0");
+
+    ctx.Deallocate(OutputName(proto.name(), 0));
+    op->Compute(proto, &ctx);
+
+    Tensor* ids_t = nullptr;
+    ASSERT_TRUE(ctx.tensor(OutputName(proto.name(), 0), &ids_t).ok());
+    ASSERT_EQ(2, ids_t->Shape().Dims()[0]);
+    ASSERT_EQ(1, ids_t->Raw<uint64_t>()[0]);
+    ASSERT_EQ(5, ids_t->Raw<uint64_t>()[1]);
+  }
 }
 
 TEST_F(OpKernelTest, GetEdge) {
@@ -566,4 +584,94 @@ TEST_F(OpKernelTest, SampleNWithTypes) {
     }
   }
 }
+TEST_F(OpKernelTest, RandomWalk) {
+  OpKernel* op = nullptr;
+  ASSERT_TRUE(CreateOpKernel("API_RANDOM_WALK", &op).ok());
+  ASSERT_NE(nullptr, op);
+
+  // Run the walks {node, parent, start} with the edge types of each step
+  auto walk = [op] (const std::vector<std::vector<uint64_t>>& walks,
+                    const std::vector<std::vector<int32_t>>& schedule,
+                    float p, float q, std::vector<uint64_t>* ids,
+                    std::vector<int32_t>* steps) {
+    OpKernelContext ctx;
+    DAGNodeProto proto;
+    proto.set_name("random_walk");
+    proto.set_op("API_RANDOM_WALK");
+    for (auto name : {"walks", "edge_types", "edge_type_nums", "pq"}) {
+      proto.mutable_inputs()->Add()->assign(name);
+    }
+
+    Tensor* t = nullptr;
+    ctx.Allocate("walks", TensorShape({walks.size(), 3}), kUInt64, &t);
+    for (size_t i = 0; i < walks.size(); ++i) {
+      std::copy(walks[i].begin(), walks[i].end(), t->Raw<uint64_t>() + i * 3);
+    }
+    std::vector<int32_t> edge_types, edge_type_nums;
+    for (auto& types : schedule) {
+      edge_types.insert(edge_types.end(), types.begin(), types.end());
+      edge_type_nums.push_back(types.size());
+    }
+    ctx.Allocate("edge_types", TensorShape({edge_types.size()}), kInt32, &t);
+    std::copy(edge_types.begin(), edge_types.end(), t->Raw<int32_t>());
+    ctx.Allocate("edge_type_nums", TensorShape({schedule.size()}), kInt32,
+                 &t);
+    std::copy(edge_type_nums.begin(), edge_type_nums.end(),
+              t->Raw<int32_t>());
+    ctx.Allocate("pq", TensorShape({2}), kFloat, &t);
+    t->Raw<float>()[0] = p;
+    t->Raw<float>()[1] = q;
+
+    op->Compute(proto, &ctx);
+    ASSERT_TRUE(ctx.tensor("random_walk:0", &t).ok());
+    ASSERT_EQ(walks.size() * (schedule.size() + 1), t->NumElements());
+    ids->assign(t->Raw<uint64_t>(), t->Raw<uint64_t>() + t->NumElements());
+    ASSERT_TRUE(ctx.tensor("random_walk:1", &t).ok());
+    steps->assign(t->Raw<int32_t>(), t->Raw<int32_t>() + t->NumElements());
+  };
+
+  // The out edges of the test graph by type
+  std::set<std::pair<uint64_t, uint64_t>> type0 = {
+    {1, 2}, {1, 4}, {3, 4}, {5, 2}, {5, 6}};
+  std::set<std::pair<uint64_t, uint64_t>> type1 = {
+    {1, 3}, {2, 3}, {2, 5}, {4, 5}, {6, 1}, {6, 3}, {6, 5}};
+
+  // Every step follows an edge, node 7 is not found
+  std::vector<uint64_t> ids;
+  std::vector<int32_t> steps;
+  std::vector<std::vector<int32_t>> schedule(4, {0, 1});
+  walk({{1, 0, 0}, {6, 0, 0}, {7, 0, 0}}, schedule, 0.5, 2, &ids, &steps);
+  ASSERT_EQ(std::vector<int32_t>({4, 4, euler::common::DEFAULT_INT32}),
+            steps);
+  for (size_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(i == 0 ? 1 : 6, ids[i * 5]);
+    for (size_t k = 0; k < 4; ++k) {
+      auto edge = std::make_pair(ids[i * 5 + k], ids[i * 5 + k + 1]);
+      ASSERT_TRUE(type0.count(edge) + type1.count(edge) == 1);
+    }
+  }
+  ASSERT_EQ(std::vector<uint64_t>(5, 0),
+            std::vector<uint64_t>(ids.begin() + 10, ids.end()));
+
+  // A metapath of type 0 then type 1, node 3 has no out edge of type 1 and
+  // the walk resumed at the last step only walks one step
+  walk({{1, 0, 0}, {3, 1, 1}, {2, 1, 1}}, {{0}, {1}}, 1, 1, &ids, &steps);
+  ASSERT_EQ(std::vector<int32_t>({2, 1, 1}), steps);
+  ASSERT_TRUE(type0.count({1, ids[1]}));
+  ASSERT_TRUE(type1.count({ids[1], ids[2]}));
+  ASSERT_EQ(std::vector<uint64_t>({3, 0, 0}),
+            std::vector<uint64_t>(ids.begin() + 3, ids.begin() + 6));
+  ASSERT_EQ(2, ids[6]);
+  ASSERT_TRUE(type1.count({2, ids[7]}));
+  ASSERT_EQ(0, ids[8]);
+
+  // With a small p the walks at node 5 from node 6 mostly return to 6
+  std::vector<std::vector<uint64_t>> walks(100, {5, 6, 1});
+  walk(walks, schedule, 0.001, 1, &ids, &steps);
+  int returns = 0;
+  for (size_t i = 0; i < walks.size(); ++i) {
+    returns += ids[i * 5 + 1] == 6;
+  }
+  ASSERT_GE(returns, 95);
+}
 }  // namespace euler
@@ -16,7 +16,7 @@ limitations under the License.
 #include <vector>
 #include <string>
 #include <algorithm>
-#include <queue>
+#include <utility>
 
 #include "euler/common/logging.h"
 #include "euler/core/framework/op_kernel.h"
@@ -27,51 +27,140 @@ limitations under the License.
 namespace euler {
 
 namespace {
-bool IdBigger(const uint64_t* a, const uint64_t* b, int32_t len) {
-  int32_t i = 0; for (; i < len && *(a + i) == *(b + i); ++i);
-  return (i < len && *(a + i) > *(b + i));
-}
 
-bool IdSmaller(const uint64_t* a, const uint64_t* b, int32_t len) {
-  int32_t i = 0; for (; i < len && *(a + i) == *(b + i); ++i);
-  return (i < len && *(a + i) < *(b + i));
-}
-}  // namespace
+// The orders of the rows of the input, by their weights, their node ids or
+// the src and dst ids of their edges
+template <bool kAsc>
+struct WeightOrder {
+  const float* weights;
 
-class MinHeapIdComparison {
- public:
-  bool operator()(const std::pair<std::vector<uint64_t>, int32_t>& a,
-                  const std::pair<std::vector<uint64_t>, int32_t>& b) {
-    return IdBigger(a.first.data(), b.first.data(),
-                    static_cast<int32_t>(a.first.size()));
+  bool operator()(int32_t a, int32_t b) const {
+    return kAsc ? weights[a] < weights[b] : weights[b] < weights[a];
   }
 };
 
-class MinHeapWeightComparison {
- public:
-  bool operator()(const std::pair<float, int32_t>& a,
-                  const std::pair<float, int32_t>& b) {
-    return a.first > b.first;
+template <bool kAsc>
+struct NodeIdOrder {
+  const uint64_t* ids;
+
+  bool operator()(int32_t a, int32_t b) const {
+    return kAsc ? ids[a] < ids[b] : ids[b] < ids[a];
   }
 };
 
-class MaxHeapIdComparison {
- public:
-  bool operator()(const std::pair<std::vector<uint64_t>, int32_t>& a,
-                  const std::pair<std::vector<uint64_t>, int32_t>& b) {
-    return IdSmaller(a.first.data(), b.first.data(),
-                     static_cast<int32_t>(a.first.size()));
+template <bool kAsc>
+struct EdgeIdOrder {
+  const uint64_t* ids;  // src, dst, type of each row
+
+  bool operator()(int32_t a, int32_t b) const {
+    if (!kAsc) {
+      std::swap(a, b);
+    }
+    const uint64_t* x = ids + a * 3;
+    const uint64_t* y = ids + b * 3;
+    return x[0] < y[0] || (x[0] == y[0] && x[1] < y[1]);
   }
 };
 
-class MaxHeapWeightComparison {
+// A tournament tree over sorted runs of rows which keeps the loser of each
+// match in the inner nodes and the winner, the least head of the runs, at
+// the top. Pop advances the run of the winner and replays only the matches
+// on its path, so a row costs log(k) comparisons and no allocation. Ties
+// are won by the former run, which keeps the merge stable.
+template <typename Less>
+class LoserTree {
  public:
-  bool operator()(const std::pair<float, int32_t>& a,
-                  const std::pair<float, int32_t>& b) {
-    return a.first < b.first;
+  LoserTree(std::vector<int32_t> heads, std::vector<int32_t> ends, Less less)
+      : heads_(std::move(heads)), ends_(std::move(ends)), less_(less),
+        tree_(heads_.size()) {
+    int32_t k = static_cast<int32_t>(heads_.size());
+    std::vector<int32_t> winners(2 * k);
+    for (int32_t i = 0; i < k; ++i) {
+      winners[k + i] = i;
+    }
+    for (int32_t n = k - 1; n > 0; --n) {
+      int32_t a = winners[2 * n];
+      int32_t b = winners[2 * n + 1];
+      if (Beats(a, b)) {
+        winners[n] = a;
+        tree_[n] = b;
+      } else {
+        winners[n] = b;
+        tree_[n] = a;
+      }
+    }
+    tree_[0] = k > 1 ? winners[1] : 0;
+  }
+
+  bool Empty() const { return heads_[tree_[0]] == ends_[tree_[0]]; }
+
+  // The row at the head of the winner
+  int32_t Top() const { return heads_[tree_[0]]; }
+
+  void Pop() {
+    int32_t winner = tree_[0];
+    ++heads_[winner];
+    int32_t k = static_cast<int32_t>(heads_.size());
+    for (int32_t n = (winner + k) / 2; n > 0; n /= 2) {
+      if (Beats(tree_[n], winner)) {
+        std::swap(tree_[n], winner);
+      }
+    }
+    tree_[0] = winner;
   }
+
+ private:
+  // An exhausted run loses to all the others
+  bool Beats(int32_t a, int32_t b) const {
+    if (heads_[a] == ends_[a]) {
+      return false;
+    }
+    if (heads_[b] == ends_[b]) {
+      return true;
+    }
+    if (less_(heads_[a], heads_[b])) {
+      return true;
+    }
+    return !less_(heads_[b], heads_[a]) && a < b;
+  }
+
+  std::vector<int32_t> heads_;
+  std::vector<int32_t> ends_;
+  Less less_;
+  std::vector<int32_t> tree_;  // tree_[0] is the winner
 };
 
+// Split the rows into the runs already in order and merge the first
+// output_num rows of them, the rest of the runs is never visited
+template <typename Less>
+void MergeRuns(Less less, int32_t num, int32_t offset,
+               const uint64_t* ids, const float* weights,
+               int32_t output_num, uint64_t* output_ids,
+               float* output_weights) {
+  std::vector<int32_t> heads = {0};
+  std::vector<int32_t> ends;
+  for (int32_t i = 0; i + 1 < num; ++i) {
+    if (less(i + 1, i)) {
+      ends.push_back(i + 1);
+      heads.push_back(i + 1);
+    }
+  }
+  ends.push_back(num);
+
+  LoserTree<Less> tree(std::move(heads), std::move(ends), less);
+  for (int32_t o = 0; o < output_num && !tree.Empty(); ++o) {
+    int32_t i = tree.Top();
+    std::copy(ids + i * offset, ids + (i + 1) * offset,
+              output_ids + o * offset);
+    if (output_weights != nullptr) {
+      output_weights[o] = weights[i];
+    }
+    tree.Pop();
+  }
+}
+
+}  // namespace
+
 class PostProcess: public OpKernel {
  public:
   explicit PostProcess(const std::string& name) : OpKernel(name) {}
@@ -83,157 +172,43 @@ class PostProcess: public OpKernel {
                  Tensor* output_ids, Tensor* output_weights);
 };
 
-#define INIT_WEIGHT_HEAP(HEAP) {                                     \
-  for (int32_t seg_id = 0; seg_id <                                  \
-       static_cast<int32_t>(ptr_list.size()); ++seg_id) {            \
-    int32_t ptr = ptr_list[seg_id];                                  \
-    std::pair<float, int32_t> p(weights->Raw<float>()[ptr], seg_id); \
-    HEAP.push(p);                                                    \
-  }                                                                  \
-}
-
-#define UPDATE_WEIGHT_HEAP(HEAP) {                                   \
-  if (ptr_list[seg_id] < ends_pos[seg_id]) {                         \
-    int32_t ptr = ptr_list[seg_id];                                  \
-    std::pair<float, int32_t> p(weights->Raw<float>()[ptr], seg_id); \
-    HEAP.push(p);                                                    \
-  }                                                                  \
-}
-
-#define INIT_ID_HEAP(HEAP) {                                   \
-  for (int32_t seg_id = 0; seg_id <                            \
-       static_cast<int32_t>(ptr_list.size()); ++seg_id) {      \
-    int32_t ptr = ptr_list[seg_id];                            \
-    std::vector<uint64_t> id(offset == 3 ? 2 : 1);             \
-    std::copy(ids->Raw<uint64_t>() + ptr * offset,             \
-              ids->Raw<uint64_t>() + ptr * offset + id.size(), \
-              id.begin());                                     \
-    std::pair<std::vector<uint64_t>, int32_t> p(id, seg_id);   \
-    HEAP.push(p);                                              \
-  }                                                            \
-}
-
-#define UPDATE_ID_HEAP(HEAP) {                                 \
-  if (ptr_list[seg_id] < ends_pos[seg_id]) {                   \
-    int32_t ptr = ptr_list[seg_id];                            \
-    std::vector<uint64_t> id(offset == 3 ? 2 : 1);             \
-    std::copy(ids->Raw<uint64_t>() + ptr * offset,             \
-              ids->Raw<uint64_t>() + ptr * offset + id.size(), \
-              id.begin());                                     \
-    std::pair<std::vector<uint64_t>, int32_t> p(id, seg_id);   \
-    HEAP.push(p);                                              \
-  }                                                            \
-}
-
-#define OUTPUT(HEAP, PAIR) {                          \
-  seg_id = PAIR.second;                               \
-  int32_t ptr = ptr_list[seg_id]++;                   \
-  for (int32_t i = 0; i < offset; ++i) {              \
-    output_ids->Raw<uint64_t>()[o_idx * offset + i] = \
-        ids->Raw<uint64_t>()[ptr * offset + i];       \
-  }                                                   \
-  if (output_weights != nullptr) {                    \
-    output_weights->Raw<float>()[o_idx] =             \
-        weights->Raw<float>()[ptr];                   \
-  }                                                   \
-  ++o_idx;                                            \
-}
-
 void PostProcess::MergeSort(Tensor* ids, int32_t offset, Tensor* weights,
                             bool order_with_weight, bool asc,
                             Tensor* output_ids, Tensor* output_weights) {
-  std::vector<int32_t> ptr_list;
-  std::vector<int32_t> ends_pos;
-  ptr_list.push_back(0);
+  int32_t num = ids->NumElements() / offset;
+  int32_t output_num = output_ids->NumElements() / offset;
+  const uint64_t* id_data = ids->Raw<uint64_t>();
+  const float* weight_data =
+      weights != nullptr ? weights->Raw<float>() : nullptr;
+  uint64_t* output_id_data = output_ids->Raw<uint64_t>();
+  float* output_weight_data =
+      output_weights != nullptr ? output_weights->Raw<float>() : nullptr;
+
+#define MERGE_RUNS(ORDER, DATA)                                  \
+  MergeRuns(ORDER{DATA}, num, offset, id_data, weight_data,     \
+            output_num, output_id_data, output_weight_data)
+
   if (order_with_weight) {
     if (asc) {
-      std::priority_queue<std::pair<float, int32_t>,
-          std::vector<std::pair<float, int32_t>>,
-          MinHeapWeightComparison> min_heap;
-      for (int32_t i = 0; i < weights->NumElements() - 1; ++i) {
-        if (weights->Raw<float>()[i] > weights->Raw<float>()[i + 1]) {
-          ends_pos.push_back(i + 1);
-          ptr_list.push_back(i + 1);
-        }
-      }
-      ends_pos.push_back(weights->NumElements());
-      INIT_WEIGHT_HEAP(min_heap);
-      int32_t o_idx = 0;
-      while (!min_heap.empty() && o_idx < output_ids->NumElements() / offset) {
-        std::pair<float, int32_t> p = min_heap.top();
-        min_heap.pop();
-        int32_t seg_id = 0;
-        OUTPUT(min_heap, p);
-        UPDATE_WEIGHT_HEAP(min_heap);
-      }
+      MERGE_RUNS(WeightOrder<true>, weight_data);
     } else {
-      std::priority_queue<std::pair<float, int32_t>,
-          std::vector<std::pair<float, int32_t>>,
-          MaxHeapWeightComparison> max_heap;
-      for (int32_t i = 0; i < weights->NumElements() - 1; ++i) {
-        if (weights->Raw<float>()[i] < weights->Raw<float>()[i + 1]) {
-          ends_pos.push_back(i + 1);
-          ptr_list.push_back(i + 1);
-        }
-      }
-      ends_pos.push_back(weights->NumElements());
-      INIT_WEIGHT_HEAP(max_heap);
-      int32_t o_idx = 0;
-      while (!max_heap.empty() && o_idx < output_ids->NumElements() / offset) {
-        std::pair<float, int32_t> p = max_heap.top();
-        max_heap.pop();
-        int32_t seg_id = 0;
-        OUTPUT(max_heap, p);
-        UPDATE_WEIGHT_HEAP(max_heap);
-      }
+      MERGE_RUNS(WeightOrder<false>, weight_data);
+    }
+  } else if (offset == 1) {
+    if (asc) {
+      MERGE_RUNS(NodeIdOrder<true>, id_data);
+    } else {
+      MERGE_RUNS(NodeIdOrder<false>, id_data);
     }
   } else {
     if (asc) {
-      std::priority_queue<std::pair<std::vector<uint64_t>, int32_t>,
-          std::vector<std::pair<std::vector<uint64_t>, int32_t>>,
-          MinHeapIdComparison> min_heap;
-      for (int32_t i = 0; i < ids->NumElements() - offset; i += offset) {
-        if (IdBigger(ids->Raw<uint64_t>() + i * offset,
-                     ids->Raw<uint64_t>() + (i + 1) * offset,
-                     offset == 3 ? 2 : 1)) {
-          ends_pos.push_back(i + 1);
-          ptr_list.push_back(i + 1);
-        }
-      }
-      ends_pos.push_back(weights->NumElements());
-      INIT_ID_HEAP(min_heap);
-      int32_t o_idx = 0;
-      while (!min_heap.empty() && o_idx < output_ids->NumElements() / offset) {
-        std::pair<std::vector<uint64_t>, int32_t> p = min_heap.top();
-        min_heap.pop();
-        int32_t seg_id = 0;
-        OUTPUT(min_heap, p);
-        UPDATE_ID_HEAP(min_heap);
-      }
+      MERGE_RUNS(EdgeIdOrder<true>, id_data);
     } else {
-      std::priority_queue<std::pair<std::vector<uint64_t>, int32_t>,
-          std::vector<std::pair<std::vector<uint64_t>, int32_t>>,
-          MaxHeapIdComparison> max_heap;
-      for (int32_t i = 0; i < ids->NumElements() - offset; i += offset) {
-        if (IdSmaller(ids->Raw<uint64_t>() + i * offset,
-                      ids->Raw<uint64_t>() + (i + 1) * offset,
-                      offset == 3 ? 2 : 1)) {
-          ends_pos.push_back(i + 1);
-          ptr_list.push_back(i + 1);
-        }
-      }
-      ends_pos.push_back(weights->NumElements());
-      INIT_ID_HEAP(max_heap);
-      int32_t o_idx = 0;
-      while (!max_heap.empty() && o_idx < output_ids->NumElements() / offset) {
-        std::pair<std::vector<uint64_t>, int32_t> p = max_heap.top();
-        max_heap.pop();
-        int32_t seg_id = 0;
-        OUTPUT(max_heap, p);
-        UPDATE_ID_HEAP(max_heap);
-      }
+      MERGE_RUNS(EdgeIdOrder<false>, id_data);
     }
   }
+
+#undef MERGE_RUNS
 }
 
 #define ALLOCATE_OUTPUT(ARG) {                                 \
@@ -295,11 +270,13 @@ void PostProcess::Compute(const DAGNodeProto& node_def,
     pp_cmds.push_back(Split(pp, " "));
   }
 
+  // The limit fuses with the merge of order_by, which stops after it
+  int32_t num = static_cast<int32_t>(input_ids_t->Shape().Dims()[0]);
   Tensor* output_ids_t = nullptr;
   Tensor* output_weights_t = nullptr;
   if (pp_cmds.size() == 1) {
     if (pp_cmds[0][0] == "limit") {  // limit
-      int32_t arg = atoi(pp_cmds[0][1].c_str());
+      int32_t arg = std::min(atoi(pp_cmds[0][1].c_str()), num);
       ALLOCATE_OUTPUT(arg);
       std::copy(input_ids_t->Raw<uint64_t>(),
                 input_ids_t->Raw<uint64_t>() +
@@ -312,11 +289,11 @@ void PostProcess::Compute(const DAGNodeProto& node_def,
                   output_weights_t->Raw<float>());
       }
     } else {  // order_by
-      ALLOCATE_OUTPUT(input_ids_t->Shape().Dims()[0]);
+      ALLOCATE_OUTPUT(num);
       PROSESS_ORDER_BY();
     }
   } else {  // order_by, limit
-    int32_t arg = atoi(pp_cmds[1][1].c_str());
+    int32_t arg = std::min(atoi(pp_cmds[1][1].c_str()), num);
     ALLOCATE_OUTPUT(arg);
     PROSESS_ORDER_BY();
   }
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -238,4 +239,79 @@ TEST(PostProcessOpTest, OrderByWeight_edgeId_desc) {
   }
 }
 
+TEST(PostProcessOpTest, OrderByEdgeId_asc) {
+  OpKernelContext ctx;
+  DAGNodeProto node_proto;
+  node_proto.set_name("POST_PROCESS,0");
+  node_proto.set_op("POST_PROCESS");
+  node_proto.add_inputs("ids");
+  node_proto.add_post_process("order_by id asc");
+  node_proto.add_post_process("limit 10");
+
+  // Runs of edges sorted by src and dst, the types are not ordered
+  Tensor* edge_ids_t = nullptr;
+  ctx.Allocate("ids", TensorShape({6, 3}), kUInt64, &edge_ids_t);
+  std::vector<uint64_t> ids = {2, 1, 0, 2, 3, 0, 1, 5, 1,
+                               2, 1, 1, 3, 0, 0, 1, 5, 0};
+  std::copy(ids.begin(), ids.end(), edge_ids_t->Raw<uint64_t>());
+
+  OpKernel* pp_op;
+  CreateOpKernel("POST_PROCESS", &pp_op);
+  pp_op->Compute(node_proto, &ctx);
+
+  Tensor* output_ids_t = nullptr;
+  ctx.tensor("POST_PROCESS,0:0", &output_ids_t);
+  std::vector<uint64_t> o_ids = {1, 5, 1, 1, 5, 0, 2, 1, 0,
+                                 2, 1, 1, 2, 3, 0, 3, 0, 0};
+  ASSERT_EQ(o_ids.size(), output_ids_t->NumElements());
+  for (size_t i = 0; i < o_ids.size(); ++i) {
+    ASSERT_EQ(o_ids[i], output_ids_t->Raw<uint64_t>()[i]);
+  }
+}
+
+TEST(PostProcessOpTest, OrderById_manyRuns_desc) {
+  OpKernelContext ctx;
+  DAGNodeProto node_proto;
+  node_proto.set_name("POST_PROCESS,0");
+  node_proto.set_op("POST_PROCESS");
+  node_proto.add_inputs("ids");
+  node_proto.add_inputs("weights");
+  node_proto.add_post_process("order_by id desc");
+  node_proto.add_post_process("limit 100");
+
+  const int32_t num = 1000;
+  Tensor* node_ids_t = nullptr;
+  Tensor* weights_t = nullptr;
+  ctx.Allocate("ids", TensorShape({num}), kUInt64, &node_ids_t);
+  ctx.Allocate("weights", TensorShape({num}), kFloat, &weights_t);
+  std::vector<std::pair<uint64_t, float>> rows;
+  for (int32_t i = 0; i < num; ++i) {
+    rows.emplace_back((i * 7919) % 313, i);
+  }
+  for (int32_t i = 0; i < num; ++i) {
+    node_ids_t->Raw<uint64_t>()[i] = rows[i].first;
+    weights_t->Raw<float>()[i] = rows[i].second;
+  }
+
+  OpKernel* pp_op;
+  CreateOpKernel("POST_PROCESS", &pp_op);
+  pp_op->Compute(node_proto, &ctx);
+
+  std::stable_sort(rows.begin(), rows.end(),
+                   [](const std::pair<uint64_t, float>& a,
+                      const std::pair<uint64_t, float>& b) {
+                     return a.first > b.first;
+                   });
+  Tensor* output_ids_t = nullptr;
+  Tensor* output_weights_t = nullptr;
+  ctx.tensor("POST_PROCESS,0:0", &output_ids_t);
+  ctx.tensor("POST_PROCESS,0:1", &output_weights_t);
+  ASSERT_EQ(100, output_ids_t->NumElements());
+  ASSERT_EQ(100, output_weights_t->NumElements());
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(rows[i].first, output_ids_t->Raw<uint64_t>()[i]);
+    ASSERT_EQ(rows[i].second, output_weights_t->Raw<float>()[i]);
+  }
+}
+
 }  // namespace euler
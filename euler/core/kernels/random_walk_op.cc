@@ -0,0 +1,124 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "euler/core/kernels/common.h"
+#include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/dag_node.pb.h"
+#include "euler/common/logging.h"
+#include "euler/core/api/api.h"
+
+namespace euler {
+
+// Walk node2vec random walks on the local graph, see RandomWalk in api.h.
+//
+// Inputs:
+//   0: walks, [n, 3] uint64, (node, parent, start step) of each walk, the
+//      walks are split by their current nodes
+//   1: edge_types, int32, the edge types of all the steps concatenated
+//   2: edge_type_nums, [walk_len] int32, the number of edge types of each
+//      step, different types make a metapath
+//   3: p and q, [2] float
+// Outputs:
+//   0: [n, walk_len + 1] uint64, the node and the nodes visited
+//   1: [n] int32, the number of the nodes visited
+class RandomWalkOp: public OpKernel {
+ public:
+  explicit RandomWalkOp(const std::string& name): OpKernel(name) { }
+
+  void Compute(const DAGNodeProto& node_def, OpKernelContext* ctx);
+};
+
+void RandomWalkOp::Compute(const DAGNodeProto& node_def,
+                           OpKernelContext* ctx) {
+  if (node_def.inputs_size() < 4) {
+    EULER_LOG(ERROR) << "Argment 'walks', 'edge_types', 'edge_type_nums', "
+                     << "'pq' must be specified!";
+    return;
+  }
+
+  Tensor* walks_t = nullptr;
+  auto s = ctx->tensor(node_def.inputs(0), &walks_t);
+  if (!s.ok() || (walks_t->NumElements() > 0 &&
+                  (walks_t->Shape().Dims().size() != 2 ||
+                   walks_t->Shape().Dims()[1] != 3))) {
+    EULER_LOG(ERROR) << "Invalid argment 'walks'";
+    return;
+  }
+
+  std::vector<int> edge_types;
+  std::vector<int> edge_type_nums;
+  s = GetArg(node_def, 1, ctx, &edge_types);
+  if (s.ok()) {
+    s = GetArg(node_def, 2, ctx, &edge_type_nums);
+  }
+  std::vector<std::vector<int>> schedule(edge_type_nums.size());
+  size_t offset = 0;
+  for (size_t i = 0; s.ok() && i < edge_type_nums.size(); ++i) {
+    if (edge_type_nums[i] < 0 ||
+        offset + edge_type_nums[i] > edge_types.size()) {
+      s = Status::InvalidArgument("Edge type nums exceed the edge types");
+      break;
+    }
+    schedule[i].assign(edge_types.begin() + offset,
+                       edge_types.begin() + offset + edge_type_nums[i]);
+    offset += edge_type_nums[i];
+  }
+  if (!s.ok()) {
+    EULER_LOG(ERROR) << "Invalid argment 'edge_types', 'edge_type_nums'";
+    return;
+  }
+
+  std::vector<float> pq;
+  s = GetArg(node_def, 3, ctx, &pq);
+  if (!s.ok() || pq.size() != 2 || !(pq[0] > 0) || !(pq[1] > 0)) {
+    EULER_LOG(ERROR) << "Invalid argment 'pq'";
+    return;
+  }
+
+  size_t num = walks_t->NumElements() / 3;
+  std::vector<NodeId> nodes(num);
+  std::vector<NodeId> parents(num);
+  std::vector<int32_t> starts(num);
+  auto walks = walks_t->Raw<uint64_t>();
+  for (size_t i = 0; i < num; ++i) {
+    nodes[i] = walks[i * 3];
+    parents[i] = walks[i * 3 + 1];
+    starts[i] = walks[i * 3 + 2];
+  }
+
+  Tensor* ids_t = nullptr;
+  Tensor* steps_t = nullptr;
+  auto ids_name = OutputName(node_def, 0);
+  auto steps_name = OutputName(node_def, 1);
+  if (!ctx->Allocate(ids_name, TensorShape({num, schedule.size() + 1}),
+                     DataType::kUInt64, &ids_t).ok() ||
+      !ctx->Allocate(steps_name, TensorShape({num}),
+                     DataType::kInt32, &steps_t).ok()) {
+    EULER_LOG(ERROR) << "Allocate output tensor " << ids_name << " or "
+                     << steps_name << " failed!";
+    return;
+  }
+
+  RandomWalk(nodes.data(), parents.data(), starts.data(), num, schedule,
+             pq[0], pq[1], ids_t->Raw<uint64_t>(), steps_t->Raw<int32_t>(),
+             ParallelSample(num * schedule.size()));
+}
+
+REGISTER_OP_KERNEL("API_RANDOM_WALK", RandomWalkOp);
+
+}  // namespace euler
@@ -0,0 +1,44 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/kernels/registered_plans.h"
+
+namespace euler {
+
+RegisteredPlans& RegisteredPlans::Instance() {
+  static RegisteredPlans plans;
+  return plans;
+}
+
+bool RegisteredPlans::Contains(int32_t shard_id, uint64_t plan_id) {
+  MutexLock l(&mu_);
+  auto shard = shards_.find(shard_id);
+  if (shard == shards_.end()) {
+    return false;
+  }
+  auto it = shard->second.plans.find(plan_id);
+  return it != shard->second.plans.end() &&
+      it->second.size() == shard->second.replicas.size();
+}
+
+void RegisteredPlans::Add(int32_t shard_id, const std::string& replica,
+                          uint64_t plan_id) {
+  MutexLock l(&mu_);
+  Shard& shard = shards_[shard_id];
+  shard.replicas.insert(replica);
+  shard.plans[plan_id].insert(replica);
+}
+
+}  // namespace euler
@@ -0,0 +1,55 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_KERNELS_REGISTERED_PLANS_H_
+#define EULER_CORE_KERNELS_REGISTERED_PLANS_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "euler/common/mutex.h"
+
+namespace euler {
+
+// The plans cached by the servers, the inner dag of a remote node is sent
+// once and then referred by its plan id. Each replica of a shard has its
+// own plan cache, so the dag is omitted only if every replica which has
+// replied a plan so far registered it. A replica not seen yet misses the
+// plan once, it replies plan_not_found and is sent the dag again.
+class RegisteredPlans {
+ public:
+  static RegisteredPlans& Instance();
+
+  bool Contains(int32_t shard_id, uint64_t plan_id);
+
+  // Called after the replica replies the plan successfully
+  void Add(int32_t shard_id, const std::string& replica, uint64_t plan_id);
+
+ private:
+  struct Shard {
+    std::unordered_set<std::string> replicas;
+    std::unordered_map<uint64_t, std::unordered_set<std::string>> plans;
+  };
+
+  Mutex mu_;
+  std::unordered_map<int32_t, Shard> shards_;  // Guard by mu_
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_KERNELS_REGISTERED_PLANS_H_
@@ -0,0 +1,43 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/kernels/registered_plans.h"
+
+#include "gtest/gtest.h"
+
+namespace euler {
+
+TEST(RegisteredPlansTest, TwoReplicas) {
+  RegisteredPlans plans;
+  ASSERT_FALSE(plans.Contains(0, 7));
+
+  // Only one replica of shard 0 is seen
+  plans.Add(0, "host0:1", 7);
+  ASSERT_TRUE(plans.Contains(0, 7));
+  ASSERT_FALSE(plans.Contains(1, 7));
+
+  // The other one has its own plan cache
+  plans.Add(0, "host1:1", 8);
+  ASSERT_FALSE(plans.Contains(0, 7));
+  ASSERT_FALSE(plans.Contains(0, 8));
+
+  plans.Add(0, "host1:1", 7);
+  ASSERT_TRUE(plans.Contains(0, 7));
+  ASSERT_FALSE(plans.Contains(0, 8));
+  plans.Add(0, "host0:1", 8);
+  ASSERT_TRUE(plans.Contains(0, 8));
+}
+
+}  // namespace euler
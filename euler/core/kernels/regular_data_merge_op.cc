@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -31,12 +32,12 @@ class RegularDataMerge: public OpKernel {
 };
 
 #define REGULE_MERGE_RESULT(DATA_TYPE, DEFAULT_VALUE) {               \
-  std::string output_name = OutputName(node_def, 0);                  \
   Tensor* data_result = nullptr;                                      \
   std::vector<size_t> idx_shape_v = datas[0]->Shape().Dims();         \
   idx_shape_v[0] = ids_num;                                           \
   TensorShape idx_shape(idx_shape_v);                                 \
-  ctx->Allocate(output_name, idx_shape, data_type, &data_result);     \
+  ctx->AllocateOutput(node_def, 0, idx_shape, data_type,              \
+                      &data_result);                                  \
   for (int32_t i = 0; i < data_result->NumElements(); ++i) {          \
     data_result->Raw<DATA_TYPE>()[i] = DEFAULT_VALUE;                 \
   }                                                                   \
@@ -62,12 +63,16 @@ void RegularDataMerge::Compute(const DAGNodeProto& node_def,
   int32_t offset = 1;
   for (int32_t i = 0; i < node_def.inputs_size(); ++i) {
     Tensor* t = nullptr;
-    ctx->tensor(node_def.inputs(i), &t);
+    ctx->input(node_def, i, &t);
     if (i % 2 == 0) {  // id
       datas.push_back(t);
-      ids_num += t->Shape().Dims()[0];
     } else {  // merge_idx
       merge_idxs.push_back(t);
+      // An id may be sent to more than one shard
+      for (int32_t j = 0; j < t->NumElements(); ++j) {
+        ids_num = std::max(ids_num,
+                           static_cast<size_t>(t->Raw<int32_t>()[j]) + 1);
+      }
     }
   }
   for (size_t i = 1; i < datas[0]->Shape().Dims().size(); ++i) {
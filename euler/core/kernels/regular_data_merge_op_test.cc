@@ -69,4 +69,48 @@ TEST(GPRegularDataMergeOpTest, Execute) {
   }
 }
 
+// The merge indexes of an id sent to both shards are duplicated, the value
+// found wins over the default one. Index 1 and 3 are sent nowhere, and the
+// output still has max merge index + 1 rows.
+TEST(GPRegularDataMergeOpTest, DuplicatedAndGappedIdx) {
+  OpKernelContext ctx;
+
+  DAGNodeProto node_proto;
+  node_proto.set_name("GP_REGULAR_DATA_MERGE,0");
+  node_proto.set_op("GP_REGULAR_DATA_MERGE");
+  node_proto.add_inputs("data,0:0");
+  node_proto.add_inputs("idx,1:0");
+  node_proto.add_inputs("data,2:0");
+  node_proto.add_inputs("idx,3:0");
+
+  const float kDefault = euler::common::DEFAULT_FLOAT;
+  std::vector<float> v0 = {1, 1, 3, 3};
+  std::vector<int32_t> idx0 = {0, 2};
+  std::vector<float> v1 = {kDefault, kDefault, 5, 5};
+  std::vector<int32_t> idx1 = {2, 4};
+  Tensor* data0 = nullptr, *idx0_t = nullptr;
+  Tensor* data1 = nullptr, *idx1_t = nullptr;
+  ctx.Allocate("data,0:0", TensorShape({2, 2}), DataType::kFloat, &data0);
+  ctx.Allocate("idx,1:0", TensorShape({2}), DataType::kInt32, &idx0_t);
+  ctx.Allocate("data,2:0", TensorShape({2, 2}), DataType::kFloat, &data1);
+  ctx.Allocate("idx,3:0", TensorShape({2}), DataType::kInt32, &idx1_t);
+  std::copy(v0.begin(), v0.end(), data0->Raw<float>());
+  std::copy(idx0.begin(), idx0.end(), idx0_t->Raw<int32_t>());
+  std::copy(v1.begin(), v1.end(), data1->Raw<float>());
+  std::copy(idx1.begin(), idx1.end(), idx1_t->Raw<int32_t>());
+
+  OpKernel* gp_regular_data_merge;
+  CreateOpKernel("GP_REGULAR_DATA_MERGE", &gp_regular_data_merge);
+  gp_regular_data_merge->Compute(node_proto, &ctx);
+
+  Tensor* output = nullptr;
+  ASSERT_TRUE(ctx.tensor("GP_REGULAR_DATA_MERGE,0:0", &output).ok());
+  ASSERT_EQ(std::vector<size_t>({5, 2}), output->Shape().Dims());
+  std::vector<float> result = {1, 1, kDefault, kDefault, 3, 3,
+                               kDefault, kDefault, 5, 5};
+  for (size_t i = 0; i < result.size(); ++i) {
+    ASSERT_EQ(result[i], output->Raw<float>()[i]);
+  }
+}
+
 }  // namespace euler
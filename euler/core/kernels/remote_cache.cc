@@ -0,0 +1,290 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/kernels/remote_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <unordered_map>
+
+#include "euler/common/hash.h"
+#include "euler/common/str_util.h"
+
+namespace euler {
+
+int32_t MapToRemoteInputIdx(std::string inner_input_name) {
+  std::vector<std::string> inner_input_info = Split(inner_input_name, ":");
+  if (inner_input_info.size() == 2) {
+    std::vector<std::string> src_name_id = Split(inner_input_info[0], ",");
+    if (src_name_id.size() == 2 && src_name_id[0] == "REMOTE") {
+      return atoi(inner_input_info[1].c_str());
+    }
+    return -1;
+  } else {
+    return -1;
+  }
+}
+
+std::unique_ptr<RemoteCache> RemoteCache::Lookup(
+    const DAGNodeProto& node_def, OpKernelContext* ctx,
+    HotVertexCache* cache) {
+  std::unique_ptr<RemoteCache> result;
+  if (cache == nullptr || node_def.inner_nodes_size() != 1) {
+    return result;
+  }
+  const DAGNodeProto& inner = node_def.inner_nodes(0);
+  const std::string& op = inner.op();
+  if ((op != "API_GET_NB_NODE" && op != "API_GET_P" &&
+       op != "API_GET_NODE_T") ||
+      inner.dnf_size() > 0 || !inner.udf_name().empty() ||
+      inner.inputs_size() == 0) {
+    return result;
+  }
+
+  // Node ids from the outside
+  int32_t ids_idx = MapToRemoteInputIdx(inner.inputs(0));
+  Tensor* ids_t = nullptr;
+  if (ids_idx < 0 || ids_idx >= node_def.inputs_size() ||
+      !ctx->tensor(node_def.inputs(ids_idx), &ids_t).ok() ||
+      ids_t->Shape().Size() != 1 || ids_t->Type() != kUInt64 ||
+      ids_t->NumElements() == 0) {
+    return result;
+  }
+
+  // The other inputs are the arguments of the query, e.g. the feature names
+  std::string signature = ToString(node_def.shard_idx(), ":",
+                                   node_def.plan_id());
+  for (int32_t i = 1; i < inner.inputs_size(); ++i) {
+    Tensor* arg_t = nullptr;
+    if (MapToRemoteInputIdx(inner.inputs(i)) != -1 ||
+        !ctx->tensor(inner.inputs(i), &arg_t).ok()) {
+      return result;
+    }
+    signature += ";";
+    if (arg_t->Type() == kString) {
+      for (int32_t j = 0; j < arg_t->NumElements(); ++j) {
+        signature += *arg_t->Raw<std::string*>()[j] + ",";
+      }
+    } else {
+      signature.append(arg_t->Raw<char>(), arg_t->TotalBytes());
+    }
+  }
+
+  std::unordered_map<int32_t, int32_t> inner_to_output;
+  std::vector<int32_t> inner_idx(node_def.output_list_size());
+  for (int32_t i = 0; i < node_def.output_list_size(); ++i) {
+    std::vector<std::string> name_idx = Split(node_def.output_list(i), ":");
+    if (name_idx.size() != 2) {
+      return result;
+    }
+    inner_idx[i] = atoi(name_idx[1].c_str());
+    inner_to_output[inner_idx[i]] = i;
+  }
+
+  result.reset(new RemoteCache(node_def, cache));
+  for (int32_t idx : inner_idx) {
+    OutputLayout layout = {kFixedRows, -1};
+    int32_t index = -1;
+    if (op == "API_GET_NB_NODE") {
+      index = idx == 0 ? -1 : 0;
+      layout.kind = idx == 0 ? kIndexRows : kDataRows;
+    } else if (op == "API_GET_P") {
+      index = idx % 2 == 0 ? -1 : idx - 1;
+      layout.kind = idx % 2 == 0 ? kIndexRows : kDataRows;
+    }
+    if (layout.kind == kDataRows) {
+      auto it = inner_to_output.find(index);
+      if (it == inner_to_output.end()) {
+        return std::unique_ptr<RemoteCache>();
+      }
+      layout.index = it->second;
+    }
+    result->layouts_.push_back(layout);
+  }
+
+  result->signature_ = hash64(signature.data(), signature.size());
+  result->ids_name_ = inner.inputs(0);
+  auto ids = ids_t->Raw<uint64_t>();
+  result->ids_.assign(ids, ids + ids_t->NumElements());
+  std::vector<uint64_t> missed_ids;
+  for (uint64_t id : result->ids_) {
+    HotVertexCache::Value value;
+    if (!cache->Lookup(result->signature_, id, &value)) {
+      missed_ids.push_back(id);
+    }
+    result->cached_.push_back(std::move(value));
+  }
+
+  TensorShape shape({missed_ids.size()});
+  auto s = ctx->Allocate(ToString(node_def.name(), ":missed_ids"),
+                         shape, kUInt64, &result->missed_ids_);
+  if (!s.ok()) {
+    EULER_LOG(ERROR) << "Allocate missed ids failed: " << s;
+    return std::unique_ptr<RemoteCache>();
+  }
+  std::copy(missed_ids.begin(), missed_ids.end(),
+            result->missed_ids_->Raw<uint64_t>());
+  return result;
+}
+
+Status RemoteCache::DecodeCached(size_t pos,
+                                 std::vector<std::vector<Row>>* rows) {
+  const std::string& value = *cached_[pos];
+  size_t offset = 0;
+  for (size_t i = 0; i < layouts_.size(); ++i) {
+    Row& row = (*rows)[i][pos];
+    int32_t type = 0;
+    if (offset + sizeof(type) + sizeof(row.count) > value.size()) {
+      return Status::Internal("Corrupted cache entry of id ", ids_[pos]);
+    }
+    memcpy(&type, value.data() + offset, sizeof(type));
+    offset += sizeof(type);
+    memcpy(&row.count, value.data() + offset, sizeof(row.count));
+    offset += sizeof(row.count);
+    row.type = static_cast<DataType>(type);
+    row.data = value.data() + offset;
+    if (layouts_[i].kind != kIndexRows) {
+      offset += row.count * SizeOfType(row.type);
+    }
+    if (offset > value.size()) {
+      return Status::Internal("Corrupted cache entry of id ", ids_[pos]);
+    }
+  }
+  return Status::OK();
+}
+
+Status RemoteCache::DecodeFetched(const std::vector<Tensor*>& fetched,
+                                  size_t k, size_t pos,
+                                  std::vector<std::vector<Row>>* rows) {
+  size_t num_missed = missed_ids_->NumElements();
+  for (size_t i = 0; i < layouts_.size(); ++i) {
+    Row& row = (*rows)[i][pos];
+    Tensor* t = fetched[i];
+    row.type = t->Type();
+    if (layouts_[i].kind == kIndexRows) {
+      if (t->NumElements() != static_cast<int>(num_missed * 2)) {
+        return Status::Internal("Invalid index output ", i);
+      }
+      auto index = t->Raw<int32_t>();
+      row.count = index[k * 2 + 1] - index[k * 2];
+      row.data = nullptr;
+    } else if (layouts_[i].kind == kDataRows) {
+      auto index = fetched[layouts_[i].index]->Raw<int32_t>();
+      if (index[k * 2 + 1] > t->NumElements()) {
+        return Status::Internal("Invalid data output ", i);
+      }
+      row.count = index[k * 2 + 1] - index[k * 2];
+      row.data = t->Raw<char>() + index[k * 2] * SizeOfType(row.type);
+    } else {
+      if (t->NumElements() % num_missed != 0) {
+        return Status::Internal("Invalid output ", i);
+      }
+      row.count = t->NumElements() / num_missed;
+      row.data = t->Raw<char>() + k * row.count * SizeOfType(row.type);
+    }
+  }
+  return Status::OK();
+}
+
+Status RemoteCache::Merge(const std::vector<Tensor*>& fetched,
+                          OpKernelContext* ctx) {
+  size_t n = ids_.size();
+  size_t num_missed = missed_ids_->NumElements();
+  if (num_missed > 0 && fetched.size() != layouts_.size()) {
+    return Status::Internal("Expect ", layouts_.size(), " fetched outputs, ",
+                            "but get ", fetched.size());
+  }
+  for (size_t i = 0; num_missed > 0 && i < fetched.size(); ++i) {
+    if (fetched[i] == nullptr) {
+      return Status::Internal("Output ", node_def_.output_list(i),
+                              " is not fetched");
+    }
+  }
+
+  std::vector<std::vector<Row>> rows(layouts_.size(), std::vector<Row>(n));
+  for (size_t pos = 0, k = 0; pos < n; ++pos) {
+    if (cached_[pos]) {
+      RETURN_IF_ERROR(DecodeCached(pos, &rows));
+    } else {
+      RETURN_IF_ERROR(DecodeFetched(fetched, k++, pos, &rows));
+    }
+  }
+
+  for (size_t i = 0; i < layouts_.size(); ++i) {
+    const std::string& name = node_def_.remote_output_list(i);
+    const std::vector<Row>& output_rows = rows[i];
+    DataType type = output_rows[0].type;
+    for (const Row& row : output_rows) {
+      if (row.type != type) {
+        return Status::Internal("Data type mismatch of output ", name);
+      }
+    }
+    Tensor* t = nullptr;
+    if (layouts_[i].kind == kIndexRows) {
+      RETURN_IF_ERROR(ctx->Allocate(name, {n, 2}, kInt32, &t));
+      auto index = t->Raw<int32_t>();
+      int32_t offset = 0;
+      for (const Row& row : output_rows) {
+        *index++ = offset;
+        offset += row.count;
+        *index++ = offset;
+      }
+    } else {
+      size_t num = 0;
+      for (const Row& row : output_rows) {
+        if (layouts_[i].kind == kFixedRows &&
+            row.count != output_rows[0].count) {
+          return Status::Internal("Row width mismatch of output ", name);
+        }
+        num += row.count;
+      }
+      if (layouts_[i].kind == kFixedRows) {
+        RETURN_IF_ERROR(ctx->Allocate(
+            name, {n, static_cast<size_t>(output_rows[0].count)}, type, &t));
+      } else {
+        RETURN_IF_ERROR(ctx->Allocate(name, {num}, type, &t));
+      }
+      char* data = t->Raw<char>();
+      for (const Row& row : output_rows) {
+        size_t bytes = row.count * SizeOfType(type);
+        memcpy(data, row.data, bytes);
+        data += bytes;
+      }
+    }
+  }
+
+  // Admit the fetched results
+  for (size_t pos = 0; pos < n; ++pos) {
+    if (cached_[pos]) {
+      continue;
+    }
+    std::string* value = new std::string();
+    for (size_t i = 0; i < layouts_.size(); ++i) {
+      const Row& row = rows[i][pos];
+      int32_t type = row.type;
+      value->append(reinterpret_cast<const char*>(&type), sizeof(type));
+      value->append(reinterpret_cast<const char*>(&row.count),
+                    sizeof(row.count));
+      if (layouts_[i].kind != kIndexRows) {
+        value->append(row.data, row.count * SizeOfType(row.type));
+      }
+    }
+    cache_->Insert(signature_, ids_[pos], HotVertexCache::Value(value));
+  }
+  return Status::OK();
+}
+
+}  // namespace euler
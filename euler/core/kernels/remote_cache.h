@@ -0,0 +1,101 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_CORE_KERNELS_REMOTE_CACHE_H_
+#define EULER_CORE_KERNELS_REMOTE_CACHE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "euler/common/status.h"
+#include "euler/client/hot_vertex_cache.h"
+#include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/dag_node.pb.h"
+#include "euler/core/framework/tensor.h"
+
+namespace euler {
+
+// The input index of the remote node which an inner input refers to,
+// -1 if the inner input is not from the remote node
+int32_t MapToRemoteInputIdx(std::string inner_input_name);
+
+// Serve the ids of a remote node from the hot vertex cache. A remote node is
+// cacheable if it wraps one op whose result of a node depends only on the
+// node, i.e. API_GET_NB_NODE, API_GET_P and API_GET_NODE_T without
+// conditions or udf. The cached ids are stripped out of the request, and
+// merged back into the outputs together with the fetched ones, which are
+// then admitted into the cache.
+class RemoteCache {
+ public:
+  // Return nullptr if the remote node is not cacheable
+  static std::unique_ptr<RemoteCache> Lookup(const DAGNodeProto& node_def,
+                                             OpKernelContext* ctx,
+                                             HotVertexCache* cache);
+
+  // The inner input name of the ids
+  const std::string& ids_name() const { return ids_name_; }
+
+  // The ids to be fetched, they are sent in place of the input ids
+  Tensor* missed_ids() const { return missed_ids_; }
+
+  // Put the outputs of the remote node into ctx. The fetched outputs of the
+  // missed ids are ordered as the output list of the remote node, and empty
+  // if no id is missed
+  Status Merge(const std::vector<Tensor*>& fetched, OpKernelContext* ctx);
+
+ private:
+  enum RowKind {
+    kIndexRows,  // [n, 2] int32 offsets into the data rows
+    kDataRows,   // Ranges given by an index output
+    kFixedRows   // [n, width]
+  };
+
+  struct OutputLayout {
+    RowKind kind;
+    int32_t index;  // The index output of the data rows
+  };
+
+  // The result of an output for an id
+  struct Row {
+    DataType type;
+    uint32_t count;
+    const char* data;
+  };
+
+  RemoteCache(const DAGNodeProto& node_def, HotVertexCache* cache)
+      : node_def_(node_def), cache_(cache), signature_(0),
+        missed_ids_(nullptr) { }
+
+  Status DecodeCached(size_t pos, std::vector<std::vector<Row>>* rows);
+
+  Status DecodeFetched(const std::vector<Tensor*>& fetched, size_t k,
+                       size_t pos, std::vector<std::vector<Row>>* rows);
+
+  const DAGNodeProto& node_def_;
+  HotVertexCache* cache_;
+  uint64_t signature_;
+  std::string ids_name_;
+  std::vector<OutputLayout> layouts_;
+  std::vector<uint64_t> ids_;
+  std::vector<HotVertexCache::Value> cached_;  // nullptr if missed
+  Tensor* missed_ids_;  // Owned by the context
+};
+
+}  // namespace euler
+
+#endif  // EULER_CORE_KERNELS_REMOTE_CACHE_H_
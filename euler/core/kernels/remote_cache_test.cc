@@ -0,0 +1,186 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/core/kernels/remote_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "euler/common/str_util.h"
+
+namespace euler {
+
+namespace {
+
+// REMOTE,1 wraps API_GET_NB_NODE,2
+DAGNodeProto NeighborRemoteNode() {
+  DAGNodeProto node_def;
+  node_def.set_name("REMOTE,1");
+  node_def.set_op("REMOTE");
+  node_def.add_inputs("ids,0:0");
+  node_def.set_shard_idx(0);
+  node_def.set_plan_id(7);
+  DAGNodeProto* inner = node_def.add_inner_nodes();
+  inner->set_name("API_GET_NB_NODE,2");
+  inner->set_op("API_GET_NB_NODE");
+  inner->add_inputs("REMOTE,1:0");
+  inner->add_inputs("edge_types,3:0");
+  for (int i = 0; i < 4; ++i) {
+    node_def.add_output_list(ToString("API_GET_NB_NODE,2:", i));
+    node_def.add_remote_output_list(ToString("REMOTE,1:", i));
+  }
+  return node_def;
+}
+
+template <typename T>
+void Fill(OpKernelContext* ctx, const std::string& name,
+          const std::vector<size_t>& dims, DataType type,
+          const std::vector<T>& values) {
+  Tensor* t = nullptr;
+  ASSERT_TRUE(ctx->Allocate(name, TensorShape(dims), type, &t).ok());
+  std::copy(values.begin(), values.end(), t->Raw<T>());
+}
+
+template <typename T>
+std::vector<T> Values(OpKernelContext* ctx, const std::string& name) {
+  Tensor* t = nullptr;
+  EXPECT_TRUE(ctx->tensor(name, &t).ok());
+  return std::vector<T>(t->Raw<T>(), t->Raw<T>() + t->NumElements());
+}
+
+// Neighbors of id are id * 10 + i, i < id % 3
+void Fetch(const std::vector<uint64_t>& ids, OpKernelContext* ctx,
+           std::vector<std::unique_ptr<Tensor>>* fetched) {
+  std::vector<int32_t> index;
+  std::vector<uint64_t> nb_ids;
+  for (auto id : ids) {
+    index.push_back(nb_ids.size());
+    for (uint64_t i = 0; i < id % 3; ++i) {
+      nb_ids.push_back(id * 10 + i);
+    }
+    index.push_back(nb_ids.size());
+  }
+  auto allocator = DefaultAllocator();
+  fetched->clear();
+  fetched->emplace_back(
+      new Tensor(allocator, {ids.size(), 2}, DataType::kInt32));
+  std::copy(index.begin(), index.end(), (*fetched)[0]->Raw<int32_t>());
+  fetched->emplace_back(
+      new Tensor(allocator, {nb_ids.size()}, DataType::kUInt64));
+  std::copy(nb_ids.begin(), nb_ids.end(), (*fetched)[1]->Raw<uint64_t>());
+  fetched->emplace_back(
+      new Tensor(allocator, {nb_ids.size()}, DataType::kFloat));
+  std::copy(nb_ids.begin(), nb_ids.end(), (*fetched)[2]->Raw<float>());
+  fetched->emplace_back(
+      new Tensor(allocator, {nb_ids.size()}, DataType::kInt32));
+  std::copy(nb_ids.begin(), nb_ids.end(), (*fetched)[3]->Raw<int32_t>());
+}
+
+std::vector<Tensor*> Raw(const std::vector<std::unique_ptr<Tensor>>& v) {
+  std::vector<Tensor*> result;
+  for (auto& t : v) {
+    result.push_back(t.get());
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(RemoteCacheTest, Neighbor) {
+  HotVertexCache hot_vertex_cache(1 << 20);
+  DAGNodeProto node_def = NeighborRemoteNode();
+  std::vector<std::unique_ptr<Tensor>> fetched;
+
+  {
+    OpKernelContext ctx;
+    Fill<uint64_t>(&ctx, "ids,0:0", {3}, kUInt64, {1, 2, 3});
+    Fill<int32_t>(&ctx, "edge_types,3:0", {1}, kInt32, {0});
+    auto cache = RemoteCache::Lookup(node_def, &ctx, &hot_vertex_cache);
+    ASSERT_NE(nullptr, cache);
+    ASSERT_EQ("REMOTE,1:0", cache->ids_name());
+    ASSERT_EQ(3, cache->missed_ids()->NumElements());
+    Fetch({1, 2, 3}, &ctx, &fetched);
+    ASSERT_TRUE(cache->Merge(Raw(fetched), &ctx).ok());
+    ASSERT_EQ(std::vector<int32_t>({0, 1, 1, 3, 3, 3}),
+              Values<int32_t>(&ctx, "REMOTE,1:0"));
+    ASSERT_EQ(std::vector<uint64_t>({10, 20, 21}),
+              Values<uint64_t>(&ctx, "REMOTE,1:1"));
+  }
+
+  {
+    OpKernelContext ctx;
+    Fill<uint64_t>(&ctx, "ids,0:0", {3}, kUInt64, {5, 1, 2});
+    Fill<int32_t>(&ctx, "edge_types,3:0", {1}, kInt32, {0});
+    auto cache = RemoteCache::Lookup(node_def, &ctx, &hot_vertex_cache);
+    ASSERT_NE(nullptr, cache);
+    ASSERT_EQ(std::vector<uint64_t>({5}),
+              Values<uint64_t>(&ctx, "REMOTE,1:missed_ids"));
+    Fetch({5}, &ctx, &fetched);
+    ASSERT_TRUE(cache->Merge(Raw(fetched), &ctx).ok());
+    ASSERT_EQ(std::vector<int32_t>({0, 2, 2, 3, 3, 5}),
+              Values<int32_t>(&ctx, "REMOTE,1:0"));
+    ASSERT_EQ(std::vector<uint64_t>({50, 51, 10, 20, 21}),
+              Values<uint64_t>(&ctx, "REMOTE,1:1"));
+    ASSERT_EQ(std::vector<float>({50, 51, 10, 20, 21}),
+              Values<float>(&ctx, "REMOTE,1:2"));
+    ASSERT_EQ(std::vector<int32_t>({50, 51, 10, 20, 21}),
+              Values<int32_t>(&ctx, "REMOTE,1:3"));
+  }
+
+  {
+    // All cached, nothing to fetch
+    OpKernelContext ctx;
+    Fill<uint64_t>(&ctx, "ids,0:0", {2}, kUInt64, {3, 5});
+    Fill<int32_t>(&ctx, "edge_types,3:0", {1}, kInt32, {0});
+    auto cache = RemoteCache::Lookup(node_def, &ctx, &hot_vertex_cache);
+    ASSERT_EQ(0, cache->missed_ids()->NumElements());
+    ASSERT_TRUE(cache->Merge({}, &ctx).ok());
+    ASSERT_EQ(std::vector<int32_t>({0, 0, 0, 2}),
+              Values<int32_t>(&ctx, "REMOTE,1:0"));
+    ASSERT_EQ(std::vector<uint64_t>({50, 51}),
+              Values<uint64_t>(&ctx, "REMOTE,1:1"));
+  }
+
+  {
+    // Another edge type is another query
+    OpKernelContext ctx;
+    Fill<uint64_t>(&ctx, "ids,0:0", {2}, kUInt64, {3, 5});
+    Fill<int32_t>(&ctx, "edge_types,3:0", {1}, kInt32, {1});
+    auto cache = RemoteCache::Lookup(node_def, &ctx, &hot_vertex_cache);
+    ASSERT_EQ(2, cache->missed_ids()->NumElements());
+  }
+  ASSERT_EQ(4, hot_vertex_cache.hits());
+  ASSERT_EQ(6, hot_vertex_cache.misses());
+}
+
+TEST(RemoteCacheTest, NotCacheable) {
+  HotVertexCache hot_vertex_cache(1 << 20);
+  DAGNodeProto node_def = NeighborRemoteNode();
+  node_def.mutable_inner_nodes(0)->add_dnf("price gt 3");
+  OpKernelContext ctx;
+  Fill<uint64_t>(&ctx, "ids,0:0", {3}, kUInt64, {1, 2, 3});
+  Fill<int32_t>(&ctx, "edge_types,3:0", {1}, kInt32, {0});
+  ASSERT_EQ(nullptr, RemoteCache::Lookup(node_def, &ctx, &hot_vertex_cache));
+
+  node_def = NeighborRemoteNode();
+  node_def.mutable_inner_nodes(0)->set_op("API_SAMPLE_NB");
+  ASSERT_EQ(nullptr, RemoteCache::Lookup(node_def, &ctx, &hot_vertex_cache));
+  ASSERT_EQ(0, hot_vertex_cache.misses());
+}
+
+}  // namespace euler
@@ -13,17 +13,20 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include <unordered_map>
+#include <memory>
 #include <unordered_set>
 
+#include "euler/common/hash.h"
 #include "euler/common/logging.h"
 #include "euler/common/str_util.h"
 #include "euler/core/framework/op_kernel.h"
 #include "euler/core/framework/dag_node.pb.h"
 #include "euler/core/framework/tensor.h"
-#include "euler/core/framework/tensor_util.h"
+#include "euler/core/framework/tracer.h"
 #include "euler/core/dag/dag.h"
-#include "euler/proto/worker.pb.h"
+#include "euler/core/kernels/registered_plans.h"
+#include "euler/core/kernels/remote_cache.h"
+#include "euler/proto/tensor_message.h"
 #include "euler/client/client_manager.h"
 
 namespace euler {
@@ -35,64 +38,166 @@ class Remote: public AsyncOpKernel {
                     OpKernelContext* ctx, DoneCallback callback) override;
 };
 
-int32_t MapToRemoteInputIdx(std::string inner_input_name) {
-  std::vector<std::string> inner_input_info = Split(inner_input_name, ":");
-  if (inner_input_info.size() == 2) {
-    std::vector<std::string> src_name_id = Split(inner_input_info[0], ",");
-    if (src_name_id.size() == 2 && src_name_id[0] == "REMOTE") {
-      return atoi(inner_input_info[1].c_str());
+namespace {
+
+// The index in output_list of the tensor i of the reply, the server replies
+// the outputs in the order of the request
+int32_t OutputIndex(const DAGNodeProto& node_def,
+                    const ExecuteTensorReply& response, int32_t i) {
+  const std::string& name = response.tensor_name(i);
+  if (i < node_def.output_list_size() && node_def.output_list(i) == name) {
+    return i;
+  }
+  for (int32_t j = 0; j < node_def.output_list_size(); ++j) {
+    if (node_def.output_list(j) == name) {
+      return j;
     }
-    return -1;
-  } else {
-    return -1;
+  }
+  EULER_LOG(FATAL) << "unexpected output: " << name;
+  return -1;
+}
+
+// The round trip of the rpc, and the spans of the server in the process of
+// the shard
+void AddTraceSpans(const DAGNodeProto& node_def, const ExecuteReply& reply,
+                   uint64_t start, Tracer* tracer) {
+  tracer->AddSpan(node_def.name() + "/rpc", "rpc", start,
+                  Tracer::NowMicros());
+  for (auto& span : reply.spans()) {
+    tracer->AddSpan({span.name(), span.category(), node_def.shard_idx() + 1,
+                     span.thread(), span.start(), span.end()});
   }
 }
 
-#define TRY_ENCODE(NAME, TENSOR) {                           \
-  if (dedup.find(NAME) == dedup.end()) {                     \
-    TensorProto* input_pb = request.mutable_inputs()->Add(); \
-    input_pb->set_name(NAME);                                \
-    Encode(*TENSOR, input_pb);                               \
-    dedup.insert(NAME);                                      \
-  }                                                          \
+void IssueExecute(std::shared_ptr<RpcClient> rpc_client, int32_t shard_id,
+                  const DAGNodeProto& node_def,
+                  std::shared_ptr<ExecuteTensorRequest> request,
+                  std::shared_ptr<RemoteCache> cache, OpKernelContext* ctx,
+                  AsyncOpKernel::DoneCallback callback) {
+  std::string method = "euler.EulerService/Execute";
+  ExecuteTensorReply* response = new ExecuteTensorReply();
+  uint64_t start = ctx->tracer() != nullptr ? Tracer::NowMicros() : 0;
+  auto done = [rpc_client, shard_id, &node_def, request, cache, ctx,
+               callback, response, start] (const Status& status,
+                                           const std::string& replica) {
+    if (ctx->tracer() != nullptr) {
+      AddTraceSpans(node_def, response->proto(), start, ctx->tracer());
+    }
+    if (status.ok() && response->proto().plan_not_found()) {
+      // The plan is evicted, the server is restarted or the replica has not
+      // cached it yet, send the graph again
+      delete response;
+      request->mutable_proto()->mutable_graph()->mutable_nodes()->CopyFrom(
+          node_def.inner_nodes());
+      IssueExecute(rpc_client, shard_id, node_def, request, cache, ctx,
+                   callback);
+      return;
+    }
+
+    if (status.ok()) {
+      uint64_t plan_id = response->proto().plan_id();
+      if (plan_id != 0) {
+        RegisteredPlans::Instance().Add(shard_id, replica, plan_id);
+      }
+      if (cache != nullptr) {
+        // merge the fetched outputs with the cached ones
+        std::vector<std::unique_ptr<Tensor>> fetched(
+            node_def.output_list_size());
+        for (int32_t i = 0; i < response->tensor_size(); ++i) {
+          fetched[OutputIndex(node_def, *response, i)].reset(
+              response->ReleaseTensor(i));
+        }
+        std::vector<Tensor*> outputs;
+        for (auto& tensor : fetched) {
+          outputs.push_back(tensor.get());
+        }
+        Status s = cache->Merge(outputs, ctx);
+        if (!s.ok()) {
+          EULER_LOG(FATAL) << "merge cached outputs error: " << s;
+        }
+        delete response;
+        callback();
+        return;
+      }
+      // put output tensor in response into ctx, they alias the rpc buffer
+      for (int32_t i = 0; i < response->tensor_size(); ++i) {
+        ctx->AddRemoteOutput(node_def, OutputIndex(node_def, *response, i),
+                             response->ReleaseTensor(i));
+      }
+    } else {
+      EULER_LOG(FATAL) << "rpc error: " << status.error_message();
+    }
+    delete response;
+    callback();
+  };
+  rpc_client->IssueRpcCall(method, *request, response, done);
 }
 
+}  // namespace
+
 void Remote::AsyncCompute(const DAGNodeProto& node_def,
                           OpKernelContext* ctx, DoneCallback callback) {
   // get server shard id
   int32_t shard_id = node_def.shard_idx();
+  ClientManager* client_manager = ClientManager::GetInstance();
+  // strip the cached ids, nothing to fetch if all of them are cached
+  std::shared_ptr<RemoteCache> cache;
+  if (client_manager != nullptr) {
+    cache = RemoteCache::Lookup(node_def, ctx,
+                                client_manager->hot_vertex_cache());
+  }
+  if (cache != nullptr && cache->missed_ids()->NumElements() == 0) {
+    Status s = cache->Merge({}, ctx);
+    if (!s.ok()) {
+      EULER_LOG(FATAL) << "merge cached outputs error: " << s;
+    }
+    callback();
+    return;
+  }
   // prepare request
-  ExecuteRequest request;
-  // 1. add inputs
-  std::unordered_set<std::string> dedup;
+  auto request = std::make_shared<ExecuteTensorRequest>();
+  // 1. add inputs, through the slots resolved when the node is added to the
+  // DAG. The udf params and the dnf values are looked up by name.
+  std::unordered_set<int32_t> sent_slots;
+  std::unordered_set<std::string> sent_names;  // The ones without a slot
+  auto encode = [&request, &sent_slots, &sent_names] (
+      const std::string& name, int32_t slot, Tensor* tensor) {
+    if (slot >= 0 ? sent_slots.insert(slot).second
+                  : sent_names.insert(name).second) {
+      request->AddTensor(name, tensor);
+    }
+  };
   for (int32_t i = 0; i < node_def.inner_nodes_size(); ++i) {
     const DAGNodeProto& inner_node = node_def.inner_nodes(i);
     for (int32_t j = 0; j < inner_node.inputs_size(); ++j) {
-      std::string inner_input_name = inner_node.inputs(j);
+      const std::string& inner_input_name = inner_node.inputs(j);
+      int32_t slot = j < inner_node.input_slots_size() ?
+          inner_node.input_slots(j) : -1;
       Tensor* inner_input_tensor = nullptr;
       int32_t remote_input_idx = MapToRemoteInputIdx(inner_input_name);
       // input from outsize
-      if (remote_input_idx != -1 &&
-          ctx->tensor(node_def.inputs(remote_input_idx),
-                      &inner_input_tensor).ok()) {
-        TRY_ENCODE(inner_input_name, inner_input_tensor);
+      if (cache != nullptr && inner_input_name == cache->ids_name()) {
+        encode(inner_input_name, slot, cache->missed_ids());
+      } else if (remote_input_idx != -1 &&
+          ctx->input(node_def, remote_input_idx, &inner_input_tensor).ok()) {
+        encode(inner_input_name, slot, inner_input_tensor);
       } else if (remote_input_idx == -1 &&
-                 ctx->tensor(inner_input_name, &inner_input_tensor).ok()) {
-        TRY_ENCODE(inner_input_name, inner_input_tensor);
+                 ctx->input(inner_node, j, &inner_input_tensor).ok()) {
+        encode(inner_input_name, slot, inner_input_tensor);
       }
     }
     // udf params
     for (int32_t j = 0; j < inner_node.udf_str_params_size(); ++j) {
-      std::string udf_params_name = inner_node.udf_str_params(j);
+      const std::string& udf_params_name = inner_node.udf_str_params(j);
       Tensor* udf_params_tensor = nullptr;
       ctx->tensor(udf_params_name, &udf_params_tensor);
-      TRY_ENCODE(udf_params_name, udf_params_tensor);
+      encode(udf_params_name, ctx->slot(udf_params_name), udf_params_tensor);
     }
     for (int32_t j = 0; j < inner_node.udf_num_params_size(); ++j) {
-      std::string udf_params_name = inner_node.udf_num_params(j);
+      const std::string& udf_params_name = inner_node.udf_num_params(j);
       Tensor* udf_params_tensor = nullptr;
       ctx->tensor(udf_params_name, &udf_params_tensor);
-      TRY_ENCODE(udf_params_name, udf_params_tensor);
+      encode(udf_params_name, ctx->slot(udf_params_name), udf_params_tensor);
     }
     // dnf value params
     for (int32_t j = 0; j < inner_node.dnf_size(); ++j) {
@@ -101,45 +206,41 @@ void Remote::AsyncCompute(const DAGNodeProto& node_def,
         std::vector<std::string> index_op_value = Split(term, " ");
         Tensor* v = nullptr;
         if (ctx->tensor(index_op_value[2], &v).ok()) {
-          TRY_ENCODE(index_op_value[2], v);
+          encode(index_op_value[2], ctx->slot(index_op_value[2]), v);
         }
       }
     }
   }
-  // 2. add dag
-  DAGProto* dag = request.mutable_graph();
-  dag->mutable_nodes()->CopyFrom(node_def.inner_nodes());
+  if (ctx->tracer() != nullptr) {
+    request->mutable_proto()->set_trace(true);
+  }
+  if (ctx->seeded()) {
+    // The shards run the same nodes, they are seeded differently not to
+    // draw the same samples
+    const std::string& name = node_def.name();
+    request->mutable_proto()->set_seeded(true);
+    request->mutable_proto()->set_seed(
+        ctx->seed() ^ hash64(name.data(), name.size(), shard_id));
+  }
+  // 2. add dag, omitted if the servers have cached it
+  uint64_t plan_id = node_def.plan_id();
+  request->mutable_proto()->set_plan_id(plan_id);
+  if (plan_id == 0 || !RegisteredPlans::Instance().Contains(shard_id,
+                                                           plan_id)) {
+    request->mutable_proto()->mutable_graph()->mutable_nodes()->CopyFrom(
+        node_def.inner_nodes());
+  }
   // 3. add output
-  std::unordered_map<std::string, std::string> io_name_2_ro_name;
   for (int32_t i = 0; i < node_def.output_list_size(); ++i) {
-    request.add_outputs(node_def.output_list(i));
-    io_name_2_ro_name[node_def.output_list(i)] =
-        node_def.remote_output_list(i);
+    request->mutable_proto()->add_outputs(node_def.output_list(i));
   }
 
   // call rpc
-  ClientManager* client_manager = ClientManager::GetInstance();
   std::shared_ptr<RpcClient> rpc_client;
   if (client_manager != nullptr &&
       (rpc_client = client_manager->GetClient(shard_id)) != nullptr) {
-    std::string method = "euler.EulerService/Execute";
-    ExecuteReply* response = new ExecuteReply();
-    auto done =
-        [ctx, response, io_name_2_ro_name, callback] (const Status& status) {
-      if (status.ok()) {
-        // put output tensor in response into ctx
-        for (int32_t i = 0; i < response->outputs_size(); ++i) {
-          std::string io_name = response->outputs(i).name();
-          ctx->Allocate(io_name_2_ro_name.at(io_name),
-                        response->outputs(i));
-        }
-      } else {
-        EULER_LOG(FATAL) << "rpc error: " << status.error_message();
-      }
-      delete response;
-      callback();
-    };
-    rpc_client->IssueRpcCall(method, request, response, done);
+    IssueExecute(rpc_client, shard_id, node_def, std::move(request),
+                 std::move(cache), ctx, callback);
   } else {
     EULER_LOG(ERROR) << "client manager error or shard id error";
   }
@@ -28,6 +28,8 @@ class Reshape: public OpKernel {
   explicit Reshape(const std::string& name) : OpKernel(name) {}
   void Compute(const DAGNodeProto& node_def,
                OpKernelContext* ctx) override;
+
+  bool IsCheap() const override { return true; }
 };
 
 void Reshape::Compute(const DAGNodeProto& node_def,
@@ -53,22 +53,9 @@ void SampleLayer::Compute(const DAGNodeProto& node_def,
   ctx->Allocate(OutputName(node_def, 0), shape, DataType::kUInt64, &o_nb_t);
   ctx->Allocate(OutputName(node_def, 1), shape, DataType::kFloat, &o_w_t);
   ctx->Allocate(OutputName(node_def, 2), shape, DataType::kInt32, &o_t_t);
-  int32_t addr = 0;
-  for (size_t i = 0; i < l_root_num; ++i) {
-    std::vector<uint64_t> roots =
-        {l_root_t->Raw<uint64_t>()[i]};
-    IdWeightPairVec nb = SampleNeighbor(roots, edge_types, 1);
-    if (nb[0].empty()) {
-      o_nb_t->Raw<uint64_t>()[addr] = default_node;
-      o_w_t->Raw<float>()[addr] = 0;
-      o_t_t->Raw<int32_t>()[addr] = 0;
-    } else {
-      o_nb_t->Raw<uint64_t>()[addr] = std::get<0>(nb[0][0]);
-      o_w_t->Raw<float>()[addr] = std::get<1>(nb[0][0]);
-      o_t_t->Raw<int32_t>()[addr] = std::get<2>(nb[0][0]);
-    }
-    ++addr;
-  }
+  SampleNeighbor(l_root_t->Raw<uint64_t>(), l_root_num, edge_types, 1,
+                 default_node, o_nb_t->Raw<uint64_t>(), o_w_t->Raw<float>(),
+                 o_t_t->Raw<int32_t>(), ParallelSample(l_root_num));
 }
 
 REGISTER_OP_KERNEL("API_SAMPLE_L", SampleLayer);
@@ -63,6 +63,14 @@ void SampleNeighborOp::Compute(const DAGNodeProto& node_def,
     return;
   }
 
+  // uint64_t default_node = atol(node_def.inputs(3).c_str());
+  uint64_t default_node = euler::common::DEFAULT_UINT64;
+  if (node_def.dnf_size() == 0 && node_def.post_process_size() == 0) {
+    SampleNeighborToOutput(node_def, ctx, node_ids.data(), node_ids.size(),
+                           edge_types, arg[0], default_node);
+    return;
+  }
+
   IdWeightPairVec res;
   if (node_def.dnf_size() > 0) {
     res = GetFullNeighbor(node_ids, edge_types);
@@ -131,8 +139,6 @@ void SampleNeighborOp::Compute(const DAGNodeProto& node_def,
     }
   }
 
-  // uint64_t default_node = atol(node_def.inputs(3).c_str());
-  uint64_t default_node = euler::common::DEFAULT_UINT64;
   for (auto& item : res) {
     if (item.empty()) {
       item.reserve(arg[0]);
@@ -75,9 +75,9 @@ void SampleNodeOp::Compute(const DAGNodeProto& node_def, OpKernelContext* ctx) {
         auto weights = index_result->GetWeights();
         size_t cur = 0;
         for (size_t i = 0; i < ids.size(); ++i) {
-          auto node = graph->GetNodeByID(ids[i]);
-          if (node != nullptr &&
-              node_type_set.find(node->GetType()) != node_type_set.end()) {
+          int32_t node_type = 0;
+          if (graph->GetNodeType(ids[i], &node_type) &&
+              node_type_set.find(node_type) != node_type_set.end()) {
             ids[cur] = ids[i];
             weights[cur] = ids[i];
             ++cur;
@@ -99,9 +99,9 @@ void SampleNodeOp::Compute(const DAGNodeProto& node_def, OpKernelContext* ctx) {
                sample_time < kMaxSampleTime) {
           auto sample_result = index_result->Sample(count);
           for (auto& item : sample_result) {
-            auto node = graph->GetNodeByID(item.first);
-            if (node != nullptr &&
-                node_type_set.find(node->GetType()) != node_type_set.end()) {
+            int32_t node_type = 0;
+            if (graph->GetNodeType(item.first, &node_type) &&
+                node_type_set.find(node_type) != node_type_set.end()) {
               node_id_vec.emplace_back(item.first);
               sample_time = 0;
               if (node_id_vec.size() == static_cast<size_t>(count)) {
@@ -26,6 +26,9 @@ namespace euler {
 Compiler::Compiler(int32_t shard_num,
                    OptimizerType type, std::string index_info):
     shard_num_(shard_num), optimizer_(type, shard_num), translator_(type) {
+  for (auto& bucket : plan_buckets_) {
+    bucket.store(nullptr, std::memory_order_relaxed);
+  }
   /* parse index info */
   std::vector<std::string> index_info_list = Split(index_info, ",");
   for (std::string name_type : index_info_list) {
@@ -343,6 +346,30 @@ Compiler::Compiler(int32_t shard_num,
     optimizer_.AddRule(optmz_rule);
   }
 
+  /* API_RANDOM_WALK
+   *
+   * ID_SPLIT                                        [REGULAR_DATA_MERGE,
+   *                  -> [REMOTE_0, REMOTE_1 ...] ->  REGULAR_DATA_MERGE]
+   * BROAD_CAST_SPLIT
+   */
+  {
+    std::vector<std::string> adj_info = {"API_RANDOM_WALK:0"};
+    std::vector<std::vector<std::string>> fusion_output_map {
+      {"API_RANDOM_WALK", "0", "0", "0"},  // ids
+      {"API_RANDOM_WALK", "0", "1", "1"}};  // steps
+    std::vector<std::vector<std::string>> split_op_info =
+      {{"ID_SPLIT", "0"}, {"BROAD_CAST_SPLIT", "1"},
+       {"BROAD_CAST_SPLIT", "2"}, {"BROAD_CAST_SPLIT", "3"}};
+    std::vector<std::vector<std::string>> merge_op_info =
+      {{"REGULAR_DATA_MERGE", "split:0", "0"},
+       {"REGULAR_DATA_MERGE", "split:0", "1"}};
+    std::shared_ptr<OptimizeRule> optmz_rule =
+        std::make_shared<FusionAndShardRule>(
+        adj_info, "REMOTE", fusion_output_map,
+        split_op_info, merge_op_info, shard_num);
+    optimizer_.AddRule(optmz_rule);
+  }
+
   /* API_GET_P:
    *
    * ID_SPLIT -> [REMOTE_0, REMOTE_1 ...] -> [ID_MERGE, DATA_MERGE, ...]
@@ -570,4 +597,40 @@ Compiler::Compiler(int32_t shard_num,
 
 Compiler* Compiler::instance_ = nullptr;
 
+const int Compiler::kPlanCacheBuckets;
+
+Compiler::~Compiler() {
+  for (auto& bucket : plan_buckets_) {
+    const Plan* plan = bucket.load(std::memory_order_relaxed);
+    while (plan != nullptr) {
+      const Plan* next = plan->next;
+      delete plan->dag;
+      delete plan;
+      plan = next;
+    }
+  }
+}
+
+DAG* Compiler::LookupPlan(uint64_t fingerprint,
+                          const std::string& key) const {
+  const std::atomic<const Plan*>& bucket =
+      plan_buckets_[fingerprint % kPlanCacheBuckets];
+  for (const Plan* plan = bucket.load(std::memory_order_acquire);
+       plan != nullptr; plan = plan->next) {
+    if (plan->fingerprint == fingerprint && plan->key == key) {
+      return plan->dag;
+    }
+  }
+  return nullptr;
+}
+
+void Compiler::InsertPlan(uint64_t fingerprint, const std::string& key,
+                          DAG* dag) {
+  std::atomic<const Plan*>& bucket =
+      plan_buckets_[fingerprint % kPlanCacheBuckets];
+  const Plan* head = bucket.load(std::memory_order_relaxed);
+  bucket.store(new Plan{fingerprint, key, dag, head},
+               std::memory_order_release);
+}
+
 }  // namespace euler
@@ -16,12 +16,16 @@ limitations under the License.
 #ifndef EULER_PARSER_COMPILER_H_
 #define EULER_PARSER_COMPILER_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <vector>
 #include <memory>
 
+#include "euler/common/hash.h"
 #include "euler/common/logging.h"
 #include "euler/common/mutex.h"
 #include "euler/parser/translator.h"
@@ -110,19 +114,26 @@ class Compiler {
 
 
   DAG* Compile(const std::string& gremlin) {
+    uint64_t fingerprint = hash64(gremlin.data(), gremlin.size());
+    DAG* dag = LookupPlan(fingerprint, gremlin);
+    if (dag != nullptr) {
+      return dag;
+    }
     MutexLock l(&mu_);
-    if (dag_cache_.find(gremlin) == dag_cache_.end()) {
+    dag = LookupPlan(fingerprint, gremlin);
+    if (dag == nullptr) {
       EULER_LOG(INFO) << "compiling: " << gremlin;
       DAGDef dag_def;
       Tree tree = BuildGrammarTree(gremlin);
       translator_.Translate(tree, &dag_def);
       if (optimizer_.Optimize(&dag_def)) {
-        dag_cache_[gremlin] = DAG::NewFromProto(dag_def.ToProto()).release();
+        dag = DAG::NewFromProto(dag_def.ToProto()).release();
+        InsertPlan(fingerprint, gremlin, dag);
       } else {
         EULER_LOG(FATAL) << "compile fail! " << gremlin;
       }
     }
-    return dag_cache_[gremlin];
+    return dag;
   }
 
   DAG* Op2DAG(const std::string& op_name,
@@ -137,8 +148,14 @@ class Compiler {
     for (const std::string& name : norm_attr_names) {
       key += " " + name;
     }
+    uint64_t fingerprint = hash64(key.data(), key.size());
+    DAG* dag = LookupPlan(fingerprint, key);
+    if (dag != nullptr) {
+      return dag;
+    }
     MutexLock l(&mu_);
-    if (dag_cache_.find(key) == dag_cache_.end()) {
+    dag = LookupPlan(fingerprint, key);
+    if (dag == nullptr) {
       EULER_LOG(INFO) << "processing single op: " << key;
       DAGDef dag_def;
       std::shared_ptr<NodeDef> node_def =
@@ -164,12 +181,13 @@ class Compiler {
       dag_def.AddNodeDef(as_node, pre, succ);
 
       if (optimizer_.Optimize(&dag_def)) {
-        dag_cache_[key] = DAG::NewFromProto(dag_def.ToProto()).release();
+        dag = DAG::NewFromProto(dag_def.ToProto()).release();
+        InsertPlan(fingerprint, key, dag);
       } else {
         EULER_LOG(FATAL) << "compile fail! " << key;
       }
     }
-    return dag_cache_[key];
+    return dag;
   }
 
   std::unordered_map<std::string, std::vector<std::string>>
@@ -177,15 +195,29 @@ class Compiler {
     return index_info_;
   }
 
-  ~Compiler() {
-    for (auto it = dag_cache_.begin(); it != dag_cache_.end(); ++it) {
-      delete it->second;
-    }
-  }
+  ~Compiler();
 
  private:
-  Mutex mu_;
-  std::unordered_map<std::string, DAG*> dag_cache_;
+  static const int kPlanCacheBuckets = 256;
+
+  // The plans are read without locking. A bucket is a list of immutable
+  // plans, a new plan is published at its head and never removed, so the
+  // memory grows with the number of distinct queries only.
+  struct Plan {
+    uint64_t fingerprint;
+    std::string key;
+    DAG* dag;
+    const Plan* next;
+  };
+
+  DAG* LookupPlan(uint64_t fingerprint, const std::string& key) const;
+
+  void InsertPlan(uint64_t fingerprint, const std::string& key, DAG* dag);
+
+  Mutex mu_;  // Serialize the compiling, translator and optimizer are not
+              // thread safe
+  // Indexed by the fingerprint of the key, written with mu_ held
+  std::atomic<const Plan*> plan_buckets_[kPlanCacheBuckets];
   int32_t shard_num_;
   Optimizer optimizer_;
   Translator translator_;
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <thread>  // NOLINT
 #include <vector>
 #include <string>
 
@@ -224,4 +225,35 @@ TEST(CompilerTest, MacroFusion) {
   }
 }
 
+TEST(CompilerTest, PlanCache) {
+  Compiler::Init(2, distribute, "att:hash_range_index,price:range_index");
+  Compiler* compiler = Compiler::GetInstance();
+
+  const int kThreads = 8;
+  std::vector<DAG*> dags(kThreads * 2, nullptr);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([compiler, &dags, i] () {
+      dags[i * 2] = compiler->Op2DAG(
+          "API_SPARSE_GET_ADJ", "sparse_get_adj", 2,
+          {"root_batch", "l_nb"}, {"edge_types", "m"});
+      dags[i * 2 + 1] = compiler->Op2DAG(
+          "API_GET_GRAPH_BY_LABEL", "get_graph", 2, {"labels"}, {});
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ASSERT_NE(nullptr, dags[0]);
+  ASSERT_NE(nullptr, dags[1]);
+  ASSERT_NE(dags[0], dags[1]);
+  for (int i = 1; i < kThreads; ++i) {
+    EXPECT_EQ(dags[0], dags[i * 2]);
+    EXPECT_EQ(dags[1], dags[i * 2 + 1]);
+  }
+  EXPECT_EQ(dags[1], compiler->Op2DAG(
+      "API_GET_GRAPH_BY_LABEL", "get_graph", 2, {"labels"}, {}));
+}
+
 }  // namespace euler
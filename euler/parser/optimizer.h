@@ -39,7 +39,7 @@ class Optimizer {
         "BROAD_CAST_SPLIT",
         "SAMPLE_NODE_SPLIT",
         "SAMPLE_EDGE_SPLIT",
-        "GP_BROAD_CAST_SPLIT",
+        "GP_ROUTE_SPLIT",
         "GP_APPEND_MERGE",
         "GP_UNIQUE_MERGE",
         "GP_IDX_MERGE",
@@ -53,12 +53,16 @@ class Optimizer {
         {"API_SAMPLE_NODE:1", "SAMPLE_NODE_SPLIT:1,0"},
         {"API_SAMPLE_EDGE:0", "BROAD_CAST_SPLIT:0"},
         {"API_SAMPLE_EDGE:1", "SAMPLE_EDGE_SPLIT:1,0"},
-        {"API_GET_NODE:0", "GP_BROAD_CAST_SPLIT:0"},
-        {"API_GET_EDGE:0", "GP_BROAD_CAST_SPLIT:0"},
-        {"API_SAMPLE_NB:0", "GP_BROAD_CAST_SPLIT:0"},
-        {"API_GET_NB_NODE:0", "GP_BROAD_CAST_SPLIT:0"},
-        {"API_GET_NODE_T:0", "GP_BROAD_CAST_SPLIT:0"},
-        {"API_GET_P:0", "GP_BROAD_CAST_SPLIT:0"}};
+        {"API_GET_NODE:0", "GP_ROUTE_SPLIT:0"},
+        {"API_GET_EDGE:0", "GP_ROUTE_SPLIT:0"},
+        {"API_SAMPLE_NB:0", "GP_ROUTE_SPLIT:0"},
+        {"API_GET_NB_NODE:0", "GP_ROUTE_SPLIT:0"},
+        {"API_GET_NODE_T:0", "GP_ROUTE_SPLIT:0"},
+        {"API_RANDOM_WALK:0", "GP_ROUTE_SPLIT:0"},
+        {"API_RANDOM_WALK:1", "BROAD_CAST_SPLIT:1"},
+        {"API_RANDOM_WALK:2", "BROAD_CAST_SPLIT:2"},
+        {"API_RANDOM_WALK:3", "BROAD_CAST_SPLIT:3"},
+        {"API_GET_P:0", "GP_ROUTE_SPLIT:0"}};
 
     /* key=op_name:output_idx
      *
@@ -82,6 +86,8 @@ class Optimizer {
         {"API_GET_NB_NODE:2", "GP_DATA_MERGE:0:2,0"},
         {"API_GET_NB_NODE:3", "GP_DATA_MERGE:0:3,0"},
         {"API_GET_NODE_T:0", "GP_REGULAR_DATA_MERGE:0:0"},
+        {"API_RANDOM_WALK:0", "GP_REGULAR_DATA_MERGE:0:0"},
+        {"API_RANDOM_WALK:1", "GP_REGULAR_DATA_MERGE:0:1"},
         {"API_GET_P:even", "GP_IDX_MERGE:0:even"},
         {"API_GET_P:odd", "GP_DATA_MERGE:0:odd,even"}};
   }
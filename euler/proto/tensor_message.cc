@@ -0,0 +1,398 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/proto/tensor_message.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "euler/core/framework/allocator.h"
+#include "euler/core/framework/tensor_util.h"
+
+namespace euler {
+
+namespace {
+
+const uint32_t kWireTypeVarint = 0;
+const uint32_t kWireTypeFixed64 = 1;
+const uint32_t kWireTypeLengthDelimited = 2;
+const uint32_t kWireTypeFixed32 = 5;
+
+// Tensors smaller than this are copied into the byte buffer, referring
+// them costs more than copying
+const size_t kMinReferenceBytes = 1024;
+
+inline uint32_t MakeTag(int field, uint32_t wire_type) {
+  return (static_cast<uint32_t>(field) << 3) | wire_type;
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+size_t VarintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+void UnrefBuffer(void* buffer) {
+  static_cast<Buffer*>(buffer)->Unref();
+}
+
+// Keep the received slices alive for the tensors aliasing them
+class SliceBuffer : public Buffer {
+ public:
+  explicit SliceBuffer(std::vector<grpc::Slice>* slices)
+      : Buffer(DefaultAllocator(), nullptr, 0, false) {
+    slices_.swap(*slices);
+  }
+
+  const std::vector<grpc::Slice>& slices() const { return slices_; }
+
+ private:
+  std::vector<grpc::Slice> slices_;
+};
+
+// Read the protobuf wire format across the slices
+class SliceReader {
+ public:
+  explicit SliceReader(const std::vector<grpc::Slice>& slices)
+      : slices_(slices), index_(0), offset_(0), position_(0), size_(0) {
+    for (auto& slice : slices_) {
+      size_ += slice.size();
+    }
+  }
+
+  size_t position() const { return position_; }
+
+  bool Done() {
+    Normalize();
+    return index_ == slices_.size();
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      Normalize();
+      if (index_ == slices_.size()) {
+        return false;
+      }
+      uint8_t byte = slices_[index_].begin()[offset_];
+      ++offset_;
+      ++position_;
+      *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Point data to the next size bytes if they are in one slice, otherwise
+  // copy them to scratch. The size comes from the wire, so it is checked
+  // against the bytes left before anything is reserved.
+  bool Read(uint64_t size, const char** data, std::string* scratch) {
+    if (size > size_ - position_) {
+      return false;
+    }
+    Normalize();
+    if (index_ < slices_.size() &&
+        slices_[index_].size() - offset_ >= size) {
+      *data = reinterpret_cast<const char*>(slices_[index_].begin()) +
+          offset_;
+      offset_ += size;
+      position_ += size;
+      return true;
+    }
+
+    scratch->clear();
+    scratch->reserve(size);
+    while (scratch->size() < size) {
+      Normalize();
+      if (index_ == slices_.size()) {
+        return false;
+      }
+      size_t bytes = std::min(size - scratch->size(),
+                              slices_[index_].size() - offset_);
+      scratch->append(
+          reinterpret_cast<const char*>(slices_[index_].begin()) + offset_,
+          bytes);
+      offset_ += bytes;
+      position_ += bytes;
+    }
+    *data = scratch->data();
+    return true;
+  }
+
+  // Append the field of tag to out in the wire format
+  bool CopyField(uint64_t tag, std::string* out) {
+    AppendVarint(tag, out);
+    uint64_t value = 0;
+    const char* data = nullptr;
+    std::string scratch;
+    switch (tag & 0x7) {
+      case kWireTypeVarint:
+        if (!ReadVarint(&value)) {
+          return false;
+        }
+        AppendVarint(value, out);
+        return true;
+      case kWireTypeFixed64:
+        value = 8;
+        break;
+      case kWireTypeFixed32:
+        value = 4;
+        break;
+      case kWireTypeLengthDelimited:
+        if (!ReadVarint(&value)) {
+          return false;
+        }
+        AppendVarint(value, out);
+        break;
+      default:
+        return false;
+    }
+    if (!Read(value, &data, &scratch)) {
+      return false;
+    }
+    out->append(data, value);
+    return true;
+  }
+
+ private:
+  void Normalize() {
+    while (index_ < slices_.size() && offset_ == slices_[index_].size()) {
+      ++index_;
+      offset_ = 0;
+    }
+  }
+
+  const std::vector<grpc::Slice>& slices_;
+  size_t index_;
+  size_t offset_;
+  size_t position_;
+  size_t size_;  // The total bytes of the slices
+};
+
+Status DecodeTensor(SliceReader* reader, size_t end, SliceBuffer* holder,
+                    std::string* name, std::unique_ptr<Tensor>* tensor) {
+  TensorProto proto;
+  std::string meta;
+  const char* content = nullptr;
+  size_t content_size = 0;
+  std::string scratch;
+  while (reader->position() < end) {
+    uint64_t tag = 0;
+    if (!reader->ReadVarint(&tag)) {
+      return Status::InvalidArgument("Invalid tensor proto");
+    }
+    if (tag == MakeTag(TensorProto::kTensorContentFieldNumber,
+                       kWireTypeLengthDelimited)) {
+      uint64_t size = 0;
+      if (!reader->ReadVarint(&size) ||
+          !reader->Read(size, &content, &scratch)) {
+        return Status::InvalidArgument("Invalid tensor proto");
+      }
+      content_size = size;
+    } else if (!reader->CopyField(tag, &meta)) {
+      return Status::InvalidArgument("Invalid tensor proto");
+    }
+  }
+  if (reader->position() != end || !proto.ParseFromString(meta)) {
+    return Status::InvalidArgument("Invalid tensor proto");
+  }
+
+  *name = proto.name();
+  TensorShape shape = ProtoToTensorShape(proto.tensor_shape());
+  DataType type = ProtoToDataType(proto.dtype());
+  if (type == DataType::kString) {
+    proto.set_tensor_content(content, content_size);
+    tensor->reset(new Tensor(DefaultAllocator(), shape, type));
+    return Decode(proto, tensor->get());
+  }
+
+  if (content_size != shape.NumElements() * SizeOfType(type)) {
+    return Status::Internal("Dismatched proto and tensor output");
+  }
+  bool in_slice = content != scratch.data();
+  bool aligned = reinterpret_cast<uintptr_t>(content) % SizeOfType(type) == 0;
+  if (content_size > 0 && in_slice && aligned) {
+    Buffer* buffer = new Buffer(DefaultAllocator(),
+                                const_cast<char*>(content), content_size,
+                                holder);
+    tensor->reset(new Tensor(shape, type, buffer));
+    buffer->Unref();
+  } else {
+    tensor->reset(new Tensor(DefaultAllocator(), shape, type));
+    if (content_size > 0) {
+      memcpy((*tensor)->Raw<char>(), content, content_size);
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+TensorMessage::TensorMessage(google::protobuf::Message* message,
+                             int tensor_field)
+    : message_(message), tensor_field_(tensor_field) {
+}
+
+TensorMessage::~TensorMessage() {
+}
+
+void TensorMessage::AddTensor(const std::string& name, const Tensor* tensor) {
+  names_.push_back(name);
+  tensors_.push_back(tensor);
+  owned_.emplace_back();
+}
+
+void TensorMessage::Swap(TensorMessage* other) {
+  message_->GetReflection()->Swap(message_, other->message_);
+  names_.swap(other->names_);
+  tensors_.swap(other->tensors_);
+  owned_.swap(other->owned_);
+}
+
+void TensorMessage::Clear() {
+  message_->Clear();
+  names_.clear();
+  tensors_.clear();
+  owned_.clear();
+}
+
+Status TensorMessage::Encode(grpc::ByteBuffer* buffer) const {
+  std::vector<grpc::Slice> slices;
+  std::string pending;
+  if (!message_->AppendToString(&pending)) {
+    return Status::Internal("Serialize message failed");
+  }
+
+  const uint32_t content_tag = MakeTag(TensorProto::kTensorContentFieldNumber,
+                                       kWireTypeLengthDelimited);
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    const Tensor* tensor = tensors_[i];
+    if (tensor == nullptr || !tensor->Initialized()) {
+      return Status::FailedPrecondition("Tensor '", names_[i],
+                                        "' should be properly initialized");
+    }
+
+    TensorProto proto;
+    size_t content_size = 0;
+    if (tensor->Type() == DataType::kString) {
+      RETURN_IF_ERROR(::euler::Encode(*tensor, &proto));
+    } else {
+      proto.set_dtype(static_cast<DataTypeProto>(tensor->Type()));
+      for (auto& dim : tensor->Shape().Dims()) {
+        proto.mutable_tensor_shape()->add_dims(dim);
+      }
+      content_size = tensor->TotalBytes();
+    }
+    proto.set_name(names_[i]);
+
+    std::string meta;
+    proto.SerializeToString(&meta);
+    uint64_t size = meta.size();
+    if (content_size > 0) {
+      size += VarintSize(content_tag) + VarintSize(content_size) +
+          content_size;
+    }
+    if (size > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+      return Status::InvalidArgument("Tensor '", names_[i], "' is too large");
+    }
+
+    AppendVarint(MakeTag(tensor_field_, kWireTypeLengthDelimited), &pending);
+    AppendVarint(size, &pending);
+    pending.append(meta);
+    if (content_size == 0) {
+      continue;
+    }
+
+    AppendVarint(content_tag, &pending);
+    AppendVarint(content_size, &pending);
+    if (content_size < kMinReferenceBytes) {
+      pending.append(tensor->Raw<char>(), content_size);
+      continue;
+    }
+    slices.emplace_back(pending);
+    pending.clear();
+    Buffer* content = tensor->GetBuffer();
+    content->Ref();  // Released with the slice
+    slices.emplace_back(tensor->Raw<char>(), content_size, UnrefBuffer,
+                        content);
+  }
+  if (!pending.empty()) {
+    slices.emplace_back(pending);
+  }
+
+  grpc::ByteBuffer result(slices.data(), slices.size());
+  buffer->Swap(&result);
+  return Status::OK();
+}
+
+Status TensorMessage::Decode(const grpc::ByteBuffer& buffer) {
+  Clear();
+  std::vector<grpc::Slice> slices;
+  if (!buffer.Dump(&slices).ok()) {
+    return Status::InvalidArgument("Invalid byte buffer");
+  }
+  auto holder = RefCountedPtr<SliceBuffer>::Create(&slices);
+
+  SliceReader reader(holder->slices());
+  std::string message;
+  const uint64_t tensor_tag = MakeTag(tensor_field_, kWireTypeLengthDelimited);
+  while (!reader.Done()) {
+    uint64_t tag = 0;
+    if (!reader.ReadVarint(&tag)) {
+      return Status::InvalidArgument("Invalid message");
+    }
+    if (tag != tensor_tag) {
+      if (!reader.CopyField(tag, &message)) {
+        return Status::InvalidArgument("Invalid message");
+      }
+      continue;
+    }
+
+    uint64_t size = 0;
+    if (!reader.ReadVarint(&size)) {
+      return Status::InvalidArgument("Invalid message");
+    }
+    std::string name;
+    std::unique_ptr<Tensor> tensor;
+    RETURN_IF_ERROR(DecodeTensor(&reader, reader.position() + size,
+                                 holder.get(), &name, &tensor));
+    names_.push_back(name);
+    tensors_.push_back(tensor.get());
+    owned_.push_back(std::move(tensor));
+  }
+
+  if (!message_->ParseFromString(message)) {
+    return Status::InvalidArgument("Invalid message");
+  }
+  return Status::OK();
+}
+
+}  // namespace euler
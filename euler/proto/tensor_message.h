@@ -0,0 +1,118 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_PROTO_TENSOR_MESSAGE_H_
+#define EULER_PROTO_TENSOR_MESSAGE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/message.h"
+#include "grpcpp/support/byte_buffer.h"
+
+#include "euler/common/macros.h"
+#include "euler/common/status.h"
+#include "euler/core/framework/tensor.h"
+#include "euler/proto/worker.pb.h"
+
+namespace euler {
+
+// A protobuf message whose repeated TensorProto field is kept out of the
+// message as tensors, e.g. the inputs of ExecuteRequest. It is encoded to and
+// decoded from grpc byte buffers in the protobuf wire format, so the peer can
+// still use the plain message, but the tensor contents are never copied: the
+// encoded buffer refers to the tensor buffers, and the decoded tensors alias
+// the slices of the received buffer.
+class TensorMessage {
+ public:
+  // The message is not owned
+  TensorMessage(google::protobuf::Message* message, int tensor_field);
+
+  virtual ~TensorMessage();
+
+  google::protobuf::Message* message() const { return message_; }
+
+  // Add a tensor to be encoded, the tensor is not owned. Its buffer is
+  // referenced by the encoded byte buffer, and must not be modified until
+  // the byte buffer is released
+  void AddTensor(const std::string& name, const Tensor* tensor);
+
+  int tensor_size() const { return names_.size(); }
+
+  const std::string& tensor_name(int i) const { return names_[i]; }
+
+  const Tensor* tensor(int i) const { return tensors_[i]; }
+
+  // Release the ownership of a decoded tensor, return nullptr if the tensor
+  // is not owned or has been released
+  Tensor* ReleaseTensor(int i) { return owned_[i].release(); }
+
+  // A new empty message of the same type, nullptr if not supported
+  virtual TensorMessage* New() const { return nullptr; }
+
+  // Swap the message and tensors with another message of the same type
+  void Swap(TensorMessage* other);
+
+  void Clear();
+
+  Status Encode(grpc::ByteBuffer* buffer) const;
+
+  // Parse the buffer, the message and tensors are replaced
+  Status Decode(const grpc::ByteBuffer& buffer);
+
+ private:
+  google::protobuf::Message* message_;
+  const int tensor_field_;
+  std::vector<std::string> names_;
+  std::vector<const Tensor*> tensors_;
+  std::vector<std::unique_ptr<Tensor>> owned_;
+
+  DISALLOW_COPY_AND_ASSIGN(TensorMessage);
+};
+
+// ExecuteRequest with the inputs kept as tensors
+class ExecuteTensorRequest : public TensorMessage {
+ public:
+  ExecuteTensorRequest()
+      : TensorMessage(&proto_, ExecuteRequest::kInputsFieldNumber) { }
+
+  TensorMessage* New() const override { return new ExecuteTensorRequest(); }
+
+  ExecuteRequest* mutable_proto() { return &proto_; }
+  const ExecuteRequest& proto() const { return proto_; }
+
+ private:
+  ExecuteRequest proto_;
+};
+
+// ExecuteReply with the outputs kept as tensors
+class ExecuteTensorReply : public TensorMessage {
+ public:
+  ExecuteTensorReply()
+      : TensorMessage(&proto_, ExecuteReply::kOutputsFieldNumber) { }
+
+  TensorMessage* New() const override { return new ExecuteTensorReply(); }
+
+  ExecuteReply* mutable_proto() { return &proto_; }
+  const ExecuteReply& proto() const { return proto_; }
+
+ private:
+  ExecuteReply proto_;
+};
+
+}  // namespace euler
+
+#endif  // EULER_PROTO_TENSOR_MESSAGE_H_
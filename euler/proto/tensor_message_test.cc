@@ -0,0 +1,190 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/proto/tensor_message.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "grpcpp/impl/codegen/proto_utils.h"
+
+#include "euler/common/str_util.h"
+#include "euler/core/framework/op_kernel.h"
+#include "euler/core/framework/tensor_util.h"
+
+namespace euler {
+
+TEST(TensorMessageTest, EncodeDecode) {
+  OpKernelContext ctx;
+  Tensor* ids = nullptr;
+  Tensor* small = nullptr;
+  Tensor* names = nullptr;
+  ASSERT_TRUE(ctx.Allocate("ids", {1000}, DataType::kUInt64, &ids).ok());
+  ASSERT_TRUE(ctx.Allocate("small", {2, 2}, DataType::kFloat, &small).ok());
+  ASSERT_TRUE(ctx.Allocate("names", {3}, DataType::kString, &names).ok());
+  for (int i = 0; i < ids->NumElements(); ++i) {
+    ids->Raw<uint64_t>()[i] = i * 3;
+  }
+  for (int i = 0; i < small->NumElements(); ++i) {
+    small->Raw<float>()[i] = i + 0.5;
+  }
+  for (int i = 0; i < names->NumElements(); ++i) {
+    *names->Raw<std::string*>()[i] = ToString("name_", i);
+  }
+
+  ExecuteTensorReply reply;
+  reply.mutable_proto()->set_plan_id(12345);
+  reply.AddTensor("ids:0", ids);
+  reply.AddTensor("small:0", small);
+  reply.AddTensor("names:0", names);
+  grpc::ByteBuffer buffer;
+  ASSERT_TRUE(reply.Encode(&buffer).ok());
+
+  ExecuteTensorReply result;
+  ASSERT_TRUE(result.Decode(buffer).ok());
+  ASSERT_EQ(12345, result.proto().plan_id());
+  ASSERT_EQ(0, result.proto().outputs_size());
+  ASSERT_EQ(3, result.tensor_size());
+
+  ASSERT_EQ("ids:0", result.tensor_name(0));
+  std::unique_ptr<Tensor> t(result.ReleaseTensor(0));
+  ASSERT_EQ(DataType::kUInt64, t->Type());
+  ASSERT_EQ(TensorShape({1000}), t->Shape());
+  ASSERT_EQ(nullptr, result.ReleaseTensor(0));
+  for (int i = 0; i < t->NumElements(); ++i) {
+    ASSERT_EQ(i * 3, t->Raw<uint64_t>()[i]);
+  }
+
+  ASSERT_EQ("small:0", result.tensor_name(1));
+  t.reset(result.ReleaseTensor(1));
+  ASSERT_EQ(DataType::kFloat, t->Type());
+  ASSERT_EQ(TensorShape({2, 2}), t->Shape());
+  for (int i = 0; i < t->NumElements(); ++i) {
+    ASSERT_EQ(i + 0.5, t->Raw<float>()[i]);
+  }
+
+  ASSERT_EQ("names:0", result.tensor_name(2));
+  t.reset(result.ReleaseTensor(2));
+  ASSERT_EQ(DataType::kString, t->Type());
+  for (int i = 0; i < t->NumElements(); ++i) {
+    ASSERT_EQ(ToString("name_", i), *t->Raw<std::string*>()[i]);
+  }
+}
+
+TEST(TensorMessageTest, AliasReceivedBuffer) {
+  std::vector<float> values(4096);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  std::string content(reinterpret_cast<char*>(values.data()),
+                      values.size() * sizeof(float));
+  ExecuteTensorReply reply;
+  Tensor tensor(DefaultAllocator(), {values.size()}, DataType::kFloat,
+                &content[0], false);
+  reply.AddTensor("values", &tensor);
+  grpc::ByteBuffer buffer;
+  ASSERT_TRUE(reply.Encode(&buffer).ok());
+
+  // The tensor content is referred by the buffer instead of copied
+  std::vector<grpc::Slice> slices;
+  ASSERT_TRUE(buffer.Dump(&slices).ok());
+  ASSERT_EQ(2, slices.size());
+  ASSERT_EQ(content.data(),
+            reinterpret_cast<const char*>(slices[1].begin()));
+
+  // Received in one slice
+  grpc::Slice received;
+  ASSERT_TRUE(buffer.DumpToSingleSlice(&received).ok());
+  grpc::ByteBuffer single(&received, 1);
+  std::unique_ptr<Tensor> t;
+  {
+    ExecuteTensorReply result;
+    ASSERT_TRUE(result.Decode(single).ok());
+    ASSERT_EQ(1, result.tensor_size());
+    t.reset(result.ReleaseTensor(0));
+  }
+  single.Clear();
+  auto begin = reinterpret_cast<const char*>(received.begin());
+  auto data = t->Raw<char>();
+  bool aligned = reinterpret_cast<uintptr_t>(data) % sizeof(float) == 0;
+  if (aligned) {
+    ASSERT_TRUE(data >= begin && data < begin + received.size());
+  }
+  received = grpc::Slice();
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], t->Raw<float>()[i]);
+  }
+}
+
+TEST(TensorMessageTest, PlainProto) {
+  // Encoded message is parsed as the plain proto
+  OpKernelContext ctx;
+  Tensor* ids = nullptr;
+  ASSERT_TRUE(ctx.Allocate("ids", {500}, DataType::kInt64, &ids).ok());
+  for (int i = 0; i < ids->NumElements(); ++i) {
+    ids->Raw<int64_t>()[i] = -i;
+  }
+
+  ExecuteTensorRequest request;
+  request.mutable_proto()->add_outputs("output:0");
+  request.mutable_proto()->set_plan_id(1);
+  request.AddTensor("ids", ids);
+  grpc::ByteBuffer buffer;
+  ASSERT_TRUE(request.Encode(&buffer).ok());
+
+  ExecuteRequest proto;
+  grpc::ProtoBufferReader reader(&buffer);
+  ASSERT_TRUE(proto.ParseFromZeroCopyStream(&reader));
+  ASSERT_EQ(1, proto.outputs_size());
+  ASSERT_EQ(1, proto.plan_id());
+  ASSERT_EQ(1, proto.inputs_size());
+  ASSERT_EQ("ids", proto.inputs(0).name());
+  ASSERT_TRUE(ctx.Allocate("decoded", proto.inputs(0)).ok());
+  Tensor* decoded = nullptr;
+  ASSERT_TRUE(ctx.tensor("decoded", &decoded).ok());
+  ASSERT_EQ(0, memcmp(ids->Raw<char>(), decoded->Raw<char>(),
+                      ids->TotalBytes()));
+
+  // Plain proto is decoded
+  grpc::ByteBuffer plain;
+  bool own_buffer = false;
+  ASSERT_TRUE((grpc::GenericSerialize<grpc::ProtoBufferWriter,
+                                      google::protobuf::Message>(
+                   proto, &plain, &own_buffer)).ok());
+  ExecuteTensorRequest result;
+  ASSERT_TRUE(result.Decode(plain).ok());
+  ASSERT_EQ(1, result.proto().outputs_size());
+  ASSERT_EQ(0, result.proto().inputs_size());
+  ASSERT_EQ(1, result.tensor_size());
+  std::unique_ptr<Tensor> t(result.ReleaseTensor(0));
+  ASSERT_EQ(TensorShape({500}), t->Shape());
+  ASSERT_EQ(0, memcmp(ids->Raw<char>(), t->Raw<char>(), ids->TotalBytes()));
+
+  // Invalid buffer
+  std::string invalid = "\x0a\xff";
+  grpc::Slice slice(invalid);
+  grpc::ByteBuffer invalid_buffer(&slice, 1);
+  ASSERT_FALSE(result.Decode(invalid_buffer).ok());
+
+  // A length beyond the received bytes is rejected before it is allocated
+  std::string huge("\x7a\x80\x80\x80\x80\x80\x20", 7);  // 1 << 40 bytes
+  grpc::Slice huge_slices[2] = {grpc::Slice(huge), grpc::Slice("content")};
+  grpc::ByteBuffer huge_buffer(huge_slices, 2);
+  ASSERT_FALSE(result.Decode(huge_buffer).ok());
+}
+
+}  // namespace euler
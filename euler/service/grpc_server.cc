@@ -46,6 +46,7 @@ GrpcServer::~GrpcServer() {
     Stop();
     delete worker_service_;
     delete worker_env_.compute_pool;
+    delete worker_env_.plan_cache;
   }
 }
 
@@ -54,8 +55,15 @@ Status GrpcServer::Init() {
   worker_env_.env = env_;
   auto& options = server_def_.options;
 
+  size_t plan_cache_size = 1024;
+  auto it = options.find("plan_cache_size");
+  if (it != options.end()) {
+    plan_cache_size = std::atoll(it->second.c_str());
+  }
+  worker_env_.plan_cache = new PlanCache(plan_cache_size);
+
   int port = 0;
-  auto it = options.find("port");
+  it = options.find("port");
   if (it  == options.end()) {
     EULER_LOG(ERROR) << "Invalid Server config, no port specified";
     return Status(ErrorCode::INTERNAL, "no port specified");
@@ -89,7 +97,13 @@ Status GrpcServer::Init() {
   if (it != options.end()) {
     num_threads = std::atoi(it->second.c_str());
   }
-  worker_env_.compute_pool = env_->StartThreadPool(name, num_threads);
+  ThreadPoolType pool_type = kStdThreadPool;
+  it = options.find("thread_pool_type");
+  if (it != options.end()) {
+    RETURN_IF_ERROR(StringToThreadPoolType(it->second, &pool_type));
+  }
+  worker_env_.compute_pool =
+      env_->StartThreadPool(name, num_threads, pool_type);
 
   // Load Graph and Index
   RETURN_IF_ERROR(LoadGraphAndIndex());
@@ -126,12 +140,52 @@ Status GrpcServer::LoadGraphAndIndex() {
     load_data_type = it->second;
   }
 
+  std::string storage_type = "node";
+  it = options.find("storage_type");
+  if (it != options.end()) {
+    storage_type = it->second;
+  }
+
   auto& graph = Graph::Instance();
 
+  GraphLoadOptions load_options;
+  it = options.find("load_reader_num");
+  if (it != options.end()) {
+    load_options.reader_num = std::atoi(it->second.c_str());
+  }
+  it = options.find("load_parser_num");
+  if (it != options.end()) {
+    load_options.parser_num = std::atoi(it->second.c_str());
+  }
+  it = options.find("load_pending_mb");
+  if (it != options.end()) {
+    load_options.max_pending_bytes = std::atoll(it->second.c_str()) << 20;
+  }
+  it = options.find("neighbor_sampler_type");
+  if (it != options.end()) {
+    RETURN_IF_ERROR(StringToNeighborSamplerType(
+        it->second, &load_options.neighbor_sampler_type));
+  }
+  it = options.find("alias_min_degree");
+  if (it != options.end()) {
+    load_options.alias_min_degree = std::atoi(it->second.c_str());
+  }
+  it = options.find("dense_feature_columns");
+  if (it != options.end()) {
+    load_options.dense_feature_columns = std::atoi(it->second.c_str()) != 0;
+  }
+  it = options.find("dense_feature_quantization");
+  if (it != options.end()) {
+    RETURN_IF_ERROR(StringToFeatureQuantization(
+        it->second, &load_options.dense_feature_quantization));
+  }
+  graph.set_load_options(load_options);
+
   // Load Graph
   RETURN_IF_ERROR(graph.Init(server_def_.shard_index,
                              server_def_.shard_number,
-                             sampler_type, data_path, load_data_type));
+                             sampler_type, data_path, load_data_type,
+                             storage_type));
 
   it = options.find("zk_server");
   if (it == options.end()) {
@@ -157,6 +211,7 @@ Status GrpcServer::LoadGraphAndIndex() {
   auto& index_manager = IndexManager::Instance();
   index_manager.set_shard_index(server_def_.shard_index);
   index_manager.set_shard_number(server_def_.shard_number);
+  index_manager.set_use_snapshot(storage_type == "snapshot");
   if (!data_dir->ListDirectory([](const std::string &filename) {
         return filename == "Index";
       }).empty()) {
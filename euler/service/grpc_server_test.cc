@@ -267,6 +267,67 @@ TEST_F(GrpcServerTest, Execute) {
   EULER_LOG(INFO) << response.DebugString();
 }
 
+TEST_F(GrpcServerTest, ExecuteCachedPlan) {
+  const uint64_t plan_id = 12345;
+  std::vector<int32_t> v(5, 1);
+  ExecuteRequest request;
+  for (auto& name : {"A", "B"}) {
+    auto input = request.mutable_inputs()->Add();
+    input->set_name(name);
+    input->set_dtype(DataTypeProto::DT_INT32);
+    input->set_tensor_content(
+        std::string(reinterpret_cast<const char*>(v.data()),
+                    v.size() * sizeof(v[0])));
+    input->mutable_tensor_shape()->mutable_dims()->Add(5);
+  }
+  request.mutable_outputs()->Add("add1:0");
+  request.set_plan_id(plan_id);
+
+  // Unknown plan without graph
+  ExecuteReply response;
+  SendRequest("euler.EulerService/Execute", request, &response);
+  ASSERT_TRUE(response.plan_not_found());
+  ASSERT_EQ(0, response.outputs_size());
+
+  // Register the plan with the graph
+  auto node = request.mutable_graph()->mutable_nodes()->Add();
+  node->set_name("add1");
+  node->set_op("add");
+  node->mutable_inputs()->Add("A");
+  node->mutable_inputs()->Add("B");
+  response.Clear();
+  SendRequest("euler.EulerService/Execute", request, &response);
+  ASSERT_FALSE(response.plan_not_found());
+  ASSERT_EQ(plan_id, response.plan_id());
+  ASSERT_EQ(1, response.outputs_size());
+
+  // Execute the cached plan
+  request.clear_graph();
+  response.Clear();
+  SendRequest("euler.EulerService/Execute", request, &response);
+  ASSERT_FALSE(response.plan_not_found());
+  ASSERT_EQ(plan_id, response.plan_id());
+  ASSERT_EQ(1, response.outputs_size());
+  auto& proto = response.outputs(0);
+  std::vector<int32_t> ov(5, 0);
+  ASSERT_EQ(ov.size() * sizeof(ov[0]), proto.tensor_content().size());
+  memcpy(&ov[0], proto.tensor_content().c_str(), proto.tensor_content().size());
+  for (auto& oov : ov) {
+    ASSERT_EQ(2, oov);
+  }
+  ASSERT_EQ(0, response.spans_size());
+
+  // Trace the execution
+  request.set_trace(true);
+  response.Clear();
+  SendRequest("euler.EulerService/Execute", request, &response);
+  ASSERT_EQ(1, response.outputs_size());
+  ASSERT_EQ(1, response.spans_size());
+  ASSERT_EQ("add1", response.spans(0).name());
+  ASSERT_EQ("add", response.spans(0).category());
+  ASSERT_LE(response.spans(0).start(), response.spans(0).end());
+}
+
 TEST_F(GrpcServerTest, SampleNode) {
   auto graph = EulerGraph();
   EULER_LOG(INFO) << graph->graph_meta().ToString();
@@ -15,13 +15,16 @@ limitations under the License.
 
 #include "euler/service/grpc_worker.h"
 
+#include <memory>
 #include <vector>
 #include <string>
+#include <utility>
 
 #include "euler/core/framework/op_kernel.h"
 #include "euler/core/framework/executor.h"
 #include "euler/core/framework/tensor.h"
 #include "euler/core/framework/tensor_util.h"
+#include "euler/core/framework/tracer.h"
 #include "euler/common/logging.h"
 #include "euler/core/api/api.h"
 
@@ -37,13 +40,55 @@ void GrpcWorker::PingAsync(const PingRequest* request,
   done(Status::OK());
 }
 
-void GrpcWorker::ExecuteAsync(const ExecuteRequest* request,
-                              ExecuteReply* reply, Callback done) {
+void GrpcWorker::ExecuteAsync(ExecuteTensorRequest* tensor_request,
+                              ExecuteTensorReply* tensor_reply,
+                              Callback done) {
+  const ExecuteRequest* request = &tensor_request->proto();
+  ExecuteReply* reply = tensor_reply->mutable_proto();
+  std::shared_ptr<DAG> dag;
+  uint64_t plan_id = request->plan_id();
+  PlanCache* plan_cache = env()->plan_cache;
+  if (plan_id != 0 && plan_cache != nullptr) {
+    dag = plan_cache->Lookup(plan_id);
+  }
+  if (dag == nullptr) {
+    if (plan_id != 0 && request->graph().nodes_size() == 0) {
+      // The client sends the graph again
+      reply->set_plan_not_found(true);
+      done(Status::OK());
+      return;
+    }
+
+    auto new_dag = DAG::NewFromProto(request->graph());
+    if (new_dag == nullptr) {
+      auto msg = ToString("Convert graph proto to DAG failed, proto:",
+                          request->graph().DebugString());
+      EULER_LOG(ERROR) << msg;
+      done(Status::Internal(msg));
+      return;
+    }
+    if (plan_id != 0 && plan_cache != nullptr) {
+      dag = plan_cache->Insert(plan_id, std::move(new_dag));
+    } else {
+      dag.reset(new_dag.release());
+    }
+  }
+  if (plan_id != 0 && plan_cache != nullptr && plan_cache->capacity() > 0) {
+    reply->set_plan_id(plan_id);
+  }
+
   auto context = new OpKernelContext;
-  for (auto& input : request->inputs()) {
-    auto s = context->Allocate(input);
+  if (request->trace()) {
+    context->EnableTrace();
+  }
+  if (request->seeded()) {
+    context->set_seed(request->seed());
+  }
+  for (int i = 0; i < tensor_request->tensor_size(); ++i) {
+    auto& name = tensor_request->tensor_name(i);
+    auto s = context->AddTensor(name, tensor_request->ReleaseTensor(i));
     if (!s.ok()) {
-      auto msg = ToString("Allocate input tensor '", input.name(), "' failed!");
+      auto msg = ToString("Allocate input tensor '", name, "' failed!");
       EULER_LOG(ERROR) << msg;
       done(Status::Internal(msg));
 
@@ -52,24 +97,10 @@ void GrpcWorker::ExecuteAsync(const ExecuteRequest* request,
     }
   }
 
-  auto dag = DAG::NewFromProto(request->graph()).release();
-  if (dag == nullptr) {
-    auto msg = ToString("Convert graph proto to DAG failed, proto:",
-                        request->graph().DebugString());
-    EULER_LOG(ERROR) << msg;
-    done(Status::Internal(msg));
+  auto executor = new Executor(dag.get(), env()->compute_pool, context);
 
-    delete dag;
-    delete context;
-    return;
-  }
-
-  auto executor = new Executor(dag, env()->compute_pool, context);
-
-  auto callback = [request, reply, done, context, dag, executor] () {
+  auto callback = [request, tensor_reply, done, context, dag, executor] () {
     for (auto& output : request->outputs()) {
-      auto outpb = reply->mutable_outputs()->Add();
-      outpb->set_name(output);
       Tensor* t = nullptr;
       auto s = context->tensor(output, &t);
       if (!s.ok() || t == nullptr) {
@@ -77,17 +108,25 @@ void GrpcWorker::ExecuteAsync(const ExecuteRequest* request,
         EULER_LOG(ERROR) << msg;
         done(Status::Internal(msg));
 
-        delete dag;
         delete context;
         delete executor;
         return;
       }
 
-      Encode(*t, outpb);
+      tensor_reply->AddTensor(output, t);
+    }
+    if (context->tracer() != nullptr) {
+      for (auto& span : context->tracer()->spans()) {
+        TraceSpan* proto = tensor_reply->mutable_proto()->add_spans();
+        proto->set_name(span.name);
+        proto->set_category(span.category);
+        proto->set_thread(span.thread);
+        proto->set_start(span.start);
+        proto->set_end(span.end);
+      }
     }
 
     done(Status::OK());
-    delete dag;
     delete context;
     delete executor;
   };
@@ -31,9 +31,11 @@ class GrpcWorker: public Worker {
                      Method##Reply* reply, Callback) override;  \
 
   DECLARE_METHOD(Ping);
-  DECLARE_METHOD(Execute);
 
 #undef DECLARE_METHOD  // DECLARE_METHOD
+
+  void ExecuteAsync(ExecuteTensorRequest* request, ExecuteTensorReply* reply,
+                    Callback done) override;
 };
 
 std::unique_ptr<GrpcWorker> NewGrpcWorker(WorkerEnv* worker_env);
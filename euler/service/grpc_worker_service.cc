@@ -79,12 +79,10 @@ class GrpcWorkerService: public AsyncServiceInterface {
   do {                                                          \
     MutexLock l(&shutdown_mu_);                                 \
     if (!is_shutdown_) {                                        \
-      Call<GrpcWorkerServiceThread, EulerService::AsyncService, \
-           method##Request, method##Reply>::                    \
-          EnqueueRequestForMethod(                              \
-              euler_service_, cq_.get(),                        \
-              static_cast<int>(EulerServiceMethod::k##method),  \
-              &GrpcWorkerServiceThread::method##Handler);       \
+      method##Call::EnqueueRequestForMethod(                    \
+          euler_service_, cq_.get(),                            \
+          static_cast<int>(EulerServiceMethod::k##method),      \
+          &GrpcWorkerServiceThread::method##Handler);           \
     }                                                           \
   } while (0)
 
@@ -153,6 +151,10 @@ class GrpcWorkerService: public AsyncServiceInterface {
     using WorkCall =
         Call<GrpcWorkerServiceThread, EulerService::AsyncService, Req, Resp>;
 
+    typedef WorkCall<PingRequest, PingReply> PingCall;
+    // The tensors are encoded and decoded by TensorMessage without copying
+    typedef WorkCall<::grpc::ByteBuffer, ::grpc::ByteBuffer> ExecuteCall;
+
     // Handlers for rpc requests
 
 #define DECLARE_HANDLER(Method)                                            \
@@ -168,12 +170,24 @@ class GrpcWorkerService: public AsyncServiceInterface {
 
 #undef DECLARE_HANDLER  // DECLARE_HANDLER
 
-    void ExecuteHandler(WorkCall<ExecuteRequest, ExecuteReply>* call) {
+    void ExecuteHandler(ExecuteCall* call) {
       Schedule([this, call] () {
-        auto done = [call] (const Status& s) {
-          call->SendResponse(ToGrpcStatus(s));
+        auto request = new ExecuteTensorRequest;
+        auto reply = new ExecuteTensorReply;
+        auto done = [call, request, reply] (const Status& s) {
+          // Encode before the output tensors are released
+          Status status = s.ok() ? reply->Encode(&call->response) : s;
+          call->SendResponse(ToGrpcStatus(status));
+          delete request;
+          delete reply;
         };
-        worker_->ExecuteAsync(&call->request, &call->response, done);
+
+        Status s = request->Decode(call->request);
+        if (!s.ok()) {
+          done(s);
+          return;
+        }
+        worker_->ExecuteAsync(request, reply, done);
       });
       ENQUEUE_REQUEST(Execute);
     }
@@ -0,0 +1,61 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/service/plan_cache.h"
+
+namespace euler {
+
+PlanCache::PlanCache(size_t capacity): capacity_(capacity) {
+}
+
+std::shared_ptr<DAG> PlanCache::Lookup(uint64_t plan_id) {
+  MutexLock l(&mu_);
+  auto it = plans_.find(plan_id);
+  if (it == plans_.end()) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<DAG> PlanCache::Insert(uint64_t plan_id,
+                                       std::unique_ptr<DAG> dag) {
+  std::shared_ptr<DAG> shared(dag.release());
+  if (capacity_ == 0) {
+    return shared;
+  }
+
+  MutexLock l(&mu_);
+  auto it = plans_.find(plan_id);
+  if (it != plans_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  lru_.emplace_front(plan_id, shared);
+  plans_[plan_id] = lru_.begin();
+  if (lru_.size() > capacity_) {
+    plans_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  return shared;
+}
+
+size_t PlanCache::size() {
+  MutexLock l(&mu_);
+  return lru_.size();
+}
+
+}  // namespace euler
@@ -0,0 +1,63 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef EULER_SERVICE_PLAN_CACHE_H_
+#define EULER_SERVICE_PLAN_CACHE_H_
+
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "euler/common/macros.h"
+#include "euler/common/mutex.h"
+#include "euler/core/dag/dag.h"
+
+namespace euler {
+
+// A bounded LRU cache of the DAGs built from the Execute requests, keyed by
+// the plan id sent by the client. The DAGs are read only once built, so they
+// are shared by the concurrent executions of the same plan.
+class PlanCache {
+ public:
+  explicit PlanCache(size_t capacity);
+
+  // Return nullptr if not found
+  std::shared_ptr<DAG> Lookup(uint64_t plan_id);
+
+  // Return the cached DAG, which is the existing one if another request has
+  // inserted the same plan
+  std::shared_ptr<DAG> Insert(uint64_t plan_id, std::unique_ptr<DAG> dag);
+
+  size_t size();
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  typedef std::pair<uint64_t, std::shared_ptr<DAG>> Entry;
+
+  const size_t capacity_;
+  Mutex mu_;
+  std::list<Entry> lru_;  // The most recently used first
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> plans_;
+
+  DISALLOW_COPY_AND_ASSIGN(PlanCache);
+};
+
+}  // namespace euler
+
+#endif  // EULER_SERVICE_PLAN_CACHE_H_
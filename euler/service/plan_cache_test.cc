@@ -0,0 +1,95 @@
+/* Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "euler/service/plan_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "euler/core/framework/dag.pb.h"
+#include "euler/core/framework/op_kernel.h"
+
+namespace euler {
+
+class Noop : public OpKernel {
+ public:
+  explicit Noop(const std::string& name): OpKernel(name) { }
+
+  void Compute(const DAGNodeProto& node_def, OpKernelContext* ctx) override {
+  }
+};
+
+REGISTER_OP_KERNEL("noop", Noop);
+
+std::unique_ptr<DAG> NewDAG(const std::string& name) {
+  DAGProto proto;
+  proto.set_name(name);
+  auto node = proto.add_nodes();
+  node->set_name("noop");
+  node->set_op("noop");
+  node->add_inputs("A");
+  node->add_inputs("B");
+  return DAG::NewFromProto(proto);
+}
+
+TEST(PlanCacheTest, LookupAndInsert) {
+  PlanCache cache(4);
+  ASSERT_EQ(4, cache.capacity());
+  ASSERT_EQ(nullptr, cache.Lookup(1));
+
+  auto dag = cache.Insert(1, NewDAG("dag1"));
+  ASSERT_NE(nullptr, dag);
+  ASSERT_EQ("dag1", dag->name());
+  ASSERT_EQ(1, dag->num_nodes());
+  ASSERT_EQ(dag, cache.Lookup(1));
+  ASSERT_EQ(1, cache.size());
+
+  // Insert the same plan concurrently built by another request
+  auto dag2 = cache.Insert(1, NewDAG("dag2"));
+  ASSERT_EQ(dag, dag2);
+  ASSERT_EQ(1, cache.size());
+}
+
+TEST(PlanCacheTest, Evict) {
+  PlanCache cache(2);
+  cache.Insert(1, NewDAG("dag1"));
+  cache.Insert(2, NewDAG("dag2"));
+  ASSERT_NE(nullptr, cache.Lookup(1));  // 2 is the least recently used
+
+  auto dag3 = cache.Insert(3, NewDAG("dag3"));
+  ASSERT_EQ(2, cache.size());
+  ASSERT_EQ(nullptr, cache.Lookup(2));
+  ASSERT_EQ("dag1", cache.Lookup(1)->name());
+  ASSERT_EQ(dag3, cache.Lookup(3));
+
+  // The evicted DAG is still usable by the running requests
+  auto dag4 = cache.Insert(4, NewDAG("dag4"));
+  ASSERT_EQ(nullptr, cache.Lookup(1));
+  ASSERT_EQ("dag3", dag3->name());
+  ASSERT_EQ(dag4, cache.Lookup(4));
+}
+
+TEST(PlanCacheTest, Disabled) {
+  PlanCache cache(0);
+  auto dag = cache.Insert(1, NewDAG("dag1"));
+  ASSERT_NE(nullptr, dag);
+  ASSERT_EQ("dag1", dag->name());
+  ASSERT_EQ(nullptr, cache.Lookup(1));
+  ASSERT_EQ(0, cache.size());
+}
+
+}  // namespace euler
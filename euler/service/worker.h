@@ -20,15 +20,18 @@ limitations under the License.
 #include <functional>
 
 #include "euler/proto/worker.pb.h"
+#include "euler/proto/tensor_message.h"
 #include "euler/common/status.h"
 #include "euler/common/signal.h"
 #include "euler/common/env.h"
+#include "euler/service/plan_cache.h"
 
 namespace euler {
 
 struct WorkerEnv {
   Env* env;
   ThreadPool* compute_pool;
+  PlanCache* plan_cache;
 };
 
 typedef std::function<void(const Status&)> Callback;
@@ -50,10 +53,18 @@ class Worker {
   }
 
   DECLARE_METHOD(Ping);
-  DECLARE_METHOD(Execute);
 
 #undef DECLARE_METHOD  // DECLARE_METHOD
 
+  // The input tensors are moved out of the request, and the output tensors
+  // of the reply are valid until the callback returns
+  virtual void ExecuteAsync(ExecuteTensorRequest* request,
+                            ExecuteTensorReply* reply, Callback) = 0;
+
+  Status Execute(ExecuteTensorRequest* request, ExecuteTensorReply* reply) {
+    return CallAndWait(&Worker::ExecuteAsync, request, reply);
+  }
+
   WorkerEnv* env() const {
     return env_;
   }
@@ -63,7 +74,7 @@ class Worker {
 
  private:
   template <typename Method, typename Req, typename Resp>
-  Status CallAndWait(Method func, const Req* req, Resp* resp) {
+  Status CallAndWait(Method func, Req* req, Resp* resp) {
     Status ret;
     Signal sig;
     (this->*func)(req, resp, [&ret, &sig](const Status& s) {
@@ -13,12 +13,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstring>
 #include <memory>
 #include <vector>
 
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -32,30 +35,59 @@ class GatherOp : public OpKernel {
     const Tensor& params = c->input(0);
     const Tensor& indices = c->input(1);
 
-    int num_slides = indices.shape().dim_size(0);
-    int slide_size = params.shape().dim_size(1);
+    int64 num_slides = indices.dim_size(0);
+    int64 num_params = params.dim_size(0);
+    int64 slide_size = params.dim_size(1);
 
     Tensor* out;
     TensorShape out_shape{num_slides, slide_size};
     OP_REQUIRES_OK(c, c->allocate_output(0, out_shape, &out));
 
-    const T* params_base = &params.flat<T>()(0);
-    const Index* indices_base = &indices.flat<Index>()(0);
-    T* out_base = &out->flat<T>()(0);
+    const T* params_base = params.flat<T>().data();
+    const Index* indices_base = indices.flat<Index>().data();
+    T* out_base = out->flat<T>().data();
 
-    #pragma omp parallel for
-    for (int i = 0; i < num_slides; ++i) {
-      std::memcpy(&out_base[i * slide_size],
-          &params_base[indices_base[i] * slide_size],
-          slide_size * sizeof(T));
+    for (int64 i = 0; i < num_slides; ++i) {
+      OP_REQUIRES(c, indices_base[i] >= 0 && indices_base[i] < num_params,
+                  errors::InvalidArgument(
+                      "indices[", i, "] = ", indices_base[i],
+                      " is not in [0, ", num_params, ")"));
     }
+    if (out->NumElements() == 0) {
+      return;
+    }
+
+    // The slides are copied by the intra op pool, the pool of TensorFlow
+    // instead of OpenMP threads competing with it
+    auto work = [&] (int64 begin, int64 end) {
+      for (int64 i = begin; i < end; ++i) {
+        std::memcpy(out_base + i * slide_size,
+                    params_base + indices_base[i] * slide_size,
+                    slide_size * sizeof(T));
+      }
+    };
+    auto workers = c->device()->tensorflow_cpu_worker_threads();
+    Shard(workers->num_threads, workers->workers, num_slides, slide_size,
+          work);
   }
 };
 
-REGISTER_KERNEL_BUILDER(Name("MPGather")
-  .Device(DEVICE_CPU)
-  .TypeConstraint<float>("T")
-  .TypeConstraint<int32>("Tindices"),
-  GatherOp<float, int32>);
+#define REGISTER_GATHER(T, Index)                           \
+  REGISTER_KERNEL_BUILDER(Name("MPGather")                  \
+    .Device(DEVICE_CPU)                                     \
+    .TypeConstraint<T>("T")                                 \
+    .TypeConstraint<Index>("Tindices"),                     \
+    GatherOp<T, Index>);
+
+#define REGISTER_GATHER_ALL_INDICES(T)                      \
+  REGISTER_GATHER(T, int32);                                \
+  REGISTER_GATHER(T, int64);
+
+TF_CALL_half(REGISTER_GATHER_ALL_INDICES);
+TF_CALL_float(REGISTER_GATHER_ALL_INDICES);
+TF_CALL_double(REGISTER_GATHER_ALL_INDICES);
+
+#undef REGISTER_GATHER_ALL_INDICES
+#undef REGISTER_GATHER
 
 }  // namespace tensorflow
@@ -105,6 +105,13 @@ void GetDenseFeature::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
             idx_ptr->NumElements()
             << "Expect: " << nodes_size * 2;
       }
+      // Every node has a full row, e.g. gathered from a dense column
+      if (static_cast<size_t>(res->NumElements()) ==
+          nodes_size * dimensions_[i]) {
+        std::copy(res_data, res_data + res->NumElements(),
+                  outputs[i]->flat<float>().data());
+        continue;
+      }
       for (size_t j = 0; j < nodes_size; ++j) {
         size_t start = idx_data[j * 2];
         size_t end = idx_data[j * 2 + 1];
@@ -13,8 +13,6 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-#include <math.h>
-
 #include <memory>
 #include <vector>
 #include <functional>
@@ -23,7 +21,6 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/framework/op_kernel.h"
 
-#include "euler/common/compact_weighted_collection.h"
 #include "euler/common/data_types.h"
 #include "tf_euler/utils/euler_query_proxy.h"
 
@@ -31,139 +28,110 @@ namespace tensorflow {
 
 namespace {
 
-class RWCallback {
+// The walks run by the API_RANDOM_WALK op on the graph shards, only the
+// nodes visited come back. A walk stops at the first node its shard does
+// not own and is resumed on the shard owning that node by the next query,
+// so a walk takes one query on a local graph.
+class Walker : public std::enable_shared_from_this<Walker> {
  public:
-  RWCallback(const std::vector<std::vector<int64_t>>& parent_neighbors,
-             const std::vector<int64_t>& parent_ids,
-             const std::vector<std::vector<int>>& edge_types,
-             int walk_len, float p, float q, int64_t default_node,
-             Tensor* output, AsyncOpKernel::DoneCallback done)
-      : parent_neighbors_(parent_neighbors), parent_ids_(parent_ids),
-        edge_types_(edge_types), walk_len_(walk_len), p_(p), q_(q),
-        default_node_(default_node), output_(output), done_(done),
-        call_time_(0), query_(nullptr) {
+  Walker(const std::vector<std::vector<int32>>& edge_types, float p, float q,
+         int64 default_node, int64* output,
+         AsyncOpKernel::DoneCallback done)
+      : walk_len_(edge_types.size()), p_(p), q_(q),
+        default_node_(default_node), output_(output), done_(done) {
+    for (auto& types : edge_types) {
+      edge_types_.insert(edge_types_.end(), types.begin(), types.end());
+      edge_type_nums_.push_back(types.size());
+    }
   }
 
-  void set_query(euler::Query* query) { query_ = query; }
-
-  void operator() ();
+  // Walk from the nodes at step starts[i], with the parents for node2vec
+  void Run(const std::vector<int>& walk_ids,
+           const std::vector<uint64_t>& nodes,
+           const std::vector<uint64_t>& parents,
+           const std::vector<int>& starts);
 
  private:
-  void BuildWeights(const std::vector<int64_t>& parent_neighbors,
-                    const std::vector<int64_t>& child_neighbors,
-                    int64_t parent_id, std::vector<float>* weights);
+  void OnResult(euler::Query* query, const std::vector<int>& walk_ids,
+                const std::vector<int>& starts);
 
- private:
-  std::vector<std::vector<int64_t>> parent_neighbors_;
-  std::vector<int64_t> parent_ids_;
-  std::vector<std::vector<int>> edge_types_;
-  int walk_len_;
+  size_t walk_len_;
   float p_;
   float q_;
-  int64_t default_node_;
-  Tensor* output_;
+  int64 default_node_;
+  std::vector<int32> edge_types_;
+  std::vector<int32> edge_type_nums_;
+  int64* output_;
   AsyncOpKernel::DoneCallback done_;
-  int call_time_;
-  euler::Query* query_;
 };
 
-void GetFullNeighbor(const std::vector<int64_t>& node_ids,
-                     const std::vector<int32>& edge_types,
-                     RWCallback done) {
-  auto query = new euler::Query("v(nodes).outV(edge_types).as(nb)");
-  auto nodes_t = query->AllocInput("nodes", {node_ids.size()}, euler::kUInt64);
+void Walker::Run(const std::vector<int>& walk_ids,
+                 const std::vector<uint64_t>& nodes,
+                 const std::vector<uint64_t>& parents,
+                 const std::vector<int>& starts) {
+  auto query = new euler::Query(
+      "API_RANDOM_WALK", "rw", 2,
+      {"walks", "edge_types", "edge_type_nums", "pq"}, {});
+  size_t num = walk_ids.size();
+  auto walks_t = query->AllocInput("walks", {num, 3}, euler::kUInt64);
+  auto walks = walks_t->Raw<uint64_t>();
+  for (size_t i = 0; i < num; ++i) {
+    walks[i * 3] = nodes[i];
+    walks[i * 3 + 1] = parents[i];
+    walks[i * 3 + 2] = starts[i];
+  }
   auto edge_types_t = query->AllocInput(
-      "edge_types", {edge_types.size()}, euler::kInt32);
-  std::copy(node_ids.begin(), node_ids.end(), nodes_t->Raw<uint64_t>());
-  std::copy(edge_types.begin(), edge_types.end(), edge_types_t->Raw<int32_t>());
-  done.set_query(query);
-  euler::QueryProxy::GetInstance()->RunAsyncGremlin(query, done);
+      "edge_types", {edge_types_.size()}, euler::kInt32);
+  std::copy(edge_types_.begin(), edge_types_.end(),
+            edge_types_t->Raw<int32_t>());
+  auto edge_type_nums_t = query->AllocInput(
+      "edge_type_nums", {edge_type_nums_.size()}, euler::kInt32);
+  std::copy(edge_type_nums_.begin(), edge_type_nums_.end(),
+            edge_type_nums_t->Raw<int32_t>());
+  auto pq_t = query->AllocInput("pq", {2}, euler::kFloat);
+  pq_t->Raw<float>()[0] = p_;
+  pq_t->Raw<float>()[1] = q_;
+
+  auto self = shared_from_this();
+  auto callback = [self, query, walk_ids, starts] () {
+    self->OnResult(query, walk_ids, starts);
+  };
+  euler::QueryProxy::GetInstance()->RunAsyncGremlin(query, callback);
 }
 
-void RWCallback::operator() () {
-  if (query_ == nullptr) {
-    return;
-  }
-
-  auto idx_t = query_->GetResult("nb:0");
-  auto ids_t = query_->GetResult("nb:1");
-  auto weights_t = query_->GetResult("nb:2");
-  std::vector<std::vector<int64_t>> neighbors(parent_neighbors_.size());
-  std::vector<std::vector<float>> weights(parent_neighbors_.size());
-  for (size_t i = 0; i < neighbors.size(); ++i) {
-    int start = idx_t->Raw<int32_t>()[2 * i];
-    int end = idx_t->Raw<int32_t>()[2 * i + 1];
-    neighbors[i].reserve(end - start);
-    weights[i].reserve(end - start);
-    for (int j = start; j < end; ++j) {
-      neighbors[i].emplace_back(ids_t->Raw<int64_t>()[j]);
-      weights[i].emplace_back(weights_t->Raw<float>()[j]);
+void Walker::OnResult(euler::Query* query, const std::vector<int>& walk_ids,
+                      const std::vector<int>& starts) {
+  auto ids = query->GetResult("rw:0")->Raw<uint64_t>();
+  auto steps = query->GetResult("rw:1")->Raw<int32_t>();
+  size_t width = walk_len_ + 1;
+
+  std::vector<int> next_walk_ids;
+  std::vector<uint64_t> nodes, parents;
+  std::vector<int> next_starts;
+  for (size_t i = 0; i < walk_ids.size(); ++i) {
+    if (steps[i] == euler::common::DEFAULT_INT32) {  // Node not found
+      continue;
     }
-  }
-
-  // Sample neighbor
-  auto data = output_->flat<int64>().data();
-  std::vector<int64_t> node_ids(neighbors.size());
-  for (size_t i = 0; i < neighbors.size(); ++i) {
-    auto& cn = neighbors[i];
-    int64_t sample_id = default_node_;
-    if (!cn.empty()) {
-      auto parent_id = parent_ids_[i];
-      auto& pn = parent_neighbors_[i];
-      auto& w = weights[i];
-      BuildWeights(pn, cn, parent_id, &w);
-
-      using CWC = euler::common::CompactWeightedCollection<int64_t>;
-      CWC sampler;
-      sampler.Init(cn, w);
-      sample_id = sampler.Sample().first;
+    const uint64_t* row = ids + i * width;
+    int64* path = output_ + walk_ids[i] * width + starts[i];
+    for (int32_t k = 1; k <= steps[i]; ++k) {
+      path[k] = row[k] == euler::common::DEFAULT_UINT64 ?
+          default_node_ : row[k];
+    }
+    size_t end = starts[i] + steps[i];
+    if (end < walk_len_) {
+      next_walk_ids.push_back(walk_ids[i]);
+      nodes.push_back(row[steps[i]]);
+      parents.push_back(row[steps[i] - 1]);
+      next_starts.push_back(end);
     }
-
-    data[i * (walk_len_ + 1) + call_time_ + 1] = sample_id;
-    node_ids[i] = sample_id;
   }
+  delete query;
 
-  ++call_time_;
-  if (call_time_ < walk_len_) {
-    parent_neighbors_ = neighbors;
-    auto nodes_t = query_->GetResult("nodes");
-    auto nodes_data = nodes_t->Raw<uint64_t>();
-    std::copy(nodes_data, nodes_data + parent_ids_.size(), parent_ids_.begin());
-    GetFullNeighbor(node_ids, edge_types_[call_time_], *this);
-  } else {
+  if (next_walk_ids.empty()) {
     done_();
-  }
-
-  delete query_;
-}
-
-void RWCallback::BuildWeights(const std::vector<int64_t>& parent_neighbors,
-                              const std::vector<int64_t>& child_neighbors,
-                              int64_t parent_id, std::vector<float>* weights) {
-  size_t j = 0;
-  size_t k = 0;
-  while (j < child_neighbors.size() && k < parent_neighbors.size()) {
-    if (child_neighbors[j] < parent_neighbors[k]) {
-      if (child_neighbors[j] != parent_id) {
-        weights->at(j) /= q_;  // d_tx = 2
-      } else {
-        weights->at(j) /=  p_;  // d_tx = 0
-      }
-      ++j;
-    } else if (child_neighbors[j] == parent_neighbors[k]) {
-      ++k;
-      ++j;
-    } else {
-      ++k;
-    }
-  }
-  while (j < child_neighbors.size()) {
-    if (child_neighbors[j] != parent_id) {
-      weights->at(j) /= q_;  // d_tx = 2
-    } else {
-      weights->at(j) /= p_;  // d_tx = 0
-    }
-    ++j;
+  } else {
+    Run(next_walk_ids, nodes, parents, next_starts);
   }
 }
 
@@ -176,23 +144,8 @@ class RandomWalk: public AsyncOpKernel {
     OP_REQUIRES_OK(context, context->GetAttr("p", &p_));
     OP_REQUIRES_OK(context, context->GetAttr("q", &q_));
     OP_REQUIRES_OK(context, context->GetAttr("default_node", &default_node_));
-    if (p_ == 1 && q_ == 1) {
-      std::stringstream ss;
-      ss << "v(nodes)";
-      for (size_t i = 0; i < walk_len_; ++i) {
-        ss << ".sampleNB(et_" << i << ", nb_count_, " << default_node_ << ")"
-           << ".as(nb_" << i << ")";
-        res_names_.push_back(euler::ToString("nb_", i, ":1"));
-      }
-      query_str_ = ss.str();
-    }
   }
 
-  void TraditionalRandomWalk(const std::vector<int64_t>& node_ids,
-                             const std::vector<std::vector<int32>>& edge_types,
-                             DoneCallback done,
-                             Tensor* output);
-
   void ComputeAsync(OpKernelContext* ctx, DoneCallback done) override;
 
  private:
@@ -200,66 +153,25 @@ class RandomWalk: public AsyncOpKernel {
   float p_;
   float q_;
   int default_node_;
-  std::string query_str_;
-  std::vector<std::string> res_names_;
 };
 
-void RandomWalk::TraditionalRandomWalk(
-    const std::vector<int64_t>& node_ids,
-    const std::vector<std::vector<int32>>& edge_types,
-    DoneCallback done,
-    Tensor* output) {
-  auto query = new euler::Query(query_str_);
-  auto t_nodes = query->AllocInput("nodes", {node_ids.size()}, euler::kUInt64);
-  std::copy(node_ids.begin(), node_ids.end(), t_nodes->Raw<uint64_t>());
-  for (size_t i = 0; i < walk_len_; ++i) {
-    auto t_edge_types =
-        query->AllocInput(euler::ToString("et_", i),
-        {edge_types[i].size()}, euler::kInt32);
-    for (size_t j = 0; j < edge_types[i].size(); ++j) {
-      t_edge_types->Raw<int32_t>()[j] = edge_types[i][j];
-    }
-  }
-  auto t_count = query->AllocInput("nb_count_", {1}, euler::kInt32);
-  *(t_count->Raw<int32_t>()) = 1;
-  size_t nodes_size = node_ids.size();
-
-  auto output_data = output->flat<int64>().data();
-  for (size_t i = 0; i < nodes_size; ++i) {
-    output_data[i * (walk_len_ + 1)] = node_ids[i];
-  }
-
-  auto callback = [output, done, nodes_size, query, this]() {
-    auto output_data = output->flat<int64>().data();
-    for (size_t i = 0; i < nodes_size; ++i) {
-      for (size_t j = 0; j < walk_len_; ++j) {
-        auto layers_t = query->GetResult(res_names_[j]);
-        uint64_t nb_id = layers_t->Raw<uint64_t>()[i] ==
-            euler::common::DEFAULT_UINT64 ? default_node_ :
-            layers_t->Raw<uint64_t>()[i];
-        output_data[i * (walk_len_ + 1) + j + 1] = nb_id;
-      }
-    }
-    delete query;
-    done();
-  };
-  euler::QueryProxy::GetInstance()->RunAsyncGremlin(query, callback);
-}
-
 void RandomWalk::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
   auto nodes = ctx->input(0).flat<int64>();
   OpInputList etypes;
-  OP_REQUIRES_OK(ctx, ctx->input_list("edge_types", &etypes));
+  OP_REQUIRES_OK_ASYNC(ctx, ctx->input_list("edge_types", &etypes), done);
 
-  OP_REQUIRES(ctx, etypes.size() == walk_len_,
-              errors::InvalidArgument("edge_types must with size of walk_len"));
+  OP_REQUIRES_ASYNC(
+      ctx, etypes.size() == walk_len_,
+      errors::InvalidArgument("edge_types must with size of walk_len"), done);
+  OP_REQUIRES_ASYNC(ctx, p_ > 0 && q_ > 0,
+                    errors::InvalidArgument("p and q must be positive"),
+                    done);
 
   std::vector<std::vector<int32>> edge_types(walk_len_);
   for (auto i = 0; i < walk_len_; ++i) {
     auto etypes_flat = etypes[i].flat<int32>();
-    edge_types[i].resize(etypes_flat.size());
-    memcpy(edge_types[i].data(), etypes_flat.data(),
-           sizeof(edge_types[i][0]) * edge_types[i].size());
+    edge_types[i].assign(etypes_flat.data(),
+                         etypes_flat.data() + etypes_flat.size());
   }
 
   TensorShape output_shape;
@@ -267,25 +179,27 @@ void RandomWalk::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
   output_shape.AddDim(walk_len_ + 1);
 
   Tensor* output = nullptr;
-  OP_REQUIRES_OK(ctx, ctx->allocate_output(0, output_shape, &output));
-
-  std::vector<std::vector<int64_t>> parent_neighbors(nodes.size());
-  std::vector<int64_t> node_ids(nodes.size(), -1);
-  memcpy(node_ids.data(), nodes.data(), sizeof(node_ids[0]) * nodes.size());
+  OP_REQUIRES_OK_ASYNC(ctx, ctx->allocate_output(0, output_shape, &output),
+                       done);
 
   auto data = output->flat<int64>().data();
-  for (auto i = 0; i < node_ids.size(); ++i) {
-    data[i * (walk_len_ + 1)] = node_ids[i];
+  std::fill(data, data + output->NumElements(), default_node_);
+  std::vector<int> walk_ids(nodes.size());
+  std::vector<uint64_t> node_ids(nodes.size());
+  for (auto i = 0; i < nodes.size(); ++i) {
+    data[i * (walk_len_ + 1)] = nodes(i);
+    walk_ids[i] = i;
+    node_ids[i] = nodes(i);
   }
-
-  const float kEps = 1.0e-6;
-  if (fabs(p_ - 1.0) <= kEps && fabs(q_ - 1.0) <= kEps) {  // randomwalk
-    TraditionalRandomWalk(node_ids, edge_types, done, output);
-  } else {  // node2vec
-    RWCallback callback(parent_neighbors, node_ids,  edge_types, walk_len_,
-                        p_, q_, default_node_, output, done);
-    GetFullNeighbor(node_ids, edge_types[0], callback);
+  if (nodes.size() == 0 || walk_len_ == 0) {
+    done();
+    return;
   }
+
+  auto walker = std::make_shared<Walker>(edge_types, p_, q_, default_node_,
+                                         data, done);
+  walker->Run(walk_ids, node_ids, std::vector<uint64_t>(nodes.size()),
+              std::vector<int>(nodes.size()));
 }
 
 REGISTER_KERNEL_BUILDER(Name("RandomWalk").Device(DEVICE_CPU), RandomWalk);
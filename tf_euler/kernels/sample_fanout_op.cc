@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 #include <sstream>
 
@@ -55,6 +56,8 @@ class SampleFanout: public AsyncOpKernel {
   int default_node_;
   std::string query_str_;
   std::vector<std::string> res_names_;
+  std::once_flag prepare_once_;
+  euler::PreparedQuery prepared_;
 };
 
 void SampleFanout::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
@@ -68,7 +71,12 @@ void SampleFanout::ComputeAsync(OpKernelContext* ctx, DoneCallback done) {
   auto etypes_flat = edge_types.flat<int32>();
   size_t etypes_size = etypes_flat.size() / layer_cnt;
 
-  auto query = new euler::Query(query_str_);
+  // The graph is initialized after the kernel is built, compile on the
+  // first run
+  std::call_once(prepare_once_, [this] () {
+    prepared_ = euler::QueryProxy::GetInstance()->Prepare(query_str_);
+  });
+  auto query = new euler::Query(prepared_);
   auto t_nodes = query->AllocInput("nodes", {nodes_size}, euler::kUInt64);
   for (size_t i = 0; i < nodes_size; ++i) {
     t_nodes->Raw<int64_t>()[i] = nodes_flat(i);
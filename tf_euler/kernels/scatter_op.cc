@@ -13,53 +13,97 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
 
-template <typename T, typename Index>
-class ScatterAddOp : public OpKernel {
- public:
-  explicit ScatterAddOp(OpKernelConstruction* c) : OpKernel(c) {
-  }
+// half is accumulated in float
+template <typename T>
+struct Accumulator {
+  typedef T Type;
+};
 
-  void Compute(OpKernelContext* c) override {
-    const Tensor& updates = c->input(0);
-    const Tensor& indices = c->input(1);
-    const Tensor& size = c->input(2);
+template <>
+struct Accumulator<Eigen::half> {
+  typedef float Type;
+};
 
-    Index size_value = size.scalar<Index>()();
-    int slide_size = updates.shape().dim_size(1);
+// The loops over a slide are kept plain so that they are vectorized
 
-    Tensor* out;
-    TensorShape out_shape{size_value, slide_size};
-    OP_REQUIRES_OK(c, c->allocate_output(0, out_shape, &out));
+template <typename T, typename Acc>
+inline void LoadSlide(const T* __restrict src, int64 n, Acc* __restrict dst) {
+  for (int64 j = 0; j < n; ++j) {
+    dst[j] = static_cast<Acc>(src[j]);
+  }
+}
+
+template <typename T, typename Acc>
+inline void StoreSlide(const Acc* __restrict src, int64 n,
+                       T* __restrict dst) {
+  for (int64 j = 0; j < n; ++j) {
+    dst[j] = static_cast<T>(src[j]);
+  }
+}
 
-    const T* updates_base = &updates.flat<T>()(0);
-    const Index* indices_base = &indices.flat<Index>()(0);
-    T* out_base = &out->flat<T>()(0);
-    std::fill_n(out_base, size_value * slide_size, 0);
+struct AddReducer {
+  template <typename T, typename Acc>
+  static void Reduce(const T* __restrict src, int64 n, Acc* __restrict dst) {
+    for (int64 j = 0; j < n; ++j) {
+      dst[j] += static_cast<Acc>(src[j]);
+    }
+  }
+};
 
-    int num_slides = indices.shape().dim_size(0);
-    for (int i = 0; i < num_slides; ++i) {
-      for (int j = 0; j < slide_size; ++j) {
-        out_base[(indices_base[i] * slide_size) + j] +=
-        updates_base[i * slide_size + j];
-      }
+struct MaxReducer {
+  template <typename T, typename Acc>
+  static void Reduce(const T* __restrict src, int64 n, Acc* __restrict dst) {
+    for (int64 j = 0; j < n; ++j) {
+      Acc value = static_cast<Acc>(src[j]);
+      dst[j] = value > dst[j] ? value : dst[j];
     }
   }
 };
 
-template <typename T, typename Index>
-class ScatterMaxOp : public OpKernel {
+// Group the update slides by their output rows with a counting sort, the
+// slides of row r are rows[offsets[r], offsets[r + 1]) in the input order.
+template <typename Index>
+Status GroupByIndex(const Index* indices, int64 num, int64 size,
+                    std::vector<int64>* offsets, std::vector<int64>* rows) {
+  offsets->assign(size + 1, 0);
+  for (int64 i = 0; i < num; ++i) {
+    int64 index = indices[i];
+    if (index < 0 || index >= size) {
+      return errors::InvalidArgument("indices[", i, "] = ", index,
+                                     " is not in [0, ", size, ")");
+    }
+    ++(*offsets)[index + 1];
+  }
+  std::partial_sum(offsets->begin(), offsets->end(), offsets->begin());
+  std::vector<int64> next(offsets->begin(), offsets->end() - 1);
+  rows->resize(num);
+  for (int64 i = 0; i < num; ++i) {
+    (*rows)[next[indices[i]]++] = i;
+  }
+  return Status::OK();
+}
+
+// Segment reduction of the update slides into size output rows. Each output
+// row is reduced by one thread of the intra op pool from its own slides, so
+// there are no conflicting writes. The rows with no update are zeros.
+template <typename T, typename Index, typename Reducer>
+class ScatterOp : public OpKernel {
  public:
-  explicit ScatterMaxOp(OpKernelConstruction* c) : OpKernel(c) {
+  explicit ScatterOp(OpKernelConstruction* c) : OpKernel(c) {
   }
 
   void Compute(OpKernelContext* c) override {
@@ -67,42 +111,94 @@ class ScatterMaxOp : public OpKernel {
     const Tensor& indices = c->input(1);
     const Tensor& size = c->input(2);
 
-    Index size_value = size.scalar<Index>()();
-    int slide_size = updates.shape().dim_size(1);
+    OP_REQUIRES(c, indices.dim_size(0) == updates.dim_size(0),
+                errors::InvalidArgument(
+                    "indices and updates have different slides: ",
+                    indices.dim_size(0), " vs ", updates.dim_size(0)));
+    int64 size_value = size.scalar<Index>()();
+    OP_REQUIRES(c, size_value >= 0,
+                errors::InvalidArgument("Negative size: ", size_value));
+    int64 num_slides = indices.dim_size(0);
+    int64 slide_size = updates.dim_size(1);
 
     Tensor* out;
     TensorShape out_shape{size_value, slide_size};
     OP_REQUIRES_OK(c, c->allocate_output(0, out_shape, &out));
+    if (out->NumElements() == 0) {
+      return;
+    }
 
-    const T* updates_base = &updates.flat<T>()(0);
-    const Index* indices_base = &indices.flat<Index>()(0);
-    T* out_base = &out->flat<T>()(0);
-    std::fill_n(out_base, size_value * slide_size, -1e9);
-
-    int num_slides = indices.shape().dim_size(0);
-    for (int i = 0; i < num_slides; ++i) {
-      for (int j = 0; j < slide_size; ++j) {
-        int out_offset = (indices_base[i] * slide_size) + j;
-        int updates_offset = i * slide_size + j;
-        if (updates_base[updates_offset] > out_base[out_offset]) {
-          out_base[out_offset] = updates_base[updates_offset];
+    const T* updates_base = updates.flat<T>().data();
+    const Index* indices_base = indices.flat<Index>().data();
+    T* out_base = out->flat<T>().data();
+
+    std::vector<int64> offsets;
+    std::vector<int64> rows;
+    OP_REQUIRES_OK(c, GroupByIndex(indices_base, num_slides, size_value,
+                                   &offsets, &rows));
+
+    // Output row r is the unit offsets[r] + r and the units of its slides,
+    // a shard of units takes the rows starting in it. The shards are
+    // balanced by the slides even if the indices follow a power law.
+    auto row_at = [&offsets] (int64 unit) {
+      int64 low = 0;
+      int64 high = offsets.size() - 1;
+      while (low < high) {
+        int64 mid = (low + high) / 2;
+        if (offsets[mid] + mid < unit) {
+          low = mid + 1;
+        } else {
+          high = mid;
         }
       }
-    }
+      return low;
+    };
+    typedef typename Accumulator<T>::Type Acc;
+    auto work = [&] (int64 begin, int64 end) {
+      std::vector<Acc> acc(slide_size);
+      for (int64 r = row_at(begin), last = row_at(end); r < last; ++r) {
+        T* out_row = out_base + r * slide_size;
+        if (offsets[r] == offsets[r + 1]) {
+          std::fill_n(out_row, slide_size, T(0));
+          continue;
+        }
+        LoadSlide(updates_base + rows[offsets[r]] * slide_size, slide_size,
+                  acc.data());
+        for (int64 k = offsets[r] + 1; k < offsets[r + 1]; ++k) {
+          Reducer::Reduce(updates_base + rows[k] * slide_size, slide_size,
+                          acc.data());
+        }
+        StoreSlide(acc.data(), slide_size, out_row);
+      }
+    };
+    auto workers = c->device()->tensorflow_cpu_worker_threads();
+    Shard(workers->num_threads, workers->workers, num_slides + size_value,
+          slide_size, work);
   }
 };
 
-REGISTER_KERNEL_BUILDER(Name("MPScatterAdd")
-  .Device(DEVICE_CPU)
-  .TypeConstraint<float>("T")
-  .TypeConstraint<int32>("Tindices"),
-  ScatterAddOp<float, int32>);
-
-REGISTER_KERNEL_BUILDER(Name("MPScatterMax")
-  .Device(DEVICE_CPU)
-  .TypeConstraint<float>("T")
-  .TypeConstraint<int32>("Tindices"),
-  ScatterMaxOp<float, int32>);
+#define REGISTER_SCATTER(T, Index)                          \
+  REGISTER_KERNEL_BUILDER(Name("MPScatterAdd")              \
+    .Device(DEVICE_CPU)                                     \
+    .TypeConstraint<T>("T")                                 \
+    .TypeConstraint<Index>("Tindices"),                     \
+    ScatterOp<T, Index, AddReducer>);                       \
+  REGISTER_KERNEL_BUILDER(Name("MPScatterMax")              \
+    .Device(DEVICE_CPU)                                     \
+    .TypeConstraint<T>("T")                                 \
+    .TypeConstraint<Index>("Tindices"),                     \
+    ScatterOp<T, Index, MaxReducer>);
+
+#define REGISTER_SCATTER_ALL_INDICES(T)                     \
+  REGISTER_SCATTER(T, int32);                               \
+  REGISTER_SCATTER(T, int64);
+
+TF_CALL_half(REGISTER_SCATTER_ALL_INDICES);
+TF_CALL_float(REGISTER_SCATTER_ALL_INDICES);
+TF_CALL_double(REGISTER_SCATTER_ALL_INDICES);
+
+#undef REGISTER_SCATTER_ALL_INDICES
+#undef REGISTER_SCATTER
 
 }  // namespace
 }  // namespace tensorflow
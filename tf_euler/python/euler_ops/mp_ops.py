@@ -65,7 +65,8 @@ def _ScatterMaxGrad(op, grad):
 def scatter_mean(updates, indices, size=None):
     out = scatter_add(updates, indices, size)
     ep = 1e-7
-    count = scatter_add(tf.ones([tf.shape(updates)[0], 1]), indices, size) + ep
+    ones = tf.ones([tf.shape(updates)[0], 1], dtype=updates.dtype)
+    count = scatter_add(ones, indices, size) + ep
     return out / count
 
 
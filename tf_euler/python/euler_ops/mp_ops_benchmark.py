@@ -0,0 +1,73 @@
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+"""Benchmarks of the message passing ops against the TensorFlow builtins.
+
+Run: python -m tf_euler.python.euler_ops.mp_ops_benchmark --benchmarks=.
+"""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import numpy as np
+import tensorflow as tf
+
+from tf_euler.python.euler_ops import mp_ops
+
+
+class MPOpsBenchmark(tf.test.Benchmark):
+
+    def _inputs(self, num, size, dim):
+        # Power law destinations like the neighbors of a real graph
+        np.random.seed(0)
+        idx = (np.random.zipf(1.5, num) - 1) % size
+        x = np.random.rand(num, dim).astype(np.float32)
+        return tf.constant(x), tf.constant(idx.astype(np.int32))
+
+    def _run(self, name, op, num):
+        with tf.Session() as sess:
+            result = self.run_op_benchmark(sess, op, min_iters=20,
+                                           name=name)
+        print('%-48s %10.1f us %10.2f M slides/s' %
+              (name, result['wall_time'] * 1e6,
+               num / result['wall_time'] / 1e6))
+
+    def benchmarkScatter(self):
+        for num, size, dim in [(100000, 10000, 16), (1000000, 100000, 64)]:
+            x, idx = self._inputs(num, size, dim)
+            suffix = '_%d_%d_%d' % (num, size, dim)
+            self._run('mp_scatter_add' + suffix,
+                      mp_ops.scatter_add(x, idx, size), num)
+            self._run('unsorted_segment_sum' + suffix,
+                      tf.math.unsorted_segment_sum(x, idx, size), num)
+            self._run('mp_scatter_max' + suffix,
+                      mp_ops.scatter_max(x, idx, size), num)
+            self._run('unsorted_segment_max' + suffix,
+                      tf.math.unsorted_segment_max(x, idx, size), num)
+
+    def benchmarkGather(self):
+        for num, size, dim in [(100000, 10000, 16), (1000000, 100000, 64)]:
+            np.random.seed(0)
+            x = tf.constant(np.random.rand(size, dim).astype(np.float32))
+            idx = tf.constant(np.random.randint(0, size, num, np.int32))
+            suffix = '_%d_%d_%d' % (num, size, dim)
+            self._run('mp_gather' + suffix, mp_ops.gather(x, idx), num)
+            self._run('gather' + suffix, tf.gather(x, idx), num)
+
+
+if __name__ == '__main__':
+    tf.test.main()
@@ -20,6 +20,8 @@ from __future__ import division
 from __future__ import print_function
 
 import os
+
+import numpy as np
 import tensorflow as tf
 
 from tf_euler.python.euler_ops import mp_ops
@@ -77,6 +79,56 @@ class ScatterTest(tf.test.TestCase):
             diff = tf.test.compute_gradient_error(x, [3, 3], out, [2, 3])
             self.assertLess(diff, 1e-4)
 
+    def testScatterMaxEmptyRow(self):
+        x = tf.constant([[-1., -6.], [-3., -4.]])
+        idx = tf.constant([2, 0])
+        out = mp_ops.scatter_max(x, idx, size=3)
+
+        with self.test_session():
+            self.assertAllEqual([[-3., -4.], [0., 0.], [-1., -6.]],
+                                out.eval())
+
+    def testScatterTypes(self):
+        for dtype in [tf.float16, tf.float32, tf.float64]:
+            for index_dtype in [tf.int32, tf.int64]:
+                x = tf.constant([[1., 6.], [3., 4.], [5., 2.]], dtype=dtype)
+                idx = tf.constant([1, 0, 1], dtype=index_dtype)
+                size = tf.constant(2, dtype=index_dtype)
+                add_out = mp_ops.scatter_add(x, idx, size)
+                max_out = mp_ops.scatter_max(x, idx, size)
+                gather_out = mp_ops.gather(x, idx)
+                with self.test_session():
+                    self.assertAllEqual([[3., 4.], [6., 8.]], add_out.eval())
+                    self.assertAllEqual([[3., 4.], [5., 6.]],
+                                        max_out.eval())
+                    self.assertAllEqual([[3., 4.], [1., 6.], [3., 4.]],
+                                        gather_out.eval())
+
+    def testScatterLarge(self):
+        # Enough slides to be split across the threads, with power law
+        # indices
+        np.random.seed(0)
+        size = 1000
+        idx = (np.random.zipf(1.5, 100000) - 1) % size
+        x = np.random.rand(100000, 16).astype(np.float32)
+        add_out = mp_ops.scatter_add(x, idx, size)
+        max_out = mp_ops.scatter_max(x, idx, size)
+        expected_add = tf.math.unsorted_segment_sum(x, idx, size)
+        expected_max = tf.math.unsorted_segment_max(x, idx, size)
+        expected_max = tf.maximum(expected_max, 0)
+        with self.test_session():
+            self.assertAllClose(expected_add.eval(), add_out.eval(),
+                                rtol=1e-4)
+            self.assertAllEqual(expected_max.eval(), max_out.eval())
+
+    def testScatterInvalidIndex(self):
+        x = tf.constant([[1., 2.], [3., 4.]])
+        idx = tf.constant([1, 2])
+        out = mp_ops.scatter_add(x, idx, size=2)
+        with self.test_session():
+            with self.assertRaises(tf.errors.InvalidArgumentError):
+                out.eval()
+
     def testGather(self):
         x = tf.constant([[1., 2.], [3., 4.], [5., 6.]])
         idx = tf.constant([1, 0, 1, 2])
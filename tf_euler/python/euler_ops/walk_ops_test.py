@@ -66,6 +66,16 @@ class WalkOpsTest(test.TestCase):
             self.assertEqual(2, paths[1][0])
             print(paths)
 
+    def testRandomWalkMetapath(self):
+        op = ops.random_walk([1, 1], [['0'], ['1']], 0.5, 2.0)
+        with tf.Session() as sess:
+            paths = sess.run(op)
+            self.assertAllEqual([2, 3], paths.shape)
+            for path in paths:
+                self.assertEqual(1, path[0])
+                self.assertIn(path[1], [2, 4])
+                self.assertIn(path[2], [3, 5])
+
 
 if __name__ == "__main__":
     test.main()